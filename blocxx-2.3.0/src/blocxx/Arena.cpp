@@ -0,0 +1,122 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Arena.hpp"
+
+#include <new>
+
+namespace BLOCXX_NAMESPACE
+{
+
+//////////////////////////////////////////////////////////////////////////////
+Arena::Arena(size_t chunkSize)
+	: m_chunks(0)
+	, m_cur(0)
+	, m_end(0)
+	, m_chunkSize(chunkSize > 0 ? chunkSize : size_t(DEFAULT_CHUNK_SIZE))
+	, m_bytesAllocated(0)
+	, m_bytesReserved(0)
+	, m_chunkCount(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Arena::~Arena()
+{
+	release();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+Arena::release()
+{
+	while (m_chunks != 0)
+	{
+		Chunk* next = m_chunks->next;
+		::operator delete(m_chunks);
+		m_chunks = next;
+	}
+	m_cur = 0;
+	m_end = 0;
+	m_bytesAllocated = 0;
+	m_bytesReserved = 0;
+	m_chunkCount = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Arena::Chunk*
+Arena::newChunk(size_t size)
+{
+	// The header takes up ALIGNMENT bytes so the data after it stays aligned.
+	Chunk* chunk = static_cast<Chunk*>(::operator new(ALIGNMENT + size));
+	m_bytesReserved += size;
+	++m_chunkCount;
+	return chunk;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void*
+Arena::allocateSlow(size_t size)
+{
+	if (size > m_chunkSize / 4)
+	{
+		// Give it a chunk of its own, behind the current one, so the space
+		// left in the current chunk isn't wasted.
+		Chunk* chunk = newChunk(size);
+		if (m_chunks != 0)
+		{
+			chunk->next = m_chunks->next;
+			m_chunks->next = chunk;
+		}
+		else
+		{
+			chunk->next = 0;
+			m_chunks = chunk;
+		}
+		m_bytesAllocated += size;
+		return reinterpret_cast<char*>(chunk) + ALIGNMENT;
+	}
+
+	Chunk* chunk = newChunk(m_chunkSize);
+	chunk->next = m_chunks;
+	m_chunks = chunk;
+	m_cur = reinterpret_cast<char*>(chunk) + ALIGNMENT;
+	m_end = m_cur + m_chunkSize;
+
+	char* p = m_cur;
+	m_cur += size;
+	m_bytesAllocated += size;
+	return p;
+}
+
+} // end namespace BLOCXX_NAMESPACE
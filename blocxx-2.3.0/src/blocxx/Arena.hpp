@@ -0,0 +1,141 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_ARENA_HPP_INCLUDE_GUARD_
+#define BLOCXX_ARENA_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include <cstddef>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * An Arena hands out memory from large chunks by bumping a pointer, and
+ * frees all of it at once when it's destroyed or release() is called.  It's
+ * meant for short-lived scratch data built up while handling one request,
+ * such as a StringBuffer constructed with the Arena.  Memory from an Arena
+ * can't be freed individually, and nothing allocated from it is destroyed,
+ * so it mustn't hold objects with destructors that matter.
+ *
+ * An Arena isn't thread safe.
+ */
+class BLOCXX_COMMON_API Arena
+{
+public:
+	/**
+	 * The default size of the chunks an Arena allocates.
+	 */
+	static const size_t DEFAULT_CHUNK_SIZE = 4096;
+
+	/**
+	 * @param chunkSize The size of the chunks to allocate.  Allocations of
+	 * more than a quarter of this get a chunk of their own.
+	 */
+	explicit Arena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+	~Arena();
+
+	/**
+	 * Allocate size bytes, aligned for any type.  The memory stays valid
+	 * until the Arena is destroyed or release() is called.
+	 * @throws std::bad_alloc
+	 */
+	void* allocate(size_t size)
+	{
+		size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+		if (size <= size_t(m_end - m_cur))
+		{
+			char* p = m_cur;
+			m_cur += size;
+			m_bytesAllocated += size;
+			return p;
+		}
+		return allocateSlow(size);
+	}
+
+	/**
+	 * Free everything allocated from the Arena.  The Arena can be used again
+	 * afterwards.
+	 */
+	void release();
+
+	/**
+	 * @return The number of bytes handed out by allocate() since the Arena
+	 * was constructed or last released, after rounding up for alignment.
+	 */
+	size_t getBytesAllocated() const
+	{
+		return m_bytesAllocated;
+	}
+
+	/**
+	 * @return The number of bytes of chunks the Arena holds.
+	 */
+	size_t getBytesReserved() const
+	{
+		return m_bytesReserved;
+	}
+
+	/**
+	 * @return The number of chunks the Arena holds.
+	 */
+	size_t getChunkCount() const
+	{
+		return m_chunkCount;
+	}
+
+private:
+	enum { ALIGNMENT = 16 };
+
+	struct Chunk
+	{
+		Chunk* next;
+	};
+
+	void* allocateSlow(size_t size);
+	Chunk* newChunk(size_t size);
+
+	Chunk* m_chunks;
+	char* m_cur;
+	char* m_end;
+	size_t m_chunkSize;
+	size_t m_bytesAllocated;
+	size_t m_bytesReserved;
+	size_t m_chunkCount;
+
+	// noncopyable
+	Arena(const Arena&);
+	Arena& operator=(const Arena&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
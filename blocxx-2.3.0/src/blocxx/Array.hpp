@@ -45,6 +45,7 @@
 #include "blocxx/Types.hpp"
 #include "blocxx/Exception.hpp"
 #include "blocxx/vector.hpp"
+#include <utility> // for std::pair, std::move
 
 namespace BLOCXX_NAMESPACE
 {
@@ -98,6 +99,26 @@ public:
 	 * Destructor
 	 */
 	~Array();
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	// Declaring the move assignment operator suppresses the implicit copy
+	// operations, so they're spelled out here.  There is no move
+	// constructor; see COWReference.
+	Array(const Array<T>& x) : m_impl(x.m_impl) {}
+	Array<T>& operator= (const Array<T>& x)
+	{
+		m_impl = x.m_impl;
+		return *this;
+	}
+	/**
+	 * Move assignment.  Exchanges contents with x without touching any
+	 * reference counts.
+	 */
+	Array<T>& operator= (Array<T>&& x) BLOCXX_NOEXCEPT
+	{
+		m_impl = std::move(x.m_impl);
+		return *this;
+	}
+#endif
 	/**
 	 * Constructor
 	 * @param toWrap The std::vector to wrap with this Array object.
@@ -165,6 +186,27 @@ public:
 	 *		with the returned iterator.
 	 */
 	const_iterator end() const;
+	/**
+	 * Make sure this Array doesn't share its elements with any other Array,
+	 * copying them if it does.  Every non-const member function does this
+	 * check itself; calling unshare() up front is only useful together
+	 * with mutableView().
+	 */
+	void unshare();
+	/**
+	 * Do the copy-on-write check once and return a read/write range over
+	 * all the elements.  Writing through the returned iterators costs no
+	 * more than writing to a plain std::vector, which makes this the
+	 * preferred way to modify elements in a tight loop, instead of calling
+	 * the non-const operator[] or begin()/end() on every iteration.
+	 *
+	 * The range is invalidated by anything that changes the size of this
+	 * Array.  It must also not be written through once this Array has been
+	 * copied, since the copy would then see the writes.
+	 *
+	 * @return A pair of iterators [first, second) covering the Array.
+	 */
+	std::pair<iterator, iterator> mutableView();
 	/**
 	 * @return A read/write reverse iterator that points to the last element
 	 * 		in the Array. Iteration is done in reverse order with the
@@ -226,6 +268,9 @@ public:
 	 * @return A reference to this Array object.
 	 */
 	Array<T>& operator+= (const T& x);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	Array<T>& operator+= (T&& x);
+#endif
 	/**
 	 * Ensure the capacity is at least the size of a given
 	 * value. If the given value is > max_size() the method
@@ -254,12 +299,29 @@ public:
 	 * @param x The element to append to the end of the Array.
 	 */
 	void push_back(const T& x);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Append an element to the end of the Array, moving it rather than
+	 * copying it.
+	 * @param x The element to append to the end of the Array.
+	 */
+	void push_back(T&& x);
+	/**
+	 * Construct an element in place at the end of the Array.
+	 * @param args The arguments to pass to T's constructor.
+	 */
+	template <typename... Args>
+	void emplace_back(Args&&... args);
+#endif
 	/**
 	 * Append an element to the end of the Array. This is identical
 	 * to push_back.
 	 * @param x The element to append to the end of the Array.
 	 */
 	void append(const T& x);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	void append(T&& x);
+#endif
 	/**
 	 * Swap the elements of this Array with the elements of another.
 	 * @param x The Array object this Array will swap elements with.
@@ -275,6 +337,9 @@ public:
 	 *		in the Array.
 	 */
 	iterator insert(iterator position, const T& x);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	iterator insert(iterator position, T&& x);
+#endif
 	/**
 	 * Insert an element in the Array before an element specified
 	 * by an index.
@@ -283,6 +348,9 @@ public:
 	 * @param x The element to insert into the Array.
 	 */
 	void insert(size_type position, const T& x);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	void insert(size_type position, T&& x);
+#endif
 	/**
 	 * Remove an element from the Array at a given index.
 	 */
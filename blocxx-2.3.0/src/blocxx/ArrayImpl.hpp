@@ -127,6 +127,21 @@ Array<T>::end() const
 }
 /////////////////////////////////////////////////////////////////////////////
 template <typename T>
+inline void
+Array<T>::unshare()
+{
+	static_cast<void>(*m_impl);
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline std::pair<typename Array<T>::iterator, typename Array<T>::iterator>
+Array<T>::mutableView()
+{
+	V& v = *m_impl;
+	return std::pair<iterator, iterator>(v.begin(), v.end());
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
 inline typename Array<T>::reverse_iterator
 Array<T>::rbegin()
 {
@@ -258,6 +273,52 @@ Array<T>::append(const T& x)
 {
 	push_back(x);
 }
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline Array<T>&
+Array<T>::operator+= (T&& x)
+{
+	m_impl->push_back(std::move(x));
+	return *this;
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void
+Array<T>::push_back(T&& x)
+{
+	m_impl->push_back(std::move(x));
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+template <typename... Args>
+inline void
+Array<T>::emplace_back(Args&&... args)
+{
+	m_impl->emplace_back(std::forward<Args>(args)...);
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void
+Array<T>::append(T&& x)
+{
+	push_back(std::move(x));
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline typename Array<T>::iterator
+Array<T>::insert(iterator position, T&& x)
+{
+	return m_impl->insert(position, std::move(x));
+}
+/////////////////////////////////////////////////////////////////////////////
+template <typename T>
+inline void
+Array<T>::insert(size_type position, T&& x)
+{
+	m_impl->insert(m_impl->begin() + position, std::move(x));
+}
+#endif
 /////////////////////////////////////////////////////////////////////////////
 template <typename T>
 inline void
@@ -0,0 +1,86 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Atomic.hpp"
+
+#if !defined(BLOCXX_HAVE_GCC_ATOMIC_BUILTINS) && !defined(BLOCXX_HAVE_GCC_SYNC_BUILTINS)
+#include "blocxx/NonRecursiveMutex.hpp"
+#include "blocxx/ThreadOnce.hpp"
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace AtomicImpl
+{
+
+namespace
+{
+	// a prime, so addresses which are a multiple of the alignment spread out.
+	const unsigned NUM_LOCKS = 31;
+
+	// These have to be pointers because of static initialization order
+	// conflicts, and are never deleted because Atomic<> variables may be used
+	// by destructors of static variables.
+	NonRecursiveMutex* g_locks = 0;
+	OnceFlag g_once = BLOCXX_ONCE_INIT;
+
+	void initLocks()
+	{
+		g_locks = new NonRecursiveMutex[NUM_LOCKS];
+	}
+
+	NonRecursiveMutex& lockFor(const volatile void* p)
+	{
+		callOnce(g_once, initLocks);
+		return g_locks[reinterpret_cast<unsigned long>(p) % NUM_LOCKS];
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void lockAddress(const volatile void* p)
+{
+	lockFor(p).acquire();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void unlockAddress(const volatile void* p)
+{
+	lockFor(p).release();
+}
+
+} // end namespace AtomicImpl
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
+
@@ -0,0 +1,512 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_ATOMIC_HPP_INCLUDE_GUARD_
+#define BLOCXX_ATOMIC_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/MemoryBarrier.hpp"
+
+#include <cstddef> // for std::ptrdiff_t
+
+/**
+ * Variables written by different threads are padded apart by this much, so
+ * they don't share a cache line.
+ */
+#define BLOCXX_CACHE_LINE_SIZE 64
+
+#if !defined(BLOCXX_HAVE_GCC_ATOMIC_BUILTINS) && defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+#define BLOCXX_HAVE_GCC_SYNC_BUILTINS 1
+#endif
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * The ordering constraints an atomic operation puts on the memory accesses
+ * around it, with the same meaning as the C++11 std::memory_order values.
+ * The values match the GCC __ATOMIC_* constants.
+ */
+enum EMemoryOrder
+{
+	E_MEMORY_ORDER_RELAXED = 0,
+	E_MEMORY_ORDER_CONSUME = 1,
+	E_MEMORY_ORDER_ACQUIRE = 2,
+	E_MEMORY_ORDER_RELEASE = 3,
+	E_MEMORY_ORDER_ACQ_REL = 4,
+	E_MEMORY_ORDER_SEQ_CST = 5
+};
+
+// The functions in AtomicImpl are implementation details of Atomic<>.
+namespace AtomicImpl
+{
+	/**
+	 * The strongest order allowed for the failure case of a compare and
+	 * exchange which uses order on success.
+	 */
+	inline EMemoryOrder failureOrder(EMemoryOrder order)
+	{
+		switch (order)
+		{
+			case E_MEMORY_ORDER_ACQ_REL:
+				return E_MEMORY_ORDER_ACQUIRE;
+			case E_MEMORY_ORDER_RELEASE:
+				return E_MEMORY_ORDER_RELAXED;
+			default:
+				return order;
+		}
+	}
+
+#if defined(BLOCXX_HAVE_GCC_ATOMIC_BUILTINS)
+
+	template <typename T>
+	inline T load(const T& x, EMemoryOrder order)
+	{
+		return __atomic_load_n(&x, order);
+	}
+	template <typename T>
+	inline void store(T& x, T val, EMemoryOrder order)
+	{
+		__atomic_store_n(&x, val, order);
+	}
+	template <typename T>
+	inline T exchange(T& x, T val, EMemoryOrder order)
+	{
+		return __atomic_exchange_n(&x, val, order);
+	}
+	template <typename T>
+	inline bool compareExchange(T& x, T& expected, T desired, bool weak,
+		EMemoryOrder success, EMemoryOrder failure)
+	{
+		return __atomic_compare_exchange_n(&x, &expected, desired, weak, success, failure);
+	}
+	template <typename T>
+	inline T fetchAdd(T& x, T val, EMemoryOrder order)
+	{
+		return __atomic_fetch_add(&x, val, order);
+	}
+	template <typename T>
+	inline T fetchSub(T& x, T val, EMemoryOrder order)
+	{
+		return __atomic_fetch_sub(&x, val, order);
+	}
+	template <typename T>
+	inline T fetchAnd(T& x, T val, EMemoryOrder order)
+	{
+		return __atomic_fetch_and(&x, val, order);
+	}
+	template <typename T>
+	inline T fetchOr(T& x, T val, EMemoryOrder order)
+	{
+		return __atomic_fetch_or(&x, val, order);
+	}
+	template <typename T>
+	inline T fetchXor(T& x, T val, EMemoryOrder order)
+	{
+		return __atomic_fetch_xor(&x, val, order);
+	}
+	template <typename T>
+	inline bool isLockFree()
+	{
+		return __atomic_always_lock_free(sizeof(T), 0);
+	}
+	inline void threadFence(EMemoryOrder order)
+	{
+		__atomic_thread_fence(order);
+	}
+
+#elif defined(BLOCXX_HAVE_GCC_SYNC_BUILTINS)
+
+	// The __sync builtins are all full barriers, so the order is ignored.
+	template <typename T>
+	inline T load(const T& x, EMemoryOrder)
+	{
+		__sync_synchronize();
+		T rv = *static_cast<const volatile T*>(&x);
+		__sync_synchronize();
+		return rv;
+	}
+	template <typename T>
+	inline void store(T& x, T val, EMemoryOrder)
+	{
+		__sync_synchronize();
+		*static_cast<volatile T*>(&x) = val;
+		__sync_synchronize();
+	}
+	template <typename T>
+	inline bool compareExchange(T& x, T& expected, T desired, bool,
+		EMemoryOrder, EMemoryOrder)
+	{
+		T prev = __sync_val_compare_and_swap(&x, expected, desired);
+		if (prev == expected)
+		{
+			return true;
+		}
+		expected = prev;
+		return false;
+	}
+	template <typename T>
+	inline T exchange(T& x, T val, EMemoryOrder order)
+	{
+		T prev = x;
+		while (!compareExchange(x, prev, val, false, order, order))
+		{
+		}
+		return prev;
+	}
+	template <typename T>
+	inline T fetchAdd(T& x, T val, EMemoryOrder)
+	{
+		return __sync_fetch_and_add(&x, val);
+	}
+	template <typename T>
+	inline T fetchSub(T& x, T val, EMemoryOrder)
+	{
+		return __sync_fetch_and_sub(&x, val);
+	}
+	template <typename T>
+	inline T fetchAnd(T& x, T val, EMemoryOrder)
+	{
+		return __sync_fetch_and_and(&x, val);
+	}
+	template <typename T>
+	inline T fetchOr(T& x, T val, EMemoryOrder)
+	{
+		return __sync_fetch_and_or(&x, val);
+	}
+	template <typename T>
+	inline T fetchXor(T& x, T val, EMemoryOrder)
+	{
+		return __sync_fetch_and_xor(&x, val);
+	}
+	template <typename T>
+	inline bool isLockFree()
+	{
+		return true;
+	}
+	inline void threadFence(EMemoryOrder)
+	{
+		__sync_synchronize();
+	}
+
+#else
+
+	// No atomic instructions are available, so each operation locks one of a
+	// fixed set of mutexes chosen by the address of the variable.
+	BLOCXX_COMMON_API void lockAddress(const volatile void* p);
+	BLOCXX_COMMON_API void unlockAddress(const volatile void* p);
+
+	class AddressLock
+	{
+	public:
+		AddressLock(const volatile void* p)
+			: m_p(p)
+		{
+			lockAddress(m_p);
+		}
+		~AddressLock()
+		{
+			unlockAddress(m_p);
+		}
+	private:
+		const volatile void* m_p;
+	};
+
+	template <typename T>
+	inline T load(const T& x, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		return x;
+	}
+	template <typename T>
+	inline void store(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		x = val;
+	}
+	template <typename T>
+	inline T exchange(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		T prev = x;
+		x = val;
+		return prev;
+	}
+	template <typename T>
+	inline bool compareExchange(T& x, T& expected, T desired, bool,
+		EMemoryOrder, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		if (x == expected)
+		{
+			x = desired;
+			return true;
+		}
+		expected = x;
+		return false;
+	}
+	template <typename T>
+	inline T fetchAdd(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		T prev = x;
+		x = prev + val;
+		return prev;
+	}
+	template <typename T>
+	inline T fetchSub(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		T prev = x;
+		x = prev - val;
+		return prev;
+	}
+	template <typename T>
+	inline T fetchAnd(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		T prev = x;
+		x = prev & val;
+		return prev;
+	}
+	template <typename T>
+	inline T fetchOr(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		T prev = x;
+		x = prev | val;
+		return prev;
+	}
+	template <typename T>
+	inline T fetchXor(T& x, T val, EMemoryOrder)
+	{
+		AddressLock lock(&x);
+		T prev = x;
+		x = prev ^ val;
+		return prev;
+	}
+	template <typename T>
+	inline bool isLockFree()
+	{
+		return false;
+	}
+	inline void threadFence(EMemoryOrder)
+	{
+		readWriteMemoryBarrier();
+	}
+
+#endif
+
+} // end namespace AtomicImpl
+
+/**
+ * A fence with the given order, like C++11 std::atomic_thread_fence().
+ * E_MEMORY_ORDER_SEQ_CST orders earlier stores before later loads, which
+ * no other order (and no acquire or release operation) does.
+ */
+inline void atomicThreadFence(EMemoryOrder order)
+{
+	AtomicImpl::threadFence(order);
+}
+
+/**
+ * The operations Atomic<T> has for every T.
+ */
+template <typename T>
+class AtomicBase
+{
+public:
+	/**
+	 * @return Whether operations on this type use atomic instructions.  If
+	 * not, they're protected by a mutex.
+	 */
+	static bool isLockFree()
+	{
+		return AtomicImpl::isLockFree<T>();
+	}
+
+	T load(EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST) const
+	{
+		return AtomicImpl::load(m_value, order);
+	}
+
+	/**
+	 * @param order E_MEMORY_ORDER_RELAXED, E_MEMORY_ORDER_RELEASE or
+	 * E_MEMORY_ORDER_SEQ_CST.
+	 */
+	void store(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		AtomicImpl::store(m_value, val, order);
+	}
+
+	/**
+	 * Store val.
+	 * @return The previous value.
+	 */
+	T exchange(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return AtomicImpl::exchange(m_value, val, order);
+	}
+
+	/**
+	 * If the value is equal to expected, replace it with desired and return
+	 * true.  Otherwise load the current value into expected and return false.
+	 * @param failure The order of the load if the values aren't equal.  It
+	 * can't be stronger than success, or E_MEMORY_ORDER_RELEASE or
+	 * E_MEMORY_ORDER_ACQ_REL.
+	 */
+	bool compareExchangeStrong(T& expected, T desired,
+		EMemoryOrder success, EMemoryOrder failure)
+	{
+		return AtomicImpl::compareExchange(m_value, expected, desired, false, success, failure);
+	}
+	bool compareExchangeStrong(T& expected, T desired,
+		EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return compareExchangeStrong(expected, desired, order, AtomicImpl::failureOrder(order));
+	}
+
+	/**
+	 * Like compareExchangeStrong(), but may fail even though the values are
+	 * equal.  This is cheaper on some architectures when it's called in a
+	 * loop anyway.
+	 */
+	bool compareExchangeWeak(T& expected, T desired,
+		EMemoryOrder success, EMemoryOrder failure)
+	{
+		return AtomicImpl::compareExchange(m_value, expected, desired, true, success, failure);
+	}
+	bool compareExchangeWeak(T& expected, T desired,
+		EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return compareExchangeWeak(expected, desired, order, AtomicImpl::failureOrder(order));
+	}
+
+protected:
+	AtomicBase(T val)
+		: m_value(val)
+	{
+	}
+
+	T m_value;
+
+private:
+	// noncopyable
+	AtomicBase(const AtomicBase&);
+	AtomicBase& operator=(const AtomicBase&);
+};
+
+/**
+ * A value of integral type T which can be read and modified atomically by
+ * several threads, with an explicit memory order for each operation.  The
+ * operations are the same as the C++11 std::atomic<T> ones.  T must be an
+ * integral type of 1, 2, 4 or 8 bytes, or bool (bool only supports the
+ * AtomicBase operations).
+ *
+ * With GCC 4.7 or later (or clang) these map onto the __atomic builtins.
+ * Older GCCs use the __sync builtins, which are full barriers whatever the
+ * order.  Otherwise the operations are protected by a mutex, in which case
+ * isLockFree() returns false.
+ */
+template <typename T>
+class Atomic : public AtomicBase<T>
+{
+public:
+	Atomic()
+		: AtomicBase<T>(T())
+	{
+	}
+	explicit Atomic(T val)
+		: AtomicBase<T>(val)
+	{
+	}
+
+	/**
+	 * Each of the fetchX functions atomically replaces the value with the
+	 * result of applying X to it and val.
+	 * @return The previous value.
+	 */
+	T fetchAdd(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return AtomicImpl::fetchAdd(this->m_value, val, order);
+	}
+	T fetchSub(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return AtomicImpl::fetchSub(this->m_value, val, order);
+	}
+	T fetchAnd(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return AtomicImpl::fetchAnd(this->m_value, val, order);
+	}
+	T fetchOr(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return AtomicImpl::fetchOr(this->m_value, val, order);
+	}
+	T fetchXor(T val, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return AtomicImpl::fetchXor(this->m_value, val, order);
+	}
+};
+
+/**
+ * An atomic pointer.  fetchAdd() and fetchSub() do pointer arithmetic, in
+ * units of T.
+ */
+template <typename T>
+class Atomic<T*> : public AtomicBase<T*>
+{
+public:
+	Atomic()
+		: AtomicBase<T*>(0)
+	{
+	}
+	explicit Atomic(T* val)
+		: AtomicBase<T*>(val)
+	{
+	}
+
+	T* fetchAdd(std::ptrdiff_t n, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		T* prev = this->load(E_MEMORY_ORDER_RELAXED);
+		while (!this->compareExchangeWeak(prev, prev + n, order, E_MEMORY_ORDER_RELAXED))
+		{
+		}
+		return prev;
+	}
+	T* fetchSub(std::ptrdiff_t n, EMemoryOrder order = E_MEMORY_ORDER_SEQ_CST)
+	{
+		return fetchAdd(-n, order);
+	}
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
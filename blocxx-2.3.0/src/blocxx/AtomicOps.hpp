@@ -39,6 +39,7 @@
 #ifndef BLOCXX_ATOMIC_OPS_HPP_INCLUDE_GUARD_
 #define BLOCXX_ATOMIC_OPS_HPP_INCLUDE_GUARD_
 #include "blocxx/BLOCXX_config.h"
+#include "blocxx/MemoryBarrier.hpp" // for BLOCXX_HAVE_GCC_ATOMIC_BUILTINS
 
 #if defined(BLOCXX_AIX)
 extern "C"
@@ -58,8 +59,57 @@ extern "C"
  * @see http://www.hpl.hp.com/research/linux/atomic_ops/
  */
 
+#if defined(BLOCXX_HAVE_GCC_ATOMIC_BUILTINS)
+
+namespace BLOCXX_NAMESPACE
+{
+
+// use the compiler's atomic builtins, which work on every architecture it
+// supports.
+struct Atomic_t
+{
+	Atomic_t() : val(0) {}
+	Atomic_t(int i) : val(i) {}
+	volatile int val;
+};
+inline void AtomicInc(Atomic_t &v)
+{
+	__atomic_fetch_add(&v.val, 1, __ATOMIC_SEQ_CST);
+}
+inline int AtomicIncAndGet(Atomic_t &v)
+{
+	return __atomic_add_fetch(&v.val, 1, __ATOMIC_SEQ_CST);
+}
+// GCC 12 can't always see that the counter is there once this is inlined
+// into a reference's destructor, and reports the decrement as a write into
+// a zero-sized region.  It's a false positive, so silence it here.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 7
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+inline bool AtomicDecAndTest(Atomic_t &v)
+{
+	return __atomic_sub_fetch(&v.val, 1, __ATOMIC_SEQ_CST) == 0;
+}
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 7
+#pragma GCC diagnostic pop
+#endif
+inline int AtomicGet(Atomic_t const &v)
+{
+	return __atomic_load_n(&v.val, __ATOMIC_ACQUIRE);
+}
+inline void AtomicDec(Atomic_t &v)
+{
+	__atomic_fetch_sub(&v.val, 1, __ATOMIC_SEQ_CST);
+}
+inline int AtomicDecAndGet(Atomic_t &v)
+{
+	return __atomic_sub_fetch(&v.val, 1, __ATOMIC_SEQ_CST);
+}
+
+} // end namespace BLOCXX_NAMESPACE
 // x86 and x86-64 asm is identical
-#if (defined(BLOCXX_ARCH_X86) || defined(__i386__) || defined(BLOCXX_ARCH_X86_64) || defined(__x86_64__)) && defined(__GNUC__)
+#elif (defined(BLOCXX_ARCH_X86) || defined(__i386__) || defined(BLOCXX_ARCH_X86_64) || defined(__x86_64__)) && defined(__GNUC__)
 
 namespace BLOCXX_NAMESPACE
 {
@@ -42,6 +42,7 @@
 #include "blocxx/ByteSwap.hpp"
 #include "blocxx/IOException.hpp"
 #include "blocxx/Format.hpp"
+#include "blocxx/DataStreams.hpp"
 #include <cerrno>
 
 namespace BLOCXX_NAMESPACE
@@ -177,6 +178,42 @@ read(std::streambuf & istrm, void * dataIn, size_t dataInLen)
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// STATIC
+void
+readArray(std::streambuf & istrm, StringArray & a)
+{
+	UInt32 len;
+	readLen(istrm, len);
+	a.clear();
+	a.resize(len);
+	for (UInt32 i = 0; i < len; i++)
+	{
+		a[i].readObject(istrm);
+	}
+}
+//////////////////////////////////////////////////////////////////////////////
+// STATIC
+StringView
+readStringView(DataIStreamBuf & istrm)
+{
+	UInt32 len;
+	readLen(istrm, len);
+	const char* data = istrm.getCurrent();
+	if (!istrm.skip(len))
+	{
+		BLOCXX_THROW(IOException, "Failed reading data");
+	}
+	return StringView(data, len);
+}
+//////////////////////////////////////////////////////////////////////////////
+// STATIC
+StringView
+readStringView(DataIStream & istrm)
+{
+	return readStringView(istrm.getBuf());
+}
+
 } // namespace BinarySerialization
 
 } // end namespace BLOCXX_NAMESPACE
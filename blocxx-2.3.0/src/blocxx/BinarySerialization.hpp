@@ -44,6 +44,7 @@
 #include "blocxx/String.hpp"
 #include "blocxx/Array.hpp"
 #include "blocxx/ByteSwap.hpp"
+#include "blocxx/StringView.hpp"
 #include "IOException.hpp"
 
 #include <iosfwd>
@@ -54,6 +55,9 @@
 namespace BLOCXX_NAMESPACE
 {
 
+class DataIStream;
+class DataIStreamBuf;
+
 namespace BinarySerialization
 {
 
@@ -215,6 +219,60 @@ const UInt8 END_STRINGENUM =		154;
 		}
 	}
 
+	// Bulk paths for arrays of integers.  The elements are converted to
+	// network byte order in blocks and written with a single sputn() per
+	// block instead of one call per element.  The wire format is the ASN.1
+	// length (element count) followed by the elements, each in network
+	// byte order, which matches writing them one at a time with write().
+	inline UInt8 toNetworkOrder(UInt8 v) { return v; }
+	inline Int8 toNetworkOrder(Int8 v) { return v; }
+	inline UInt16 toNetworkOrder(UInt16 v) { return hton16(v); }
+	inline Int16 toNetworkOrder(Int16 v) { return hton16(v); }
+	inline UInt32 toNetworkOrder(UInt32 v) { return hton32(v); }
+	inline Int32 toNetworkOrder(Int32 v) { return hton32(v); }
+	inline UInt64 toNetworkOrder(UInt64 v) { return hton64(v); }
+	inline Int64 toNetworkOrder(Int64 v) { return hton64(v); }
+
+	/////////////////////////////////////////////////////////////////////////////
+	template <typename T>
+	inline void
+	writeIntegerArray(std::streambuf & ostrm, const Array<T> & a)
+	{
+		UInt32 len = static_cast<UInt32>(a.size());
+		BinarySerialization::writeLen(ostrm, len);
+		if (len == 0)
+		{
+			return;
+		}
+		const T* src = &a[0];
+		if (sizeof(T) == 1)
+		{
+			BinarySerialization::write(ostrm, src, len);
+			return;
+		}
+		const UInt32 blockSize = 256;
+		T block[blockSize];
+		for (UInt32 done = 0; done < len; )
+		{
+			UInt32 n = len - done < blockSize ? len - done : blockSize;
+			for (UInt32 i = 0; i < n; ++i)
+			{
+				block[i] = toNetworkOrder(src[done + i]);
+			}
+			BinarySerialization::write(ostrm, block, n * sizeof(T));
+			done += n;
+		}
+	}
+
+	inline void writeArray(std::streambuf & ostrm, const UInt8Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const Int8Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const UInt16Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const Int16Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const UInt32Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const Int32Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const UInt64Array & a) { writeIntegerArray(ostrm, a); }
+	inline void writeArray(std::streambuf & ostrm, const Int64Array & a) { writeIntegerArray(ostrm, a); }
+
 	inline void writeStringArray(
 		std::streambuf & ostrm, const StringArray & stra
 	)
@@ -278,6 +336,56 @@ const UInt8 END_STRINGENUM =		154;
 		BinarySerialization::read(istrm, &val, sizeof(val));
 	}
 
+	/////////////////////////////////////////////////////////////////////////////
+	template <typename T>
+	inline void
+	readIntegerArray(std::streambuf & istrm, Array<T> & a)
+	{
+		UInt32 len;
+		BinarySerialization::readLen(istrm, len);
+		a.clear();
+		if (len == 0)
+		{
+			return;
+		}
+		a.resize(len);
+		// only one copy-on-write check for the whole array
+		T* dest = &a[0];
+		BinarySerialization::read(istrm, dest, len * sizeof(T));
+		if (sizeof(T) > 1)
+		{
+			for (UInt32 i = 0; i < len; ++i)
+			{
+				dest[i] = toNetworkOrder(dest[i]);
+			}
+		}
+	}
+
+	inline void readArray(std::streambuf & istrm, UInt8Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, Int8Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, UInt16Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, Int16Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, UInt32Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, Int32Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, UInt64Array & a) { readIntegerArray(istrm, a); }
+	inline void readArray(std::streambuf & istrm, Int64Array & a) { readIntegerArray(istrm, a); }
+
+	/**
+	 * Read the strings directly into the elements of the array instead of
+	 * into a temporary which is then copied into the array.
+	 */
+	BLOCXX_COMMON_API void readArray(std::streambuf & istrm, StringArray & a);
+
+	/**
+	 * Zero-copy string reader.  Reads a String written by String::writeObject()
+	 * and returns a view into the buffer of istrm, without copying the
+	 * characters.  The view is valid as long as the buffer given to istrm.
+	 * Unlike a String, the view is not NULL terminated.
+	 * @throws IOException if the buffer does not hold the complete string.
+	 */
+	BLOCXX_COMMON_API StringView readStringView(DataIStreamBuf & istrm);
+	BLOCXX_COMMON_API StringView readStringView(DataIStream & istrm);
+
 	inline Bool readBool(std::streambuf & istrm)
 	{
 		BinarySerialization::verifySignature(istrm, BINSIG_BOOL);
@@ -134,6 +134,24 @@ public:
 	{
 		if (m_pObj != 0) COWIntrusiveReferenceAddRef(m_pObj);
 	}
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Move constructor. Takes over the pointer held by rhs without changing
+	 * the reference count, and leaves rhs null.
+	 */
+	COWIntrusiveReference(COWIntrusiveReference && rhs) BLOCXX_NOEXCEPT: m_pObj(rhs.m_pObj)
+	{
+		rhs.m_pObj = 0;
+	}
+	/**
+	 * Move assignment. Exchanges pointers with rhs.
+	 */
+	COWIntrusiveReference & operator=(COWIntrusiveReference && rhs) BLOCXX_NOEXCEPT
+	{
+		swap(rhs);
+		return *this;
+	}
+#endif
 	/**
 	 * Destroy this COWIntrusiveReference. If the reference count to the
 	 * underlying COWIntrusiveCountableBase object is zero after it is
@@ -105,6 +105,18 @@ public:
 	 * @return A reference to this COWReference object.
 	 */
 	COWReference<T>& operator= (const COWReference<T>& arg);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Move assignment.  Exchanges objects with arg, so no reference counts
+	 * are touched and arg is left holding a valid object.
+	 *
+	 * There is deliberately no move constructor: it would have to leave
+	 * arg null, and the containers built on COWReference (Array, Map, ...)
+	 * rely on their m_impl never being null.  Without one, their implicit
+	 * move constructors fall back to copying, which is always safe.
+	 */
+	COWReference<T>& operator= (COWReference<T>&& arg) BLOCXX_NOEXCEPT;
+#endif
 
 	/**
 	 * Assignment operator.
@@ -186,6 +198,15 @@ inline COWReference<T>::COWReference(const COWReference<U>& arg)
 	: COWReferenceBase(arg), m_pObj(arg.m_pObj)
 {
 }
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+//////////////////////////////////////////////////////////////////////////////
+template<class T>
+inline COWReference<T>& COWReference<T>::operator= (COWReference<T>&& arg) BLOCXX_NOEXCEPT
+{
+	swap(arg);
+	return *this;
+}
+#endif
 //////////////////////////////////////////////////////////////////////////////
 template<class T>
 inline COWReference<T>::~COWReference()
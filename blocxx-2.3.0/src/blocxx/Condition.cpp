@@ -40,6 +40,7 @@
 #include "blocxx/ExceptionIds.hpp"
 #include "blocxx/Timeout.hpp"
 #include "blocxx/TimeoutTimer.hpp"
+#include "blocxx/TimePoint.hpp"
 #include "blocxx/ThreadImpl.hpp"
 
 #include <cassert>
@@ -55,10 +56,32 @@ namespace BLOCXX_NAMESPACE
 BLOCXX_DEFINE_EXCEPTION_WITH_ID(ConditionLock);
 BLOCXX_DEFINE_EXCEPTION_WITH_ID(ConditionResource);
 #if defined(BLOCXX_USE_PTHREAD)
+
+// Timed waits are made against the monotonic clock where the condition
+// variable can be told to use it, so a change to the system time can't make
+// them return early or hang.
+#if defined(BLOCXX_HAVE_CLOCK_MONOTONIC) && defined(BLOCXX_HAVE_PTHREAD_CONDATTR_SETCLOCK)
+#define BLOCXX_CONDITION_USE_MONOTONIC_CLOCK
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 Condition::Condition()
 {
+#ifdef BLOCXX_CONDITION_USE_MONOTONIC_CLOCK
+	pthread_condattr_t attr;
+	int res = pthread_condattr_init(&attr);
+	if (res == 0)
+	{
+		res = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+		if (res == 0)
+		{
+			res = pthread_cond_init(&m_condition, &attr);
+		}
+		pthread_condattr_destroy(&attr);
+	}
+#else
 	int res = pthread_cond_init(&m_condition, PTHREAD_COND_ATTR_DEFAULT);
+#endif
 	if (res != 0)
 	{
 		BLOCXX_THROW_ERRNO_MSG1(ConditionResourceException, "Failed initializing condition variable", res);
@@ -122,8 +145,9 @@ namespace
 			((x.tv_sec == y.tv_sec) && (x.tv_nsec < y.tv_nsec));
 	}
 
+	// now_sec must be read from the clock the condition variable uses.
 	int runCheckedTimedwait(pthread_cond_t * cond, pthread_mutex_t * mtx,
-		struct timespec const * abstime)
+		struct timespec const * abstime, time_t now_sec)
 	{
 		// Solaris won't let you wait more than 10 ** 8 seconds.  On 64-bit
 		// linux, pthread_cond_timedwait may treat the value as a 32-bit time_t
@@ -131,7 +155,6 @@ namespace
 		// that long anyway.
 		time_t const max_future = 99999999;
 		time_t const max_time = std::numeric_limits<time_t>::max();
-		time_t now_sec = DateTime::getCurrent().get();
 		struct timespec new_abstime;
 		new_abstime.tv_sec = (
 			now_sec <= max_time - max_future
@@ -184,7 +207,14 @@ Condition::doTimedWait(NonRecursiveMutex& mutex, const Timeout& timeout)
 	timespec ts;
 	TimeoutTimer timer(timeout);
 
-	res = runCheckedTimedwait(&m_condition, state.pmutex, timer.asTimespec(ts));
+#ifdef BLOCXX_CONDITION_USE_MONOTONIC_CLOCK
+	time_t nowSec = static_cast<time_t>(Time::TimePoint::now().microseconds() / 1000000);
+	res = runCheckedTimedwait(&m_condition, state.pmutex,
+		timer.asTimePoint().toTimespec(ts), nowSec);
+#else
+	res = runCheckedTimedwait(&m_condition, state.pmutex, timer.asTimespec(ts),
+		DateTime::getCurrent().get());
+#endif
 	mutex.conditionPostWait(state);
 	assert(res == 0 || res == ETIMEDOUT || res == EINTR);
 	if (!(res == 0 || res == ETIMEDOUT || res == EINTR))
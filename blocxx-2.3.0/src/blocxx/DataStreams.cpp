@@ -101,23 +101,63 @@ DataIStreamBuf::seekpos(pos_type sp, std::ios_base::openmode which)
 }
 
 //////////////////////////////////////////////////////////////////////////////
+// The vector is used as the put area, so writes are plain stores into it
+// and only running out of space needs a virtual call.  m_bfr.size() is the
+// capacity of the put area, length() is the number of bytes written.
 DataOStreamBuf::DataOStreamBuf(size_t initialSize)
 	: std::streambuf()
+	, m_bfr(initialSize ? initialSize : 1)
 {
-	m_bfr.reserve(initialSize);
+	clear();
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+DataOStreamBuf::clear()
+{
+	char* begin = reinterpret_cast<char*>(&m_bfr[0]);
+	setp(begin, begin + m_bfr.size());
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+DataOStreamBuf::grow(size_t n)
+{
+	size_t used = pptr() - pbase();
+	size_t newSize = m_bfr.size() * 2;
+	if (newSize < used + n)
+	{
+		newSize = used + n;
+	}
+	m_bfr.resize(newSize);
+	char* begin = reinterpret_cast<char*>(&m_bfr[0]);
+	setp(begin, begin + newSize);
+	pbump(static_cast<int>(used));
 }
 //////////////////////////////////////////////////////////////////////////////
 int
 DataOStreamBuf::overflow(int c)
 {
-	m_bfr.push_back(c);
+	if (c == EOF)
+	{
+		return 0;
+	}
+	if (pptr() == epptr())
+	{
+		grow(1);
+	}
+	*pptr() = static_cast<char>(c);
+	pbump(1);
 	return 0;
 }
 //////////////////////////////////////////////////////////////////////////////
 std::streamsize
 DataOStreamBuf::xsputn(const char* s, std::streamsize n)
 {
-	m_bfr.insert(m_bfr.end(), s, s+n);
+	if (epptr() - pptr() < n)
+	{
+		grow(n);
+	}
+	::memcpy(pptr(), s, n);
+	pbump(static_cast<int>(n));
 	return n;
 }
 
@@ -73,6 +73,28 @@ public:
 			const_cast<char*>(reinterpret_cast<const char*>(data)),
 			const_cast<char*>(reinterpret_cast<const char*>(data+dataLen)));
 	}
+
+	/**
+	 * Direct access to the unread part of the buffer.  Used by the
+	 * zero-copy readers in BinarySerialization, which hand out pointers into
+	 * the buffer instead of copying the data.
+	 */
+	const char* getCurrent() const { return gptr(); }
+	size_t available() const { return egptr() - gptr(); }
+	/**
+	 * Advance the read position by n bytes.
+	 * @return false if less than n bytes are available, in which case the
+	 *	read position is not changed.
+	 */
+	bool skip(size_t n)
+	{
+		if (n > available())
+		{
+			return false;
+		}
+		gbump(static_cast<int>(n));
+		return true;
+	}
 protected:
 	virtual int underflow();
 
@@ -93,6 +115,7 @@ public:
 	DataIStream(int dataLen, const unsigned char* data)
 	: DataIStreamBase(dataLen, data)
 	, std::basic_istream<char, std::char_traits<char> >(&m_strbuf)	{}
+	DataIStreamBuf& getBuf() { return m_strbuf; }
 };
 //////////////////////////////////////////////////////////////////////////////
 class BLOCXX_COMMON_API DataOStreamBuf : public std::streambuf
@@ -100,12 +123,14 @@ class BLOCXX_COMMON_API DataOStreamBuf : public std::streambuf
 public:
 	DataOStreamBuf(size_t initialSize = 256);
 	const unsigned char* getData() const { return &m_bfr[0]; }
-	int length() const { return m_bfr.size(); }
-	void clear() { m_bfr.clear(); }
+	int length() const { return pptr() - pbase(); }
+	void clear();
 protected:
 	virtual int overflow(int c);
 	virtual std::streamsize xsputn(const char* s, std::streamsize n);
 private:
+	// Make room for at least n more bytes in the put area.
+	void grow(size_t n);
 
 #ifdef BLOCXX_WIN32
 #pragma warning (push)
@@ -48,6 +48,7 @@
 #include "blocxx/ExceptionIds.hpp"
 #include "blocxx/DivRem.hpp"
 #include "blocxx/TmUtils.hpp"
+#include "blocxx/Atomic.hpp"
 
 #include <time.h>
 #ifdef BLOCXX_HAVE_SYS_TIME_H
@@ -924,6 +925,269 @@ namespace BLOCXX_NAMESPACE
 			}
 		}
 
+		time_t const SECONDS_PER_DAY = 86400;
+
+		// Seconds since the epoch of a UTC date and time.  The fields are
+		// only added up, so any that are out of their usual range carry into
+		// the next larger one, as timeGm() would do.
+		Int64 civilToSeconds(Int32 year, Int32 month, Int32 day, Int32 hour,
+			Int32 minute, Int32 second)
+		{
+			return Int64(daysFromCivil(year, month, day)) * SECONDS_PER_DAY +
+				hour * 3600 + minute * 60 + second;
+		}
+
+		time_t checkedTime(Int64 seconds)
+		{
+			if (seconds < BLOCXX_DATETIME_MINIMUM_TIME ||
+				seconds > BLOCXX_DATETIME_MAXIMUM_TIME)
+			{
+				BLOCXX_THROW(DateTimeException,
+					Format("Time out of range: %1", seconds).c_str());
+			}
+			return time_t(seconds);
+		}
+
+		inline bool isDecimalDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		// Parse a fixed width CIM field at p.  In CIM, "Fields which are not
+		// significant must be replaced with asterisk characters", so those
+		// are read as 0s.  Anything but digits and asterisks goes through
+		// String::toInt32(), which may accept it (e.g. a sign) or throw
+		// StringConversionException.
+		Int32 parseCIMField(const char* p, size_t width)
+		{
+			Int32 value = 0;
+			for (size_t i = 0; i < width; ++i)
+			{
+				if (isDecimalDigit(p[i]))
+				{
+					value = value * 10 + (p[i] - '0');
+				}
+				else if (p[i] == '*')
+				{
+					value *= 10;
+				}
+				else
+				{
+					String field(p, width);
+					for (size_t j = 0; j < width; ++j)
+					{
+						if (field[j] == '*')
+						{
+							field[j] = '0';
+						}
+					}
+					return field.toInt32();
+				}
+			}
+			return value;
+		}
+
+		// Parse exactly width digits at p into value.
+		inline bool parseDigits(const char* p, size_t width, Int32& value)
+		{
+			value = 0;
+			for (size_t i = 0; i < width; ++i)
+			{
+				if (!isDecimalDigit(p[i]))
+				{
+					return false;
+				}
+				value = value * 10 + (p[i] - '0');
+			}
+			return true;
+		}
+
+		// Parse the ISO 8601 (RFC 3339) layout
+		// YYYY-MM-DDThh:mm:ss[.f...](Z|+hh:mm|-hh:mm)
+		// into the UTC seconds since the epoch.
+		// @return false if str doesn't have that layout.
+		bool parseISO8601(const String& str, Int64& seconds, Int32& microseconds)
+		{
+			const char* p = str.c_str();
+			size_t len = str.length();
+			Int32 year;
+			Int32 month;
+			Int32 day;
+			Int32 hour;
+			Int32 minute;
+			Int32 second;
+			if (len < 20 ||
+				!parseDigits(p, 4, year) || p[4] != '-' ||
+				!parseDigits(p + 5, 2, month) || p[7] != '-' ||
+				!parseDigits(p + 8, 2, day) || p[10] != 'T' ||
+				!parseDigits(p + 11, 2, hour) || p[13] != ':' ||
+				!parseDigits(p + 14, 2, minute) || p[16] != ':' ||
+				!parseDigits(p + 17, 2, second))
+			{
+				return false;
+			}
+
+			size_t pos = 19;
+			microseconds = 0;
+			if (p[pos] == '.')
+			{
+				// Digits past microseconds are dropped.
+				size_t digits = 0;
+				for (++pos; isDecimalDigit(p[pos]); ++pos, ++digits)
+				{
+					if (digits < 6)
+					{
+						microseconds = microseconds * 10 + (p[pos] - '0');
+					}
+				}
+				if (digits == 0 || digits > 9)
+				{
+					return false;
+				}
+				for (; digits < 6; ++digits)
+				{
+					microseconds *= 10;
+				}
+			}
+
+			Int32 offset = 0;
+			if (p[pos] == 'Z' && pos + 1 == len)
+			{
+			}
+			else if ((p[pos] == '+' || p[pos] == '-') && pos + 6 == len &&
+				p[pos + 3] == ':')
+			{
+				Int32 offsetHour;
+				Int32 offsetMinute;
+				if (!parseDigits(p + pos + 1, 2, offsetHour) ||
+					!parseDigits(p + pos + 4, 2, offsetMinute) ||
+					offsetHour > 23 || offsetMinute > 59)
+				{
+					return false;
+				}
+				offset = offsetHour * 60 + offsetMinute;
+				if (p[pos] == '-')
+				{
+					offset = -offset;
+				}
+			}
+			else
+			{
+				return false;
+			}
+
+			VALIDATE_RANGES(year, month, day, hour, minute, second, microseconds, str);
+			seconds = civilToSeconds(year, month, day, hour, minute - offset, second);
+			return true;
+		}
+
+		// The offset of local time from UTC usually changes at most twice a
+		// year, but finding it with localtime_r() costs a lot more than the
+		// arithmetic in utcTm(), and where there is no localtime_r() it
+		// takes a global lock.  So offsets are cached per UTC day, in a
+		// direct mapped table which readers never lock.  Each entry packs
+		//   bits  0-31  the day (days since the epoch, truncated to 32 bits)
+		//   bits 32-49  the offset in seconds, plus OFFSET_BIAS
+		//   bit  50     tm_isdst
+		//   bit  51     the entry is valid
+		// Days on which the offset or tm_isdst change aren't cached, which
+		// assumes they don't change and then change back within one day.
+		size_t const OFFSET_CACHE_SIZE = 256;
+		Atomic<UInt64> offsetCache[OFFSET_CACHE_SIZE];
+
+		Int64 const OFFSET_BIAS = 1 << 17;
+		UInt64 const OFFSET_ENTRY_ISDST = UInt64(1) << 50;
+		UInt64 const OFFSET_ENTRY_VALID = UInt64(1) << 51;
+
+		// The offset of the local time loc from the UTC time t, in seconds.
+		Int64 localOffsetOf(time_t t, const tm& loc)
+		{
+			return civilToSeconds(loc.tm_year + 1900, loc.tm_mon + 1,
+				loc.tm_mday, loc.tm_hour, loc.tm_min, loc.tm_sec) - t;
+		}
+
+		// Find the offset of local time from UTC at t (in seconds) and
+		// whether daylight saving time is in effect.
+		// @return false if the offset changes on t's day (or can't be
+		// found), in which case use localtime_r() instead.
+		bool localOffset(time_t t, Int64& offset, bool& isdst)
+		{
+			Int64 day = divFloor(Int64(t), Int64(SECONDS_PER_DAY));
+			Atomic<UInt64>& slot = offsetCache[UInt64(day) % OFFSET_CACHE_SIZE];
+			UInt64 entry = slot.load(E_MEMORY_ORDER_RELAXED);
+			if ((entry & OFFSET_ENTRY_VALID) && UInt32(entry) == UInt32(day))
+			{
+				offset = Int64((entry >> 32) & 0x3FFFF) - OFFSET_BIAS;
+				isdst = (entry & OFFSET_ENTRY_ISDST) != 0;
+				return true;
+			}
+
+			time_t start = time_t(day * SECONDS_PER_DAY);
+			time_t end = start + SECONDS_PER_DAY - 1;
+			tm startLoc;
+			tm endLoc;
+			if (!localtime_r(&start, &startLoc) || !localtime_r(&end, &endLoc))
+			{
+				return false;
+			}
+			offset = localOffsetOf(start, startLoc);
+			isdst = startLoc.tm_isdst > 0;
+			if (offset != localOffsetOf(end, endLoc) ||
+				isdst != (endLoc.tm_isdst > 0) ||
+				offset <= -OFFSET_BIAS || offset >= OFFSET_BIAS)
+			{
+				return false;
+			}
+			entry = UInt64(UInt32(day)) | (UInt64(offset + OFFSET_BIAS) << 32) |
+				(isdst ? OFFSET_ENTRY_ISDST : 0) | OFFSET_ENTRY_VALID;
+			slot.store(entry, E_MEMORY_ORDER_RELAXED);
+			return true;
+		}
+
+		// Like localtime_r(), but only the standard fields of tm are set.
+		void localTm(time_t t, tm& loc)
+		{
+			Int64 offset;
+			bool isdst;
+			if (localOffset(t, offset, isdst))
+			{
+				utcTm(time_t(t + offset), loc);
+				loc.tm_isdst = isdst;
+			}
+			else
+			{
+				localtime_r(&t, &loc);
+			}
+		}
+
+		// The offset of local time from UTC at t, in whole minutes (rounded
+		// down: a few historical offsets have seconds).
+		Int32 localOffsetMinutes(time_t t)
+		{
+			Int64 offset;
+			bool isdst;
+			if (!localOffset(t, offset, isdst))
+			{
+				tm loc;
+				if (!localtime_r(&t, &loc))
+				{
+					BLOCXX_THROW(DateTimeException, Format("Invalid time_t: %1", t).c_str());
+				}
+				offset = localOffsetOf(t, loc);
+			}
+			return Int32(divFloor(offset, Int64(60)));
+		}
+
+		inline char* putDigits(char* p, UInt32 value, int width)
+		{
+			for (int i = width - 1; i >= 0; --i)
+			{
+				p[i] = char('0' + value % 10);
+				value /= 10;
+			}
+			return p + width;
+		}
+
 
 	} // end anonymous namespace
 
@@ -938,28 +1202,18 @@ namespace BLOCXX_NAMESPACE
 			{
 				try
 				{
-					// in CIM, "Fields which are not significant must be
-					// replaced with asterisk characters."  We'll convert
-					// asterisks to 0s so we can process them.
-					String strNoAsterisks(str);
-					for (size_t i = 0; i < strNoAsterisks.length(); ++i)
-					{
-						if (strNoAsterisks[i] == '*')
-						{
-							strNoAsterisks[i] = '0';
-						}
-					}
-					Int32 year = strNoAsterisks.substring(0, 4).toInt32();
-					Int32 month = strNoAsterisks.substring(4, 2).toInt32();
-					Int32 day = strNoAsterisks.substring(6, 2).toInt32();
-					Int32 hour = strNoAsterisks.substring(8, 2).toInt32();
-					Int32 minute = strNoAsterisks.substring(10, 2).toInt32();
-					Int32 second = strNoAsterisks.substring(12, 2).toInt32();
-					Int32 microseconds = strNoAsterisks.substring(15, 6).toInt32();
+					const char* p = str.c_str();
+					Int32 year = parseCIMField(p, 4);
+					Int32 month = parseCIMField(p + 4, 2);
+					Int32 day = parseCIMField(p + 6, 2);
+					Int32 hour = parseCIMField(p + 8, 2);
+					Int32 minute = parseCIMField(p + 10, 2);
+					Int32 second = parseCIMField(p + 12, 2);
+					Int32 microseconds = parseCIMField(p + 15, 6);
 
 					VALIDATE_RANGES(year, month, day, hour, minute, second, microseconds, str);
 
-					Int32 utc = strNoAsterisks.substring(22, 3).toInt32();
+					Int32 utc = parseCIMField(p + 22, 3);
 					// adjust the time to utc.  According to the CIM spec:
 					// "utc is the offset from UTC in minutes"
 					if (str[21] == '+')
@@ -968,8 +1222,9 @@ namespace BLOCXX_NAMESPACE
 					}
 					minute += utc;
 
-					set(year, month, day, hour, minute, second,
-						microseconds, E_UTC_TIME);
+					m_seconds = checkedTime(
+						civilToSeconds(year, month, day, hour, minute, second));
+					m_microseconds = microseconds;
 					return;
 				}
 				catch (StringConversionException&)
@@ -980,8 +1235,17 @@ namespace BLOCXX_NAMESPACE
 			}
 		}
 
-		// It didn't return from above, so it's not a CIM datetime.  Try to parse
-		// it as a free-form date string.
+		Int64 seconds;
+		Int32 microseconds;
+		if (parseISO8601(str, seconds, microseconds))
+		{
+			m_seconds = checkedTime(seconds);
+			m_microseconds = microseconds;
+			return;
+		}
+
+		// It didn't return from above, so it's not a CIM or ISO 8601
+		// datetime.  Try to parse it as a free-form date string.
 		if ( !str.empty() )
 		{
 			// This is a general method of extracting the date.
@@ -1172,18 +1436,16 @@ namespace BLOCXX_NAMESPACE
 	{
 		checkNormalTime(m_microseconds);
 
+		tm theTime;
 		if (timeOffset == E_LOCAL_TIME)
 		{
-			tm theTime;
-			localtime_r(&m_seconds, &theTime);
-			return theTime;
+			localTm(m_seconds, theTime);
 		}
 		else // timeOffset == E_UTC_TIME
 		{
-			tm theTime;
-			gmtime_r(&m_seconds, &theTime);
-			return theTime;
+			utcTm(m_seconds, theTime);
 		}
+		return theTime;
 	}
 
 	//////////////////////////////////////////////////////////////////////////////
@@ -1533,7 +1795,17 @@ namespace BLOCXX_NAMESPACE
 
 		if( flag == Time::E_TIME_NOT_SPECIAL )
 		{
-			tm theTime = getTm(timeOffset);
+			// strftime() may need the time zone fields that only
+			// localtime_r() and gmtime_r() fill in.
+			tm theTime;
+			if (timeOffset == E_LOCAL_TIME)
+			{
+				localtime_r(&m_seconds, &theTime);
+			}
+			else
+			{
+				gmtime_r(&m_seconds, &theTime);
+			}
 			size_t const BUFSZ = 1024;
 			char buf[BUFSZ];
 			size_t n = strftime(buf, BUFSZ, format, &theTime);
@@ -1543,9 +1815,90 @@ namespace BLOCXX_NAMESPACE
 		return Time::getDescriptionForFlag(flag);
 	}
 
+	//////////////////////////////////////////////////////////////////////////////
+	String DateTime::toCIMString(ETimeOffset timeOffset) const
+	{
+		Time::ESpecialTime flag = getSpecialTimeFlag();
+		if( flag != Time::E_TIME_NOT_SPECIAL )
+		{
+			return Time::getDescriptionForFlag(flag);
+		}
+
+		Int32 offset = timeOffset == E_LOCAL_TIME ? localOffsetMinutes(m_seconds) : 0;
+		tm theTime;
+		utcTm(time_t(m_seconds + offset * 60), theTime);
+
+		// yyyymmddhhmmss.mmmmmmsutc
+		char buf[25];
+		char* p = putDigits(buf, theTime.tm_year + 1900, 4);
+		p = putDigits(p, theTime.tm_mon + 1, 2);
+		p = putDigits(p, theTime.tm_mday, 2);
+		p = putDigits(p, theTime.tm_hour, 2);
+		p = putDigits(p, theTime.tm_min, 2);
+		p = putDigits(p, theTime.tm_sec, 2);
+		*p++ = '.';
+		p = putDigits(p, m_microseconds, 6);
+		*p++ = offset < 0 ? '-' : '+';
+		p = putDigits(p, offset < 0 ? -offset : offset, 3);
+		return String(buf, p - buf);
+	}
+
+	//////////////////////////////////////////////////////////////////////////////
+	String DateTime::toISO8601String(ETimeOffset timeOffset) const
+	{
+		Time::ESpecialTime flag = getSpecialTimeFlag();
+		if( flag != Time::E_TIME_NOT_SPECIAL )
+		{
+			return Time::getDescriptionForFlag(flag);
+		}
+
+		Int32 offset = timeOffset == E_LOCAL_TIME ? localOffsetMinutes(m_seconds) : 0;
+		tm theTime;
+		utcTm(time_t(m_seconds + offset * 60), theTime);
+
+		// YYYY-MM-DDThh:mm:ss.ffffff+hh:mm
+		char buf[32];
+		char* p = putDigits(buf, theTime.tm_year + 1900, 4);
+		*p++ = '-';
+		p = putDigits(p, theTime.tm_mon + 1, 2);
+		*p++ = '-';
+		p = putDigits(p, theTime.tm_mday, 2);
+		*p++ = 'T';
+		p = putDigits(p, theTime.tm_hour, 2);
+		*p++ = ':';
+		p = putDigits(p, theTime.tm_min, 2);
+		*p++ = ':';
+		p = putDigits(p, theTime.tm_sec, 2);
+		*p++ = '.';
+		p = putDigits(p, m_microseconds, 6);
+		if (timeOffset == E_UTC_TIME)
+		{
+			*p++ = 'Z';
+		}
+		else
+		{
+			*p++ = offset < 0 ? '-' : '+';
+			Int32 absOffset = offset < 0 ? -offset : offset;
+			p = putDigits(p, absOffset / 60, 2);
+			*p++ = ':';
+			p = putDigits(p, absOffset % 60, 2);
+		}
+		return String(buf, p - buf);
+	}
+
 	//////////////////////////////////////////////////////////////////////////////
 	char const DateTime::DEFAULT_FORMAT[] = "%c";
 
+	//////////////////////////////////////////////////////////////////////////////
+	// static
+	void DateTime::clearTimeZoneCache()
+	{
+		for (size_t i = 0; i < OFFSET_CACHE_SIZE; ++i)
+		{
+			offsetCache[i].store(0, E_MEMORY_ORDER_RELAXED);
+		}
+	}
+
 	//////////////////////////////////////////////////////////////////////////////
 	Int16 DateTime::localTimeAndOffset(time_t t, struct tm & t_loc)
 	{
@@ -123,7 +123,11 @@ namespace BLOCXX_NAMESPACE
 		 * (1) a CIM DateTime formatted string (e.g. "19980525133015.000000-300")
 		 * (2) a ctime() formatted string (e.g. "Wed Jun 30 21:49:08 1993")
 		 *     The current local timezone is assumed.
-		 * (3) a free-form date which must have a month, day, year, and time.
+		 * (3) an ISO 8601 (RFC 3339) date and time with a UTC offset, laid out
+		 *     exactly as YYYY-MM-DDThh:mm:ss[.fraction](Z|+hh:mm|-hh:mm)
+		 *     (e.g. "1998-05-25T13:30:15.5-05:00").  The fraction may have
+		 *     up to 9 digits; those past microseconds are dropped.
+		 * (4) a free-form date which must have a month, day, year, and time.
 		 *     Optional fields are a weekday, and timezone, and the seconds
 		 *     sub-field of the time field.
 		 *
@@ -187,8 +191,8 @@ namespace BLOCXX_NAMESPACE
 		 *
 		 * Note that DateTime cannot hold an interval, so you cannot construct
 		 * one from an CIM DateTime interval.
-		 * If str is a CIM DateTime, the timezone is part of the string and
-		 * will be honored.
+		 * If str is a CIM or ISO 8601 DateTime, the timezone is part of the
+		 * string and will be honored.
 		 * Otherwise, if str is a ctime() formatted string, the current C
 		 * timezone will be used.
 		 *
@@ -557,6 +561,24 @@ namespace BLOCXX_NAMESPACE
 		String toString(
 			char const * format, ETimeOffset timeOffset = E_LOCAL_TIME) const;
 
+		/**
+		 * @param timeOffset Indicates whether to use the local timezone or UTC
+		 * @return The CIM DateTime representation of this DateTime, e.g.
+		 * "19980525133015.000000-300", which DateTime(const String&) reads
+		 * back as the same time.  A special DateTime gives the same string
+		 * as toString().
+		 */
+		String toCIMString(ETimeOffset timeOffset = E_LOCAL_TIME) const;
+
+		/**
+		 * @param timeOffset Indicates whether to use the local timezone or UTC
+		 * @return The ISO 8601 representation of this DateTime with
+		 * microseconds, e.g. "1998-05-25T13:30:15.000000-05:00", or with a
+		 * "Z" suffix for UTC.  A special DateTime gives the same string as
+		 * toString().
+		 */
+		String toISO8601String(ETimeOffset timeOffset = E_LOCAL_TIME) const;
+
 
 		/**
 		 * Get a flag that shows what kind of DateTime this is.  This will be
@@ -583,6 +605,13 @@ namespace BLOCXX_NAMESPACE
 			return DateTime::localTimeAndOffset(t, tt);
 		}
 
+		/**
+		 * The offset of local time from UTC is cached for each day it was
+		 * asked about.  Call this after changing the time zone (i.e. TZ
+		 * and tzset()) while the process is running.
+		 */
+		static void clearTimeZoneCache();
+
 		/**
 		 * Converts date/time specified by *this to local time, stored in
 		 * tt as per the C localtime function, and returns the corresponding
@@ -0,0 +1,188 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/EventCount.hpp"
+#include "blocxx/TimeoutTimer.hpp"
+#include "blocxx/TimePoint.hpp"
+#include "blocxx/TimeDuration.hpp"
+
+#ifdef BLOCXX_EVENT_COUNT_USE_FUTEX
+#include <linux/futex.h>
+#include <unistd.h>
+#include <time.h>
+#include <cerrno>
+#else
+#include "blocxx/NonRecursiveMutexLock.hpp"
+#endif
+
+namespace BLOCXX_NAMESPACE
+{
+
+#ifdef BLOCXX_EVENT_COUNT_USE_FUTEX
+namespace
+{
+	// Sleep while *addr == expected, for at most relative (if not null).
+	void futexWait(UInt32* addr, UInt32 expected, const ::timespec* relative)
+	{
+		::syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, relative, 0, 0);
+	}
+
+	void futexWake(UInt32* addr, int count)
+	{
+		::syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, 0, 0, 0);
+	}
+}
+#endif
+
+/////////////////////////////////////////////////////////////////////////////
+EventCount::EventCount()
+	: m_epoch(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+EventCount::~EventCount()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+EventCount::Key
+EventCount::prepareWait()
+{
+	m_waiters.fetchAdd(1, E_MEMORY_ORDER_SEQ_CST);
+	// the caller's next check of its condition mustn't be done before the
+	// increment is visible to notifyAll().
+	atomicThreadFence(E_MEMORY_ORDER_SEQ_CST);
+	return AtomicImpl::load(m_epoch, E_MEMORY_ORDER_ACQUIRE);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+EventCount::cancelWait()
+{
+	m_waiters.fetchSub(1, E_MEMORY_ORDER_RELAXED);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+bool
+EventCount::wait(Key key, const Timeout& timeout)
+{
+	TimeoutTimer timer(timeout);
+	bool notified = true;
+#ifdef BLOCXX_EVENT_COUNT_USE_FUTEX
+	while (AtomicImpl::load(m_epoch, E_MEMORY_ORDER_ACQUIRE) == key)
+	{
+		if (timer.infinite())
+		{
+			futexWait(&m_epoch, key, 0);
+		}
+		else
+		{
+			timer.loop();
+			if (timer.expired())
+			{
+				notified = false;
+				break;
+			}
+			Time::TimeDuration remaining = timer.asTimePoint() - Time::TimePoint::now();
+			if (remaining.microseconds() <= 0)
+			{
+				continue;
+			}
+			::timespec ts;
+			ts.tv_sec = remaining.completeSeconds();
+			ts.tv_nsec = remaining.microsecondInSecond() * 1000;
+			futexWait(&m_epoch, key, &ts);
+		}
+	}
+#else
+	{
+		NonRecursiveMutexLock lock(m_mutex);
+		while (m_epoch == key)
+		{
+			if (!m_cond.timedWait(lock, timer.asAbsoluteTimeout()))
+			{
+				notified = m_epoch != key;
+				break;
+			}
+		}
+	}
+#endif
+	m_waiters.fetchSub(1, E_MEMORY_ORDER_RELAXED);
+	return notified;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+EventCount::notifyAll()
+{
+	// the caller's change to its condition mustn't be ordered after the
+	// check for waiters.
+	atomicThreadFence(E_MEMORY_ORDER_SEQ_CST);
+	if (m_waiters.load(E_MEMORY_ORDER_RELAXED) == 0)
+	{
+		return;
+	}
+#ifdef BLOCXX_EVENT_COUNT_USE_FUTEX
+	AtomicImpl::fetchAdd(m_epoch, UInt32(1), E_MEMORY_ORDER_RELEASE);
+	futexWake(&m_epoch, 0x7fffffff);
+#else
+	NonRecursiveMutexLock lock(m_mutex);
+	AtomicImpl::fetchAdd(m_epoch, UInt32(1), E_MEMORY_ORDER_RELEASE);
+	m_cond.notifyAll();
+#endif
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+EventCount::notifyOne()
+{
+	atomicThreadFence(E_MEMORY_ORDER_SEQ_CST);
+	if (m_waiters.load(E_MEMORY_ORDER_RELAXED) == 0)
+	{
+		return;
+	}
+	// Changing the epoch releases every waiter that hasn't gone to sleep
+	// yet, as well as the one woken here.
+#ifdef BLOCXX_EVENT_COUNT_USE_FUTEX
+	AtomicImpl::fetchAdd(m_epoch, UInt32(1), E_MEMORY_ORDER_RELEASE);
+	futexWake(&m_epoch, 1);
+#else
+	NonRecursiveMutexLock lock(m_mutex);
+	AtomicImpl::fetchAdd(m_epoch, UInt32(1), E_MEMORY_ORDER_RELEASE);
+	m_cond.notifyOne();
+#endif
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
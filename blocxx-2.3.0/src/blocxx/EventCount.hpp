@@ -0,0 +1,136 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_EVENT_COUNT_HPP_INCLUDE_GUARD_
+#define BLOCXX_EVENT_COUNT_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/Types.hpp"
+#include "blocxx/Timeout.hpp"
+
+#if defined(BLOCXX_GNU_LINUX)
+#include <sys/syscall.h>
+#endif
+
+// Linux can block directly on the epoch word with futex(2).  Elsewhere a
+// mutex and condition variable are used, but only by threads that actually
+// block or wake someone.
+#if defined(BLOCXX_GNU_LINUX) && defined(SYS_futex)
+#define BLOCXX_EVENT_COUNT_USE_FUTEX
+#else
+#include "blocxx/NonRecursiveMutex.hpp"
+#include "blocxx/Condition.hpp"
+#endif
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * An event count lets threads block until a condition on some lock-free
+ * state becomes true, without the threads that change the state taking a
+ * lock.  A notifier pays for a fence and a load when nobody is waiting.
+ *
+ * Waiting on a condition works like this:
+ *
+ * for (;;)
+ * {
+ *     if (tryToConsume())
+ *         break;
+ *     EventCount::Key key = ec.prepareWait();
+ *     if (tryToConsume())
+ *     {
+ *         ec.cancelWait();
+ *         break;
+ *     }
+ *     ec.wait(key, timeout);
+ * }
+ *
+ * and a thread that makes the condition true calls notifyAll() afterwards.
+ * The notification can't be lost: either the second check sees the change,
+ * or notifyAll() sees the waiter and changes the key, so wait() returns.
+ */
+class BLOCXX_COMMON_API EventCount
+{
+public:
+	typedef UInt32 Key;
+
+	EventCount();
+	~EventCount();
+
+	/**
+	 * Register as a waiter.  Must be followed by exactly one call to either
+	 * cancelWait() or wait().
+	 * @return The key to pass to wait().
+	 */
+	Key prepareWait();
+
+	/**
+	 * Stop being a waiter without blocking.
+	 */
+	void cancelWait();
+
+	/**
+	 * Block until notifyAll() has been called since the prepareWait() that
+	 * returned key, or until timeout expires.  May also return early
+	 * spuriously, so the caller has to check its condition again.
+	 * @return false if the timeout expired.
+	 */
+	bool wait(Key key, const Timeout& timeout);
+
+	/**
+	 * Wake every thread blocked in wait().  Cheap if there are none.
+	 */
+	void notifyAll();
+
+	/**
+	 * Wake at least one thread blocked in wait(), if there are any.  Cheap
+	 * if there are none.  Use this when only one waiter can make progress,
+	 * e.g. for one semaphore count.
+	 */
+	void notifyOne();
+
+private:
+	UInt32 m_epoch;
+	Atomic<UInt32> m_waiters;
+#ifndef BLOCXX_EVENT_COUNT_USE_FUTEX
+	NonRecursiveMutex m_mutex;
+	Condition m_cond;
+#endif
+
+	// noncopyable
+	EventCount(const EventCount&);
+	EventCount& operator=(const EventCount&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -40,6 +40,7 @@
 #include "blocxx/Exception.hpp"
 #include "blocxx/StackTrace.hpp"
 #include "blocxx/Format.hpp"
+#include "blocxx/Atomic.hpp"
 #if defined(BLOCXX_NON_THREAD_SAFE_EXCEPTION_HANDLING)
 #include "blocxx/Mutex.hpp"
 #endif
@@ -83,6 +84,15 @@ namespace BLOCXX_NAMESPACE
 #if defined(BLOCXX_NON_THREAD_SAFE_EXCEPTION_HANDLING)
 Mutex* Exception::m_mutex = new Mutex();
 #endif
+
+namespace
+{
+#ifdef BLOCXX_ENABLE_STACK_TRACE_ON_EXCEPTIONS
+	int g_captureCallStacks = 1;
+#else
+	int g_captureCallStacks = 0;
+#endif
+}
 //////////////////////////////////////////////////////////////////////////////
 static void freeBuf(char** ptr)
 {
@@ -113,7 +123,17 @@ Exception::Exception(const char* file, int line, const char* msg, int errorCode,
 	, m_subClassId(subClassId)
 	, m_subException(subException ? subException->clone() : 0)
 	, m_errorCode(errorCode)
+	, m_callStack(0)
 {
+	if (getCaptureCallStacks())
+	{
+		m_callStack = new (std::nothrow) StackTrace::CallStack;
+		if (m_callStack)
+		{
+			// Leave out this constructor.
+			m_callStack->capture(1);
+		}
+	}
 #ifdef BLOCXX_ENABLE_STACK_TRACE_ON_EXCEPTIONS
 	StackTrace::printStackTrace();
 #endif
@@ -130,6 +150,7 @@ Exception::Exception( const Exception& e )
 	, m_subClassId(e.m_subClassId)
     , m_subException(e.m_subException ? e.m_subException->clone() : 0)
 	, m_errorCode(e.m_errorCode)
+	, m_callStack(e.m_callStack ? new (std::nothrow) StackTrace::CallStack(*e.m_callStack) : 0)
 {
 #if defined(BLOCXX_NON_THREAD_SAFE_EXCEPTION_HANDLING)
     m_mutex->acquire();
@@ -141,6 +162,7 @@ Exception::~Exception() throw()
 	try
 	{
 		delete m_subException;
+		delete m_callStack;
 		freeBuf(&m_file);
 		freeBuf(&m_msg);
 #if defined(BLOCXX_NON_THREAD_SAFE_EXCEPTION_HANDLING)
@@ -170,6 +192,7 @@ Exception::swap(Exception& rhs)
 	std::swap(m_subClassId, rhs.m_subClassId);
 	std::swap(m_subException, rhs.m_subException);
 	std::swap(m_errorCode, rhs.m_errorCode);
+	std::swap(m_callStack, rhs.m_callStack);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -298,6 +321,27 @@ Exception::setErrorCode(int errorCode)
 	m_errorCode = errorCode;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+const StackTrace::CallStack*
+Exception::getCallStack() const
+{
+	return m_callStack;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+Exception::setCaptureCallStacks(bool capture)
+{
+	AtomicImpl::store(g_captureCallStacks, capture ? 1 : 0, E_MEMORY_ORDER_RELAXED);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+Exception::getCaptureCallStacks()
+{
+	return AtomicImpl::load(g_captureCallStacks, E_MEMORY_ORDER_RELAXED) != 0;
+}
+
 namespace ExceptionDetail
 {
 
@@ -52,6 +52,11 @@
 namespace BLOCXX_NAMESPACE
 {
 
+namespace StackTrace
+{
+	class CallStack;
+}
+
 /**
  * This class is the base of all exceptions thrown by BloCxx code.
  * It cannot be constructed directly, only subclasses can be instantiated.
@@ -130,6 +135,22 @@ public:
 	 */
 	int getErrorCode() const;
 
+	/**
+	 * Returns the call stack where the exception was constructed, or 0 if
+	 * call stacks weren't being captured.  Use CallStack::toString() to
+	 * symbolize it.
+	 */
+	const StackTrace::CallStack* getCallStack() const;
+
+	/**
+	 * Turn capturing call stacks in new exceptions on or off for the whole
+	 * process.  It's on at startup if the library was configured with
+	 * --enable-stack-trace.  A capture is an unwind and an allocation; the
+	 * frames are only symbolized if getCallStack()->toString() is called.
+	 */
+	static void setCaptureCallStacks(bool capture);
+	static bool getCaptureCallStacks();
+
 	/**
 	 * Returns getMessage()
 	 */
@@ -169,6 +190,7 @@ private:
 	int m_subClassId;
 	const Exception* m_subException;
 	int m_errorCode;
+	StackTrace::CallStack* m_callStack;
 
 #if defined(BLOCXX_NON_THREAD_SAFE_EXCEPTION_HANDLING)
 	static Mutex* m_mutex;
@@ -105,6 +105,7 @@ namespace BLOCXX_NAMESPACE
 		static const int IPCMutexExceptionId = -5001;
 		static const int RegExCompileExceptionId = -5002;
 		static const int RegExExecuteExceptionId = -5003;
+		static const int ShardedRWLockImplExceptionId = -5004;
 	}
 }
 
@@ -42,6 +42,7 @@
 #include "blocxx/TimeoutTimer.hpp"
 #include "blocxx/ExecMockObject.hpp"
 #include "blocxx/GlobalPtr.hpp"
+#include "blocxx/AutoPtr.hpp"
 #include "blocxx/WaitpidThreadFix.hpp"
 
 #if !defined(BLOCXX_WIN32)
@@ -167,7 +168,11 @@ void close_child_ends(UnnamedPipeRef ppipe[BLOCXX_NPIPE])
 	{
 		ppipe[BLOCXX_SERR]->closeOutputHandle();
 	}
-	ppipe[BLOCXX_EXEC_ERR]->closeOutputHandle();
+	// The posix_spawn() path has no exec error pipe.
+	if (ppipe[BLOCXX_EXEC_ERR])
+	{
+		ppipe[BLOCXX_EXEC_ERR]->closeOutputHandle();
+	}
 }
 } // end namespace Impl
 
@@ -347,6 +352,50 @@ OutputCallback::handleData(const char* data, size_t dataLen, EOutputSource outpu
 	doHandleData(data, dataLen, outputSource, theProc, streamIndex, inputBuffer);
 }
 
+/////////////////////////////////////////////////////////////////////////////
+DescriptorOutputCallback::DescriptorOutputCallback(Descriptor stdoutDescriptor, Descriptor stderrDescriptor)
+	: m_stdout(stdoutDescriptor)
+	, m_stderr(stderrDescriptor)
+	, m_bytesWritten(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+DescriptorOutputCallback::~DescriptorOutputCallback()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+DescriptorOutputCallback::doHandleData(const char* data, size_t dataLen, EOutputSource outputSource, const ProcessRef& theProc, size_t streamIndex, Array<char>& inputBuffer)
+{
+	Descriptor d = (outputSource == E_STDOUT) ? m_stdout : m_stderr;
+	while (dataLen > 0)
+	{
+#ifdef BLOCXX_WIN32
+		DWORD written = 0;
+		if (!::WriteFile(d, data, static_cast<DWORD>(dataLen), &written, NULL))
+		{
+			BLOCXX_THROW(ExecErrorException, "Exec::DescriptorOutputCallback: write error");
+		}
+		size_t rc = written;
+#else
+		ssize_t rc = ::write(d, data, dataLen);
+		if (rc < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			BLOCXX_THROW_ERRNO_MSG(ExecErrorException, "Exec::DescriptorOutputCallback: write error");
+		}
+#endif
+		data += rc;
+		dataLen -= rc;
+		m_bytesWritten += rc;
+	}
+}
+
 /////////////////////////////////////////////////////////////////////////////
 InputCallback::~InputCallback()
 {
@@ -367,16 +416,69 @@ namespace
 		bool outIsOpen;
 		bool errIsOpen;
 		size_t availableDataLen;
+		size_t inSlot;
+		size_t outSlot;
+		size_t errSlot;
 
 		ProcessOutputState()
 			: inIsOpen(true)
 			, outIsOpen(true)
 			, errIsOpen(true)
 			, availableDataLen(0)
+			, inSlot(0)
+			, outSlot(0)
+			, errSlot(0)
 		{
 		}
 	};
 
+	enum EStreamKind
+	{
+		E_STDIN_STREAM,
+		E_STDOUT_STREAM,
+		E_STDERR_STREAM
+	};
+
+	// What a Select::SelectSet slot refers to.
+	struct SlotInfo
+	{
+		size_t procIndex;
+		EStreamKind kind;
+	};
+
+	// Big enough that capturing large amounts of output doesn't cost a
+	// read() and a callback for every kilobyte.
+	const size_t OUTPUT_BUFFER_SIZE = 64 * 1024;
+
+	void setSlotInfo(Array<SlotInfo>& slotInfo, size_t slot, size_t procIndex, EStreamKind kind)
+	{
+		if (slot >= slotInfo.size())
+		{
+			slotInfo.resize(slot + 1);
+		}
+		slotInfo[slot].procIndex = procIndex;
+		slotInfo[slot].kind = kind;
+	}
+
+	// Only wait for stdin to become writable while there is data for it.
+	// Either callback may also have closed it.
+	void updateStdinInterest(Select::SelectSet& selSet, ProcessOutputState& state, const ProcessRef& proc)
+	{
+		if (!state.inIsOpen)
+		{
+			return;
+		}
+		if (!proc->in()->isOpen())
+		{
+			selSet.remove(state.inSlot);
+			state.inIsOpen = false;
+		}
+		else
+		{
+			selSet.modify(state.inSlot, false, state.availableDataLen > 0);
+		}
+	}
+
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -388,6 +490,11 @@ processInputOutput(OutputCallback& output, Array<ProcessRef>& procs, InputCallba
 	Array<ProcessOutputState> processStates(procs.size());
 	int numOpenPipes(procs.size() * 2); // count of stdout & stderr. Ignore stdin for purposes of algorithm termination.
 
+	// The set of descriptors is only updated when a stream closes or stdin
+	// runs out of (or gets more) data, rather than rebuilt every time round.
+	Select::SelectSet selSet;
+	Array<SlotInfo> slotInfo;
+
 	Array<Array<char> > inputs(processStates.size());
 	for (size_t i = 0; i < processStates.size(); ++i)
 	{
@@ -406,42 +513,32 @@ processInputOutput(OutputCallback& output, Array<ProcessRef>& procs, InputCallba
 			processStates[i].inIsOpen = false;
 		}
 
+		if (processStates[i].outIsOpen)
+		{
+			processStates[i].outSlot = selSet.add(procs[i]->out()->getReadSelectObj(), true, false);
+			setSlotInfo(slotInfo, processStates[i].outSlot, i, E_STDOUT_STREAM);
+		}
+		if (processStates[i].errIsOpen)
+		{
+			processStates[i].errSlot = selSet.add(procs[i]->err()->getReadSelectObj(), true, false);
+			setSlotInfo(slotInfo, processStates[i].errSlot, i, E_STDERR_STREAM);
+		}
+		if (processStates[i].inIsOpen)
+		{
+			processStates[i].inSlot = selSet.add(procs[i]->in()->getWriteSelectObj(),
+				false, processStates[i].availableDataLen > 0);
+			setSlotInfo(slotInfo, processStates[i].inSlot, i, E_STDIN_STREAM);
+		}
 	}
 
+	// One extra byte so the data passed to handleData() can be NUL terminated.
+	AutoPtrVec<char> buff(new char[OUTPUT_BUFFER_SIZE + 1]);
+
 	timer.start();
 
 	while (numOpenPipes > 0)
 	{
-		Select::SelectObjectArray selObjs;
-		std::map<int, int> inputIndexProcessIndex;
-		std::map<int, int> outputIndexProcessIndex;
-		for (size_t i = 0; i < procs.size(); ++i)
-		{
-			if (processStates[i].outIsOpen)
-			{
-				Select::SelectObject selObj(procs[i]->out()->getReadSelectObj());
-				selObj.waitForRead = true;
-				selObjs.push_back(selObj);
-				inputIndexProcessIndex[selObjs.size() - 1] = i;
-			}
-			if (processStates[i].errIsOpen)
-			{
-				Select::SelectObject selObj(procs[i]->err()->getReadSelectObj());
-				selObj.waitForRead = true;
-				selObjs.push_back(selObj);
-				inputIndexProcessIndex[selObjs.size() - 1] = i;
-			}
-			if (processStates[i].inIsOpen && processStates[i].availableDataLen > 0)
-			{
-				Select::SelectObject selObj(procs[i]->in()->getWriteSelectObj());
-				selObj.waitForWrite = true;
-				selObjs.push_back(selObj);
-				outputIndexProcessIndex[selObjs.size() - 1] = i;
-			}
-
-		}
-
-		int selectrval = Select::selectRW(selObjs, timer.asRelativeTimeout());
+		int selectrval = selSet.selectRW(timer.asRelativeTimeout());
 		switch (selectrval)
 		{
 			case Select::SELECT_ERROR:
@@ -465,53 +562,32 @@ processInputOutput(OutputCallback& output, Array<ProcessRef>& procs, InputCallba
 				// reset the timeout counter
 				timer.resetOnLoop();
 
-				for (size_t i = 0; i < selObjs.size() && availableToFind > 0; ++i)
+				for (size_t slot = 0; slot < selSet.size() && availableToFind > 0; ++slot)
 				{
-					if (!selObjs[i].readAvailable)
+					if (!selSet[slot].readAvailable)
 					{
 						continue;
 					}
-					else
-					{
-						--availableToFind;
-					}
-					int streamIndex = inputIndexProcessIndex[i];
-					UnnamedPipeRef readstream;
-					if (processStates[streamIndex].outIsOpen)
-					{
-						if (procs[streamIndex]->out()->getReadSelectObj() == selObjs[i].s)
-						{
-							readstream = procs[streamIndex]->out();
-						}
-					}
+					--availableToFind;
 
-					if (!readstream && processStates[streamIndex].errIsOpen)
-					{
-						if (procs[streamIndex]->err()->getReadSelectObj() == selObjs[i].s)
-						{
-							readstream = procs[streamIndex]->err();
-						}
-					}
-
-					if (!readstream)
-					{
-						continue; // for loop
-					}
+					size_t streamIndex = slotInfo[slot].procIndex;
+					ProcessOutputState& state = processStates[streamIndex];
+					bool isOut = slotInfo[slot].kind == E_STDOUT_STREAM;
+					UnnamedPipeRef readstream = isOut ? procs[streamIndex]->out() : procs[streamIndex]->err();
 
-					char buff[1024];
-					int readrc = readstream->read(buff, sizeof(buff) - 1);
+					int readrc = readstream->read(buff.get(), OUTPUT_BUFFER_SIZE);
 					if (readrc == 0)
 					{
-						if (readstream == procs[streamIndex]->out())
+						selSet.remove(slot);
+						if (isOut)
 						{
-							processStates[streamIndex].outIsOpen = false;
-							procs[streamIndex]->out()->close();
+							state.outIsOpen = false;
 						}
 						else
 						{
-							processStates[streamIndex].errIsOpen = false;
-							procs[streamIndex]->err()->close();
+							state.errIsOpen = false;
 						}
+						readstream->close();
 						--numOpenPipes;
 					}
 					else if (readrc == -1)
@@ -522,43 +598,40 @@ processInputOutput(OutputCallback& output, Array<ProcessRef>& procs, InputCallba
 					{
 						buff[readrc] = '\0';
 						output.handleData(
-							buff,
+							buff.get(),
 							readrc,
-							readstream == procs[streamIndex]->out() ? E_STDOUT : E_STDERR,
+							isOut ? E_STDOUT : E_STDERR,
 							procs[streamIndex],
 							streamIndex, inputs[streamIndex]);
+						state.availableDataLen = inputs[streamIndex].size();
+						updateStdinInterest(selSet, state, procs[streamIndex]);
 					}
 				}
 
 				// handle stdin for all processes which have data to send to them.
-				for (size_t i = 0; i < selObjs.size() && availableToFind > 0; ++i)
+				for (size_t slot = 0; slot < selSet.size() && availableToFind > 0; ++slot)
 				{
-					if (!selObjs[i].writeAvailable)
+					if (!selSet[slot].writeAvailable)
 					{
 						continue;
 					}
-					else
-					{
-						--availableToFind;
-					}
-					int streamIndex = outputIndexProcessIndex[i];
-					UnnamedPipeRef writestream;
-					if (processStates[streamIndex].inIsOpen)
-					{
-						writestream = procs[streamIndex]->in();
-					}
+					--availableToFind;
 
-					if (!writestream)
+					size_t streamIndex = slotInfo[slot].procIndex;
+					ProcessOutputState& state = processStates[streamIndex];
+					if (!state.inIsOpen)
 					{
 						continue; // for loop
 					}
+					UnnamedPipeRef writestream = procs[streamIndex]->in();
 
-					size_t offset = inputs[streamIndex].size() - processStates[streamIndex].availableDataLen;
-					int writerc = writestream->write(&inputs[streamIndex][offset], processStates[streamIndex].availableDataLen);
+					size_t offset = inputs[streamIndex].size() - state.availableDataLen;
+					int writerc = writestream->write(&inputs[streamIndex][offset], state.availableDataLen);
 					if (writerc == -1 && errno == EPIPE)
 					{
-						processStates[streamIndex].inIsOpen = false;
-						procs[streamIndex]->in()->close();
+						selSet.remove(slot);
+						state.inIsOpen = false;
+						writestream->close();
 					}
 					else if (writerc == -1)
 					{
@@ -568,7 +641,8 @@ processInputOutput(OutputCallback& output, Array<ProcessRef>& procs, InputCallba
 					{
 						inputs[streamIndex].erase(inputs[streamIndex].begin(), inputs[streamIndex].begin() + writerc);
 						input.getData(inputs[streamIndex], procs[streamIndex], streamIndex);
-						processStates[streamIndex].availableDataLen = inputs[streamIndex].size();
+						state.availableDataLen = inputs[streamIndex].size();
+						updateStdinInterest(selSet, state, procs[streamIndex]);
 					}
 				}
 			}
@@ -588,6 +662,14 @@ void processInputOutput(const String& input, String& output, const ProcessRef& p
 	processInputOutput(gatherer, procs, singleStringInputCallback, timeout);
 }
 
+void processInputOutput(const String& input, OutputCallback& output, const ProcessRef& process,
+	const Timeout& timeout)
+{
+	Array<ProcessRef> procs(1, process);
+	SingleStringInputCallback singleStringInputCallback(input);
+	processInputOutput(output, procs, singleStringInputCallback, timeout);
+}
+
 
 } // end namespace Exec
 
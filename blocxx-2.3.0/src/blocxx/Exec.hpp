@@ -339,6 +339,40 @@ namespace Exec
 	private:
 		virtual void doGetData(Array<char>& inputBuffer, const ProcessRef& theProc, size_t streamIndex) = 0;
 	};
+
+	/**
+	 * An OutputCallback which writes process output straight to descriptors,
+	 * so that large amounts of output can be captured (e.g. to a file)
+	 * without accumulating it in memory.  Stdout and stderr may go to the
+	 * same descriptor.  The descriptors are not owned and are not closed.
+	 */
+	class BLOCXX_COMMON_API DescriptorOutputCallback : public OutputCallback
+	{
+	public:
+		/**
+		 * @param stdoutDescriptor Where data from stdout is written.
+		 * @param stderrDescriptor Where data from stderr is written.
+		 */
+		DescriptorOutputCallback(Descriptor stdoutDescriptor, Descriptor stderrDescriptor);
+		virtual ~DescriptorOutputCallback();
+
+		/**
+		 * @return The total number of bytes written so far.
+		 */
+		UInt64 bytesWritten() const
+		{
+			return m_bytesWritten;
+		}
+	private:
+		/**
+		 * @throws ExecErrorException if a write fails.
+		 */
+		virtual void doHandleData(const char* data, size_t dataLen, EOutputSource outputSource, const ProcessRef& theProc, size_t streamIndex, Array<char>& inputBuffer);
+
+		Descriptor m_stdout;
+		Descriptor m_stderr;
+		UInt64 m_bytesWritten;
+	};
 #if 0
 	enum EProcessRunning
 	{
@@ -408,6 +442,17 @@ namespace Exec
 	BLOCXX_COMMON_API void processInputOutput(const String& input, String& output, const ProcessRef& process,
 		const Timeout& timeout = Timeout::infinite, int outputlimit = -1);
 
+	/**
+	 * Send input to a single process and pass everything it outputs to
+	 * output, e.g. a DescriptorOutputCallback.  Returns once the process has
+	 * closed stdout and stderr; it does not wait for the process to exit.
+	 *
+	 * @throws ExecErrorException on error.
+	 * @throws ExecTimeoutException if the timeout expires first.
+	 */
+	BLOCXX_COMMON_API void processInputOutput(const String& input, OutputCallback& output, const ProcessRef& process,
+		const Timeout& timeout = Timeout::infinite);
+
 	/**
 	 * Send input to a process, collect the output, and wait for it to exit.
 	 * The function returns when the process exits. In the case that the child
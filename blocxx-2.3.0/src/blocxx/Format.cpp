@@ -39,7 +39,12 @@
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/Format.hpp"
 #include "blocxx/ExceptionIds.hpp"
-#include <limits>
+#include "blocxx/StringConversionImpl.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <vector>
 
 namespace BLOCXX_NAMESPACE
 {
@@ -48,17 +53,17 @@ BLOCXX_DEFINE_EXCEPTION_WITH_ID(Format);
 /////////////////////////////////////////////////////////////////////////////
 Format::operator String() const
 {
-	return oss.toString();
+	return m_buf.toString();
 }
 /////////////////////////////////////////////////////////////////////////////
 String Format::toString() const
 {
-	return oss.toString();
+	return m_buf.toString();
 }
 /////////////////////////////////////////////////////////////////////////////
 const char* Format::c_str() const
 {
-	return oss.c_str();
+	return m_buf.c_str();
 }
 
 Format::~Format()
@@ -66,7 +71,7 @@ Format::~Format()
 }
 
 Format::Format()
-	: oss()
+	: m_buf()
 {
 }
 
@@ -75,18 +80,11 @@ Format::Flags::Flags()
 	, width(0)
 	, precision(-1)
 	, fill(' ')
-	, savedprecision(0)
-	, savedwidth(0)
-	, savedfill(' ')
 {
 }
 
-void Format::useFlags(std::ostream& o, Flags& flags)
+void Format::useFlags(std::ostream& o, const Flags& flags)
 {
-	flags.savedprecision = o.precision();
-	flags.savedwidth = o.width();
-	flags.savedfill = o.fill();
-
 	long filtered = flags.flags & ~(std::ios::hex|std::ios::oct);
 	o << std::setiosflags(std::ios::fmtflags(filtered));
 
@@ -100,7 +98,6 @@ void Format::useFlags(std::ostream& o, Flags& flags)
 	{
 		o << std::oct;
 	}
-	o << std::setw(flags.width);
 	if( flags.precision >= 0 )
 	{
 		o << std::setprecision(flags.precision);
@@ -108,56 +105,40 @@ void Format::useFlags(std::ostream& o, Flags& flags)
 	o << std::setfill(flags.fill);
 }
 
-void Format::clearFlags(std::ostream& o, Flags& flags)
+namespace
 {
-	if( flags.flags & (std::ios::hex|std::ios::oct) )
+	bool isDigit(char c)
 	{
-		o << std::dec;
+		return isdigit(static_cast<unsigned char>(c)) != 0;
 	}
-	o << std::resetiosflags(std::ios::fmtflags(flags.flags));
-	o << std::setprecision(flags.savedprecision);
-	o << std::setw(flags.savedwidth);
-	o << std::setfill(flags.savedfill);
-
-
-	flags.savedprecision = 0;
-	flags.savedwidth = 0;
-	flags.savedfill = ' ';
-}
 
-namespace
-{
-	bool scanNumber(const String& str, size_t& offset, int& result, int& sign, bool& leadingZero)
+	bool scanNumber(const char*& str, int& result, int& sign, bool& leadingZero)
 	{
 		int c = 0;
-		int len = str.length();
-		int i = offset;
+		const char* i = str;
 		bool havedigit = false;
 		sign = 0;
 		leadingZero = false;
 
-		if( i < len )
+		if( *i == '-' )
 		{
-			if( str[i] == '-' )
-			{
-				sign = -1;
-				++i;
-			}
-			else if( str[i] == '+' )
-			{
-				sign = 1;
-				++i;
-			}
-			if( (i < len) && (str[i] == '0') )
-			{
-				leadingZero = true;
-			}
+			sign = -1;
+			++i;
+		}
+		else if( *i == '+' )
+		{
+			sign = 1;
+			++i;
+		}
+		if( *i == '0' )
+		{
+			leadingZero = true;
 		}
 
-		while( i < len && isdigit(str[i]) )
+		while( isDigit(*i) )
 		{
 			havedigit = true;
-			c = c * 10 + (str[i] - '0');
+			c = c * 10 + (*i - '0');
 			++i;
 		}
 
@@ -172,29 +153,28 @@ namespace
 		}
 
 		result = c;
-		offset = i;
+		str = i;
 
 		return true;
 	}
 
 	const char BRACE_OPEN = '<';
 	const char BRACE_CLOSE = '>';
-}
-
-// BRACE_OPEN [0-9]+ ( ':' ([0-9]* '.' [0-9]* )? ('x' | 'X' | 'o')? '!'? )? BRACE_CLOSE
-bool Format::processFormatSpecifier(String& str, size_t& offset, size_t& argnum, Format::Flags& flags)
-{
-	bool retval = true;
 
-	if( str[offset] == BRACE_OPEN )
+	// BRACE_OPEN [0-9]+ ( ':' ([0-9]* '.' [0-9]* )? ('x' | 'X' | 'o')? '!'? )? BRACE_CLOSE
+	// str points at the BRACE_OPEN, and is left after the last character
+	// accepted.
+	bool processFormatSpecifier(const char*& str, size_t& argnum, long& flagBits, size_t& width, int& precision, char& fill)
 	{
-		++offset;
+		bool retval = true;
+
+		++str;
 
 		// Get the argument number.
 		int arg;
 		int argsign;
 		bool unused;
-		if( scanNumber(str, offset, arg, argsign, unused) )
+		if( scanNumber(str, arg, argsign, unused) )
 		{
 			// Don't allow signs on the number.
 			if( argsign != 0 )
@@ -210,107 +190,155 @@ bool Format::processFormatSpecifier(String& str, size_t& offset, size_t& argnum,
 		}
 
 		// Get the format width/output specifiers.
-		if( str[offset] == ':' )
+		if( *str == ':' )
 		{
-			++offset;
+			++str;
 
 			int val;
 			int sign;
 			bool leadingZero;
-			if( scanNumber(str, offset, val, sign, leadingZero) )
+			if( scanNumber(str, val, sign, leadingZero) )
 			{
 				if( sign == -1 )
 				{
 					val *= -1;
-					flags.flags |= std::ios::left;
+					flagBits |= std::ios::left;
 				}
 				else if( sign == 1 )
 				{
-					flags.flags |= std::ios::showpos;
+					flagBits |= std::ios::showpos;
 				}
 
 				if( leadingZero && sign != -1)
 				{
-					flags.fill = '0';
+					fill = '0';
 				}
-				flags.width = val;
+				width = val;
 			}
 
-			if( (offset < str.length()) && (str[offset] == '.') )
+			if( *str == '.' )
 			{
-				size_t j = offset + 1;
-				if( scanNumber(str, j, val, sign, leadingZero) )
+				const char* j = str + 1;
+				if( scanNumber(j, val, sign, leadingZero) )
 				{
-					flags.precision = val;
-					flags.flags |= std::ios::showpoint | std::ios::fixed;
-					offset = j;
+					precision = val;
+					flagBits |= std::ios::showpoint | std::ios::fixed;
+					str = j;
 				}
 			}
 
-			if( offset < str.length() )
+			if( *str == 'x' )
 			{
-				if( str[offset] == 'x' )
-				{
-					flags.flags |= std::ios::hex;
-					++offset;
-				}
-				else if( str[offset] == 'X' )
-				{
-					flags.flags |= std::ios::hex | std::ios::uppercase;
-					++offset;
-				}
-				else if( str[offset] == 'o' )
-				{
-					flags.flags |= std::ios::oct;
-					++offset;
-				}
+				flagBits |= std::ios::hex;
+				++str;
+			}
+			else if( *str == 'X' )
+			{
+				flagBits |= std::ios::hex | std::ios::uppercase;
+				++str;
+			}
+			else if( *str == 'o' )
+			{
+				flagBits |= std::ios::oct;
+				++str;
+			}
 
-				if( offset < str.length() && str[offset] == '!' )
-				{
-					flags.flags |= std::ios::showbase | std::ios::boolalpha;
-					++offset;
-				}
+			if( *str == '!' )
+			{
+				flagBits |= std::ios::showbase | std::ios::boolalpha;
+				++str;
 			}
 		}
 
-		if( (offset < str.length()) && (str[offset] == BRACE_CLOSE) )
+		if( *str == BRACE_CLOSE )
 		{
-			++offset;
+			++str;
 		}
 		else
 		{
 			// No close brace.
 			retval = false;
 		}
+
+		return retval;
+	}
+
+	char* formatBase(unsigned long long n, unsigned shift, const char* digits, char* end)
+	{
+		const unsigned mask = (1U << shift) - 1;
+		do
+		{
+			*--end = digits[n & mask];
+			n >>= shift;
+		} while( n != 0 );
+		return end;
+	}
+
+	template <typename T>
+	struct UnsignedOf;
+	template <> struct UnsignedOf<short> { typedef unsigned short type; };
+	template <> struct UnsignedOf<int> { typedef unsigned int type; };
+	template <> struct UnsignedOf<long> { typedef unsigned long type; };
+	template <> struct UnsignedOf<long long> { typedef unsigned long long type; };
+
+	// Builds the printf conversion a std::ostream would use for a floating
+	// point value with these flags.
+	void floatConversion(long flags, bool isLong, char* conv)
+	{
+		*conv++ = '%';
+		if( flags & std::ios::showpos )
+		{
+			*conv++ = '+';
+		}
+		if( flags & std::ios::showpoint )
+		{
+			*conv++ = '#';
+		}
+		*conv++ = '.';
+		*conv++ = '*';
+		if( isLong )
+		{
+			*conv++ = 'L';
+		}
+		if( flags & std::ios::fixed )
+		{
+			*conv++ = 'f';
+		}
+		else
+		{
+			*conv++ = (flags & std::ios::uppercase) ? 'G' : 'g';
+		}
+		*conv = '\0';
 	}
 
-	return retval;
+	const int DEFAULT_FLOAT_PRECISION = 6;
 }
 
 /////////////////////////////////////////////////////////////////////////////
-size_t Format::process(String& str, size_t minArg, size_t maxArg, Format::Flags& flags, FormatErrorHandling errortype)
+size_t Format::process(const char*& str, size_t minArg, size_t maxArg, Format::Flags& flags, FormatErrorHandling errortype)
 {
-	size_t len(str.length());
 	size_t c = static_cast<size_t>(-1);
 	bool err = false;
-	size_t i = 0;
-	size_t percentStart = 0;
-	for (; (i < len) && (c == size_t(-1)) && !err; ++i)
+	const char* i = str;
+	const char* percentStart = str;
+	const char* literalStart = str;
+	for (; *i && (c == size_t(-1)) && !err; ++i)
 	{
-		if( str[i] == '%' )
+		if( *i == '%' )
 		{
+			m_buf.append(literalStart, i - literalStart);
 			percentStart = i;
-			if (i + 1 < len)
+			if( i[1] )
 			{
 				++i;
 
-				if( str[i] == '%' )
+				if( *i == '%' )
 				{
-					oss << '%';
+					m_buf += '%';
 				}
-				else if( str[i] == BRACE_OPEN )
+				else if( *i == BRACE_OPEN )
 				{
-					if( !processFormatSpecifier(str, i, c, flags) )
+					if( !processFormatSpecifier(i, c, flags.flags, flags.width, flags.precision, flags.fill) )
 					{
 						// No close brace or some other error.
 						err = true;
@@ -321,9 +349,9 @@ size_t Format::process(String& str, size_t minArg, size_t maxArg, Format::Flags&
 						--i;
 					}
 				}
-				else if( isdigit(str[i]) )
+				else if( isDigit(*i) )
 				{
-					c = str[i] - '0';
+					c = *i - '0';
 				}
 				else
 				{
@@ -335,13 +363,15 @@ size_t Format::process(String& str, size_t minArg, size_t maxArg, Format::Flags&
 			{
 				err = true;
 			}
-		}
-		else // anything other than a '%'
-		{
-			oss << str[i];
+			literalStart = i + 1;
 		}
 	} // for
-	if ( (i <= len) && (c != size_t(-1)))
+	if( !err && c == size_t(-1) )
+	{
+		// No more specifiers.
+		m_buf.append(literalStart, i - literalStart);
+	}
+	if ( c != size_t(-1) )
 	{
 		if( c > maxArg )
 		{
@@ -352,7 +382,8 @@ size_t Format::process(String& str, size_t minArg, size_t maxArg, Format::Flags&
 			{
 				BLOCXX_THROW(FormatException, error.c_str());
 			}
-			oss << "\n*** " << error.c_str();
+			m_buf += "\n*** ";
+			m_buf += error.c_str();
 			err = true;
 		}
 		else if( c < minArg )
@@ -363,28 +394,32 @@ size_t Format::process(String& str, size_t minArg, size_t maxArg, Format::Flags&
 			{
 				BLOCXX_THROW(FormatException, error.c_str());
 			}
-			oss << "\n*** " << error.c_str();
+			m_buf += "\n*** ";
+			m_buf += error.c_str();
 
 			err = true;
 		}
 	}
 	if (err)
 	{
-		// Print the percent and all of the text causing the error.
-		size_t textlength = std::max(i, percentStart + 1) - percentStart;
+		// Print the percent and all of the text causing the error.  i may be
+		// one past the terminating nul here.
+		size_t textlength = std::min<size_t>(std::max(i, percentStart + 1) - percentStart, ::strlen(percentStart));
 
 		OStringStream error;
-		error << "Error in format string at \"" << str.substring(percentStart, textlength) << "\"";
+		error << "Error in format string at \"" << String(percentStart, textlength) << "\"";
 
 		if( errortype == E_FORMAT_EXCEPTION )
 		{
 			BLOCXX_THROW(FormatException, error.c_str());
 		}
-		oss << "\n*** " << error.c_str() << "\n";
-		str.erase();
-		return '0';
+		m_buf += "\n*** ";
+		m_buf += error.c_str();
+		m_buf += '\n';
+		str = percentStart + ::strlen(percentStart);
+		return 0;
 	}
-	str.erase(0, i);
+	str = i;
 
 	return c;
 } // process
@@ -393,59 +428,170 @@ size_t Format::process(String& str, size_t minArg, size_t maxArg, Format::Flags&
 std::ostream&
 operator<<(std::ostream& os, const Format& f)
 {
-	os.write(f.oss.c_str(), f.oss.length());
+	os.write(f.m_buf.c_str(), f.m_buf.length());
 	return os;
 }
 /////////////////////////////////////////////////////////////////////////////
+void Format::putPadded(const char* str, size_t len, const Flags& flags, char fill)
+{
+	size_t pad = flags.width > len ? flags.width - len : 0;
+	bool left = (flags.flags & std::ios::left) != 0;
+	for (size_t i = 0; !left && i < pad; ++i)
+	{
+		m_buf += fill;
+	}
+	m_buf.append(str, len);
+	for (size_t i = 0; left && i < pad; ++i)
+	{
+		m_buf += fill;
+	}
+}
+/////////////////////////////////////////////////////////////////////////////
+void Format::putInteger(unsigned long long magnitude, bool negative, bool isSigned, const Flags& flags, char fill)
+{
+	// Enough for 64 bits in octal, plus a sign or base prefix.
+	char buf[32];
+	char* end = buf + sizeof(buf);
+	char* start;
+	if( flags.flags & std::ios::hex )
+	{
+		bool upper = (flags.flags & std::ios::uppercase) != 0;
+		start = formatBase(magnitude, 4, upper ? "0123456789ABCDEF" : "0123456789abcdef", end);
+		if( (flags.flags & std::ios::showbase) && magnitude != 0 )
+		{
+			*--start = upper ? 'X' : 'x';
+			*--start = '0';
+		}
+	}
+	else if( flags.flags & std::ios::oct )
+	{
+		start = formatBase(magnitude, 3, "01234567", end);
+		if( (flags.flags & std::ios::showbase) && magnitude != 0 )
+		{
+			*--start = '0';
+		}
+	}
+	else
+	{
+		start = formatUnsignedDecimal(magnitude, end);
+		if( negative )
+		{
+			*--start = '-';
+		}
+		else if( isSigned && (flags.flags & std::ios::showpos) )
+		{
+			*--start = '+';
+		}
+	}
+	putPadded(start, end - start, flags, fill);
+}
+/////////////////////////////////////////////////////////////////////////////
 void Format::put(const String& t, Format::Flags& flags)
-{ // t is inserted into oss
-	if (!oss.good())
+{
+	// Strings are copied as is; the width doesn't apply to them.
+	m_buf.append(t.c_str(), t.length());
+}
+/////////////////////////////////////////////////////////////////////////////
+void Format::put(const char* t, Format::Flags& flags)
+{
+	if( !t )
 	{
 		return;
 	}
-	useFlags(oss, flags);
-	oss << t;
-	clearFlags(oss, flags);
+	putPadded(t, ::strlen(t), flags, ' ');
 }
 /////////////////////////////////////////////////////////////////////////////
-#define BLOCXX_DEFINE_PUT(type) \
+void Format::put(char t, Format::Flags& flags)
+{
+	putPadded(&t, 1, flags, flags.fill);
+}
+/////////////////////////////////////////////////////////////////////////////
+void Format::put(unsigned char t, Format::Flags& flags)
+{
+	char c = static_cast<char>(t);
+	putPadded(&c, 1, flags, flags.fill);
+}
+/////////////////////////////////////////////////////////////////////////////
+void Format::put(bool t, Format::Flags& flags)
+{
+	// Zero padding isn't applied to bools.
+	if( flags.flags & std::ios::boolalpha )
+	{
+		putPadded(t ? "true" : "false", t ? 4 : 5, flags, ' ');
+	}
+	else
+	{
+		putInteger(t ? 1 : 0, false, true, flags, ' ');
+	}
+}
+/////////////////////////////////////////////////////////////////////////////
+#define BLOCXX_DEFINE_PUT_SIGNED(stype) \
+void Format::put(stype t, Format::Flags& flags) \
+{ \
+	typedef UnsignedOf<stype>::type utype; \
+	if( flags.flags & (std::ios::hex | std::ios::oct) ) \
+	{ \
+		putInteger(static_cast<utype>(t), false, true, flags, flags.fill); \
+	} \
+	else \
+	{ \
+		unsigned long long magnitude = static_cast<unsigned long long>(static_cast<long long>(t)); \
+		putInteger(t < 0 ? 0 - magnitude : magnitude, t < 0, true, flags, flags.fill); \
+	} \
+}
+
+#define BLOCXX_DEFINE_PUT_UNSIGNED(type) \
 void Format::put(type t, Format::Flags& flags) \
 { \
-\
-	if (!oss.good()) \
+	putInteger(t, false, false, flags, flags.fill); \
+}
+
+BLOCXX_DEFINE_PUT_SIGNED(short)
+BLOCXX_DEFINE_PUT_UNSIGNED(unsigned short)
+BLOCXX_DEFINE_PUT_SIGNED(int)
+BLOCXX_DEFINE_PUT_UNSIGNED(unsigned int)
+BLOCXX_DEFINE_PUT_SIGNED(long)
+BLOCXX_DEFINE_PUT_UNSIGNED(unsigned long)
+BLOCXX_DEFINE_PUT_SIGNED(long long)
+BLOCXX_DEFINE_PUT_UNSIGNED(unsigned long long)
+#undef BLOCXX_DEFINE_PUT_SIGNED
+#undef BLOCXX_DEFINE_PUT_UNSIGNED
+
+/////////////////////////////////////////////////////////////////////////////
+// float is promoted to double, as a std::ostream does.
+#define BLOCXX_DEFINE_PUT_FLOAT(type, promoted, isLong) \
+void Format::put(type t, Format::Flags& flags) \
+{ \
+	char conv[16]; \
+	floatConversion(flags.flags, isLong, conv); \
+	int precision = flags.precision >= 0 ? flags.precision : DEFAULT_FLOAT_PRECISION; \
+	char buf[64]; \
+	int len = ::snprintf(buf, sizeof(buf), conv, precision, static_cast<promoted>(t)); \
+	if( len < 0 ) \
 	{ \
 		return; \
 	} \
-\
-	useFlags(oss, flags); \
-	if (!std::numeric_limits<type>::is_specialized) \
+	if( size_t(len) < sizeof(buf) ) \
 	{ \
-		oss << std::setfill(flags.savedfill); \
+		putPadded(buf, len, flags, flags.fill); \
+	} \
+	else \
+	{ \
+		std::vector<char> big(len + 1); \
+		::snprintf(&big[0], big.size(), conv, precision, static_cast<promoted>(t)); \
+		putPadded(&big[0], len, flags, flags.fill); \
 	} \
-	oss << t; \
-	clearFlags(oss, flags);	\
 }
 
-BLOCXX_DEFINE_PUT(const char*);
-BLOCXX_DEFINE_PUT(char);
-BLOCXX_DEFINE_PUT(unsigned char);
-BLOCXX_DEFINE_PUT(short);
-BLOCXX_DEFINE_PUT(unsigned short);
-BLOCXX_DEFINE_PUT(int);
-BLOCXX_DEFINE_PUT(unsigned int);
-BLOCXX_DEFINE_PUT(long);
-BLOCXX_DEFINE_PUT(unsigned long);
-BLOCXX_DEFINE_PUT(long long);
-BLOCXX_DEFINE_PUT(unsigned long long);
-BLOCXX_DEFINE_PUT(float);
-BLOCXX_DEFINE_PUT(double);
-BLOCXX_DEFINE_PUT(long double);
-#undef BLOCXX_DEFINE_PUT
-
-Format::Format(const char* ca, const String& a) : oss()
+BLOCXX_DEFINE_PUT_FLOAT(float, double, false)
+BLOCXX_DEFINE_PUT_FLOAT(double, double, false)
+BLOCXX_DEFINE_PUT_FLOAT(long double, long double, true)
+#undef BLOCXX_DEFINE_PUT_FLOAT
+
+Format::Format(const char* ca, const String& a)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch( process(fmt, 1, 1, flags) )
@@ -454,10 +600,10 @@ Format::Format(const char* ca, const String& a) : oss()
 		}
 	}
 }
-Format::Format(const char* ca, const String& a, const String& b) : oss()
+Format::Format(const char* ca, const String& a, const String& b)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch( process(fmt, 1, 2, flags) )
@@ -467,10 +613,10 @@ Format::Format(const char* ca, const String& a, const String& b) : oss()
 		}
 	}
 }
-Format::Format(const char* ca, const String& a, const String& b, const String& c) : oss()
+Format::Format(const char* ca, const String& a, const String& b, const String& c)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch( process(fmt, 1, 3, flags) )
@@ -483,4 +629,3 @@ Format::Format(const char* ca, const String& a, const String& b, const String& c
 }
 
 } // end namespace BLOCXX_NAMESPACE
-
@@ -41,6 +41,7 @@
 #include "blocxx/BLOCXX_config.h"
 #include <iosfwd>
 #include "blocxx/StringStream.hpp"
+#include "blocxx/StringBuffer.hpp"
 #include "blocxx/String.hpp"
 #include "blocxx/Exception.hpp"
 #include <iomanip>
@@ -94,6 +95,11 @@ namespace BLOCXX_NAMESPACE
 	 *
 	 * Note: The number of arguments is limited to 9 unless a C++0x compiler is
 	 * used with the C++0x features enabled.
+	 *
+	 * The pattern is scanned once, front to back, and the output is built in a
+	 * single StringBuffer.  Strings, characters, bools and the arithmetic types
+	 * are converted without iostreams; only other types (those that are
+	 * written with their operator<<) use a temporary stream.
 	 */
 
 //  Format class declaration  -----------------------------------------------//
@@ -141,25 +147,20 @@ public:
 
 private:
 
-	OStringStream oss;
+	StringBuffer m_buf;
 
 protected:
 	// Used only in derived classes.
 	Format();
 
-	// These are to handle internal stream manipulation of format flags.
+	// The modifiers of one format specifier, as iostream format flags.
 	struct Flags
 	{
 		Flags();
 		long flags;
 		size_t width;
 		int precision;
-		std::ostream::char_type fill;
-
-		// set in useFlags(), restored in clearFlags()
-		int savedprecision;
-		size_t savedwidth;
-		std::ostream::char_type savedfill;
+		char fill;
 	};
 
 	enum FormatErrorHandling
@@ -168,17 +169,26 @@ protected:
 		E_FORMAT_EXCEPTION
 	};
 
-	static void useFlags(std::ostream& o, Flags& flags);
-	static void clearFlags(std::ostream& o, Flags& flags);
+	// Sets up o to write a value of a type without its own put() overload.
+	// The width isn't set; put() pads the result itself.
+	static void useFlags(std::ostream& o, const Flags& flags);
 
-	bool processFormatSpecifier(String& str, size_t& offset, size_t& argnum, Format::Flags& flags);
-	size_t process(String& f, size_t minArg, size_t maxArg, Flags& flags, FormatErrorHandling errortype = E_FORMAT_ERROR_IN_OUTPUT);
+	/**
+	 * Copy the text of fmt up to the next format specifier to the output
+	 * and parse the specifier into flags.  fmt is advanced past it, or to
+	 * the end of the pattern if there are no more specifiers or there's an
+	 * error.
+	 * @return The argument number of the specifier, or a value outside
+	 *   [minArg, maxArg] if there's no argument to output.
+	 */
+	size_t process(const char*& fmt, size_t minArg, size_t maxArg, Flags& flags, FormatErrorHandling errortype = E_FORMAT_ERROR_IN_OUTPUT);
 	template<typename T> void put(const T& t, Flags& flags);
 	// These are to help prevent template bloat
 	void put (const String& t, Flags& flags);
 	void put (const char* t, Flags& flags);
 	void put (char t, Flags& flags);
 	void put (unsigned char t, Flags& flags);
+	void put (bool t, Flags& flags);
 	void put (short t, Flags& flags);
 	void put (unsigned short t, Flags& flags);
 	void put (int t, Flags& flags);
@@ -190,6 +200,10 @@ protected:
 	void put (float t, Flags& flags);
 	void put (double t, Flags& flags);
 	void put (long double t, Flags& flags);
+
+	// Append str, padded with fill to flags.width.
+	void putPadded(const char* str, size_t len, const Flags& flags, char fill);
+	void putInteger(unsigned long long magnitude, bool negative, bool isSigned, const Flags& flags, char fill);
 #if defined(BLOCXX_USE_CXX_0X)
 	// This will be turned into something similar to an array of multiple types
 	// and doing a chain of if statements (with optimizations turned on a low
@@ -235,51 +249,21 @@ protected:
 
 template<typename T>
 void Format::put(const T& t, Flags& flags)
-{ // t is inserted into oss
-	if (!oss.good())
-		return;
-
-	if( flags.width != 0 )
-	{
-		// Convert to a string using all of the flags except the width
-		// (which behaves poorly for structures).
-		OStringStream tss;
-		Flags modFlags = flags;
-		modFlags.width = 0;
-		useFlags(tss, modFlags);
-		tss << t;
-
-		String s2 = tss.toString();
-		if( s2.length() < flags.width )
-		{
-			size_t left = flags.width - s2.length();
-			size_t right = 0;
-
-			if( flags.flags & std::ios::left )
-			{
-				std::swap(left, right);
-			}
-			oss << std::setw(left) << "" << s2 << std::setw(right) << "";
-		}
-		else
-		{
-			oss << s2;
-		}
-	}
-	else
-	{
-		useFlags(oss, flags);
-		oss << t;
-		clearFlags(oss, flags);
-	}
+{
+	// Convert to a string using all of the flags except the width (which
+	// behaves poorly for structures), then pad that.
+	OStringStream tss;
+	useFlags(tss, flags);
+	tss << t;
+	putPadded(tss.c_str(), tss.length(), flags, ' ');
 }
 
 #if defined(BLOCXX_USE_CXX_0X)
 template <typename... Args>
 Format::Format(const char* ca, const Args&... args)
 {
-	String fmt(ca);
-	while(!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		putArgs(process(fmt, 1, sizeof...(args), flags), flags, args...);
@@ -289,10 +273,10 @@ Format::Format(const char* ca, const Args&... args)
 #else
 
 template<typename A>
-Format::Format(const char* ca, const A& a) : oss()
+Format::Format(const char* ca, const A& a)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 1, flags))
@@ -302,10 +286,10 @@ Format::Format(const char* ca, const A& a) : oss()
 	}
 }
 template<typename A, typename B>
-Format::Format(const char* ca, const A& a, const B& b) : oss()
+Format::Format(const char* ca, const A& a, const B& b)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 2, flags))
@@ -316,10 +300,10 @@ Format::Format(const char* ca, const A& a, const B& b) : oss()
 	}
 }
 template<typename A, typename B, typename C>
-Format::Format(const char* ca, const A& a, const B& b, const C& c) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 3, flags))
@@ -331,10 +315,10 @@ Format::Format(const char* ca, const A& a, const B& b, const C& c) : oss()
 	}
 }
 template<typename A, typename B, typename C, typename D>
-Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 4, flags))
@@ -347,10 +331,10 @@ Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d) :
 	}
 }
 template<typename A, typename B, typename C, typename D, typename E>
-Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 5, flags))
@@ -364,10 +348,10 @@ Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, c
 	}
 }
 template<typename A, typename B, typename C, typename D, typename E, typename F>
-Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 6, flags))
@@ -382,10 +366,10 @@ Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, c
 	}
 }
 template<typename A, typename B, typename C, typename D, typename E, typename F, typename G>
-Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f, const G& g) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f, const G& g)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 7, flags))
@@ -401,10 +385,10 @@ Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, c
 	}
 }
 template<typename A, typename B, typename C, typename D, typename E, typename F, typename G, typename H>
-Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f, const G& g, const H& h) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f, const G& g, const H& h)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 8, flags))
@@ -421,10 +405,10 @@ Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, c
 	}
 }
 template<typename A, typename B, typename C, typename D, typename E, typename F, typename G, typename H, typename I>
-Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f, const G& g, const H& h, const I& i) : oss()
+Format::Format(const char* ca, const A& a, const B& b, const C& c, const D& d, const E& e, const F& f, const G& g, const H& h, const I& i)
 {
-	String fmt(ca);
-	while (!fmt.empty())
+	const char* fmt = ca;
+	while (fmt && *fmt)
 	{
 		Flags flags;
 		switch (process(fmt, 1, 9, flags))
@@ -0,0 +1,192 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/HazardPointer.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace BLOCXX_NAMESPACE
+{
+
+struct HazardPointerDomain::Record
+{
+	Record()
+		: active(1)
+		, next(0)
+	{
+	}
+
+	Atomic<int> active;
+	Atomic<const void*> hazard;
+	Record* next;
+	// only touched by the thread which has this record active.
+	std::vector<std::pair<void*, DeleterFunc> > retired;
+};
+
+namespace
+{
+	// A record scans its retired list once it's this much longer than the
+	// number of hazard pointers, so each scan frees at least half of it.
+	const size_t MIN_SCAN_THRESHOLD = 16;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+HazardPointerDomain::HazardPointerDomain()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+HazardPointerDomain::~HazardPointerDomain()
+{
+	Record* record = m_records.load(E_MEMORY_ORDER_ACQUIRE);
+	while (record)
+	{
+		for (size_t i = 0; i < record->retired.size(); ++i)
+		{
+			record->retired[i].second(record->retired[i].first);
+		}
+		Record* next = record->next;
+		delete record;
+		record = next;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+HazardPointerDomain::Record*
+HazardPointerDomain::acquireRecord()
+{
+	// reuse an inactive record if there is one
+	for (Record* record = m_records.load(E_MEMORY_ORDER_ACQUIRE); record; record = record->next)
+	{
+		int inactive = 0;
+		if (record->active.load(E_MEMORY_ORDER_RELAXED) == 0 &&
+			record->active.compareExchangeStrong(inactive, 1, E_MEMORY_ORDER_ACQUIRE, E_MEMORY_ORDER_RELAXED))
+		{
+			return record;
+		}
+	}
+
+	// Records are never removed, so pushing a new one has no ABA problem.
+	Record* record = new Record;
+	Record* head = m_records.load(E_MEMORY_ORDER_RELAXED);
+	do
+	{
+		record->next = head;
+	} while (!m_records.compareExchangeWeak(head, record, E_MEMORY_ORDER_RELEASE, E_MEMORY_ORDER_RELAXED));
+	m_recordCount.fetchAdd(1, E_MEMORY_ORDER_RELAXED);
+	return record;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+HazardPointerDomain::releaseRecord(Record* record)
+{
+	// The retired list stays with the record, for whoever uses it next.
+	record->hazard.store(0, E_MEMORY_ORDER_RELEASE);
+	record->active.store(0, E_MEMORY_ORDER_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+HazardPointerDomain::scan(Record* record)
+{
+	std::vector<const void*> hazards;
+	hazards.reserve(m_recordCount.load(E_MEMORY_ORDER_RELAXED));
+	for (Record* r = m_records.load(E_MEMORY_ORDER_ACQUIRE); r; r = r->next)
+	{
+		const void* p = r->hazard.load(E_MEMORY_ORDER_SEQ_CST);
+		if (p)
+		{
+			hazards.push_back(p);
+		}
+	}
+	std::sort(hazards.begin(), hazards.end());
+
+	std::vector<std::pair<void*, DeleterFunc> > stillHazardous;
+	for (size_t i = 0; i < record->retired.size(); ++i)
+	{
+		if (std::binary_search(hazards.begin(), hazards.end(), record->retired[i].first))
+		{
+			stillHazardous.push_back(record->retired[i]);
+		}
+		else
+		{
+			record->retired[i].second(record->retired[i].first);
+		}
+	}
+	record->retired.swap(stillHazardous);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+HazardPointerDomain::Guard::Guard(HazardPointerDomain& domain)
+	: m_domain(domain)
+	, m_record(domain.acquireRecord())
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+HazardPointerDomain::Guard::~Guard()
+{
+	m_domain.releaseRecord(m_record);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+HazardPointerDomain::Guard::set(const void* p)
+{
+	m_record->hazard.store(p, E_MEMORY_ORDER_SEQ_CST);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+HazardPointerDomain::Guard::clear()
+{
+	m_record->hazard.store(0, E_MEMORY_ORDER_RELEASE);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+void
+HazardPointerDomain::Guard::retire(void* p, DeleterFunc deleter)
+{
+	m_record->retired.push_back(std::make_pair(p, deleter));
+	size_t threshold = 2 * m_domain.m_recordCount.load(E_MEMORY_ORDER_RELAXED) + MIN_SCAN_THRESHOLD;
+	if (m_record->retired.size() >= threshold)
+	{
+		m_domain.scan(m_record);
+	}
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
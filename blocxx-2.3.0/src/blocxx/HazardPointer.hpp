@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_HAZARD_POINTER_HPP_INCLUDE_GUARD_
+#define BLOCXX_HAZARD_POINTER_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Atomic.hpp"
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * Safe memory reclamation for lock-free data structures, using hazard
+ * pointers (Maged Michael, "Hazard Pointers: Safe Memory Reclamation for
+ * Lock-Free Objects", 2004).
+ *
+ * A thread that is about to dereference a node another thread might unlink
+ * and free first publishes the pointer in a hazard slot (Guard::protect()).
+ * A thread that unlinks a node retires it (Guard::retire()) instead of
+ * deleting it, and retired nodes are only deleted once no slot refers to
+ * them.  This also prevents the ABA problem, since a node's address can't be
+ * reused while anyone might still compare against it.
+ *
+ * Each data structure has its own domain.  Slots are claimed by a Guard for
+ * the duration of one operation and are reused, so the number of slots is the
+ * largest number of simultaneous operations seen.  The domain's destructor
+ * deletes everything still retired; no Guard may be alive at that point.
+ */
+class BLOCXX_COMMON_API HazardPointerDomain
+{
+public:
+	typedef void (*DeleterFunc)(void*);
+
+	HazardPointerDomain();
+	~HazardPointerDomain();
+
+	struct Record;
+
+	/**
+	 * Owns one hazard pointer slot of a domain.  Not thread safe; create one
+	 * on the stack for each operation.
+	 */
+	class BLOCXX_COMMON_API Guard
+	{
+	public:
+		explicit Guard(HazardPointerDomain& domain);
+		~Guard();
+
+		/**
+		 * Load src and protect the pointer read, so it won't be deleted until
+		 * clear() is called or the Guard is destroyed, even if it's retired.
+		 * @return The protected pointer, which was the value of src after it
+		 * was protected.
+		 */
+		template <typename T>
+		T* protect(const Atomic<T*>& src)
+		{
+			T* p = src.load(E_MEMORY_ORDER_ACQUIRE);
+			for (;;)
+			{
+				set(p);
+				// the pointer may have been retired before the hazard was
+				// visible, so it's only safe if src still holds it.
+				T* current = src.load(E_MEMORY_ORDER_SEQ_CST);
+				if (current == p)
+				{
+					return p;
+				}
+				p = current;
+			}
+		}
+
+		/**
+		 * Stop protecting the current pointer.
+		 */
+		void clear();
+
+		/**
+		 * Hand over p, which must already be unreachable from the data
+		 * structure, to be passed to deleter once no hazard pointer refers
+		 * to it.  That may be immediately, or on a later call to retire(),
+		 * or when the domain is destroyed.
+		 */
+		void retire(void* p, DeleterFunc deleter);
+
+	private:
+		void set(const void* p);
+
+		HazardPointerDomain& m_domain;
+		Record* m_record;
+
+		// noncopyable
+		Guard(const Guard&);
+		Guard& operator=(const Guard&);
+	};
+
+private:
+	friend class Guard;
+
+	Record* acquireRecord();
+	void releaseRecord(Record* record);
+	void scan(Record* record);
+
+	Atomic<Record*> m_records;
+	Atomic<int> m_recordCount;
+
+	// noncopyable
+	HazardPointerDomain(const HazardPointerDomain&);
+	HazardPointerDomain& operator=(const HazardPointerDomain&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
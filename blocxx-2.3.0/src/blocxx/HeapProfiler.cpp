@@ -0,0 +1,848 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/HeapProfiler.hpp"
+#include "blocxx/StackTrace.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/IOException.hpp"
+#include "blocxx/Format.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <ctime>
+#include <new>
+
+extern "C"
+{
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+}
+
+#if defined(__GNUC__)
+#define BLOCXX_HEAP_PROFILER_NOINLINE __attribute__((noinline))
+#else
+#define BLOCXX_HEAP_PROFILER_NOINLINE
+#endif
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace
+{
+	// Everything here is reachable from operator new, so it uses malloc()
+	// directly and mustn't allocate with new.
+
+	const size_t NUM_BUCKETS = 256;
+	const size_t BUCKET_PROBES = 8;
+	const size_t NUM_STRIPES = 4096;
+
+	// The samples for one call stack.  Only the owning thread writes the
+	// frames, and it publishes them before any other thread can see the
+	// bucket.  The counters are updated atomically because a sampled
+	// allocation may be freed by any thread.
+	struct Bucket
+	{
+		int published;
+		UInt32 hash;
+		size_t depth;
+		void* frames[HeapProfiler::MAX_FRAMES];
+		UInt64 allocCount;
+		UInt64 allocBytes;
+		UInt64 freeCount;
+		UInt64 freeBytes;
+	};
+
+	// States are never freed.  When a thread exits its state is released,
+	// and the next thread that needs one takes it over, so the number of
+	// states is bounded by the number of threads alive at once.
+	struct ThreadState
+	{
+		ThreadState* next;
+		int owned;
+		bool busy;
+		// Written by start() as well as the owner, so accessed atomically.
+		long bytesUntilSample;
+		// The value of g_generation bytesUntilSample was drawn for.
+		UInt32 generation;
+		UInt64 rng;
+		Bucket buckets[NUM_BUCKETS];
+		// Used once all the probed buckets are taken by other stacks.
+		Bucket overflow;
+	};
+
+	// Where a sampled allocation is, so freeing it can be charged to the
+	// stack that allocated it.
+	struct Sample
+	{
+		void* ptr;
+		size_t size;
+		Bucket* bucket;
+		Sample* next;
+	};
+
+	struct Stripe
+	{
+		int lock;
+		Sample* head;
+	};
+
+	int g_running = 0;
+	size_t g_sampleInterval = 0;
+	// Incremented by start(), so gaps drawn for an earlier sampling interval
+	// are discarded.
+	UInt32 g_generation = 0;
+	ThreadState* g_threads = 0;
+	size_t g_liveSamples = 0;
+	Stripe g_stripes[NUM_STRIPES];
+	// A bit per stripe, set while it has samples.  Every free checks it, and
+	// it's small enough to stay in cache where the stripes wouldn't.
+	UInt32 g_stripeOccupied[NUM_STRIPES / 32];
+	pthread_key_t g_stateKey;
+	pthread_once_t g_stateKeyOnce = PTHREAD_ONCE_INIT;
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+	__thread ThreadState* t_state = 0;
+#endif
+
+	char g_dumpPrefix[1024];
+	UInt32 g_dumpCount = 0;
+
+	void releaseThreadState(void* p)
+	{
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+		t_state = 0;
+#endif
+		ThreadState* st = static_cast<ThreadState*>(p);
+		AtomicImpl::store(st->owned, 0, E_MEMORY_ORDER_RELEASE);
+	}
+
+	void createStateKey()
+	{
+		pthread_key_create(&g_stateKey, releaseThreadState);
+	}
+
+	inline ThreadState* currentState()
+	{
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+		return t_state;
+#else
+		return static_cast<ThreadState*>(pthread_getspecific(g_stateKey));
+#endif
+	}
+
+	// The number of bytes to allocate before the next sample, drawn from an
+	// exponential distribution with the sampling interval as its mean.
+	long nextSampleGap(ThreadState* st)
+	{
+		size_t interval = AtomicImpl::load(g_sampleInterval, E_MEMORY_ORDER_RELAXED);
+		if (interval <= 1)
+		{
+			return 0;
+		}
+		// xorshift64
+		UInt64 x = st->rng;
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		st->rng = x;
+		// uniform in (0, 1]
+		double u = (double(x >> 11) + 1.0) / 9007199254740992.0;
+		double gap = -std::log(u) * double(interval);
+		double const maxGap = double(1L << 30) * 16;
+		return gap < maxGap ? long(gap) + 1 : long(maxGap);
+	}
+
+	ThreadState* acquireState()
+	{
+		ThreadState* st = AtomicImpl::load(g_threads, E_MEMORY_ORDER_ACQUIRE);
+		for (; st != 0; st = st->next)
+		{
+			int expected = 0;
+			if (AtomicImpl::load(st->owned, E_MEMORY_ORDER_RELAXED) == 0 &&
+				AtomicImpl::compareExchange(st->owned, expected, 1, false,
+					E_MEMORY_ORDER_ACQUIRE, E_MEMORY_ORDER_RELAXED))
+			{
+				break;
+			}
+		}
+		if (st == 0)
+		{
+			st = static_cast<ThreadState*>(::calloc(1, sizeof(ThreadState)));
+			if (st == 0)
+			{
+				return 0;
+			}
+			st->owned = 1;
+			st->rng = (UInt64(reinterpret_cast<size_t>(st)) << 16) ^ UInt64(::time(0)) ^ 0x9e3779b9u;
+			ThreadState* head = AtomicImpl::load(g_threads, E_MEMORY_ORDER_RELAXED);
+			do
+			{
+				st->next = head;
+			} while (!AtomicImpl::compareExchange(g_threads, head, st, true,
+				E_MEMORY_ORDER_RELEASE, E_MEMORY_ORDER_RELAXED));
+		}
+		pthread_setspecific(g_stateKey, st);
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+		t_state = st;
+#endif
+		return st;
+	}
+
+	UInt32 hashFrames(void* const* frames, size_t depth)
+	{
+		UInt32 h = 2166136261u;
+		for (size_t i = 0; i < depth; ++i)
+		{
+			size_t v = reinterpret_cast<size_t>(frames[i]);
+			h = (h ^ UInt32(v)) * 16777619u;
+			h = (h ^ UInt32(v >> 16 >> 16)) * 16777619u;
+		}
+		return h;
+	}
+
+	Bucket* findBucket(ThreadState* st, void* const* frames, size_t depth)
+	{
+		UInt32 h = hashFrames(frames, depth);
+		for (size_t i = 0; i < BUCKET_PROBES; ++i)
+		{
+			Bucket& b = st->buckets[(h + i) % NUM_BUCKETS];
+			if (!b.published)
+			{
+				b.hash = h;
+				b.depth = depth;
+				std::memcpy(b.frames, frames, depth * sizeof(void*));
+				AtomicImpl::store(b.published, 1, E_MEMORY_ORDER_RELEASE);
+				return &b;
+			}
+			if (b.hash == h && b.depth == depth &&
+				std::memcmp(b.frames, frames, depth * sizeof(void*)) == 0)
+			{
+				return &b;
+			}
+		}
+		if (!st->overflow.published)
+		{
+			AtomicImpl::store(st->overflow.published, 1, E_MEMORY_ORDER_RELEASE);
+		}
+		return &st->overflow;
+	}
+
+	inline size_t stripeIndex(void* p)
+	{
+		size_t v = reinterpret_cast<size_t>(p) >> 4;
+		return (v ^ (v >> 12)) % NUM_STRIPES;
+	}
+
+	void lockStripe(Stripe& s)
+	{
+		int expected = 0;
+		while (!AtomicImpl::compareExchange(s.lock, expected, 1, true,
+			E_MEMORY_ORDER_ACQUIRE, E_MEMORY_ORDER_RELAXED))
+		{
+			expected = 0;
+			::sched_yield();
+		}
+	}
+
+	void unlockStripe(Stripe& s)
+	{
+		AtomicImpl::store(s.lock, 0, E_MEMORY_ORDER_RELEASE);
+	}
+
+	// Kept out of line so allocate() stays small, and so the frames to skip
+	// are known.
+	BLOCXX_HEAP_PROFILER_NOINLINE void recordAllocation(ThreadState* st, void* p, size_t size)
+	{
+		if (st == 0)
+		{
+			st = acquireState();
+			if (st == 0)
+			{
+				return;
+			}
+		}
+		if (st->busy)
+		{
+			return;
+		}
+		UInt32 generation = AtomicImpl::load(g_generation, E_MEMORY_ORDER_ACQUIRE);
+		if (st->generation != generation)
+		{
+			// The first allocation by this thread since start(), which isn't
+			// sampled unless it's bigger than the first gap.
+			st->generation = generation;
+			long gap = nextSampleGap(st) - long(size);
+			AtomicImpl::store(st->bytesUntilSample, gap, E_MEMORY_ORDER_RELAXED);
+			if (gap > 0)
+			{
+				return;
+			}
+		}
+		st->busy = true;
+		AtomicImpl::store(st->bytesUntilSample, nextSampleGap(st), E_MEMORY_ORDER_RELAXED);
+
+		void* frames[HeapProfiler::MAX_FRAMES];
+		// Skip this function and allocate().
+		size_t depth = StackTrace::capture(frames, HeapProfiler::MAX_FRAMES, 2);
+		Bucket* b = findBucket(st, frames, depth);
+
+		Sample* s = static_cast<Sample*>(::malloc(sizeof(Sample)));
+		if (s != 0)
+		{
+			s->ptr = p;
+			s->size = size;
+			s->bucket = b;
+			size_t i = stripeIndex(p);
+			Stripe& stripe = g_stripes[i];
+			lockStripe(stripe);
+			s->next = stripe.head;
+			if (stripe.head == 0)
+			{
+				AtomicImpl::fetchOr(g_stripeOccupied[i / 32], UInt32(1) << (i % 32),
+					E_MEMORY_ORDER_RELAXED);
+			}
+			stripe.head = s;
+			unlockStripe(stripe);
+			AtomicImpl::fetchAdd(g_liveSamples, size_t(1), E_MEMORY_ORDER_RELAXED);
+		}
+		AtomicImpl::fetchAdd(b->allocCount, UInt64(1), E_MEMORY_ORDER_RELAXED);
+		AtomicImpl::fetchAdd(b->allocBytes, UInt64(size), E_MEMORY_ORDER_RELAXED);
+		st->busy = false;
+	}
+
+	void recordDeallocation(void* p)
+	{
+		size_t i = stripeIndex(p);
+		UInt32 bit = UInt32(1) << (i % 32);
+		if ((AtomicImpl::load(g_stripeOccupied[i / 32], E_MEMORY_ORDER_RELAXED) & bit) == 0)
+		{
+			return;
+		}
+		Stripe& stripe = g_stripes[i];
+		Sample* found = 0;
+		lockStripe(stripe);
+		for (Sample** link = &stripe.head; *link != 0; link = &(*link)->next)
+		{
+			if ((*link)->ptr == p)
+			{
+				found = *link;
+				*link = found->next;
+				break;
+			}
+		}
+		if (found != 0 && stripe.head == 0)
+		{
+			AtomicImpl::fetchAnd(g_stripeOccupied[i / 32], ~bit, E_MEMORY_ORDER_RELAXED);
+		}
+		unlockStripe(stripe);
+		if (found != 0)
+		{
+			AtomicImpl::fetchAdd(found->bucket->freeCount, UInt64(1), E_MEMORY_ORDER_RELAXED);
+			AtomicImpl::fetchAdd(found->bucket->freeBytes, UInt64(found->size), E_MEMORY_ORDER_RELAXED);
+			AtomicImpl::fetchSub(g_liveSamples, size_t(1), E_MEMORY_ORDER_RELAXED);
+			::free(found);
+		}
+	}
+
+	// Calls f for every bucket with samples.  Safe to use while other
+	// threads are recording.
+	template <typename F>
+	void forEachBucket(F& f)
+	{
+		ThreadState* st = AtomicImpl::load(g_threads, E_MEMORY_ORDER_ACQUIRE);
+		for (; st != 0; st = st->next)
+		{
+			for (size_t i = 0; i <= NUM_BUCKETS; ++i)
+			{
+				Bucket& b = i < NUM_BUCKETS ? st->buckets[i] : st->overflow;
+				if (AtomicImpl::load(b.published, E_MEMORY_ORDER_ACQUIRE))
+				{
+					f(b, i < NUM_BUCKETS ? b.depth : 0);
+				}
+			}
+		}
+	}
+
+	struct BucketCounts
+	{
+		UInt64 allocCount;
+		UInt64 allocBytes;
+		UInt64 freeCount;
+		UInt64 freeBytes;
+
+		void read(const Bucket& b)
+		{
+			allocCount = AtomicImpl::load(b.allocCount, E_MEMORY_ORDER_RELAXED);
+			allocBytes = AtomicImpl::load(b.allocBytes, E_MEMORY_ORDER_RELAXED);
+			freeCount = AtomicImpl::load(b.freeCount, E_MEMORY_ORDER_RELAXED);
+			freeBytes = AtomicImpl::load(b.freeBytes, E_MEMORY_ORDER_RELAXED);
+			// A free can be counted before the allocation it matches.
+			if (freeCount > allocCount)
+			{
+				freeCount = allocCount;
+			}
+			if (freeBytes > allocBytes)
+			{
+				freeBytes = allocBytes;
+			}
+		}
+	};
+
+	struct ProfileCollector
+	{
+		HeapProfiler::Profile profile;
+
+		void operator()(const Bucket& b, size_t depth)
+		{
+			BucketCounts c;
+			c.read(b);
+			if (c.allocCount == 0)
+			{
+				return;
+			}
+			HeapProfiler::StackProfile sp;
+			sp.frames = Array<void*>(b.frames, b.frames + depth);
+			sp.allocCount = c.allocCount;
+			sp.allocBytes = c.allocBytes;
+			sp.freeCount = c.freeCount;
+			sp.freeBytes = c.freeBytes;
+			profile.push_back(sp);
+		}
+	};
+
+	// Buffers output to a file descriptor using only async-signal-safe calls.
+	class RawWriter
+	{
+	public:
+		RawWriter(int fd)
+			: m_fd(fd)
+			, m_len(0)
+			, m_failed(false)
+		{
+		}
+
+		void write(const char* s, size_t n)
+		{
+			while (n > 0)
+			{
+				if (m_len == sizeof(m_buf))
+				{
+					flush();
+				}
+				size_t chunk = sizeof(m_buf) - m_len;
+				if (chunk > n)
+				{
+					chunk = n;
+				}
+				std::memcpy(m_buf + m_len, s, chunk);
+				m_len += chunk;
+				s += chunk;
+				n -= chunk;
+			}
+		}
+		void write(const char* s)
+		{
+			write(s, std::strlen(s));
+		}
+		void writeNumber(UInt64 v, unsigned base = 10)
+		{
+			char digits[24];
+			char* p = digits + sizeof(digits);
+			do
+			{
+				*--p = "0123456789abcdef"[v % base];
+				v /= base;
+			} while (v != 0);
+			write(p, digits + sizeof(digits) - p);
+		}
+		void writeCounts(UInt64 inUseCount, UInt64 inUseBytes,
+			UInt64 allocCount, UInt64 allocBytes)
+		{
+			writeNumber(inUseCount);
+			write(": ");
+			writeNumber(inUseBytes);
+			write(" [");
+			writeNumber(allocCount);
+			write(": ");
+			writeNumber(allocBytes);
+			write("]");
+		}
+		// Returns false if any write failed.
+		bool flush()
+		{
+			size_t done = 0;
+			while (done < m_len && !m_failed)
+			{
+				ssize_t rv = ::write(m_fd, m_buf + done, m_len - done);
+				if (rv < 0)
+				{
+					if (errno != EINTR)
+					{
+						m_failed = true;
+					}
+				}
+				else
+				{
+					done += rv;
+				}
+			}
+			m_len = 0;
+			return !m_failed;
+		}
+
+	private:
+		int m_fd;
+		size_t m_len;
+		bool m_failed;
+		char m_buf[4096];
+	};
+
+	struct TotalCounter
+	{
+		BucketCounts total;
+
+		TotalCounter()
+		{
+			std::memset(&total, 0, sizeof(total));
+		}
+		void operator()(const Bucket& b, size_t)
+		{
+			BucketCounts c;
+			c.read(b);
+			total.allocCount += c.allocCount;
+			total.allocBytes += c.allocBytes;
+			total.freeCount += c.freeCount;
+			total.freeBytes += c.freeBytes;
+		}
+	};
+
+	struct BucketWriter
+	{
+		RawWriter& out;
+
+		BucketWriter(RawWriter& out_)
+			: out(out_)
+		{
+		}
+		void operator()(const Bucket& b, size_t depth)
+		{
+			BucketCounts c;
+			c.read(b);
+			if (c.allocCount == 0)
+			{
+				return;
+			}
+			out.writeCounts(c.allocCount - c.freeCount, c.allocBytes - c.freeBytes,
+				c.allocCount, c.allocBytes);
+			out.write(" @");
+			for (size_t i = 0; i < depth; ++i)
+			{
+				out.write(" 0x");
+				out.writeNumber(UInt64(reinterpret_cast<size_t>(b.frames[i])), 16);
+			}
+			out.write("\n");
+		}
+	};
+
+	void copyMemoryMap(RawWriter& out)
+	{
+		int fd = ::open("/proc/self/maps", O_RDONLY);
+		if (fd < 0)
+		{
+			return;
+		}
+		char buf[1024];
+		for (;;)
+		{
+			ssize_t n = ::read(fd, buf, sizeof(buf));
+			if (n < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (n <= 0)
+			{
+				break;
+			}
+			out.write(buf, size_t(n));
+		}
+		::close(fd);
+	}
+
+	void dumpOnSignal(int)
+	{
+		int savedErrno = errno;
+		char path[sizeof(g_dumpPrefix) + 64];
+		size_t len = std::strlen(g_dumpPrefix);
+		std::memcpy(path, g_dumpPrefix, len);
+
+		char digits[24];
+		UInt64 parts[2];
+		parts[0] = UInt64(::getpid());
+		parts[1] = AtomicImpl::fetchAdd(g_dumpCount, UInt32(1), E_MEMORY_ORDER_RELAXED) + 1;
+		for (size_t i = 0; i < 2; ++i)
+		{
+			char* p = digits + sizeof(digits);
+			UInt64 v = parts[i];
+			do
+			{
+				*--p = char('0' + v % 10);
+				v /= 10;
+			} while (v != 0);
+			path[len++] = '.';
+			size_t n = digits + sizeof(digits) - p;
+			std::memcpy(path + len, p, n);
+			len += n;
+		}
+		std::memcpy(path + len, ".heap", sizeof(".heap"));
+
+		int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd >= 0)
+		{
+			HeapProfiler::writeProfile(fd);
+			::close(fd);
+		}
+		errno = savedErrno;
+	}
+} // end unnamed namespace
+
+//////////////////////////////////////////////////////////////////////////////
+void HeapProfiler::start(size_t sampleInterval)
+{
+	pthread_once(&g_stateKeyOnce, createStateKey);
+	// The first backtrace() may load libgcc, so get that over with here
+	// instead of inside an allocation.
+	void* frames[1];
+	StackTrace::capture(frames, 1);
+	AtomicImpl::store(g_sampleInterval, sampleInterval, E_MEMORY_ORDER_RELAXED);
+	AtomicImpl::fetchAdd(g_generation, UInt32(1), E_MEMORY_ORDER_RELEASE);
+	// Send every thread's next allocation to the slow path, which draws a
+	// new gap for the new interval.
+	ThreadState* st = AtomicImpl::load(g_threads, E_MEMORY_ORDER_ACQUIRE);
+	for (; st != 0; st = st->next)
+	{
+		AtomicImpl::store(st->bytesUntilSample, 0L, E_MEMORY_ORDER_RELAXED);
+	}
+	AtomicImpl::store(g_running, 1, E_MEMORY_ORDER_RELEASE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void HeapProfiler::stop()
+{
+	AtomicImpl::store(g_running, 0, E_MEMORY_ORDER_RELEASE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool HeapProfiler::isRunning()
+{
+	return AtomicImpl::load(g_running, E_MEMORY_ORDER_ACQUIRE) != 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t HeapProfiler::getSampleInterval()
+{
+	return AtomicImpl::load(g_sampleInterval, E_MEMORY_ORDER_RELAXED);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void* HeapProfiler::allocate(size_t size)
+{
+	void* p = ::malloc(size ? size : 1);
+	if (p != 0 && AtomicImpl::load(g_running, E_MEMORY_ORDER_RELAXED))
+	{
+		ThreadState* st = currentState();
+		if (st == 0)
+		{
+			recordAllocation(st, p, size);
+		}
+		else
+		{
+			long left = AtomicImpl::load(st->bytesUntilSample, E_MEMORY_ORDER_RELAXED) - long(size);
+			AtomicImpl::store(st->bytesUntilSample, left, E_MEMORY_ORDER_RELAXED);
+			if (left <= 0)
+			{
+				recordAllocation(st, p, size);
+			}
+		}
+	}
+	return p;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void HeapProfiler::deallocate(void* p)
+{
+	if (p != 0 && AtomicImpl::load(g_liveSamples, E_MEMORY_ORDER_RELAXED) != 0)
+	{
+		recordDeallocation(p);
+	}
+	::free(p);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+HeapProfiler::Profile HeapProfiler::getProfile()
+{
+	ProfileCollector collector;
+	forEachBucket(collector);
+	return collector.profile;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+int HeapProfiler::writeProfile(int fd)
+{
+	TotalCounter counter;
+	forEachBucket(counter);
+	const BucketCounts& t = counter.total;
+
+	RawWriter out(fd);
+	out.write("heap profile: ");
+	out.writeCounts(t.allocCount - t.freeCount, t.allocBytes - t.freeBytes,
+		t.allocCount, t.allocBytes);
+	out.write(" @ heap_v2/");
+	out.writeNumber(getSampleInterval());
+	out.write("\n");
+
+	BucketWriter writer(out);
+	forEachBucket(writer);
+
+	out.write("\nMAPPED_LIBRARIES:\n");
+	copyMemoryMap(out);
+	return out.flush() ? 0 : -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void HeapProfiler::writeProfile(const String& path)
+{
+	int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		BLOCXX_THROW_ERRNO_MSG(IOException,
+			Format("HeapProfiler::writeProfile: can't open %1", path).c_str());
+	}
+	int rv = writeProfile(fd);
+	int lastErrno = errno;
+	::close(fd);
+	if (rv != 0)
+	{
+		BLOCXX_THROW_ERRNO_MSG1(IOException,
+			Format("HeapProfiler::writeProfile: can't write %1", path).c_str(), lastErrno);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void HeapProfiler::installDumpSignalHandler(int sig, const String& pathPrefix)
+{
+	if (pathPrefix.length() >= sizeof(g_dumpPrefix))
+	{
+		BLOCXX_THROW(IOException,
+			Format("HeapProfiler::installDumpSignalHandler: path prefix is too long: %1",
+				pathPrefix).c_str());
+	}
+	std::memcpy(g_dumpPrefix, pathPrefix.c_str(), pathPrefix.length() + 1);
+
+	struct sigaction sa;
+	std::memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = dumpOnSignal;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_RESTART;
+	if (::sigaction(sig, &sa, 0) != 0)
+	{
+		BLOCXX_THROW_ERRNO_MSG(IOException,
+			"HeapProfiler::installDumpSignalHandler: sigaction");
+	}
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
+#ifdef BLOCXX_HEAP_PROFILER
+
+//////////////////////////////////////////////////////////////////////////////
+static void* heapProfilerNew(std::size_t size)
+{
+	for (;;)
+	{
+		void* p = BLOCXX_NAMESPACE::HeapProfiler::allocate(size);
+		if (p != 0)
+		{
+			return p;
+		}
+		std::new_handler handler = std::set_new_handler(0);
+		std::set_new_handler(handler);
+		if (handler == 0)
+		{
+			throw std::bad_alloc();
+		}
+		handler();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void*
+operator new(std::size_t size) BLOCXX_THROW_BAD_ALLOC
+{
+	return heapProfilerNew(size);
+}
+//////////////////////////////////////////////////////////////////////////////
+void*
+operator new[](std::size_t size) BLOCXX_THROW_BAD_ALLOC
+{
+	return heapProfilerNew(size);
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+operator delete(void* p) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+operator delete[](void* p) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+operator delete(void* p, std::size_t) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+operator delete[](void* p, std::size_t) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+
+#endif	// BLOCXX_HEAP_PROFILER
@@ -0,0 +1,175 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_HEAP_PROFILER_HPP_INCLUDE_GUARD_
+#define BLOCXX_HEAP_PROFILER_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Types.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/String.hpp"
+#include <cstddef>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * A sampling heap profiler.  While it's running, about one allocation per
+ * sampling interval bytes has its call stack recorded, so the cost of
+ * profiling a long-running process stays low enough to leave on.  Samples
+ * are aggregated per call stack in tables that belong to the allocating
+ * thread, so recording a sample doesn't take a lock shared with other
+ * threads.  The profile can be dumped in the legacy pprof heap format on
+ * demand, either by calling writeProfile() or by sending a signal set up
+ * with installDumpSignalHandler().
+ *
+ * Allocations only reach the profiler through allocate() and deallocate().
+ * Configuring with --enable-heap-profiler makes the library's operator new
+ * and delete call them; otherwise a program can replace operator new and
+ * delete itself and forward to them.
+ *
+ * Unlike MemTracer, which records every allocation to find leaks and
+ * overruns, the profiler only tells where memory is allocated.
+ */
+namespace HeapProfiler
+{
+	/**
+	 * The sampling interval start() uses by default, in bytes.
+	 */
+	static const size_t DEFAULT_SAMPLE_INTERVAL = 512 * 1024;
+
+	/**
+	 * The most call stack frames recorded for a sample.
+	 */
+	static const size_t MAX_FRAMES = 24;
+
+	/**
+	 * Start sampling allocations, or change the sampling interval if the
+	 * profiler is already running.  Samples recorded before an earlier
+	 * stop() are kept.
+	 *
+	 * @param sampleInterval The mean number of bytes allocated between
+	 * samples.  The gaps between samples are drawn from an exponential
+	 * distribution, so allocations of any size can be sampled.  0 or 1
+	 * samples every allocation.
+	 */
+	BLOCXX_COMMON_API void start(size_t sampleInterval = DEFAULT_SAMPLE_INTERVAL);
+
+	/**
+	 * Stop sampling allocations.  Frees of sampled allocations are still
+	 * recorded, and the profile can still be retrieved.
+	 */
+	BLOCXX_COMMON_API void stop();
+
+	BLOCXX_COMMON_API bool isRunning();
+
+	/**
+	 * @return The sampling interval given to the last call to start(), or 0
+	 * if it has never been called.
+	 */
+	BLOCXX_COMMON_API size_t getSampleInterval();
+
+	/**
+	 * Allocate size bytes with malloc(), and sample the allocation if the
+	 * profiler is running.
+	 *
+	 * @return The allocated memory, or 0 if malloc() failed.
+	 */
+	BLOCXX_COMMON_API void* allocate(size_t size);
+
+	/**
+	 * Free memory returned by allocate(), and record the free if the
+	 * allocation was sampled.  p may be 0.
+	 */
+	BLOCXX_COMMON_API void deallocate(void* p);
+
+	/**
+	 * The samples recorded for one call stack.
+	 */
+	struct BLOCXX_COMMON_API StackProfile
+	{
+		/** Return addresses, innermost first. */
+		Array<void*> frames;
+		UInt64 allocCount;
+		UInt64 allocBytes;
+		UInt64 freeCount;
+		UInt64 freeBytes;
+
+		UInt64 inUseCount() const
+		{
+			return allocCount - freeCount;
+		}
+		UInt64 inUseBytes() const
+		{
+			return allocBytes - freeBytes;
+		}
+	};
+	typedef Array<StackProfile> Profile;
+
+	/**
+	 * @return The samples recorded so far, one entry per call stack.  The
+	 * counts are of samples, not of all allocations.  Multiplying them by
+	 * roughly sampleInterval / size estimates the true counts, which is what
+	 * pprof does when reading a dump.
+	 */
+	BLOCXX_COMMON_API Profile getProfile();
+
+	/**
+	 * Write the profile to fd in the legacy pprof heap format, followed by
+	 * the process's memory map so pprof can symbolize it.  This only makes
+	 * async-signal-safe calls, so it can be used from a signal handler.
+	 *
+	 * @return 0 on success, or -1 with errno set if a write failed.
+	 */
+	BLOCXX_COMMON_API int writeProfile(int fd);
+
+	/**
+	 * Write the profile to the file at path, replacing it if it exists.
+	 *
+	 * @throws IOException if the file can't be written.
+	 */
+	BLOCXX_COMMON_API void writeProfile(const String& path);
+
+	/**
+	 * Make signal sig write the profile to a new file named
+	 * <pathPrefix>.<pid>.<sequence>.heap, where sequence counts the dumps
+	 * from 1.
+	 *
+	 * @throws IOException if pathPrefix is too long or the handler can't be
+	 * installed.
+	 */
+	BLOCXX_COMMON_API void installDumpSignalHandler(int sig, const String& pathPrefix);
+
+} // end namespace HeapProfiler
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
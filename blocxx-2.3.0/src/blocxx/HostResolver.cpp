@@ -0,0 +1,442 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/HostResolver.hpp"
+#include "blocxx/MutexLock.hpp"
+#include "blocxx/ThreadPool.hpp"
+#include "blocxx/Runnable.hpp"
+#include "blocxx/LazyGlobal.hpp"
+#include "blocxx/FileSystem.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/ByteSwap.hpp"
+
+extern "C"
+{
+#if defined(BLOCXX_WIN32)
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#endif
+#include <string.h>
+}
+
+namespace BLOCXX_NAMESPACE
+{
+
+//////////////////////////////////////////////////////////////////////////////
+HostResolverCallback::~HostResolverCallback()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+HostResolverCallback::resolved(const String& hostName, const Array<SocketAddress>& addresses)
+{
+	doResolved(hostName, addresses);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+HostResolverCallback::failed(const String& hostName, const String& message)
+{
+	doFailed(hostName, message);
+}
+
+namespace
+{
+	DefaultConstructedLazyGlobal<HostResolver>::type g_defaultResolver = BLOCXX_LAZY_GLOBAL_DEFAULT_INIT;
+
+	String makeKey(const String& hostName)
+	{
+		String key(hostName);
+		key.toLowerCase();
+		return key;
+	}
+
+	// getaddrinfo() errors which say nothing about whether the name exists,
+	// so they shouldn't be remembered.
+	bool isTransientError(int gaiErr)
+	{
+		return gaiErr == EAI_AGAIN || gaiErr == EAI_MEMORY
+#ifdef EAI_SYSTEM
+			|| gaiErr == EAI_SYSTEM
+#endif
+			;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Does the lookup for resolveAsync().  The resolver must outlive it.
+class HostResolverWork : public Runnable
+{
+public:
+	HostResolverWork(HostResolver& resolver, const String& hostName, UInt16 port,
+		const HostResolverCallbackRef& callback)
+		: m_resolver(resolver)
+		, m_hostName(hostName)
+		, m_port(port)
+		, m_callback(callback)
+	{
+	}
+
+	virtual void run()
+	{
+		Array<SocketAddress> addresses;
+		String error;
+		if (m_resolver.resolveCached(m_hostName, m_port, addresses, error))
+		{
+			m_callback->resolved(m_hostName, addresses);
+		}
+		else
+		{
+			m_callback->failed(m_hostName, error);
+		}
+	}
+
+private:
+	HostResolver& m_resolver;
+	String m_hostName;
+	UInt16 m_port;
+	HostResolverCallbackRef m_callback;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+HostResolver::Config::Config()
+	: maxEntries(1024)
+	, positiveTTL(60)
+	, negativeTTL(10)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+HostResolver::HostResolver()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+HostResolver::HostResolver(const Config& config)
+	: m_config(config)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+HostResolver::~HostResolver()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// static
+HostResolver&
+HostResolver::getDefault()
+{
+	return g_defaultResolver;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+DateTime
+HostResolver::getCurrentTime() const
+{
+	return DateTime::getCurrent();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Array<SocketAddress>
+HostResolver::resolve(const String& hostName, UInt16 port)
+{
+	Array<SocketAddress> addresses;
+	String error;
+	if (!resolveCached(hostName, port, addresses, error))
+	{
+		BLOCXX_THROW(UnknownHostException, Format("Unknown host: %1: %2", hostName, error).c_str());
+	}
+	return addresses;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+HostResolver::resolveAsync(const String& hostName, UInt16 port,
+	const HostResolverCallbackRef& callback, const ThreadPoolRef& pool)
+{
+	Array<SocketAddress> addresses;
+	String error;
+	if (lookupCache(hostName, addresses, error))
+	{
+		if (addresses.empty())
+		{
+			callback->failed(hostName, error);
+		}
+		else
+		{
+			applyPort(addresses, port);
+			callback->resolved(hostName, addresses);
+		}
+		return;
+	}
+	if (!pool->addWork(RunnableRef(new HostResolverWork(*this, hostName, port, callback))))
+	{
+		BLOCXX_THROW(ThreadPoolException, "HostResolver::resolveAsync: thread pool is shutting down");
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+HostResolver::clearCache()
+{
+	MutexLock lock(m_guard);
+	m_cache.clear();
+	m_lru.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t
+HostResolver::cacheSize() const
+{
+	MutexLock lock(m_guard);
+	return m_cache.size();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+HostResolver::resolveCached(const String& hostName, UInt16 port, Array<SocketAddress>& addresses, String& error)
+{
+	if (!lookupCache(hostName, addresses, error))
+	{
+		// The lock isn't held during the lookup, so two threads may look up
+		// the same name at once.  Both get the same answer, so that's harmless.
+		bool cacheable = true;
+		addresses = lookup(hostName, error, cacheable);
+		if (cacheable)
+		{
+			storeCache(hostName, addresses, error);
+		}
+	}
+	if (addresses.empty())
+	{
+		return false;
+	}
+	applyPort(addresses, port);
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// static
+void
+HostResolver::applyPort(Array<SocketAddress>& addresses, UInt16 port)
+{
+	for (size_t i = 0; i < addresses.size(); ++i)
+	{
+		InetSocketAddress_t& sa = addresses[i].m_inetNativeAddress;
+#ifdef BLOCXX_HAVE_IPV6
+		if (reinterpret_cast<sockaddr*>(&sa)->sa_family == AF_INET6)
+		{
+			reinterpret_cast<sockaddr_in6*>(&sa)->sin6_port = hton16(port);
+			continue;
+		}
+#endif
+		reinterpret_cast<sockaddr_in*>(&sa)->sin_port = hton16(port);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+HostResolver::lookupCache(const String& hostName, Array<SocketAddress>& addresses, String& error)
+{
+	if (m_config.maxEntries == 0)
+	{
+		return false;
+	}
+	DateTime now = getCurrentTime();
+	MutexLock lock(m_guard);
+	cache_t::iterator it = m_cache.find(makeKey(hostName));
+	if (it == m_cache.end())
+	{
+		return false;
+	}
+	if (it->second.expires <= now)
+	{
+		m_lru.erase(it->second.lruPos);
+		m_cache.erase(it);
+		return false;
+	}
+	m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+	addresses = it->second.addresses;
+	error = it->second.error;
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+HostResolver::storeCache(const String& hostName, const Array<SocketAddress>& addresses, const String& error)
+{
+	if (m_config.maxEntries == 0)
+	{
+		return;
+	}
+	DateTime expires = getCurrentTime();
+	expires += addresses.empty() ? m_config.negativeTTL : m_config.positiveTTL;
+
+	String key(makeKey(hostName));
+	MutexLock lock(m_guard);
+	cache_t::iterator it = m_cache.find(key);
+	if (it == m_cache.end())
+	{
+		m_lru.push_front(key);
+		it = m_cache.insert(std::make_pair(key, Entry())).first;
+		it->second.lruPos = m_lru.begin();
+	}
+	else
+	{
+		m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+	}
+	it->second.addresses = addresses;
+	it->second.error = error;
+	it->second.expires = expires;
+
+	while (m_cache.size() > m_config.maxEntries)
+	{
+		m_cache.erase(m_lru.back());
+		m_lru.pop_back();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// static
+int
+HostResolver::getAddresses(const char* node, int flags, const String& name,
+	Array<SocketAddress>& addresses, String& canonName)
+{
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+#ifdef BLOCXX_HAVE_IPV6
+	hints.ai_family = AF_UNSPEC;
+#else
+	hints.ai_family = AF_INET;
+#endif
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = flags;
+
+	addrinfo* result = 0;
+	int rc = ::getaddrinfo(node, 0, &hints, &result);
+	if (rc != 0)
+	{
+		return rc;
+	}
+	if (result->ai_canonname)
+	{
+		canonName = result->ai_canonname;
+	}
+	for (addrinfo* ai = result; ai; ai = ai->ai_next)
+	{
+		if (ai->ai_addrlen > sizeof(InetSocketAddress_t))
+		{
+			continue;
+		}
+		InetSocketAddress_t sa;
+		memset(&sa, 0, sizeof(sa));
+		memcpy(&sa, ai->ai_addr, ai->ai_addrlen);
+		SocketAddress addr(sa);
+		addr.m_type = SocketAddress::INET;
+		addr.m_name = name;
+		addresses.push_back(addr);
+	}
+	::freeaddrinfo(result);
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Array<SocketAddress>
+HostResolver::lookup(const String& hostName, String& error, bool& cacheable) const
+{
+	Array<SocketAddress> addresses;
+	String canonName;
+	if (m_config.hostsFile.empty())
+	{
+		int rc = getAddresses(hostName.c_str(), AI_CANONNAME, hostName, addresses, canonName);
+		if (rc != 0)
+		{
+			error = gai_strerror(rc);
+			cacheable = !isTransientError(rc);
+			return addresses;
+		}
+		if (!canonName.empty())
+		{
+			for (size_t i = 0; i < addresses.size(); ++i)
+			{
+				addresses[i].m_name = canonName;
+			}
+		}
+	}
+	else if (getAddresses(hostName.c_str(), AI_NUMERICHOST, hostName, addresses, canonName) != 0)
+	{
+		StringArray lines;
+		try
+		{
+			lines = FileSystem::getFileLines(m_config.hostsFile);
+		}
+		catch (const Exception& e)
+		{
+			error = e.getMessage();
+			cacheable = false;
+			return addresses;
+		}
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			String line = lines[i];
+			size_t comment = line.indexOf('#');
+			if (comment != String::npos)
+			{
+				line = line.substring(0, comment);
+			}
+			StringArray fields = line.tokenize();
+			for (size_t j = 1; j < fields.size(); ++j)
+			{
+				if (fields[j].equalsIgnoreCase(hostName))
+				{
+					// The first name on the line is the canonical one.
+					getAddresses(fields[0].c_str(), AI_NUMERICHOST, fields[1], addresses, canonName);
+					break;
+				}
+			}
+		}
+		if (addresses.empty())
+		{
+			error = Format("not found in %1", m_config.hostsFile);
+		}
+	}
+	return addresses;
+}
+
+} // end namespace BLOCXX_NAMESPACE
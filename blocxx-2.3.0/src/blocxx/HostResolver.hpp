@@ -0,0 +1,193 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_HOST_RESOLVER_HPP_INCLUDE_GUARD_
+#define BLOCXX_HOST_RESOLVER_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/CommonFwd.hpp"
+#include "blocxx/SocketAddress.hpp"
+#include "blocxx/IntrusiveReference.hpp"
+#include "blocxx/IntrusiveCountableBase.hpp"
+#include "blocxx/DateTime.hpp"
+#include "blocxx/Mutex.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Array.hpp"
+
+#include <list>
+#include <map>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * Callback for HostResolver::resolveAsync().  Exactly one of
+ * resolved() or failed() is called, from a thread pool thread.
+ */
+class BLOCXX_COMMON_API HostResolverCallback : public IntrusiveCountableBase
+{
+public:
+	virtual ~HostResolverCallback();
+	void resolved(const String& hostName, const Array<SocketAddress>& addresses);
+	void failed(const String& hostName, const String& message);
+protected:
+	virtual void doResolved(const String& hostName, const Array<SocketAddress>& addresses) = 0;
+	virtual void doFailed(const String& hostName, const String& message) = 0;
+};
+BLOCXX_EXPORT_TEMPLATE(BLOCXX_COMMON_API, IntrusiveReference, HostResolverCallback);
+typedef IntrusiveReference<HostResolverCallback> HostResolverCallbackRef;
+
+/**
+ * Resolves host names using getaddrinfo() and caches the results.
+ *
+ * Both successful lookups and failures are cached, each for its own TTL.
+ * The cache is bounded; once it is full the least recently used entry is
+ * dropped.  All member functions are thread safe.
+ *
+ * IPv6 addresses are returned only when blocxx is built with IPv6 support,
+ * since otherwise InetSocketAddress_t can't hold them.
+ *
+ * For testing, a resolver can be pointed at a file in /etc/hosts format,
+ * in which case that file is consulted instead of the system resolver.
+ */
+class BLOCXX_COMMON_API HostResolver : public IntrusiveCountableBase
+{
+public:
+	struct Config
+	{
+		Config();
+
+		/// Maximum number of host names kept in the cache.
+		size_t maxEntries;
+		/// How long, in seconds, a successful lookup is cached.
+		UInt32 positiveTTL;
+		/// How long, in seconds, a failed lookup is cached.
+		UInt32 negativeTTL;
+		/**
+		 * If not empty, host names are looked up in this file (in
+		 * /etc/hosts format) instead of with getaddrinfo().  Numeric
+		 * addresses are still accepted.
+		 */
+		String hostsFile;
+	};
+
+	HostResolver();
+	explicit HostResolver(const Config& config);
+	virtual ~HostResolver();
+
+	/**
+	 * Look up all addresses for a host.
+	 *
+	 * @param hostName A host name or numeric address.
+	 * @param port The port to put in the returned addresses.
+	 * @return The addresses, in the order the resolver returned them.
+	 *  Never empty.
+	 * @throws UnknownHostException if the host can't be resolved.
+	 */
+	Array<SocketAddress> resolve(const String& hostName, UInt16 port = 0);
+
+	/**
+	 * Start looking up a host and return immediately.  If the result is
+	 * already cached, callback is called before this function returns.
+	 * Otherwise the lookup is queued on pool, and callback is called from
+	 * the thread that performs it.
+	 *
+	 * @throws ThreadPoolException if the pool doesn't accept the work.
+	 */
+	void resolveAsync(const String& hostName, UInt16 port,
+		const HostResolverCallbackRef& callback, const ThreadPoolRef& pool);
+
+	/**
+	 * Remove all entries from the cache.
+	 */
+	void clearCache();
+
+	/**
+	 * @return The number of host names currently cached.
+	 */
+	size_t cacheSize() const;
+
+	/**
+	 * The resolver used by SocketAddress::getByName() and
+	 * SocketAddress::getAllByName().
+	 */
+	static HostResolver& getDefault();
+
+protected:
+	/**
+	 * Used to decide when cache entries expire.  Subclasses may override it
+	 * for testing.
+	 */
+	virtual DateTime getCurrentTime() const;
+
+private:
+	// noncopyable
+	HostResolver(const HostResolver&);
+	HostResolver& operator=(const HostResolver&);
+
+	struct Entry
+	{
+		Array<SocketAddress> addresses; // empty for a failed lookup
+		String error;
+		DateTime expires;
+		std::list<String>::iterator lruPos;
+	};
+	typedef std::map<String, Entry> cache_t;
+
+	bool lookupCache(const String& hostName, Array<SocketAddress>& addresses, String& error);
+	void storeCache(const String& hostName, const Array<SocketAddress>& addresses, const String& error);
+	Array<SocketAddress> lookup(const String& hostName, String& error, bool& cacheable) const;
+	static int getAddresses(const char* node, int flags, const String& name,
+		Array<SocketAddress>& addresses, String& canonName);
+	static void applyPort(Array<SocketAddress>& addresses, UInt16 port);
+
+	friend class HostResolverWork;
+	bool resolveCached(const String& hostName, UInt16 port, Array<SocketAddress>& addresses, String& error);
+
+#ifdef BLOCXX_WIN32
+#pragma warning (push)
+#pragma warning (disable: 4251)
+#endif
+	Config m_config;
+	mutable Mutex m_guard;
+	cache_t m_cache;
+	// Most recently used at the front.
+	std::list<String> m_lru;
+#ifdef BLOCXX_WIN32
+#pragma warning (pop)
+#endif
+};
+BLOCXX_EXPORT_TEMPLATE(BLOCXX_COMMON_API, IntrusiveReference, HostResolver);
+typedef IntrusiveReference<HostResolver> HostResolverRef;
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
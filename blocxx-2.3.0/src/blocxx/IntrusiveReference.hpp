@@ -97,6 +97,17 @@ public:
 	{
 		if (m_pObj != 0) IntrusiveReferenceAddRef(m_pObj);
 	}
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	IntrusiveReference(IntrusiveReference && rhs) BLOCXX_NOEXCEPT: m_pObj(rhs.m_pObj)
+	{
+		rhs.m_pObj = 0;
+	}
+	IntrusiveReference & operator=(IntrusiveReference && rhs) BLOCXX_NOEXCEPT
+	{
+		swap(rhs);
+		return *this;
+	}
+#endif
 	~IntrusiveReference()
 	{
 		//Don't allow an exception to escape.
@@ -0,0 +1,304 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_LOCK_FREE_MT_QUEUE_HPP_INCLUDE_GUARD_
+#define BLOCXX_LOCK_FREE_MT_QUEUE_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/MTQueue.hpp"
+#include "blocxx/LockFreeQueue.hpp"
+#include "blocxx/EventCount.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/Assertion.hpp"
+#include "blocxx/Timeout.hpp"
+#include "blocxx/TimeoutTimer.hpp"
+#include "blocxx/Types.hpp"
+
+#include <utility> // for std::move
+#include <vector>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * A bounded MTQueue which doesn't take a lock to push or pop.  The items are
+ * kept in a BoundedMPMCQueue, and threads only block (on an EventCount) when
+ * the queue is empty or full, so a pushBack() or popFront() which doesn't
+ * have to wait is a compare and exchange plus a fence.
+ *
+ * The semantics are the same as MTQueue's: pushBack() blocks while the queue
+ * is full, popFront() waits up to its timeout while it's empty, and after
+ * shutdown() pushes are ignored and pops return E_SHUT_DOWN.  The difference
+ * is that the maximum size is fixed at construction, and is rounded up to a
+ * power of two.  T must be default constructible and assignable.
+ *
+ * pushBackBatch() and popFrontBatch() move several items while waking the
+ * other side only once.
+ */
+template <typename T>
+class LockFreeMTQueue : public MTSourceIfc<T>
+{
+public:
+	typedef MTQueueEnum::EPopResult EPopResult;
+
+	/**
+	 * @param maxQueueSize When this many items (rounded up to a power of two)
+	 * are in the queue, calls to pushBack() will block.
+	 */
+	explicit LockFreeMTQueue(UInt32 maxQueueSize)
+		: m_queue(maxQueueSize)
+	{
+	}
+
+	/**
+	 * @return The number of items the queue can hold.
+	 */
+	size_t capacity() const
+	{
+		return m_queue.capacity();
+	}
+
+	/**
+	 * Shut down the queue.  Any threads blocked in popFront() or pushBack()
+	 * will be woken, popFront() will return E_SHUT_DOWN, and subsequent calls
+	 * to pushBack() will not insert items in the queue.
+	 */
+	void shutdown()
+	{
+		m_shutdown.store(true, E_MEMORY_ORDER_RELEASE);
+		m_notEmpty.notifyAll();
+		m_notFull.notifyAll();
+	}
+
+	/**
+	 * Add val to the back of the queue, waiting while the queue is full.  If
+	 * another thread is waiting in popFront(), it will be woken up.
+	 * No-op if shutdown() has been called.
+	 */
+	void pushBack(T const & val)
+	{
+		if (pushOrWait(val))
+		{
+			m_notEmpty.notifyAll();
+		}
+	}
+
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Like pushBack(const T&), but moves val into the queue.
+	 */
+	void pushBack(T&& val)
+	{
+		if (pushOrWait(val))
+		{
+			m_notEmpty.notifyAll();
+		}
+	}
+#endif
+
+	/**
+	 * Add the items in [first, last) to the back of the queue in order,
+	 * waiting whenever the queue is full.  Threads waiting in popFront() are
+	 * woken once for all the items that fit, instead of once per item.
+	 * Stops if shutdown() is called.
+	 */
+	template <typename InputIterator>
+	void pushBackBatch(InputIterator first, InputIterator last)
+	{
+		bool pushed = false;
+		for (; first != last; ++first)
+		{
+			if (m_shutdown.load(E_MEMORY_ORDER_ACQUIRE))
+			{
+				break;
+			}
+			T const & val = *first;
+			if (!m_queue.push(val))
+			{
+				// full, let the consumers have what's there before waiting.
+				if (pushed)
+				{
+					m_notEmpty.notifyAll();
+				}
+				if (!pushOrWait(val))
+				{
+					return;
+				}
+			}
+			pushed = true;
+		}
+		if (pushed)
+		{
+			m_notEmpty.notifyAll();
+		}
+	}
+
+	/**
+	 * If the queue is not empty, remove one element from the front of the
+	 * queue, otherwise wait until timeout for pushBack() to be called.  If
+	 * timeout has passed, then return E_TIMED_OUT.  If an item is available
+	 * in the queue it will be assigned to value, and E_VALUE will be
+	 * returned.  If shutdown() is called while waiting, E_SHUT_DOWN will be
+	 * returned.
+	 */
+	virtual EPopResult popFront(Timeout const & timeout, T & value)
+	{
+		EPopResult rv = popOrWait(timeout, value);
+		if (rv == MTQueueEnum::E_VALUE)
+		{
+			m_notFull.notifyAll();
+		}
+		return rv;
+	}
+
+	/**
+	 * Like popFront(), but once an item is available, also removes up to
+	 * maxItems - 1 more that are already in the queue without waiting.  The
+	 * items are appended to values.  Threads blocked in pushBack() are woken
+	 * once for the whole batch.
+	 * @pre maxItems > 0
+	 */
+	EPopResult popFrontBatch(Timeout const & timeout, size_t maxItems, std::vector<T> & values)
+	{
+		BLOCXX_ASSERT(maxItems > 0);
+		T value;
+		EPopResult rv = popOrWait(timeout, value);
+		if (rv == MTQueueEnum::E_VALUE)
+		{
+			do
+			{
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+				values.push_back(std::move(value));
+#else
+				values.push_back(value);
+#endif
+			} while (--maxItems > 0 && m_queue.pop(value));
+			m_notFull.notifyAll();
+		}
+		return rv;
+	}
+
+private:
+	// The value to pass to BoundedMPMCQueue::push(), which moves from val
+	// when it can.
+	static T const & pushArg(T const & val)
+	{
+		return val;
+	}
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	static T&& pushArg(T & val)
+	{
+		return std::move(val);
+	}
+#endif
+
+	/**
+	 * Push val, waiting while the queue is full.  Doesn't notify.
+	 * @return false if the queue was shut down.
+	 */
+	template <typename U>
+	bool pushOrWait(U & val)
+	{
+		for (;;)
+		{
+			if (m_shutdown.load(E_MEMORY_ORDER_ACQUIRE))
+			{
+				return false;
+			}
+			if (m_queue.push(pushArg(val)))
+			{
+				return true;
+			}
+			EventCount::Key key = m_notFull.prepareWait();
+			if (m_shutdown.load(E_MEMORY_ORDER_ACQUIRE))
+			{
+				m_notFull.cancelWait();
+				return false;
+			}
+			if (m_queue.push(pushArg(val)))
+			{
+				m_notFull.cancelWait();
+				return true;
+			}
+			m_notFull.wait(key, Timeout::infinite);
+		}
+	}
+
+	/**
+	 * Pop into value, waiting while the queue is empty.  Doesn't notify.
+	 */
+	EPopResult popOrWait(Timeout const & timeout, T & value)
+	{
+		TimeoutTimer timer(timeout);
+		for (;;)
+		{
+			if (m_shutdown.load(E_MEMORY_ORDER_ACQUIRE))
+			{
+				return MTQueueEnum::E_SHUT_DOWN;
+			}
+			if (m_queue.pop(value))
+			{
+				return MTQueueEnum::E_VALUE;
+			}
+			EventCount::Key key = m_notEmpty.prepareWait();
+			if (m_shutdown.load(E_MEMORY_ORDER_ACQUIRE))
+			{
+				m_notEmpty.cancelWait();
+				return MTQueueEnum::E_SHUT_DOWN;
+			}
+			if (m_queue.pop(value))
+			{
+				m_notEmpty.cancelWait();
+				return MTQueueEnum::E_VALUE;
+			}
+			timer.loop();
+			if (timer.expired())
+			{
+				m_notEmpty.cancelWait();
+				return MTQueueEnum::E_TIMED_OUT;
+			}
+			m_notEmpty.wait(key, timer.asRelativeTimeout());
+		}
+	}
+
+	BoundedMPMCQueue<T> m_queue;
+	Atomic<bool> m_shutdown;
+	EventCount m_notEmpty;
+	EventCount m_notFull;
+
+	// non-copyable
+	LockFreeMTQueue(const LockFreeMTQueue&);
+	LockFreeMTQueue& operator=(const LockFreeMTQueue&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
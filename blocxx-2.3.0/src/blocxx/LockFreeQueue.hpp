@@ -0,0 +1,355 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_LOCK_FREE_QUEUE_HPP_INCLUDE_GUARD_
+#define BLOCXX_LOCK_FREE_QUEUE_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Atomic.hpp"
+
+#include <cstddef> // for size_t, ptrdiff_t
+#include <utility> // for std::move
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace LockFreeQueueImpl
+{
+	/**
+	 * @return The smallest power of two >= n (and >= 2).
+	 */
+	inline size_t roundUpToPowerOfTwo(size_t n)
+	{
+		size_t rv = 2;
+		while (rv < n)
+		{
+			rv <<= 1;
+		}
+		return rv;
+	}
+}
+
+/**
+ * A fixed capacity queue for exactly one producer thread and one consumer
+ * thread.  push() and pop() never block and never take a lock; each is a
+ * handful of loads and one release store.
+ *
+ * Only one thread may call push() and only one (other) thread may call pop()
+ * at a time.  T must be default constructible and assignable; popped slots
+ * are reset to T() so they don't hold on to resources.
+ */
+template <typename T>
+class SPSCRingBuffer
+{
+public:
+	/**
+	 * @param capacity The minimum number of elements the queue can hold.  It
+	 * is rounded up to a power of two.
+	 */
+	explicit SPSCRingBuffer(size_t capacity)
+		: m_mask(LockFreeQueueImpl::roundUpToPowerOfTwo(capacity) - 1)
+		, m_buffer(new T[m_mask + 1])
+		, m_consumerCachedTail(0)
+		, m_producerCachedHead(0)
+	{
+	}
+
+	~SPSCRingBuffer()
+	{
+		delete[] m_buffer;
+	}
+
+	/**
+	 * Called by the producer.
+	 * @return false if the queue is full.
+	 */
+	bool push(const T& x)
+	{
+		size_t tail = m_tail.load(E_MEMORY_ORDER_RELAXED);
+		if (tail - m_producerCachedHead > m_mask)
+		{
+			// looks full, see how far the consumer has got.
+			m_producerCachedHead = m_head.load(E_MEMORY_ORDER_ACQUIRE);
+			if (tail - m_producerCachedHead > m_mask)
+			{
+				return false;
+			}
+		}
+		m_buffer[tail & m_mask] = x;
+		m_tail.store(tail + 1, E_MEMORY_ORDER_RELEASE);
+		return true;
+	}
+
+	/**
+	 * Called by the consumer.
+	 * @return false if the queue is empty, otherwise x is set to the oldest
+	 * element, which is removed.
+	 */
+	bool pop(T& x)
+	{
+		size_t head = m_head.load(E_MEMORY_ORDER_RELAXED);
+		if (head == m_consumerCachedTail)
+		{
+			m_consumerCachedTail = m_tail.load(E_MEMORY_ORDER_ACQUIRE);
+			if (head == m_consumerCachedTail)
+			{
+				return false;
+			}
+		}
+		T& slot = m_buffer[head & m_mask];
+		x = slot;
+		slot = T();
+		m_head.store(head + 1, E_MEMORY_ORDER_RELEASE);
+		return true;
+	}
+
+	size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+	/**
+	 * @return The number of elements.  Only exact if neither push() nor pop()
+	 * is running.
+	 */
+	size_t size() const
+	{
+		return m_tail.load(E_MEMORY_ORDER_ACQUIRE) - m_head.load(E_MEMORY_ORDER_ACQUIRE);
+	}
+
+private:
+	const size_t m_mask;
+	T* const m_buffer;
+
+	char m_pad0[BLOCXX_CACHE_LINE_SIZE];
+	// next slot to pop, written by the consumer.
+	Atomic<size_t> m_head;
+	size_t m_consumerCachedTail;
+
+	char m_pad1[BLOCXX_CACHE_LINE_SIZE];
+	// next slot to push, written by the producer.
+	Atomic<size_t> m_tail;
+	size_t m_producerCachedHead;
+
+	char m_pad2[BLOCXX_CACHE_LINE_SIZE];
+
+	// noncopyable
+	SPSCRingBuffer(const SPSCRingBuffer&);
+	SPSCRingBuffer& operator=(const SPSCRingBuffer&);
+};
+
+/**
+ * A fixed capacity queue which any number of threads may push() to and pop()
+ * from concurrently.  Neither operation takes a lock or blocks: a full queue
+ * makes push() return false, an empty one makes pop() return false.
+ *
+ * This is Dmitry Vyukov's bounded MPMC queue.  Each slot has a sequence
+ * number saying whether it's ready to be written or read for a given lap of
+ * the ring, so producers and consumers only contend on their own position
+ * counter, with a single compare and exchange per operation.
+ *
+ * T must be default constructible and assignable; popped slots are reset to
+ * T() so they don't hold on to resources.
+ */
+template <typename T>
+class BoundedMPMCQueue
+{
+public:
+	/**
+	 * @param capacity The minimum number of elements the queue can hold.  It
+	 * is rounded up to a power of two.
+	 */
+	explicit BoundedMPMCQueue(size_t capacity)
+		: m_mask(LockFreeQueueImpl::roundUpToPowerOfTwo(capacity) - 1)
+		, m_cells(new Cell[m_mask + 1])
+	{
+		for (size_t i = 0; i <= m_mask; ++i)
+		{
+			m_cells[i].sequence.store(i, E_MEMORY_ORDER_RELAXED);
+		}
+	}
+
+	~BoundedMPMCQueue()
+	{
+		delete[] m_cells;
+	}
+
+	/**
+	 * @return false if the queue is full.
+	 */
+	bool push(const T& x)
+	{
+		size_t pos;
+		Cell* cell = claimPushCell(pos);
+		if (!cell)
+		{
+			return false;
+		}
+		cell->data = x;
+		cell->sequence.store(pos + 1, E_MEMORY_ORDER_RELEASE);
+		return true;
+	}
+
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Moves x into the queue, unless it's full.
+	 * @return false if the queue is full, in which case x is unchanged.
+	 */
+	bool push(T&& x)
+	{
+		size_t pos;
+		Cell* cell = claimPushCell(pos);
+		if (!cell)
+		{
+			return false;
+		}
+		cell->data = std::move(x);
+		cell->sequence.store(pos + 1, E_MEMORY_ORDER_RELEASE);
+		return true;
+	}
+#endif
+
+	/**
+	 * @return false if the queue is empty, otherwise x is set to the element
+	 * removed.
+	 */
+	bool pop(T& x)
+	{
+		Cell* cell;
+		size_t pos = m_dequeuePos.load(E_MEMORY_ORDER_RELAXED);
+		for (;;)
+		{
+			cell = &m_cells[pos & m_mask];
+			size_t seq = cell->sequence.load(E_MEMORY_ORDER_ACQUIRE);
+			std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (m_dequeuePos.compareExchangeWeak(pos, pos + 1, E_MEMORY_ORDER_RELAXED))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// nothing has been pushed to the slot for this lap.
+				return false;
+			}
+			else
+			{
+				pos = m_dequeuePos.load(E_MEMORY_ORDER_RELAXED);
+			}
+		}
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+		x = std::move(cell->data);
+#else
+		x = cell->data;
+#endif
+		cell->data = T();
+		// make the slot free for the next lap.
+		cell->sequence.store(pos + m_mask + 1, E_MEMORY_ORDER_RELEASE);
+		return true;
+	}
+
+	size_t capacity() const
+	{
+		return m_mask + 1;
+	}
+
+	/**
+	 * @return The number of elements.  Only exact if no push() or pop() is
+	 * running.
+	 */
+	size_t size() const
+	{
+		size_t dequeuePos = m_dequeuePos.load(E_MEMORY_ORDER_ACQUIRE);
+		size_t enqueuePos = m_enqueuePos.load(E_MEMORY_ORDER_ACQUIRE);
+		return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+	}
+
+private:
+	struct Cell
+	{
+		Atomic<size_t> sequence;
+		T data;
+	};
+
+	/**
+	 * Reserve the next cell to push to.
+	 * @return 0 if the queue is full.  Otherwise the cell, which the caller
+	 * must fill and then publish by setting its sequence to pos + 1.
+	 */
+	Cell* claimPushCell(size_t& pos)
+	{
+		Cell* cell;
+		pos = m_enqueuePos.load(E_MEMORY_ORDER_RELAXED);
+		for (;;)
+		{
+			cell = &m_cells[pos & m_mask];
+			size_t seq = cell->sequence.load(E_MEMORY_ORDER_ACQUIRE);
+			std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+			if (diff == 0)
+			{
+				// the slot is free for this lap, try to claim it.
+				if (m_enqueuePos.compareExchangeWeak(pos, pos + 1, E_MEMORY_ORDER_RELAXED))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				// the slot still holds the element from the previous lap.
+				return 0;
+			}
+			else
+			{
+				pos = m_enqueuePos.load(E_MEMORY_ORDER_RELAXED);
+			}
+		}
+		return cell;
+	}
+
+	const size_t m_mask;
+	Cell* const m_cells;
+
+	char m_pad0[BLOCXX_CACHE_LINE_SIZE];
+	Atomic<size_t> m_enqueuePos;
+	char m_pad1[BLOCXX_CACHE_LINE_SIZE];
+	Atomic<size_t> m_dequeuePos;
+	char m_pad2[BLOCXX_CACHE_LINE_SIZE];
+
+	// noncopyable
+	BoundedMPMCQueue(const BoundedMPMCQueue&);
+	BoundedMPMCQueue& operator=(const BoundedMPMCQueue&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -0,0 +1,147 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_LOCK_FREE_STACK_HPP_INCLUDE_GUARD_
+#define BLOCXX_LOCK_FREE_STACK_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/HazardPointer.hpp"
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * An unbounded LIFO stack which any number of threads may push() to and
+ * pop() from concurrently without taking a lock (a Treiber stack).
+ *
+ * Popped nodes are reclaimed with hazard pointers, so a pop() can't read a
+ * node another pop() has already freed, and a recycled node address can't
+ * make a compare and exchange succeed when it shouldn't (the ABA problem).
+ * A popped node's memory is freed on a later pop(), or when the stack is
+ * destroyed.
+ *
+ * T must be copy constructible and assignable.
+ */
+template <typename T>
+class LockFreeStack
+{
+public:
+	LockFreeStack()
+	{
+	}
+
+	/**
+	 * No other thread may be using the stack.
+	 */
+	~LockFreeStack()
+	{
+		Node* node = m_head.load(E_MEMORY_ORDER_ACQUIRE);
+		while (node)
+		{
+			Node* next = node->next;
+			delete node;
+			node = next;
+		}
+	}
+
+	void push(const T& x)
+	{
+		Node* node = new Node(x);
+		// No hazard pointer is needed, node->next is never dereferenced here.
+		node->next = m_head.load(E_MEMORY_ORDER_RELAXED);
+		while (!m_head.compareExchangeWeak(node->next, node, E_MEMORY_ORDER_RELEASE, E_MEMORY_ORDER_RELAXED))
+		{
+		}
+	}
+
+	/**
+	 * @return false if the stack is empty, otherwise x is set to the element
+	 * removed.
+	 */
+	bool pop(T& x)
+	{
+		HazardPointerDomain::Guard guard(m_hazards);
+		Node* head;
+		for (;;)
+		{
+			head = guard.protect(m_head);
+			if (!head)
+			{
+				return false;
+			}
+			if (m_head.compareExchangeWeak(head, head->next, E_MEMORY_ORDER_ACQ_REL, E_MEMORY_ORDER_RELAXED))
+			{
+				break;
+			}
+		}
+		x = head->value;
+		guard.clear();
+		guard.retire(head, &deleteNode);
+		return true;
+	}
+
+	/**
+	 * @return Whether the stack was empty when it was checked.
+	 */
+	bool empty() const
+	{
+		return m_head.load(E_MEMORY_ORDER_ACQUIRE) == 0;
+	}
+
+private:
+	struct Node
+	{
+		Node(const T& x)
+			: value(x)
+			, next(0)
+		{
+		}
+		T value;
+		Node* next;
+	};
+
+	static void deleteNode(void* p)
+	{
+		delete static_cast<Node*>(p);
+	}
+
+	Atomic<Node*> m_head;
+	HazardPointerDomain m_hazards;
+
+	// noncopyable
+	LockFreeStack(const LockFreeStack&);
+	LockFreeStack& operator=(const LockFreeStack&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -58,6 +58,11 @@
 #include "blocxx/ThreadOnce.hpp"
 #include "blocxx/NullLogger.hpp"
 #include "blocxx/GlobalPtr.hpp"
+#include "blocxx/AtomicOps.hpp"
+
+#if !defined(BLOCXX_WIN32) && !defined(BLOCXX_NCR)
+#define BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+#endif
 
 
 namespace BLOCXX_NAMESPACE
@@ -88,6 +93,9 @@ static void freeThreadLogAppender(void *ptr)
 {
 	delete static_cast<LogAppenderRef *>(ptr);
 }
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+static void freeDefaultAppenderCache(void *ptr);
+#endif
 } // end extern "C"
 
 /////////////////////////////////////////////////////////////////////////////
@@ -106,11 +114,35 @@ struct NullAppenderFactory
 };
 ::BLOCXX_NAMESPACE::GlobalPtr<LogAppenderRef,NullAppenderFactory> g_defaultLogAppender = BLOCXX_GLOBAL_PTR_INIT;
 
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+// getDefaultLogAppender() is called every time a Logger is constructed, so
+// each thread keeps its own copy of the default appender, tagged with the
+// value g_defaultGeneration had when the copy was taken.
+// setDefaultLogAppender() bumps g_defaultGeneration, after which every
+// thread's copy is stale and is refreshed (under g_mutexGuard) on its next
+// call.  Until then a thread's copy keeps the previous appender alive.
+// A cache hit takes no lock: it only reads the generation counter and the
+// calling thread's own data.
+Atomic_t* g_defaultGeneration = NULL;
+pthread_key_t g_defaultCacheKey;
+
+struct DefaultAppenderCache
+{
+	LogAppenderRef appender;
+	int generation;
+};
+#endif
+
 
 /////////////////////////////////////////////////////////////////////////////
 void initGuardAndKey()
 {
 	g_mutexGuard = new NonRecursiveMutex();
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+	g_defaultGeneration = new Atomic_t(0);
+	int cacheRet = pthread_key_create(&g_defaultCacheKey, freeDefaultAppenderCache);
+	BLOCXX_ASSERTMSG(cacheRet == 0, "failed create a thread specific key");
+#endif
 #ifdef BLOCXX_WIN32
 	LPVOID thread_data = NULL;
 	BOOL ret = TlsSetValue(dwTlsIndex, thread_data)
@@ -127,6 +159,16 @@ void initGuardAndKey()
 
 } // end unnamed namespace
 
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+extern "C"
+{
+static void freeDefaultAppenderCache(void *ptr)
+{
+	delete static_cast<DefaultAppenderCache *>(ptr);
+}
+} // end extern "C"
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 // STATIC
 LogAppenderRef
@@ -149,12 +191,40 @@ LogAppenderRef
 LogAppender::getDefaultLogAppender()
 {
 	callOnce(g_onceGuard, initGuardAndKey);
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+	int generation = AtomicGet(*g_defaultGeneration);
+	DefaultAppenderCache* cache = static_cast<DefaultAppenderCache *>(
+		pthread_getspecific(g_defaultCacheKey));
+	if (cache && cache->generation == generation)
+	{
+		return cache->appender;
+	}
+	if (!cache)
+	{
+		cache = new DefaultAppenderCache;
+		if (pthread_setspecific(g_defaultCacheKey, cache) != 0)
+		{
+			delete cache;
+			cache = 0;
+		}
+	}
+#endif
 	NonRecursiveMutexLock lock(*g_mutexGuard);
 
 	// This looks unsafe, but the get() method (called indirectly by operator*),
 	// if it has never been previously called, will allocate a new
 	// LogAppenderRef wich will have a NullAppender inside it.
-	return *g_defaultLogAppender;
+	LogAppenderRef rval(*g_defaultLogAppender);
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+	if (cache)
+	{
+		// Re-read under the lock; setDefaultLogAppender() only changes it
+		// while holding g_mutexGuard.
+		cache->appender = rval;
+		cache->generation = AtomicGet(*g_defaultGeneration);
+	}
+#endif
+	return rval;
 }
 
 
@@ -169,6 +239,9 @@ LogAppender::setDefaultLogAppender(const LogAppenderRef &ref)
 		NonRecursiveMutexLock lock(*g_mutexGuard);
 
 		LogAppenderRef(ref).swap(*g_defaultLogAppender);
+#ifdef BLOCXX_CACHE_DEFAULT_LOG_APPENDER
+		AtomicInc(*g_defaultGeneration);
+#endif
 		return true;
 	}
 	return false;
@@ -258,9 +331,13 @@ LogAppender::setThreadLogAppender(const LogAppenderRef &ref)
 void
 LogAppender::logMessage(const LogMessage& message) const
 {
-	if (componentAndCategoryAreEnabled(message.component, message.category))
+	bool enabled = (message.componentId.isValid() && message.categoryId.isValid())
+		? componentAndCategoryAreEnabled(message.componentId, message.categoryId)
+		: componentAndCategoryAreEnabled(message.component, message.category);
+	if (enabled)
 	{
-		StringBuffer buf;
+		// Most messages fit, so the only allocation is the String.
+		InlineStringBuffer<256> buf;
 		m_formatter.formatMessage(message, buf);
 		doProcessLogMessage(buf.releaseString(), message);
 	}
@@ -270,20 +347,30 @@ LogAppender::logMessage(const LogMessage& message) const
 bool
 LogAppender::categoryIsEnabled(const String& category) const
 {
-	return m_allCategories || m_categories.count(category) > 0;
+	return m_allCategories || categoryIsEnabled(LogCategoryId::find(category));
 }
 
 //////////////////////////////////////////////////////////////////////////////
 bool
 LogAppender::componentAndCategoryAreEnabled(const String& component, const String& category) const
 {
-	return (m_allComponents || m_components.count(component) > 0) &&
+	return (m_allComponents || maskContains(m_componentMask, LogComponentId::find(component).getIndex())) &&
 		categoryIsEnabled(category);
 }
 
 /////////////////////////////////////////////////////////////////////////////
 namespace
 {
+	void
+	addToMask(std::vector<bool>& mask, UInt32 index)
+	{
+		if (index >= mask.size())
+		{
+			mask.resize(index + 1);
+		}
+		mask[index] = true;
+	}
+
 	String
 	getConfigItem(const LoggerConfigMap& configItems, const String &itemName, const String& defRetVal = "")
 	{
@@ -410,23 +497,33 @@ const GlobalString LogAppender::TYPE_NULL = BLOCXX_GLOBAL_STRING_INIT("null");
 
 //////////////////////////////////////////////////////////////////////////////
 LogAppender::LogAppender(const StringArray& components, const StringArray& categories, const String& pattern)
-	: m_components(components.begin(), components.end())
-	, m_categories(categories.begin(), categories.end())
-	, m_formatter(pattern)
+	: m_formatter(pattern)
 	, m_logLevel(E_NONE_LEVEL)
 {
-	m_allComponents = m_components.count("*") > 0;
-	m_allCategories = m_categories.count("*") > 0;
+	SortedVectorSet<String> componentSet(components.begin(), components.end());
+	SortedVectorSet<String> categorySet(categories.begin(), categories.end());
+	m_allComponents = componentSet.count("*") > 0;
+	m_allCategories = categorySet.count("*") > 0;
+
+	typedef SortedVectorSet<String>::const_iterator iter_t;
+	for (iter_t i = componentSet.begin(); i != componentSet.end(); ++i)
+	{
+		addToMask(m_componentMask, LogComponentId(*i).getIndex());
+	}
+	for (iter_t i = categorySet.begin(); i != categorySet.end(); ++i)
+	{
+		addToMask(m_categoryMask, LogCategoryId(*i).getIndex());
+	}
 
 	// set up the log level
-	size_t numCategories = m_categories.size();
-	size_t debug3Count = m_categories.count(Logger::STR_DEBUG3_CATEGORY);
-	size_t debug2Count = m_categories.count(Logger::STR_DEBUG2_CATEGORY);
-	size_t debugCount = m_categories.count(Logger::STR_DEBUG_CATEGORY);
-	size_t infoCount = m_categories.count(Logger::STR_INFO_CATEGORY);
-	size_t warningCount = m_categories.count(Logger::STR_WARNING_CATEGORY);
-	size_t errorCount = m_categories.count(Logger::STR_ERROR_CATEGORY);
-	size_t fatalCount = m_categories.count(Logger::STR_FATAL_CATEGORY);
+	size_t numCategories = categorySet.size();
+	size_t debug3Count = categorySet.count(Logger::STR_DEBUG3_CATEGORY);
+	size_t debug2Count = categorySet.count(Logger::STR_DEBUG2_CATEGORY);
+	size_t debugCount = categorySet.count(Logger::STR_DEBUG_CATEGORY);
+	size_t infoCount = categorySet.count(Logger::STR_INFO_CATEGORY);
+	size_t warningCount = categorySet.count(Logger::STR_WARNING_CATEGORY);
+	size_t errorCount = categorySet.count(Logger::STR_ERROR_CATEGORY);
+	size_t fatalCount = categorySet.count(Logger::STR_FATAL_CATEGORY);
 	int nonLevelCategoryCount = numCategories - debug3Count - debug2Count - debugCount - infoCount - warningCount - errorCount - fatalCount;
 
 	if (numCategories == 0)
@@ -43,9 +43,11 @@
 #include "blocxx/SortedVectorSet.hpp"
 #include "blocxx/LogConfig.hpp"
 #include "blocxx/LogLevel.hpp"
+#include "blocxx/LogSymbol.hpp"
 #include "blocxx/LogMessagePatternFormatter.hpp"
 #include "blocxx/GlobalString.hpp"
 #include "blocxx/GlobalStringArray.hpp"
+#include <vector>
 
 
 namespace BLOCXX_NAMESPACE
@@ -107,6 +109,20 @@ public:
 	bool categoryIsEnabled(const String& category) const;
 	bool componentAndCategoryAreEnabled(const String& component, const String& category) const;
 
+	/**
+	 * Id based versions of the filtering functions above.  These only
+	 * test a bit in a per-appender mask.
+	 */
+	bool categoryIsEnabled(LogCategoryId category) const
+	{
+		return m_allCategories || maskContains(m_categoryMask, category.getIndex());
+	}
+	bool componentAndCategoryAreEnabled(LogComponentId component, LogCategoryId category) const
+	{
+		return (m_allComponents || maskContains(m_componentMask, component.getIndex())) &&
+			categoryIsEnabled(category);
+	}
+
 	ELogLevel getLogLevel() const
 	{
 		return m_logLevel;
@@ -185,10 +201,16 @@ protected:
 private:
 	virtual void doProcessLogMessage(const String& formattedMessage, const LogMessage& message) const = 0;
 
+	static bool maskContains(const std::vector<bool>& mask, UInt32 index)
+	{
+		return index < mask.size() && mask[index];
+	}
+
 private: // data
-	SortedVectorSet<String> m_components;
+	// Indexed by LogComponentId/LogCategoryId::getIndex()
+	std::vector<bool> m_componentMask;
 	bool m_allComponents;
-	SortedVectorSet<String> m_categories;
+	std::vector<bool> m_categoryMask;
 	bool m_allCategories;
 
 	LogMessagePatternFormatter m_formatter;
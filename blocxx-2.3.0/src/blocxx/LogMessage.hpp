@@ -39,6 +39,7 @@
 #define BLOCXX_LOG_MESSAGE_HPP_INCLUDE_GUARD_
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/String.hpp"
+#include "blocxx/LogSymbol.hpp"
 
 namespace BLOCXX_NAMESPACE
 {
@@ -55,12 +56,29 @@ struct BLOCXX_COMMON_API LogMessage
 	{
 	}
 
+	LogMessage(const String& component_, const String& category_, const String& message_, const char* filename_, int fileline_, const char* methodname_,
+		LogComponentId componentId_, LogCategoryId categoryId_)
+		: component(component_)
+		, category(category_)
+		, message(message_)
+		, filename(filename_)
+		, fileline(fileline_)
+		, methodname(methodname_)
+		, componentId(componentId_)
+		, categoryId(categoryId_)
+	{
+	}
+
 	String component;
 	String category;
 	String message;
 	const char* filename;
 	int fileline;
 	const char* methodname;
+	// The interned component and category, if the creator already had
+	// them.  If either is invalid, LogAppender looks the names up instead.
+	LogComponentId componentId;
+	LogCategoryId categoryId;
 };
 
 
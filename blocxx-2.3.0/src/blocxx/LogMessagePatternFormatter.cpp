@@ -47,7 +47,6 @@
 #include "blocxx/ThreadImpl.hpp"
 #include "blocxx/GlobalString.hpp"
 
-#include <vector>
 #include <cstdlib> // for strtol
 #include <climits> // for CHAR_MAX
 
@@ -90,6 +89,14 @@ struct Formatting
 	{}
 };
 
+inline void appendSpaces(StringBuffer& output, int count)
+{
+	for (; count > 0; --count)
+	{
+		output += ' ';
+	}
+}
+
 } // end namespace LogMessagePatternFormatterImpl
 
 using namespace LogMessagePatternFormatterImpl;
@@ -115,15 +122,13 @@ public:
 		}
 		else
 		{
-			StringBuffer buf;
+			// Padded fields are usually short, so this rarely allocates.
+			InlineStringBuffer<64> buf;
 			convert(message, buf);
 
 			if (buf.length() == 0)
 			{
-				if (m_formatting.minWidth > 0)
-				{
-					output.append(&(std::vector<char>(size_t(m_formatting.minWidth), ' ')[0]), m_formatting.minWidth);
-				}
+				appendSpaces(output, m_formatting.minWidth);
 				return;
 			}
 
@@ -137,7 +142,7 @@ public:
 				}
 				else
 				{
-					output += buf.releaseString().substring(len - m_formatting.maxWidth);
+					output.append(buf.c_str() + len - m_formatting.maxWidth, m_formatting.maxWidth);
 				}
 			}
 			else if (len < m_formatting.minWidth)
@@ -145,11 +150,11 @@ public:
 				if (m_formatting.justification == E_LEFT_JUSTIFY)
 				{
 					output += buf;
-					output.append(&(std::vector<char>(size_t(m_formatting.minWidth - len), ' ')[0]), m_formatting.minWidth - len);
+					appendSpaces(output, m_formatting.minWidth - len);
 				}
 				else
 				{
-					output.append(&(std::vector<char>(size_t(m_formatting.minWidth - len), ' ')[0]), m_formatting.minWidth - len);
+					appendSpaces(output, m_formatting.minWidth - len);
 					output += buf;
 				}
 			}
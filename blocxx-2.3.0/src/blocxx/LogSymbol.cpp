@@ -0,0 +1,227 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/LogSymbol.hpp"
+#include "blocxx/LazyGlobal.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/NonRecursiveMutex.hpp"
+#include "blocxx/NonRecursiveMutexLock.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace
+{
+
+/////////////////////////////////////////////////////////////////////////////
+// An append-only name <-> index table.  Readers use the current snapshot,
+// which isn't modified once it's published, so looking up a name, or
+// interning one that's already there, takes no lock.  Adding a name copies
+// the snapshot under the lock and publishes the copy.  That only happens
+// the first time a component or category is used, so replaced snapshots
+// are simply kept until the table is destroyed, since a reader may still
+// be looking at one.
+class SymbolTable
+{
+public:
+	SymbolTable(const char* const* seed = 0)
+		: m_snapshot(new Snapshot)
+	{
+		for (; seed && *seed; ++seed)
+		{
+			intern(*seed);
+		}
+	}
+
+	~SymbolTable()
+	{
+		delete m_snapshot.load(E_MEMORY_ORDER_RELAXED);
+		for (size_t i = 0; i < m_retired.size(); ++i)
+		{
+			delete m_retired[i];
+		}
+	}
+
+	UInt32 intern(const String& name)
+	{
+		UInt32 index = find(name, NOT_FOUND);
+		if (index != NOT_FOUND)
+		{
+			return index;
+		}
+
+		NonRecursiveMutexLock lock(m_guard);
+		// another thread may have added it since the lookup above.
+		const Snapshot* current = m_snapshot.load(E_MEMORY_ORDER_RELAXED);
+		index = current->find(name, NOT_FOUND);
+		if (index != NOT_FOUND)
+		{
+			return index;
+		}
+		Snapshot* next = new Snapshot(*current);
+		index = static_cast<UInt32>(next->names.size());
+		next->names.push_back(name);
+		next->ids.insert(std::lower_bound(next->ids.begin(), next->ids.end(), name, EntryLess()),
+			Entry(name, index));
+		m_retired.push_back(current);
+		m_snapshot.store(next, E_MEMORY_ORDER_RELEASE);
+		return index;
+	}
+
+	UInt32 find(const String& name, UInt32 notFound) const
+	{
+		return m_snapshot.load(E_MEMORY_ORDER_ACQUIRE)->find(name, notFound);
+	}
+
+	String name(UInt32 index) const
+	{
+		const Snapshot* snapshot = m_snapshot.load(E_MEMORY_ORDER_ACQUIRE);
+		return index < snapshot->names.size() ? snapshot->names[index] : String();
+	}
+
+private:
+	static const UInt32 NOT_FOUND = 0xFFFFFFFFu;
+
+	typedef std::pair<String, UInt32> Entry;
+
+	struct EntryLess
+	{
+		bool operator()(const Entry& x, const String& name) const
+		{
+			return x.first < name;
+		}
+	};
+
+	struct Snapshot
+	{
+		UInt32 find(const String& name, UInt32 notFound) const
+		{
+			std::vector<Entry>::const_iterator i = std::lower_bound(ids.begin(), ids.end(), name, EntryLess());
+			return i != ids.end() && i->first == name ? i->second : notFound;
+		}
+
+		// sorted by name
+		std::vector<Entry> ids;
+		std::vector<String> names;
+	};
+
+	Atomic<const Snapshot*> m_snapshot;
+	// guards adding names, and m_retired
+	NonRecursiveMutex m_guard;
+	std::vector<const Snapshot*> m_retired;
+
+	// noncopyable
+	SymbolTable(const SymbolTable&);
+	SymbolTable& operator=(const SymbolTable&);
+};
+
+// Must match the strings of Logger::STR_*_CATEGORY, in ELogLevel order,
+// for LogCategoryId::forLevel().
+const char* const g_levelCategories[] =
+{
+	"FATAL",
+	"ERROR",
+	"WARNING",
+	"INFO",
+	"DEBUG",
+	"DEBUG2",
+	"DEBUG3",
+	0
+};
+
+struct CategoryTableFactory
+{
+	static SymbolTable* create(int)
+	{
+		return new SymbolTable(g_levelCategories);
+	}
+};
+
+DefaultConstructedLazyGlobal<SymbolTable>::type g_components = BLOCXX_LAZY_GLOBAL_DEFAULT_INIT;
+LazyGlobal<SymbolTable, int, CategoryTableFactory> g_categories = BLOCXX_LAZY_GLOBAL_INIT(0);
+
+} // end unnamed namespace
+
+const UInt32 LogComponentId::INVALID_INDEX;
+const UInt32 LogCategoryId::INVALID_INDEX;
+
+/////////////////////////////////////////////////////////////////////////////
+LogComponentId::LogComponentId(const String& name)
+	: m_index(g_components.get().intern(name))
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+LogComponentId
+LogComponentId::find(const String& name)
+{
+	LogComponentId rv;
+	rv.m_index = g_components.get().find(name, INVALID_INDEX);
+	return rv;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+String
+LogComponentId::toString() const
+{
+	return isValid() ? g_components.get().name(m_index) : String();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+LogCategoryId::LogCategoryId(const String& name)
+	: m_index(g_categories.get().intern(name))
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////
+LogCategoryId
+LogCategoryId::find(const String& name)
+{
+	LogCategoryId rv;
+	rv.m_index = g_categories.get().find(name, INVALID_INDEX);
+	return rv;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+String
+LogCategoryId::toString() const
+{
+	return isValid() ? g_categories.get().name(m_index) : String();
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
@@ -0,0 +1,169 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_LOG_SYMBOL_HPP_INCLUDE_GUARD_
+#define BLOCXX_LOG_SYMBOL_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/LogLevel.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Types.hpp"
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * A LogComponentId is a small integer handle for a log component name.
+ * Names are interned in a process wide table the first time an id is
+ * constructed for them, and are never removed, so two ids compare equal
+ * exactly when their names are equal.  Finding or interning a name that's
+ * already in the table takes no lock.  LogAppender uses the index of an
+ * id to look the component up in a bitset, instead of searching for the
+ * name.
+ *
+ * A default constructed LogComponentId is invalid; it refers to no name.
+ */
+class BLOCXX_COMMON_API LogComponentId
+{
+public:
+	static const UInt32 INVALID_INDEX = 0xFFFFFFFFu;
+
+	LogComponentId()
+		: m_index(INVALID_INDEX)
+	{
+	}
+	/**
+	 * Intern name, adding it to the table if necessary.
+	 */
+	explicit LogComponentId(const String& name);
+
+	/**
+	 * Look up name without adding it to the table.
+	 * @return The id for name, or an invalid id if name has never been
+	 *  interned.
+	 */
+	static LogComponentId find(const String& name);
+
+	bool isValid() const
+	{
+		return m_index != INVALID_INDEX;
+	}
+	UInt32 getIndex() const
+	{
+		return m_index;
+	}
+	/**
+	 * @return The interned name, or an empty String if this id is invalid.
+	 */
+	String toString() const;
+
+	bool operator==(const LogComponentId& x) const
+	{
+		return m_index == x.m_index;
+	}
+	bool operator!=(const LogComponentId& x) const
+	{
+		return m_index != x.m_index;
+	}
+
+private:
+	UInt32 m_index;
+};
+
+/**
+ * A LogCategoryId is the category counterpart of LogComponentId.  The
+ * categories used by the log levels ("FATAL", "ERROR", ... "DEBUG3") are
+ * interned up front, so forLevel() needs no table lookup.
+ */
+class BLOCXX_COMMON_API LogCategoryId
+{
+public:
+	static const UInt32 INVALID_INDEX = 0xFFFFFFFFu;
+
+	LogCategoryId()
+		: m_index(INVALID_INDEX)
+	{
+	}
+	/**
+	 * Intern name, adding it to the table if necessary.
+	 */
+	explicit LogCategoryId(const String& name);
+
+	/**
+	 * Look up name without adding it to the table.
+	 * @return The id for name, or an invalid id if name has never been
+	 *  interned.
+	 */
+	static LogCategoryId find(const String& name);
+
+	/**
+	 * @return The id of the category logged for level, or an invalid id
+	 *  for E_NONE_LEVEL and E_ALL_LEVEL, which have no category.
+	 */
+	static LogCategoryId forLevel(ELogLevel level)
+	{
+		LogCategoryId rv;
+		if (level > E_NONE_LEVEL && level < E_ALL_LEVEL)
+		{
+			rv.m_index = level - E_FATAL_ERROR_LEVEL;
+		}
+		return rv;
+	}
+
+	bool isValid() const
+	{
+		return m_index != INVALID_INDEX;
+	}
+	UInt32 getIndex() const
+	{
+		return m_index;
+	}
+	/**
+	 * @return The interned name, or an empty String if this id is invalid.
+	 */
+	String toString() const;
+
+	bool operator==(const LogCategoryId& x) const
+	{
+		return m_index == x.m_index;
+	}
+	bool operator!=(const LogCategoryId& x) const
+	{
+		return m_index != x.m_index;
+	}
+
+private:
+	UInt32 m_index;
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -67,6 +67,7 @@ Logger::Logger(const String& defaultComponent, const LogAppenderRef& appender)
 	: m_defaultComponent(defaultComponent)
 	, m_appender(appender ? appender : LogAppender::getCurrentLogAppender())
 	, m_logLevel(m_appender->getLogLevel())
+	, m_defaultComponentId(defaultComponent)
 {
 	BLOCXX_ASSERT(m_defaultComponent.length());
 }
@@ -76,6 +77,7 @@ Logger::Logger(const String& defaultComponent, const ELogLevel logLevel)
 	: m_defaultComponent(defaultComponent)
 	, m_appender(LogAppender::getCurrentLogAppender())
 	, m_logLevel(logLevel)
+	, m_defaultComponentId(defaultComponent)
 {
 	BLOCXX_ASSERT(m_defaultComponent.length());
 }
@@ -86,6 +88,7 @@ Logger::Logger(const Logger& x)
 	, m_defaultComponent(x.m_defaultComponent)
 	, m_appender(x.m_appender)
 	, m_logLevel(x.m_logLevel)
+	, m_defaultComponentId(x.m_defaultComponentId)
 {
 }
 
@@ -96,10 +99,21 @@ Logger::operator=(const Logger& x)
 	m_defaultComponent = x.m_defaultComponent;
 	m_appender = x.m_appender;
 	m_logLevel = x.m_logLevel;
+	m_defaultComponentId = x.m_defaultComponentId;
 
 	return *this;
 }
 
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+/////////////////////////////////////////////////////////////////////////////
+Logger&
+Logger::operator=(Logger&& x) BLOCXX_NOEXCEPT
+{
+	swap(x);
+	return *this;
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 void
 Logger::swap(Logger& x)
@@ -107,6 +121,7 @@ Logger::swap(Logger& x)
 	m_defaultComponent.swap(x.m_defaultComponent);
 	m_appender.swap(x.m_appender);
 	std::swap(m_logLevel, x.m_logLevel);
+	std::swap(m_defaultComponentId, x.m_defaultComponentId);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -120,7 +135,7 @@ Logger::logFatalError(const String& message, const char* filename, int fileline,
 {
 	if (m_logLevel >= E_FATAL_ERROR_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_FATAL_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_FATAL_ERROR_LEVEL, STR_FATAL_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -130,7 +145,7 @@ Logger::logError(const String& message, const char* filename, int fileline, cons
 {
 	if (m_logLevel >= E_ERROR_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_ERROR_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_ERROR_LEVEL, STR_ERROR_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -140,7 +155,7 @@ Logger::logWarning(const String& message, const char* filename, int fileline, co
 {
 	if (m_logLevel >= E_WARNING_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_WARNING_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_WARNING_LEVEL, STR_WARNING_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -150,7 +165,7 @@ Logger::logInfo(const String& message, const char* filename, int fileline, const
 {
 	if (m_logLevel >= E_INFO_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_INFO_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_INFO_LEVEL, STR_INFO_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -160,7 +175,7 @@ Logger::logDebug(const String& message, const char* filename, int fileline, cons
 {
 	if (m_logLevel >= E_DEBUG_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_DEBUG_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_DEBUG_LEVEL, STR_DEBUG_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -170,7 +185,7 @@ Logger::logDebug2(const String& message, const char* filename, int fileline, con
 {
 	if (m_logLevel >= E_DEBUG2_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_DEBUG2_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_DEBUG2_LEVEL, STR_DEBUG2_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -180,7 +195,7 @@ Logger::logDebug3(const String& message, const char* filename, int fileline, con
 {
 	if (m_logLevel >= E_DEBUG3_LEVEL)
 	{
-		processLogMessage( LogMessage(m_defaultComponent, STR_DEBUG3_CATEGORY, message, filename, fileline, methodname) );
+		logLevelMessage(E_DEBUG3_LEVEL, STR_DEBUG3_CATEGORY, message, filename, fileline, methodname);
 	}
 }
 
@@ -202,14 +217,18 @@ Logger::logMessage(const String& component, const String& category, const String
 void
 Logger::logMessage(const String& category, const String& message) const
 {
-	processLogMessage(LogMessage(m_defaultComponent, category, message, 0, -1, 0));
+	logMessage(category, message, 0, -1, 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 void
 Logger::logMessage(const String& category, const String& message, const char* filename, int fileline, const char* methodname) const
 {
-	processLogMessage(LogMessage(m_defaultComponent, category, message, filename, fileline, methodname));
+	// Pass the ids along so the appender can filter with them.  If category
+	// was never interned no appender names it, and the appender falls back
+	// to the names.
+	processLogMessage(LogMessage(m_defaultComponent, category, message, filename, fileline, methodname,
+		m_defaultComponentId, LogCategoryId::find(category)));
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -225,6 +244,7 @@ Logger::setDefaultComponent(const String& component)
 {
 	BLOCXX_ASSERT(component != "");
 	m_defaultComponent = component;
+	m_defaultComponentId = LogComponentId(component);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -338,6 +358,19 @@ Logger::componentAndCategoryAreEnabled(const String& component, const String& ca
 	return m_appender->componentAndCategoryAreEnabled(component, category);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+void
+Logger::logLevelMessage(ELogLevel level, const String& category, const String& message, const char* filename, int fileline, const char* methodname) const
+{
+	// Check the appender's filter before building the LogMessage, so a
+	// filtered out message costs two bitset lookups and nothing else.
+	LogCategoryId categoryId(LogCategoryId::forLevel(level));
+	if (m_appender->componentAndCategoryAreEnabled(m_defaultComponentId, categoryId))
+	{
+		processLogMessage( LogMessage(m_defaultComponent, category, message, filename, fileline, methodname, m_defaultComponentId, categoryId) );
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////
 void
 Logger::processLogMessage(const LogMessage& message) const
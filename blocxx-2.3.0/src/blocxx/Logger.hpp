@@ -43,6 +43,7 @@
 #include "blocxx/IntrusiveCountableBase.hpp"
 #include "blocxx/Exception.hpp"
 #include "blocxx/LogAppender.hpp"
+#include "blocxx/LogSymbol.hpp"
 #include "blocxx/GlobalString.hpp"
 #include <cerrno>
 
@@ -118,6 +119,9 @@ public:
 
 	Logger(const Logger&);
 	Logger& operator=(const Logger&);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	Logger& operator=(Logger&&) BLOCXX_NOEXCEPT;
+#endif
 	void swap(Logger& x);
 	virtual ~Logger();
 
@@ -314,11 +318,15 @@ public:
 
 private:
 	void processLogMessage(const LogMessage& message) const;
+	void logLevelMessage(ELogLevel level, const String& category, const String& message, const char* filename, int fileline, const char* methodname) const;
 
 protected: // data
 	String m_defaultComponent;
 	LogAppenderRef m_appender;
 	ELogLevel m_logLevel;
+	// m_defaultComponent, interned once so that the per-message component
+	// check is a bitset lookup.
+	LogComponentId m_defaultComponentId;
 
 	/** \example loggers.cpp */
 };
@@ -347,7 +355,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_DEBUG3_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_DEBUG3_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logDebug3((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -365,7 +373,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_DEBUG2_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_DEBUG2_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logDebug2((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -383,7 +391,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_DEBUG_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_DEBUG_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logDebug((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -401,7 +409,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_INFO_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_INFO_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logInfo((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -418,7 +426,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_WARNING_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_WARNING_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logWarning((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -435,7 +443,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_ERROR_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_ERROR_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logError((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -452,7 +460,7 @@ do \
 	int err = errno; \
 	if (::BLOCXX_NAMESPACE::Logger::asLogger((logger)).getLogLevel() >= ::BLOCXX_NAMESPACE::E_FATAL_ERROR_LEVEL) \
 	{ \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_FATAL_CATEGORY, (message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logFatalError((message), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -493,7 +501,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_DEBUG3_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logDebug3(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -516,7 +524,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_DEBUG2_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logDebug2(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -539,7 +547,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_DEBUG_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logDebug(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -562,7 +570,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_INFO_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logInfo(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -585,7 +593,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_WARNING_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logWarning(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -608,7 +616,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_ERROR_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logError(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
@@ -630,7 +638,7 @@ do \
 	{ \
 		OStringStream buf; \
 		buf << message; \
-		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logMessage(::BLOCXX_NAMESPACE::Logger::STR_FATAL_CATEGORY, buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
+		::BLOCXX_NAMESPACE::Logger::asLogger((logger)).logFatalError(buf.toString(), __FILE__, __LINE__, BLOCXX_LOGGER_PRETTY_FUNCTION); \
 	} \
 	errno = err; \
 } while (0)
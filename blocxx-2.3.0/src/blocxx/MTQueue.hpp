@@ -41,7 +41,10 @@
 #include "blocxx/NonRecursiveMutexLock.hpp"
 #include "blocxx/Timeout.hpp"
 #include "blocxx/Types.hpp"
+#include <algorithm> // for std::min
 #include <deque>
+#include <utility> // for std::move
+#include <vector>
 
 namespace BLOCXX_NAMESPACE
 {
@@ -151,6 +154,41 @@ public:
 		}
 	}
 
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Like pushBack(const T&), but moves val into the queue.
+	 */
+	void pushBack(T&& val)
+	{
+		NonRecursiveMutexLock lock(m_mutex);
+		enterPushBack(lock);
+		if (!m_shutdown)
+		{
+			m_deque.push_back(std::move(val));
+		}
+	}
+#endif
+
+	/**
+	 * Add the items in [first, last) to the back of the queue in order,
+	 * taking the lock once instead of once per item.  Blocks whenever the
+	 * queue is full, like pushBack().  Stops if shutdown() is called.
+	 */
+	template <typename InputIterator>
+	void pushBackBatch(InputIterator first, InputIterator last)
+	{
+		NonRecursiveMutexLock lock(m_mutex);
+		for (; first != last; ++first)
+		{
+			enterPushBack(lock);
+			if (m_shutdown)
+			{
+				break;
+			}
+			m_deque.push_back(*first);
+		}
+	}
+
 	/**
 	 * If the queue is not empty, remove one element from the front
 	 * of the queue, otherwise wait until timeout for pushBack() to be
@@ -171,6 +209,31 @@ public:
 		return rv;
 	}
 
+	/**
+	 * Like popFront(), but once an item is available, also removes up to
+	 * maxItems - 1 more that are already in the queue, taking the lock only
+	 * once.  The items are appended to values.
+	 * @pre maxItems > 0
+	 */
+	EPopResult popFrontBatch(Timeout const & timeout, std::size_t maxItems, std::vector<T> & values)
+	{
+		NonRecursiveMutexLock lock(m_mutex);
+		EPopResult rv = enterPopFront(lock, timeout);
+		if (rv == MTQueueEnum::E_VALUE)
+		{
+			std::size_t n = std::min(maxItems, m_deque.size());
+			values.insert(values.end(), m_deque.begin(), m_deque.begin() + n);
+			m_deque.erase(m_deque.begin(), m_deque.begin() + n);
+			// enterPopFront() only woke one pusher, but there may now be
+			// room for more.
+			if (n > 1 && m_pushesBlocked > 0)
+			{
+				m_cond.notifyAll();
+			}
+		}
+		return rv;
+	}
+
 private:
 	// non-copyable
 	MTQueue(const MTQueue&) BLOCXX_FUNCTION_NOT_IMPLEMENTED;
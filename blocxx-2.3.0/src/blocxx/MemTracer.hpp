@@ -45,6 +45,10 @@
 
 #include <new> // for std::bad_alloc
 
+// Memory debug mode tracks every allocation behind one global mutex to catch
+// leaks and overruns, which makes it too slow to leave on.  To find out where
+// a running process allocates, use HeapProfiler instead.
+
 void* operator new(std::size_t size) throw (std::bad_alloc);
 void* operator new[](std::size_t size) throw (std::bad_alloc);
 void* operator new(std::size_t size, char const* file, int line) throw (std::bad_alloc);
@@ -82,6 +82,51 @@ inline void readWriteMemoryBarrier()
 #endif
 }
 
+/**
+ * The GCC __atomic builtins (GCC 4.7 and later, and clang) give loads and
+ * stores with only the ordering that's needed, instead of a full barrier.
+ */
+#if defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7)))
+#define BLOCXX_HAVE_GCC_ATOMIC_BUILTINS 1
+#endif
+
+/**
+ * Read x so that no reads or writes after it can be done before it.  Used
+ * with releaseStore() to publish data to other threads: anything written
+ * before the releaseStore() is visible after an acquireLoad() that sees the
+ * stored value.  On x86 and x86-64 this is a plain load; on other
+ * architectures it's a load followed by the lightest barrier that works.
+ *
+ * Like readWriteMemoryBarrier(), this is solely for the use of libblocxx
+ * threading primitives.
+ */
+template <typename T>
+inline T acquireLoad(const volatile T& x)
+{
+#if defined(BLOCXX_HAVE_GCC_ATOMIC_BUILTINS)
+	return __atomic_load_n(&x, __ATOMIC_ACQUIRE);
+#else
+	T rv = x;
+	readWriteMemoryBarrier();
+	return rv;
+#endif
+}
+
+/**
+ * Write val to x so that no reads or writes before it can be done after it.
+ * @see acquireLoad()
+ */
+template <typename T>
+inline void releaseStore(volatile T& x, T val)
+{
+#if defined(BLOCXX_HAVE_GCC_ATOMIC_BUILTINS)
+	__atomic_store_n(&x, val, __ATOMIC_RELEASE);
+#else
+	readWriteMemoryBarrier();
+	x = val;
+#endif
+}
+
 } // end namespace BLOCXX_NAMESPACE
 
 
@@ -47,8 +47,31 @@
 #ifdef BLOCXX_HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#ifdef BLOCXX_HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#include <cerrno>
+#include <cstring>
 #include <vector>
 
+// Paths are walked with openat() and fstat() relative to the descriptor of
+// the directory being looked in, rather than by lstat()ing each prefix of
+// the path.  That takes one directory lookup per component instead of one
+// per prefix component, and no component can be swapped out between being
+// checked and being walked through.  O_PATH (Linux) is needed to open
+// directories that can't be read, and symbolic links themselves.
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_OPENAT) \
+	&& defined(BLOCXX_HAVE_READLINKAT) && defined(O_PATH) \
+	&& defined(O_NOFOLLOW) && defined(O_CLOEXEC)
+#define BLOCXX_PATH_SECURITY_USE_OPENAT
+#include "blocxx/AutoDescriptor.hpp"
+#include "blocxx/FileSystemMockObject.hpp"
+#include "blocxx/LazyGlobal.hpp"
+#include "blocxx/Mutex.hpp"
+#include "blocxx/MutexLock.hpp"
+#include "blocxx/PosixFileSystem.hpp"
+#endif
+
 namespace BLOCXX_NAMESPACE
 {
 
@@ -116,6 +139,18 @@ namespace
 		// a terminating '\0' character).
 		void read_symlink(std::vector<char> & path);
 
+#ifdef BLOCXX_PATH_SECURITY_USE_OPENAT
+		// Opens the resolved part, which must be a directory.
+		// RETURNS: the descriptor, or -1 with errno set.
+		int open_resolved() const;
+
+		// Opens the last component of the resolved part relative to dirfd,
+		// the directory containing it, without following symbolic links.
+		// RETURNS: the descriptor, or -1 with errno set.
+		// REQUIRE: resolved part is not "/".
+		int openat_last(int dirfd) const;
+#endif
+
 	private:
 
 		// INVARIANT: Holds an absolute path with no duplicate '/' chars,
@@ -283,6 +318,306 @@ namespace
 		path.swap(buf);
 	}
 
+#ifdef BLOCXX_PATH_SECURITY_USE_OPENAT
+	int PartiallyResolvedPath::open_resolved() const
+	{
+		NullTerminate x(m_resolved);
+		return ::open(&m_resolved[0], O_PATH | O_DIRECTORY | O_CLOEXEC);
+	}
+
+	int PartiallyResolvedPath::openat_last(int dirfd) const
+	{
+		BLOCXX_ASSERT(m_resolved.size() > 1);
+		NullTerminate x(m_resolved);
+		char const * last = std::strrchr(&m_resolved[0], '/') + 1;
+		return ::openat(dirfd, last, O_PATH | O_NOFOLLOW | O_CLOEXEC);
+	}
+#endif
+
+	// Looks path components up by name, through FileSystem, so that a
+	// FileSystemMockObject sees the lookups.
+	class NameLookup
+	{
+	public:
+		void start(PartiallyResolvedPath const &)
+		{
+		}
+
+		FileInformation stat_resolved(PartiallyResolvedPath const & prp)
+		{
+			return prp.lstat_resolved();
+		}
+
+		FileInformation stat_last(PartiallyResolvedPath const & prp)
+		{
+			return prp.lstat_resolved();
+		}
+
+		void enter_last()
+		{
+		}
+
+		void read_last_symlink(PartiallyResolvedPath & prp, std::vector<char> & path)
+		{
+			prp.read_symlink(path);
+		}
+
+		void pop_resolved(PartiallyResolvedPath & prp)
+		{
+			prp.pop_resolved();
+		}
+
+		void reset_resolved(PartiallyResolvedPath & prp)
+		{
+			prp.reset_resolved();
+		}
+	};
+
+#ifdef BLOCXX_PATH_SECURITY_USE_OPENAT
+	// Targets of recently read symbolic links.  A link's target can't be
+	// changed in place, so an entry is only used for a link with the same
+	// device, inode, size, mtime and ctime as the one it was read from.
+	class SymlinkCache
+	{
+	public:
+		SymlinkCache();
+
+		// RETURNS: true iff the target of the link described by st was found.
+		bool find(struct stat const & st, std::vector<char> & target);
+
+		void store(struct stat const & st, std::vector<char> const & target);
+
+	private:
+		struct Entry
+		{
+			Entry();
+
+			bool matches(struct stat const & st) const;
+
+			dev_t dev;
+			ino_t ino;
+			off_t size;
+			struct timespec mtime;
+			struct timespec ctime;
+			std::vector<char> target; // empty if unused
+		};
+
+		static Entry & slot(Entry * entries, struct stat const & st);
+
+		enum { E_NUM_ENTRIES = 64 };
+
+		Mutex m_guard;
+		Entry m_entries[E_NUM_ENTRIES];
+	};
+
+	SymlinkCache::Entry::Entry()
+	: dev(0)
+	, ino(0)
+	, size(0)
+	, target()
+	{
+		std::memset(&mtime, 0, sizeof(mtime));
+		std::memset(&ctime, 0, sizeof(ctime));
+	}
+
+	bool SymlinkCache::Entry::matches(struct stat const & st) const
+	{
+		return !target.empty() && dev == st.st_dev && ino == st.st_ino &&
+			size == st.st_size &&
+			mtime.tv_sec == st.st_mtim.tv_sec && mtime.tv_nsec == st.st_mtim.tv_nsec &&
+			ctime.tv_sec == st.st_ctim.tv_sec && ctime.tv_nsec == st.st_ctim.tv_nsec;
+	}
+
+	SymlinkCache::SymlinkCache()
+	{
+	}
+
+	SymlinkCache::Entry & SymlinkCache::slot(Entry * entries, struct stat const & st)
+	{
+		UInt32 h = UInt32(st.st_ino) ^ UInt32(UInt64(st.st_ino) >> 32) ^ UInt32(st.st_dev);
+		// Fibonacci hashing; the top 6 bits index the 64 entries.
+		return entries[(h * 2654435761U) >> 26];
+	}
+
+	bool SymlinkCache::find(struct stat const & st, std::vector<char> & target)
+	{
+		MutexLock lock(m_guard);
+		Entry & e = slot(m_entries, st);
+		if (!e.matches(st))
+		{
+			return false;
+		}
+		target = e.target;
+		return true;
+	}
+
+	void SymlinkCache::store(struct stat const & st, std::vector<char> const & target)
+	{
+		MutexLock lock(m_guard);
+		Entry & e = slot(m_entries, st);
+		e.dev = st.st_dev;
+		e.ino = st.st_ino;
+		e.size = st.st_size;
+		e.mtime = st.st_mtim;
+		e.ctime = st.st_ctim;
+		e.target = target;
+	}
+
+	DefaultConstructedLazyGlobal<SymlinkCache>::type g_symlinkCache = BLOCXX_LAZY_GLOBAL_DEFAULT_INIT;
+
+	// Looks path components up relative to the descriptor of the directory
+	// containing them.  Holds a descriptor for each directory in the
+	// resolved part of the path, from the directory the walk started at
+	// (or was reset to) down; if ".." climbs above that directory, its
+	// parent is opened by name.
+	class DescriptorLookup
+	{
+	public:
+		DescriptorLookup();
+		~DescriptorLookup();
+
+		// Opens the resolved part of prp, which the walk starts from.
+		void start(PartiallyResolvedPath const & prp);
+
+		FileInformation stat_resolved(PartiallyResolvedPath const & prp);
+
+		// Opens and stats the last component of prp's resolved part, in the
+		// current directory.
+		FileInformation stat_last(PartiallyResolvedPath const & prp);
+
+		// The last component opened by stat_last(), a directory, becomes the
+		// current directory.
+		void enter_last();
+
+		// REQUIRE: the last component opened by stat_last() is a symbolic link.
+		void read_last_symlink(PartiallyResolvedPath & prp, std::vector<char> & path);
+
+		void pop_resolved(PartiallyResolvedPath & prp);
+
+		void reset_resolved(PartiallyResolvedPath & prp);
+
+	private:
+		// noncopyable
+		DescriptorLookup(DescriptorLookup const &);
+		DescriptorLookup & operator=(DescriptorLookup const &);
+
+		void close_dirs();
+
+		std::vector<int> m_dirs;
+		AutoDescriptor m_last;
+		struct stat m_lastStat;
+	};
+
+	DescriptorLookup::DescriptorLookup()
+	: m_dirs()
+	, m_last()
+	{
+		m_dirs.reserve(16);
+	}
+
+	DescriptorLookup::~DescriptorLookup()
+	{
+		close_dirs();
+	}
+
+	void DescriptorLookup::close_dirs()
+	{
+		for (std::size_t i = 0; i < m_dirs.size(); ++i)
+		{
+			::close(m_dirs[i]);
+		}
+		m_dirs.clear();
+	}
+
+	void DescriptorLookup::start(PartiallyResolvedPath const & prp)
+	{
+		close_dirs();
+		AutoDescriptor fd(prp.open_resolved());
+		if (fd.get() < 0)
+		{
+			BLOCXX_THROW_ERRNO_MSG(FileSystemException, prp.get_resolved());
+		}
+		m_dirs.push_back(fd.get());
+		fd.release();
+	}
+
+	FileInformation DescriptorLookup::stat_resolved(PartiallyResolvedPath const & prp)
+	{
+		struct stat st;
+		if (::fstat(m_dirs.back(), &st) != 0)
+		{
+			BLOCXX_THROW_ERRNO_MSG(FileSystemException, prp.get_resolved());
+		}
+		return FileSystem::statToFileInfo(st);
+	}
+
+	FileInformation DescriptorLookup::stat_last(PartiallyResolvedPath const & prp)
+	{
+		m_last.reset(prp.openat_last(m_dirs.back()));
+		if (m_last.get() < 0 || ::fstat(m_last.get(), &m_lastStat) != 0)
+		{
+			BLOCXX_THROW_ERRNO_MSG(FileSystemException, prp.get_resolved());
+		}
+		return FileSystem::statToFileInfo(m_lastStat);
+	}
+
+	void DescriptorLookup::enter_last()
+	{
+		m_dirs.push_back(m_last.get());
+		m_last.release();
+	}
+
+	void DescriptorLookup::read_last_symlink(
+		PartiallyResolvedPath & prp, std::vector<char> & path)
+	{
+		SymlinkCache & cache = g_symlinkCache;
+		if (cache.find(m_lastStat, path))
+		{
+			return;
+		}
+		// st_size is 0 for some links in /proc
+		std::vector<char> buf(m_lastStat.st_size > 0 ? m_lastStat.st_size + 1 : 256);
+		for (;;)
+		{
+			// An empty path reads the link open as m_last (O_PATH).
+			ssize_t len = ::readlinkat(m_last.get(), "", &buf[0], buf.size());
+			if (len < 0)
+			{
+				BLOCXX_THROW_ERRNO_MSG(FileSystemException, prp.get_resolved());
+			}
+			if (std::size_t(len) < buf.size())
+			{
+				buf.resize(len + 1);
+				buf[len] = '\0';
+				break;
+			}
+			buf.resize(buf.size() * 2);
+		}
+		path.swap(buf);
+		cache.store(m_lastStat, path);
+	}
+
+	void DescriptorLookup::pop_resolved(PartiallyResolvedPath & prp)
+	{
+		prp.pop_resolved();
+		if (m_dirs.size() > 1)
+		{
+			::close(m_dirs.back());
+			m_dirs.pop_back();
+		}
+		else
+		{
+			start(prp);
+		}
+	}
+
+	void DescriptorLookup::reset_resolved(PartiallyResolvedPath & prp)
+	{
+		prp.reset_resolved();
+		start(prp);
+	}
+#endif
+
 	char const * strip_leading_slashes(char const * path)
 	{
 		while (*path == '/')
@@ -351,6 +686,11 @@ namespace
 
 	void takeSecurityAction(path_results_t const & results, const ::uid_t uid, ESecurityLoggingAction loggingAction)
 	{
+		// Nothing is formatted (or looked up) unless something was insecure.
+		if (results.empty())
+		{
+			return;
+		}
 		switch(loggingAction)
 		{
 		case E_SECURITY_DO_NOTHING:
@@ -361,10 +701,11 @@ namespace
 		}
 	}
 
+	template <typename Lookup>
 	std::pair<ESecurity, String>
-	path_security(
-		char const * base_dir, char const * rel_path, ::uid_t uid, bool bdsecure,
-		ESecurityLoggingAction loggingAction
+	walk_path(
+		Lookup & lookup, char const * base_dir, char const * rel_path,
+		::uid_t uid, bool bdsecure, ESecurityLoggingAction loggingAction
 	)
 	{
 		BLOCXX_ASSERT(base_dir[0] == '/');
@@ -383,6 +724,7 @@ namespace
 			prp = base_dir;
 		}
 #endif
+		lookup.start(prp);
 		ESecurity status_if_secure = E_SECURE_DIR;
 		unsigned num_symbolic_links = 0;
 		EFileStatusReturn file_status(E_FILE_BAD_OTHER);
@@ -392,7 +734,7 @@ namespace
 		// This handles the case where there are no unresolved items in the path (only possible for '/')
 		if( prp.unresolved_empty() )
 		{
-			st = prp.lstat_resolved();
+			st = lookup.stat_resolved(prp);
 			file_status = getFileStatus(st, uid, true, rel_path);
 		}
 		while (!prp.unresolved_empty())
@@ -404,13 +746,18 @@ namespace
 			else if (prp.unresolved_starts_with_parent())
 			{
 				prp.pop_unresolved();
-				prp.pop_resolved();
+				lookup.pop_resolved(prp);
 			}
 			else
 			{
 				prp.xfer_component();
-				st = prp.lstat_resolved();
+				st = lookup.stat_last(prp);
+#ifdef BLOCXX_WIN32
 				file_status = getFileStatus(st, uid, prp.unresolved_empty(), prp.get_resolved());
+#else
+				// The POSIX check doesn't need the path, so don't build it.
+				file_status = getFileStatus(st, uid, prp.unresolved_empty(), String());
+#endif
 
 				if (file_status != E_FILE_OK)
 				{
@@ -434,12 +781,12 @@ namespace
 							FileSystemException, prp.get_resolved(), ELOOP);
 					}
 					std::vector<char> slpath_vec;
-					prp.read_symlink(slpath_vec);
+					lookup.read_last_symlink(prp, slpath_vec);
 
 					char const * slpath = &slpath_vec[0];
 					if (slpath[0] == '/')
 					{
-						prp.reset_resolved();
+						lookup.reset_resolved(prp);
 						slpath = strip_leading_slashes(slpath);
 					}
 					else
@@ -448,7 +795,11 @@ namespace
 					}
 					prp.multi_push_unresolved(slpath);
 				}
-				else if (st.type != FileInformation::E_FILE_DIRECTORY)
+				else if (st.type == FileInformation::E_FILE_DIRECTORY)
+				{
+					lookup.enter_last();
+				}
+				else
 				{
 					String msg = prp.get_resolved() +
 						" is not a directory, symbolic link, nor regular file";
@@ -462,6 +813,23 @@ namespace
 		return std::make_pair(sec, prp.get_resolved());
 	}
 
+	std::pair<ESecurity, String>
+	path_security(
+		char const * base_dir, char const * rel_path, ::uid_t uid, bool bdsecure,
+		ESecurityLoggingAction loggingAction
+	)
+	{
+#ifdef BLOCXX_PATH_SECURITY_USE_OPENAT
+		if (!FileSystem::mockObjectIsInstalled())
+		{
+			DescriptorLookup lookup;
+			return walk_path(lookup, base_dir, rel_path, uid, bdsecure, loggingAction);
+		}
+#endif
+		NameLookup lookup;
+		return walk_path(lookup, base_dir, rel_path, uid, bdsecure, loggingAction);
+	}
+
 	std::pair<ESecurity, String> path_security(char const * path, UserId uid, ESecurityLoggingAction loggingAction)
 	{
 		if(!isPathAbsolute(path))
@@ -386,6 +386,7 @@ PerlRegEx::execute(MatchArray &sub, const String &str,
 	if( m_ecode > 0)
 	{
 		sub.resize(count); // as specified by user
+		MatchArray::iterator out = sub.mutableView().first;
 		for(size_t i = 0, n = 0; i < count; i++, n += 2)
 		{
 			match_t  m = { vsub[n], vsub[n+1] };
@@ -394,7 +395,7 @@ PerlRegEx::execute(MatchArray &sub, const String &str,
 			if( i >= (size_t)m_ecode)
 				m.rm_so = m.rm_eo = -1;
 
-			sub[i] = m;
+			out[i] = m;
 		}
 		m_error.erase();
 		return true;
@@ -458,13 +459,14 @@ PerlRegEx::execute(MatchVector &sub, const String &str,
 		count   *= 2;
 		m_ecode *= 2;
 		sub.resize(count); // as specified by user
+		MatchVector::iterator out = sub.mutableView().first;
 		for(size_t i = 0; i < count; i++)
 		{
 			// if user wants more than detected
 			if( i >= (size_t)m_ecode)
 				vsub[i] = -1;
 
-			sub[i] = vsub[i];
+			out[i] = vsub[i];
 		}
 		return true;
 	}
@@ -47,6 +47,9 @@
 #include "blocxx/Paths.hpp"
 #include "blocxx/TimeoutTimer.hpp"
 #include "blocxx/Select.hpp"
+#include "blocxx/Environ.hpp"
+
+#include <typeinfo>
 
 extern "C"
 {
@@ -65,6 +68,12 @@ extern "C"
 #include <errno.h>
 #include <stdio.h> // for perror
 #include <signal.h>
+#ifdef BLOCXX_GNU_LINUX
+#include <sys/syscall.h>
+#endif
+#ifdef BLOCXX_HAVE_SPAWN_H
+#include <spawn.h>
+#endif
 }
 
 #include <limits>
@@ -79,6 +88,13 @@ extern "C"
 #undef sigemptyset
 #endif // sigemptyset
 
+// posix_spawn() is only used when the child can be kept from inheriting
+// stray descriptors, which needs posix_spawn_file_actions_addclosefrom_np().
+#if defined(BLOCXX_HAVE_SPAWN_H) && defined(BLOCXX_HAVE_POSIX_SPAWN) \
+	&& defined(BLOCXX_HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP)
+#define BLOCXX_USE_POSIX_SPAWN
+#endif
+
 #ifdef BLOCXX_NCR
 #if defined(sigaction)
 #undef sigaction
@@ -178,6 +194,78 @@ namespace // anonymous
 		return maxOpen;
 	}
 
+#ifdef BLOCXX_GNU_LINUX
+	// Marks every descriptor above stderr close-on-exec in a single call.
+	// Needs Linux 5.11; returns false if the kernel doesn't support it.
+	bool closeRangeOnExec()
+	{
+#ifdef SYS_close_range
+		const unsigned int CLOSE_RANGE_CLOEXEC_FLAG = 1U << 2;
+		return ::syscall(SYS_close_range, 3U, ~0U, CLOSE_RANGE_CLOEXEC_FLAG) == 0;
+#else
+		return false;
+#endif
+	}
+
+	// Walks /proc/self/fd so that only descriptors which are actually open
+	// get touched, rather than every possible one up to RLIMIT_NOFILE.  This
+	// runs between fork() and exec(), so it uses raw system calls and a stack
+	// buffer instead of opendir()/readdir(), which may allocate.
+	bool procFdsOnExec(std::vector<bool> const & keep)
+	{
+		int dirfd = ::open("/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (dirfd < 0)
+		{
+			return false;
+		}
+		struct linux_dirent64
+		{
+			unsigned long long d_ino;
+			long long d_off;
+			unsigned short d_reclen;
+			unsigned char d_type;
+			char d_name[1];
+		};
+		long buf[1024 / sizeof(long)];
+		char * const cbuf = reinterpret_cast<char *>(buf);
+		for (;;)
+		{
+			long nread = ::syscall(SYS_getdents64, dirfd, cbuf, sizeof(buf));
+			if (nread < 0)
+			{
+				::close(dirfd);
+				return false;
+			}
+			if (nread == 0)
+			{
+				break;
+			}
+			for (long pos = 0; pos < nread; )
+			{
+				linux_dirent64 const * ent = reinterpret_cast<linux_dirent64 const *>(cbuf + pos);
+				pos += ent->d_reclen;
+				char const * name = ent->d_name;
+				if (*name < '0' || *name > '9')
+				{
+					continue; // "." and ".."
+				}
+				int d = 0;
+				for (; *name >= '0' && *name <= '9'; ++name)
+				{
+					d = d * 10 + (*name - '0');
+				}
+				if (d < 3 || d == dirfd || (size_t(d) < keep.size() && keep[d]))
+				{
+					continue;
+				}
+				close_on_exec(d, true);
+			}
+		}
+		::close(dirfd);
+		return true;
+	}
+#endif
+
 	void init_child(char const * exec_path,
 		char const * const argv[], char const * const envp[],
 		Exec::PreExec & pre_exec, UnnamedPipe* ppipe[Exec::Impl::BLOCXX_NPIPE])
@@ -289,6 +377,17 @@ void PreExec::resetSignals()
 
 void PreExec::closeDescriptorsOnExec(std::vector<bool> const & keep)
 {
+#ifdef BLOCXX_GNU_LINUX
+	bool keepAny = false;
+	for (size_t d = 3; d < keep.size() && !keepAny; ++d)
+	{
+		keepAny = keep[d];
+	}
+	if ((!keepAny && closeRangeOnExec()) || procFdsOnExec(keep))
+	{
+		return;
+	}
+#endif
 	long numd = m_max_descriptors ? m_max_descriptors : getMaxOpenFiles();
 	for (int d = 3; d < int(numd); ++d) // Don't close standard descriptors
 	{
@@ -405,6 +504,116 @@ void SystemPreExec::call(pipe_pointer_t const pparr[])
 	PreExec::closeDescriptorsOnExec(empty);
 }
 
+#ifdef BLOCXX_USE_POSIX_SPAWN
+namespace
+{
+	struct SpawnFileActions
+	{
+		posix_spawn_file_actions_t fa;
+		SpawnFileActions() { ::posix_spawn_file_actions_init(&fa); }
+		~SpawnFileActions() { ::posix_spawn_file_actions_destroy(&fa); }
+	};
+
+	struct SpawnAttr
+	{
+		posix_spawnattr_t attr;
+		SpawnAttr() { ::posix_spawnattr_init(&attr); }
+		~SpawnAttr() { ::posix_spawnattr_destroy(&attr); }
+	};
+
+	// StandardPreExec and SystemPreExec only do things posix_spawn() can
+	// express, so for them the fork() + pre_exec.call() dance (and the
+	// exec error pipe it needs) can be skipped.  Subclasses may do anything
+	// in call(), so they always take the fork() path.
+	bool canUsePosixSpawn(Exec::PreExec const & pre_exec)
+	{
+		return !pre_exec.m_daemonize &&
+			(typeid(pre_exec) == typeid(StandardPreExec) ||
+			 typeid(pre_exec) == typeid(SystemPreExec));
+	}
+
+	ProcessRef posixSpawn(char const * exec_path, char const * const argv[],
+		char const * const envp[], Exec::PreExec & pre_exec)
+	{
+		UnnamedPipeRef upipe[Exec::BLOCXX_NPIPE];
+		for (unsigned i = 0; i < Exec::BLOCXX_EXEC_ERR; ++i)
+		{
+			if (pre_exec.keepStd(i))
+			{
+				upipe[i] = UnnamedPipe::createUnnamedPipe();
+			}
+		}
+
+		SpawnFileActions fa;
+		int rc = 0;
+		// SystemPreExec leaves the standard descriptors alone; it only
+		// creates the pipes so the Process object has something to hold.
+		if (typeid(pre_exec) == typeid(StandardPreExec))
+		{
+			for (unsigned d = 0; d < 3 && rc == 0; ++d)
+			{
+				PosixUnnamedPipe * p = dynamic_cast<PosixUnnamedPipe*>(upipe[d].getPtr());
+				if (p)
+				{
+					int src = d == Exec::BLOCXX_IN ? p->getInputHandle() : p->getOutputHandle();
+					rc = ::posix_spawn_file_actions_adddup2(&fa.fa, src, d);
+				}
+				else
+				{
+					rc = ::posix_spawn_file_actions_addopen(&fa.fa, d, _PATH_DEVNULL, O_RDWR, 0);
+				}
+			}
+		}
+		if (rc == 0)
+		{
+			rc = ::posix_spawn_file_actions_addclosefrom_np(&fa.fa, 3);
+		}
+
+		// Same state PreExec::resetSignals() and setNewProcessGroup() leave
+		// behind: nothing blocked, every handler SIG_DFL, own process group.
+		SpawnAttr attr;
+		::sigset_t mask;
+		::sigemptyset(&mask);
+		if (rc == 0)
+		{
+			rc = ::posix_spawnattr_setsigmask(&attr.attr, &mask);
+		}
+		::sigfillset(&mask);
+		::sigdelset(&mask, SIGKILL);
+		::sigdelset(&mask, SIGSTOP);
+		if (rc == 0)
+		{
+			rc = ::posix_spawnattr_setsigdefault(&attr.attr, &mask);
+		}
+		if (rc == 0)
+		{
+			rc = ::posix_spawnattr_setpgroup(&attr.attr, 0);
+		}
+		if (rc == 0)
+		{
+			rc = ::posix_spawnattr_setflags(&attr.attr,
+				POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETPGROUP);
+		}
+
+		::pid_t child_pid = -1;
+		if (rc == 0)
+		{
+			rc = ::posix_spawn(&child_pid, exec_path, &fa.fa, &attr.attr,
+				const_cast<char * const *>(argv),
+				const_cast<char * const *>(envp ? envp : environ));
+		}
+		if (rc != 0)
+		{
+			BLOCXX_THROW_ERRNO_MSG1(ExecErrorException,
+				Format("Exec::spawn(%1): child startup failed: posix_spawn", exec_path).c_str(), rc);
+		}
+
+		Exec::close_child_ends(upipe);
+		return ProcessRef(new Process(upipe[0], upipe[1], upipe[2], child_pid));
+	}
+} // end anonymous namespace
+#endif
+
 ProcessRef spawnImpl(char const * exec_path, char const * const argv[], char const * const envp[],
 					 Exec::PreExec & pre_exec)
 {
@@ -426,6 +635,13 @@ ProcessRef spawnImpl(char const * exec_path, char const * const argv[], char con
 	// failing for an unreportable reason.
 	getMaxOpenFiles();
 
+#ifdef BLOCXX_USE_POSIX_SPAWN
+	if (canUsePosixSpawn(pre_exec))
+	{
+		return posixSpawn(exec_path, argv, envp, pre_exec);
+	}
+#endif
+
 	UnnamedPipeRef upipe[Exec::BLOCXX_NPIPE];
 	UnnamedPipe* ppipe[Exec::BLOCXX_NPIPE] = {0};
 
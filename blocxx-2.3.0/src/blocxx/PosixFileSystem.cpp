@@ -1402,6 +1402,11 @@ FileInformation getFileInformation(const String& filename)
 	return statToFileInfo(statbuf);
 }
 
+bool mockObjectIsInstalled()
+{
+	return g_fileSystemMockObject.get() != 0;
+}
+
 } // end namespace FileSystem
 } // end namespace BLOCXX_NAMESPACE
 
@@ -55,6 +55,12 @@ namespace BLOCXX_NAMESPACE
 		 * Convert a stat buffer into FileInformation.
 		 */
 		FileInformation statToFileInfo(const struct stat& statbuf);
+
+		/**
+		 * @return true if a FileSystemMockObject is installed, in which case
+		 * files must only be reached through the FileSystem functions.
+		 */
+		bool mockObjectIsInstalled();
 	} // end namespace FileSystem
 } // end namespace BLOCXX_NAMESPACE
 
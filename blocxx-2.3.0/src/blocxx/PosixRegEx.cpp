@@ -298,17 +298,18 @@ PosixRegEx::execute(MatchArray &sub, const String &str,
 		}
 
 		sub.resize(count);
+		MatchArray::iterator out = sub.mutableView().first;
 		for(size_t n = 0; n < count; n++)
 		{
 			if( rsub[n].rm_so < 0 || rsub[n].rm_eo < 0)
 			{
-				sub[n] = rsub[n];
+				out[n] = rsub[n];
 			}
 			else
 			{
 				rsub[n].rm_so += index;
 				rsub[n].rm_eo += index;
-				sub[n] = rsub[n];
+				out[n] = rsub[n];
 			}
 		}
 		return true;
@@ -57,6 +57,8 @@
 #include "blocxx/GlobalString.hpp"
 #include "blocxx/WaitpidThreadFix.hpp"
 #include "blocxx/System.hpp"
+#include "blocxx/ProcessReaper.hpp"
+#include "blocxx/AutoDescriptor.hpp"
 
 #ifdef BLOCXX_WIN32
 #include "blocxx/WinProcessUtils.hpp"
@@ -255,12 +257,26 @@ ProcessImpl::~ProcessImpl()
 {
 }
 
+Select_t ProcessImpl::getExitSelectObj(ProcId pid)
+{
+#ifdef BLOCXX_WIN32
+	return Select_t();
+#else
+	return BLOCXX_INVALID_HANDLE;
+#endif
+}
+
 namespace
 {
 
 class ChildProcessImpl : public ProcessImpl
 {
 public:
+	ChildProcessImpl()
+	: m_exitDescriptorPid(BLOCXX_INVALID_HANDLE)
+	{
+	}
+
 	virtual int kill(ProcId pid, int sig)
 	{
 #ifdef BLOCXX_WIN32
@@ -278,6 +294,26 @@ public:
 		}
 		return pollStatusImpl(pid);
 	}
+
+	virtual Select_t getExitSelectObj(ProcId pid)
+	{
+#ifdef BLOCXX_WIN32
+		return Select_t();
+#else
+		// Only try once per pid, so we don't retry pidfd_open() on every
+		// call if it isn't supported.
+		if (pid != m_exitDescriptorPid)
+		{
+			m_exitDescriptor = ProcessReaper::openExitDescriptor(pid);
+			m_exitDescriptorPid = pid;
+		}
+		return m_exitDescriptor.get();
+#endif
+	}
+
+private:
+	AutoDescriptor m_exitDescriptor;
+	ProcId m_exitDescriptorPid;
 };
 
 
@@ -334,7 +370,17 @@ public:
 				BLOCXX_LOG_DEBUG(lgr, Format("ZombieReaper failed to send signal to %1", m_pid));
 			}
 
-			Thread::sleep(Timeout::relative(10));
+#ifndef BLOCXX_WIN32
+			Select_t exitObj = m_impl->getExitSelectObj(m_pid);
+			if (exitObj != BLOCXX_INVALID_HANDLE)
+			{
+				ProcessReaper::waitForExit(exitObj, Timeout::relative(10));
+			}
+			else
+#endif
+			{
+				Thread::sleep(Timeout::relative(10));
+			}
 			BLOCXX_LOG_DEBUG(lgr, Format("ZombieReaper getting status for %1.", m_pid));
 			status = m_impl->pollStatus(m_pid);
 		}
@@ -449,6 +495,17 @@ ProcId Process::pid() const
 	return m_pid;
 }
 
+Select_t Process::getExitSelectObj()
+{
+#ifndef BLOCXX_WIN32
+	if (m_pid < 0)
+	{
+		return BLOCXX_INVALID_HANDLE;
+	}
+#endif
+	return m_impl->getExitSelectObj(m_pid);
+}
+
 Process::Status Process::processStatus()
 {
 	// m_pid tested in case this method is called inappropriately
@@ -558,10 +615,31 @@ void Process::waitCloseTerm(const Timeout& wait_initial, const Timeout& wait_clo
 //
 bool Process::terminatesWithin(const Timeout& wait_time)
 {
+	TimeoutTimer timer(wait_time);
+#ifndef BLOCXX_WIN32
+	// If we can be notified when the process exits, sleep until then instead
+	// of polling.
+	Select_t exitObj = m_impl->getExitSelectObj(m_pid);
+	if (exitObj != BLOCXX_INVALID_HANDLE)
+	{
+		while (!m_status.terminated())
+		{
+			ProcessReaper::EWaitResult rv = ProcessReaper::waitForExit(exitObj, timer.asAbsoluteTimeout());
+			if (rv == ProcessReaper::E_ERROR)
+			{
+				break; // fall back to polling
+			}
+			m_status = m_impl->pollStatus(m_pid);
+			if (rv == ProcessReaper::E_TIMED_OUT)
+			{
+				return m_status.terminated();
+			}
+		}
+	}
+#endif
 	float const mult = 1.20;
 	float const max_period = 5000.0; // milliseconds
 	float period = 100.0; // milliseconds
-	TimeoutTimer timer(wait_time);
 	while (!timer.expired() && !m_status.terminated())
 	{
 		Thread::sleep(static_cast<UInt32>(period));
@@ -44,6 +44,7 @@
 #include "blocxx/IntrusiveCountableBase.hpp"
 #include "blocxx/CommonFwd.hpp"
 #include "blocxx/Timeout.hpp"
+#include "blocxx/NetworkTypes.hpp"
 
 namespace BLOCXX_NAMESPACE
 {
@@ -114,6 +115,15 @@ public:
 	/// Process ID for the child process.
 	ProcId pid() const;
 
+	/**
+	* @return A descriptor which becomes readable when the child process
+	* terminates, suitable for use with Select or SelectEngine to wait for
+	* process exit together with I/O.  The descriptor is owned by this object.
+	* BLOCXX_INVALID_HANDLE is returned if the platform does not support it,
+	* in which case processStatus() must be polled.
+	*/
+	Select_t getExitSelectObj();
+
 	/// Portable process status.
 	//
 	class BLOCXX_COMMON_API Status
@@ -310,6 +320,14 @@ public:
 	 * @throws ProcessErrorException on error.
 	 */
 	virtual Process::Status pollStatus(ProcId pid) = 0;
+
+	/**
+	 * @return A descriptor which becomes readable when process @a pid
+	 * terminates, or BLOCXX_INVALID_HANDLE if status changes can only be
+	 * detected by calling pollStatus().  The descriptor remains owned by this
+	 * object.  The default implementation returns BLOCXX_INVALID_HANDLE.
+	 */
+	virtual Select_t getExitSelectObj(ProcId pid);
 };
 
 
@@ -0,0 +1,130 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/ProcessReaper.hpp"
+#include "blocxx/Select.hpp"
+
+#if defined(BLOCXX_GNU_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <cerrno>
+
+// glibc only gained a wrapper for pidfd_open() in 2.36, so use the syscall
+// directly.  The number is the same on all architectures.
+#if defined(BLOCXX_GNU_LINUX) && !defined(SYS_pidfd_open)
+#define SYS_pidfd_open 434
+#endif
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace ProcessReaper
+{
+
+namespace
+{
+	// 0 = unknown, 1 = supported, -1 = not supported.  Races on this are
+	// benign, every thread will come to the same conclusion.
+	volatile int g_pidfdSupport = 0;
+
+	Descriptor pidfdOpen(ProcId pid)
+	{
+#if defined(BLOCXX_GNU_LINUX)
+		if (g_pidfdSupport < 0)
+		{
+			return BLOCXX_INVALID_HANDLE;
+		}
+		long rv = ::syscall(SYS_pidfd_open, static_cast<long>(pid), 0L);
+		if (rv >= 0)
+		{
+			g_pidfdSupport = 1;
+			return static_cast<Descriptor>(rv);
+		}
+		if (errno == ENOSYS)
+		{
+			g_pidfdSupport = -1;
+		}
+#endif
+		return BLOCXX_INVALID_HANDLE;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+isSupported()
+{
+#if defined(BLOCXX_GNU_LINUX)
+	if (g_pidfdSupport == 0)
+	{
+		// Probe with our own pid, which always exists.
+		AutoDescriptor probe(pidfdOpen(::getpid()));
+	}
+	return g_pidfdSupport > 0;
+#else
+	return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+AutoDescriptor
+openExitDescriptor(ProcId pid)
+{
+	if (pid <= 0)
+	{
+		return AutoDescriptor();
+	}
+	return AutoDescriptor(pidfdOpen(pid));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+EWaitResult
+waitForExit(Descriptor exitDescriptor, const Timeout& timeout)
+{
+	SelectTypeArray selObjs;
+	selObjs.push_back(exitDescriptor);
+	int rv = Select::select(selObjs, timeout);
+	if (rv == Select::SELECT_TIMEOUT)
+	{
+		return E_TIMED_OUT;
+	}
+	else if (rv == Select::SELECT_ERROR)
+	{
+		return E_ERROR;
+	}
+	return E_TERMINATED;
+}
+
+} // end namespace ProcessReaper
+
+} // end namespace BLOCXX_NAMESPACE
@@ -0,0 +1,95 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_PROCESS_REAPER_HPP_INCLUDE_GUARD_
+#define BLOCXX_PROCESS_REAPER_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Types.hpp"
+#include "blocxx/AutoDescriptor.hpp"
+#include "blocxx/Timeout.hpp"
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * Event driven notification of child process termination.
+ *
+ * On Linux a process descriptor (pidfd) is used.  It becomes readable when
+ * the child terminates, so waiters sleep in the kernel until exactly that
+ * moment instead of repeatedly calling waitpid() with a growing sleep in
+ * between.  The descriptor can also be added to a Select::SelectObjectArray
+ * or a SelectEngine to wait for process exit and I/O at the same time.
+ *
+ * Waiting on the descriptor does not reap the child, so this can be used
+ * together with WaitpidThreadFix.
+ *
+ * On platforms without process descriptors the functions report that
+ * they are not supported, and the caller should fall back to polling.
+ */
+namespace ProcessReaper
+{
+	/**
+	 * @return Whether process descriptors are supported by this platform and
+	 * the running kernel.
+	 */
+	BLOCXX_COMMON_API bool isSupported();
+
+	/**
+	 * Open a descriptor that becomes readable once the child process
+	 * @a pid has terminated.
+	 * @return The descriptor, or an invalid descriptor if process
+	 * descriptors are not supported or @a pid does not exist.
+	 */
+	BLOCXX_COMMON_API AutoDescriptor openExitDescriptor(ProcId pid);
+
+	enum EWaitResult
+	{
+		/// The process has terminated.  Its status can now be retrieved with waitpid().
+		E_TERMINATED,
+		/// The timeout expired before the process terminated.
+		E_TIMED_OUT,
+		/// An error occurred waiting on the descriptor.
+		E_ERROR
+	};
+
+	/**
+	 * Wait until the process referred to by @a exitDescriptor terminates
+	 * or @a timeout expires.
+	 * @param exitDescriptor A descriptor returned by openExitDescriptor()
+	 */
+	BLOCXX_COMMON_API EWaitResult waitForExit(Descriptor exitDescriptor, const Timeout& timeout);
+
+} // end namespace ProcessReaper
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -47,6 +47,11 @@ namespace BLOCXX_NAMESPACE
 
 BLOCXX_DEFINE_EXCEPTION_WITH_ID(RWLocker);
 
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+typedef ShardedRWLockImplException RWLockImplException;
+#else
+typedef GenericRWLockImplException RWLockImplException;
+
 inline bool RWLocker::ThreadComparer::operator()(Thread_t x, Thread_t y) const
 {
 #ifdef BLOCXX_NCR
@@ -55,6 +60,7 @@ inline bool RWLocker::ThreadComparer::operator()(Thread_t x, Thread_t y) const
 	return !ThreadImpl::sameThreads(x, y) && x < y;
 #endif
 }
+#endif
 
 //////////////////////////////////////////////////////////////////////////////
 RWLocker::RWLocker()
@@ -65,30 +71,49 @@ RWLocker::~RWLocker()
 {
 }
 
+namespace
+{
+// Logging every lock operation means creating a Logger, which is far more
+// expensive than taking a read lock, so it's only done in debug builds.
+#ifdef BLOCXX_DEBUG
+void logLockEvent(const RWLocker* locker, const char* event)
+{
+	Logger logger("blocxx.RWLocker");
+	BLOCXX_LOG_DEBUG3(logger, Format("%1 %2", locker, event));
+}
+#else
+inline void logLockEvent(const RWLocker*, const char*)
+{
+}
+#endif
+} // end unnamed namespace
+
 //////////////////////////////////////////////////////////////////////////////
 void
 RWLocker::getReadLock(const Timeout& timeout)
 {
-	Thread_t tid = ThreadImpl::currentThread();
-	m_impl.acquireReadLock(tid, timeout);
-
-	Logger logger("blocxx.RWLocker");
-	BLOCXX_LOG_DEBUG3(logger, Format("%1 Acquired Read Lock.", this));
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+	m_impl.acquireReadLock(timeout);
+#else
+	m_impl.acquireReadLock(ThreadImpl::currentThread(), timeout);
+#endif
+	logLockEvent(this, "Acquired Read Lock.");
 }
 
 //////////////////////////////////////////////////////////////////////////////
 void
 RWLocker::releaseReadLock()
 {
-	Thread_t tid = ThreadImpl::currentThread();
 	try
 	{
-		m_impl.releaseReadLock(tid);
-
-		Logger logger("blocxx.RWLocker");
-		BLOCXX_LOG_DEBUG3(logger, Format("%1 Released Read Lock.", this));
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+		m_impl.releaseReadLock();
+#else
+		m_impl.releaseReadLock(ThreadImpl::currentThread());
+#endif
+		logLockEvent(this, "Released Read Lock.");
 	}
-	catch (GenericRWLockImplException& e)
+	catch (RWLockImplException& e)
 	{
 		BLOCXX_THROW_SUBEX(RWLockerException, "Cannot release a read lock when no read lock is held", e);
 	}
@@ -98,26 +123,28 @@ RWLocker::releaseReadLock()
 void
 RWLocker::getWriteLock(const Timeout& timeout)
 {
-	Thread_t tid = ThreadImpl::currentThread();
-	m_impl.acquireWriteLock(tid, timeout);
-
-	Logger logger("blocxx.RWLocker");
-	BLOCXX_LOG_DEBUG3(logger, Format("%1 Acquired Write Lock.", this));
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+	m_impl.acquireWriteLock(timeout);
+#else
+	m_impl.acquireWriteLock(ThreadImpl::currentThread(), timeout);
+#endif
+	logLockEvent(this, "Acquired Write Lock.");
 }
 
 //////////////////////////////////////////////////////////////////////////////
 void
 RWLocker::releaseWriteLock()
 {
-	Thread_t tid = ThreadImpl::currentThread();
 	try
 	{
-		m_impl.releaseWriteLock(tid);
-
-		Logger logger("blocxx.RWLocker");
-		BLOCXX_LOG_DEBUG3(logger, Format("%1 Released Write Lock.", this));
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+		m_impl.releaseWriteLock();
+#else
+		m_impl.releaseWriteLock(ThreadImpl::currentThread());
+#endif
+		logLockEvent(this, "Released Write Lock.");
 	}
-	catch (GenericRWLockImplException& e)
+	catch (RWLockImplException& e)
 	{
 		BLOCXX_THROW_SUBEX(RWLockerException, "Cannot release a write lock when no write lock is held", e);
 	}
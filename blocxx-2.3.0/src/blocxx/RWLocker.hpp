@@ -39,6 +39,7 @@
 #ifndef BLOCXX_RW_LOCKER_HPP_INCLUDE_GUARD_
 #define BLOCXX_RW_LOCKER_HPP_INCLUDE_GUARD_
 #include "blocxx/BLOCXX_config.h"
+#include "blocxx/ShardedRWLockImpl.hpp"
 #include "blocxx/GenericRWLockImpl.hpp"
 
 namespace BLOCXX_NAMESPACE
@@ -46,7 +47,8 @@ namespace BLOCXX_NAMESPACE
 
 BLOCXX_DECLARE_APIEXCEPTION(RWLocker, BLOCXX_COMMON_API);
 //////////////////////////////////////////////////////////////////////////////
-// The locker is recursive and also supports upgrading a read-lock to a write lock
+// The locker is recursive and also supports upgrading a read-lock to a write lock.
+// Taking a read lock scales with the number of reading threads.
 class BLOCXX_COMMON_API RWLocker
 {
 public:
@@ -77,6 +79,10 @@ public:
 	void releaseWriteLock();
 
 private:
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+	// Readers don't share any lock or counter, see ShardedRWLockImpl.
+	ShardedRWLockImpl m_impl;
+#else
 	// Have to do this because on some platforms one thread may have different values for
 	// a Thread_t, and ThreadImpl::sameThreads() has to be called to know if they refer
 	// to the same one.
@@ -86,6 +92,7 @@ private:
 	};
 
 	GenericRWLockImpl<Thread_t, ThreadComparer> m_impl;
+#endif
 
 	// unimplemented
 	RWLocker(const RWLocker&);
@@ -41,6 +41,7 @@
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/IntrusiveReference.hpp"
 #include "blocxx/IntrusiveCountableBase.hpp"
+#include "blocxx/SmallObjectPool.hpp"
 #include "blocxx/ThreadDoneCallback.hpp"
 #include "blocxx/CommonFwd.hpp"
 
@@ -53,8 +54,11 @@ namespace BLOCXX_NAMESPACE
  * on instances of the class to get the thread running.
  * The other method is to derive from Runnable and pass references of the
  * derived class to ThreadPool::addWork()
+ *
+ * Runnables are allocated from the SmallObjectPool, since one is usually
+ * allocated for each piece of work given to a ThreadPool.
  */
-class BLOCXX_COMMON_API Runnable : public IntrusiveCountableBase
+class BLOCXX_COMMON_API Runnable : public IntrusiveCountableBase, public PooledObject
 {
 public:
 	virtual ~Runnable();
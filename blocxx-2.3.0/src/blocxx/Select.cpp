@@ -510,6 +510,214 @@ select(const SelectTypeArray& selarray, const Timeout& timeout)
 	return SELECT_ERROR;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+namespace
+{
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_SYS_EPOLL_H)
+	UInt32 const EPOLL_READ_EVENTS = EPOLLIN | EPOLLPRI | EPOLLERR | EPOLLHUP;
+	UInt32 const EPOLL_WRITE_EVENTS = EPOLLOUT | EPOLLERR | EPOLLHUP;
+
+	int epollControl(int epfd, int op, const SelectObject& so, size_t slot)
+	{
+		epoll_event ev;
+		ev.data = epoll_data_t(); // zero-init to make valgrind happy
+		ev.data.u32 = slot;
+		ev.events = (so.waitForRead ? EPOLL_READ_EVENTS : 0) | (so.waitForWrite ? EPOLL_WRITE_EVENTS : 0);
+		return epoll_ctl(epfd, op, so.s, &ev);
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+SelectSet::SelectSet()
+	: m_numInUse(0)
+	, m_epfd(-1)
+{
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_SYS_EPOLL_H)
+	// If this fails (e.g. ENOSYS) selectRW() falls back to Select::selectRW().
+	m_epfd = epoll_create(16);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+SelectSet::~SelectSet()
+{
+#if !defined(BLOCXX_WIN32)
+	if (m_epfd != -1)
+	{
+		::close(m_epfd);
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t
+SelectSet::add(Select_t s, bool waitForRead, bool waitForWrite)
+{
+	size_t slot = 0;
+	while (slot < m_inUse.size() && m_inUse[slot])
+	{
+		++slot;
+	}
+	if (slot == m_objs.size())
+	{
+		m_objs.push_back(SelectObject(s));
+		m_inUse.push_back(true);
+	}
+	else
+	{
+		m_objs[slot] = SelectObject(s);
+		m_inUse[slot] = true;
+	}
+	++m_numInUse;
+	m_objs[slot].waitForRead = waitForRead;
+	m_objs[slot].waitForWrite = waitForWrite;
+
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_SYS_EPOLL_H)
+	if (m_epfd != -1 && (waitForRead || waitForWrite) &&
+		epollControl(m_epfd, EPOLL_CTL_ADD, m_objs[slot], slot) != 0)
+	{
+		// Some descriptors (e.g. regular files) can't be used with epoll.
+		// Switch the whole set over to the fallback.
+		::close(m_epfd);
+		m_epfd = -1;
+	}
+#endif
+	return slot;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+SelectSet::modify(size_t slot, bool waitForRead, bool waitForWrite)
+{
+	BLOCXX_ASSERT(slot < m_objs.size() && m_inUse[slot]);
+	SelectObject& so = m_objs[slot];
+	if (so.waitForRead == waitForRead && so.waitForWrite == waitForWrite)
+	{
+		return;
+	}
+	// Objects that aren't waited on are kept out of the epoll set entirely,
+	// otherwise a hangup on them would wake every call.
+	bool wasRegistered = so.waitForRead || so.waitForWrite;
+	bool isRegistered = waitForRead || waitForWrite;
+	so.waitForRead = waitForRead;
+	so.waitForWrite = waitForWrite;
+	so.readAvailable = so.readAvailable && waitForRead;
+	so.writeAvailable = so.writeAvailable && waitForWrite;
+
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_SYS_EPOLL_H)
+	int op = !isRegistered ? EPOLL_CTL_DEL : wasRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+	if (m_epfd != -1 && epollControl(m_epfd, op, so, slot) != 0)
+	{
+		::close(m_epfd);
+		m_epfd = -1;
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+SelectSet::remove(size_t slot)
+{
+	BLOCXX_ASSERT(slot < m_objs.size() && m_inUse[slot]);
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_SYS_EPOLL_H)
+	if (m_epfd != -1 && (m_objs[slot].waitForRead || m_objs[slot].waitForWrite))
+	{
+		epoll_event unused; // pre-2.6.9 kernels require a non-null pointer
+		epoll_ctl(m_epfd, EPOLL_CTL_DEL, m_objs[slot].s, &unused);
+	}
+#endif
+	m_objs[slot].waitForRead = false;
+	m_objs[slot].waitForWrite = false;
+	m_objs[slot].readAvailable = false;
+	m_objs[slot].writeAvailable = false;
+	m_inUse[slot] = false;
+	--m_numInUse;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+int
+SelectSet::selectRW(const Timeout& timeout)
+{
+#if !defined(BLOCXX_WIN32) && defined(BLOCXX_HAVE_SYS_EPOLL_H)
+	if (m_epfd == -1)
+	{
+		return selectRWFallback(timeout);
+	}
+
+	for (size_t i = 0; i < m_objs.size(); ++i)
+	{
+		m_objs[i].readAvailable = false;
+		m_objs[i].writeAvailable = false;
+		m_objs[i].wasError = false;
+	}
+
+	const int MAX_EVENTS = 64;
+	epoll_event events[MAX_EVENTS];
+	int ecc = 0;
+	TimeoutTimer timer(timeout);
+	timer.start();
+	int savedErrno;
+	do
+	{
+		Thread::testCancel();
+		ecc = epoll_wait(m_epfd, events, MAX_EVENTS, timer.asIntMs(LOOP_TIMEOUT));
+		savedErrno = errno;
+		if (ecc < 0 && errno == EINTR)
+		{
+			ecc = 0;
+			errno = 0;
+			Thread::testCancel();
+		}
+		timer.loop();
+	} while ((ecc == 0) && !timer.expired());
+
+	if (ecc < 0)
+	{
+		errno = savedErrno;
+		return SELECT_ERROR;
+	}
+	if (ecc == 0)
+	{
+		return SELECT_TIMEOUT;
+	}
+
+	for (int i = 0; i < ecc; ++i)
+	{
+		SelectObject& so = m_objs[events[i].data.u32];
+		so.readAvailable = so.waitForRead && (events[i].events & EPOLL_READ_EVENTS);
+		so.writeAvailable = so.waitForWrite && (events[i].events & EPOLL_WRITE_EVENTS);
+	}
+	return ecc;
+#else
+	return selectRWFallback(timeout);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+int
+SelectSet::selectRWFallback(const Timeout& timeout)
+{
+	SelectObjectArray objs;
+	Array<size_t> slots;
+	objs.reserve(m_numInUse);
+	slots.reserve(m_numInUse);
+	for (size_t i = 0; i < m_objs.size(); ++i)
+	{
+		if (m_inUse[i])
+		{
+			objs.push_back(m_objs[i]);
+			slots.push_back(i);
+		}
+	}
+	int rv = Select::selectRW(objs, timeout);
+	for (size_t i = 0; i < objs.size(); ++i)
+	{
+		m_objs[slots[i]] = objs[i];
+	}
+	return rv;
+}
+
 } // end namespace Select
 
 } // end namespace BLOCXX_NAMESPACE
@@ -122,6 +122,83 @@ namespace Select
 	 */
 	BLOCXX_COMMON_API int selectRW(SelectObjectArray& selarray, const Timeout& timeout = Timeout::infinite);
 
+	/**
+	 * A set of Select_t objects that is waited on repeatedly.  Unlike
+	 * selectRW(), which has to register every object with the kernel on each
+	 * call, the registrations made by add(), modify() and remove() persist
+	 * between calls to selectRW().  Where epoll is available a single epoll
+	 * descriptor is kept for the lifetime of the set; elsewhere selectRW()
+	 * is used underneath.
+	 *
+	 * An object must be remove()d before the descriptor it refers to is
+	 * closed.
+	 */
+	class BLOCXX_COMMON_API SelectSet
+	{
+	public:
+		SelectSet();
+		~SelectSet();
+
+		/**
+		 * Add s to the set.
+		 * @return A slot number identifying s, which stays valid until
+		 *  remove() is called for it.  Slot numbers are reused.
+		 */
+		size_t add(Select_t s, bool waitForRead, bool waitForWrite);
+
+		/**
+		 * Change what is waited for on the object in slot.
+		 */
+		void modify(size_t slot, bool waitForRead, bool waitForWrite);
+
+		/**
+		 * Remove the object in slot from the set.
+		 */
+		void remove(size_t slot);
+
+		/**
+		 * The object in slot, including the readAvailable and
+		 * writeAvailable results of the last call to selectRW().
+		 */
+		const SelectObject& operator[](size_t slot) const
+		{
+			return m_objs[slot];
+		}
+
+		/**
+		 * @return One past the highest slot number in use.
+		 */
+		size_t size() const
+		{
+			return m_objs.size();
+		}
+
+		/**
+		 * Wait until one of the objects in the set becomes available.
+		 * @return Same as Select::selectRW().
+		 */
+		int selectRW(const Timeout& timeout = Timeout::infinite);
+
+	private:
+		// noncopyable
+		SelectSet(const SelectSet&);
+		SelectSet& operator=(const SelectSet&);
+
+		int selectRWFallback(const Timeout& timeout);
+
+#ifdef BLOCXX_WIN32
+#pragma warning (push)
+#pragma warning (disable: 4251)
+#endif
+		SelectObjectArray m_objs;
+		Array<bool> m_inUse;
+#ifdef BLOCXX_WIN32
+#pragma warning (pop)
+#endif
+		size_t m_numInUse;
+		int m_epfd;
+	};
+
 } // end namespace Select
 
 } // end namespace BLOCXX_NAMESPACE
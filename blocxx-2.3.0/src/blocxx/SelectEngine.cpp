@@ -71,9 +71,14 @@ SelectEngine::go(const Timeout& timeout)
 	m_stopFlag = false;
 	do
 	{
+		// Iterate through a const reference: the non-const begin()/end()
+		// would do a copy-on-write check on every pass through the loop.
+		const SortedVectorMap<Select_t, Data>& table(m_table);
 		Select::SelectObjectArray selObjs;
+		selObjs.reserve(table.size());
 		typedef SortedVectorMap<Select_t, Data>::const_iterator citer_t;
-		for (citer_t iter = m_table.begin(); iter != m_table.end(); ++iter)
+		citer_t end(table.end());
+		for (citer_t iter = table.begin(); iter != end; ++iter)
 		{
 			Select::SelectObject so(iter->first);
 			if (iter->second.eventType & SelectableCallbackIFC::E_READ_EVENT)
@@ -103,9 +108,10 @@ SelectEngine::go(const Timeout& timeout)
 		}
 		else
 		{
-			for (size_t i = 0; i < selObjs.size() && selected > 0; ++i)
+			const Select::SelectObjectArray& results(selObjs);
+			for (size_t i = 0; i < results.size() && selected > 0; ++i)
 			{
-				const Select::SelectObject& selObj(selObjs[i]);
+				const Select::SelectObject& selObj(results[i]);
 				if (selObj.readAvailable || selObj.writeAvailable)
 				{
 					--selected;
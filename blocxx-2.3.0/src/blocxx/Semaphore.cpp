@@ -0,0 +1,131 @@
+/*******************************************************************************
+* Copyright (C) 2005, 2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+/**
+ * @author Dan Nuffer
+ */
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Semaphore.hpp"
+#include "blocxx/TimeoutTimer.hpp"
+
+namespace BLOCXX_NAMESPACE
+{
+
+//////////////////////////////////////////////////////////////////////////////
+Semaphore::Semaphore()
+	: m_curCount(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Semaphore::Semaphore(Int32 initCount)
+	: m_curCount(initCount)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Semaphore::~Semaphore()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+Semaphore::tryDecrement()
+{
+	Int32 count = m_curCount.load(E_MEMORY_ORDER_RELAXED);
+	while (count > 0)
+	{
+		if (m_curCount.compareExchangeWeak(count, count - 1, E_MEMORY_ORDER_ACQUIRE, E_MEMORY_ORDER_RELAXED))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+Semaphore::wait()
+{
+	timedWait(Timeout::infinite);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+Semaphore::timedWait(const Timeout& timeout)
+{
+	if (tryDecrement())
+	{
+		return true;
+	}
+	TimeoutTimer timer(timeout);
+	for (;;)
+	{
+		EventCount::Key key = m_countChanged.prepareWait();
+		if (tryDecrement())
+		{
+			m_countChanged.cancelWait();
+			return true;
+		}
+		timer.loop();
+		if (timer.expired())
+		{
+			m_countChanged.cancelWait();
+			return false;
+		}
+		m_countChanged.wait(key, timer.asRelativeTimeout());
+		if (tryDecrement())
+		{
+			return true;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+Semaphore::signal()
+{
+	m_curCount.fetchAdd(1, E_MEMORY_ORDER_RELEASE);
+	m_countChanged.notifyOne();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Int32
+Semaphore::getCount()
+{
+	return m_curCount.load(E_MEMORY_ORDER_ACQUIRE);
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
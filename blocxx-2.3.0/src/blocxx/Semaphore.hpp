@@ -39,63 +39,35 @@
 #define BLOCXX_SEMAPHORE_HPP_INCLUDE_GUARD_
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/Types.hpp"
-#include "blocxx/NonRecursiveMutex.hpp"
-#include "blocxx/Condition.hpp"
-#include "blocxx/NonRecursiveMutexLock.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/EventCount.hpp"
 #include "blocxx/Timeout.hpp"
-#include "blocxx/TimeoutTimer.hpp"
 
 namespace BLOCXX_NAMESPACE
 {
-/// @todo uninline this class.
-class Semaphore
+/**
+ * A counting semaphore.  The count is an atomic, so signal() and a wait()
+ * that doesn't have to block don't take a lock, and signal() only enters
+ * the kernel when a thread is blocked in wait().
+ */
+class BLOCXX_COMMON_API Semaphore
 {
 public:
-	Semaphore()
-		: m_curCount(0)
-	{}
-	Semaphore(Int32 initCount)
-		: m_curCount(initCount)
-	{}
-	void wait()
-	{
-		NonRecursiveMutexLock l(m_mutex);
-		while (m_curCount <= 0)
-		{
-			m_cond.wait(l);
-		}
-		--m_curCount;
-	}
-	bool timedWait(const Timeout& timeout)
-	{
-		bool ret = true;
-		NonRecursiveMutexLock l(m_mutex);
-		TimeoutTimer timer(timeout);
-		while (m_curCount <= 0 && ret == true)
-		{
-			ret = m_cond.timedWait(l, timer.asAbsoluteTimeout());
-		}
-		if (ret == true)
-		{
-			--m_curCount;
-		}
-		return ret;
-	}
-	void signal()
-	{
-		NonRecursiveMutexLock l(m_mutex);
-		++m_curCount;
-		m_cond.notifyAll();
-	}
-	Int32 getCount()
-	{
-		NonRecursiveMutexLock l(m_mutex);
-		return m_curCount;
-	}
+	Semaphore();
+	Semaphore(Int32 initCount);
+	~Semaphore();
+	void wait();
+	/**
+	 * @return false if the count stayed zero until timeout expired.
+	 */
+	bool timedWait(const Timeout& timeout);
+	void signal();
+	Int32 getCount();
 private:
-	Int32 m_curCount;
-	Condition m_cond;
-	NonRecursiveMutex m_mutex;
+	bool tryDecrement();
+
+	Atomic<Int32> m_curCount;
+	EventCount m_countChanged;
 	// noncopyable
 	Semaphore(const Semaphore&) BLOCXX_FUNCTION_NOT_IMPLEMENTED;
 	Semaphore& operator=(const Semaphore&) BLOCXX_FUNCTION_NOT_IMPLEMENTED;
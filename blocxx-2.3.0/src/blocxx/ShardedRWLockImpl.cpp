@@ -0,0 +1,386 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/ShardedRWLockImpl.hpp"
+
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+#include "blocxx/NonRecursiveMutexLock.hpp"
+#include "blocxx/ThreadOnce.hpp"
+#include "blocxx/TimeoutException.hpp"
+#include "blocxx/TimeoutTimer.hpp"
+#include "blocxx/Assertion.hpp"
+#include "blocxx/ExceptionIds.hpp"
+
+#include <vector>
+
+#include <pthread.h>
+
+namespace BLOCXX_NAMESPACE
+{
+
+BLOCXX_DEFINE_EXCEPTION_WITH_ID(ShardedRWLockImpl);
+
+namespace
+{
+
+// The locks a thread holds.  Only that thread ever looks at it.
+struct LockerInfo
+{
+	const ShardedRWLockImpl* lock;
+	unsigned readCount;
+	unsigned writeCount;
+};
+
+struct ThreadLockState
+{
+	size_t shard;
+	// A thread seldom holds more than a few locks at a time, so this is
+	// searched linearly, and it keeps its capacity once it has grown.
+	std::vector<LockerInfo> locks;
+};
+
+OnceFlag g_onceGuard = BLOCXX_ONCE_INIT;
+pthread_key_t g_stateKey;
+Atomic<UInt32>* g_nextShard = 0;
+
+extern "C"
+{
+static void freeThreadLockState(void* ptr)
+{
+	delete static_cast<ThreadLockState*>(ptr);
+}
+} // end extern "C"
+
+void initKey()
+{
+	g_nextShard = new Atomic<UInt32>(0);
+	int ret = pthread_key_create(&g_stateKey, freeThreadLockState);
+	BLOCXX_ASSERTMSG(ret == 0, "failed create a thread specific key");
+}
+
+ThreadLockState& getThreadState()
+{
+	callOnce(g_onceGuard, initKey);
+	ThreadLockState* state = static_cast<ThreadLockState*>(pthread_getspecific(g_stateKey));
+	if (!state)
+	{
+		state = new ThreadLockState;
+		// Hand out the shards round-robin, so up to E_NUM_SHARDS threads
+		// each get one to themselves.
+		state->shard = g_nextShard->fetchAdd(1, E_MEMORY_ORDER_RELAXED) % ShardedRWLockImpl::E_NUM_SHARDS;
+		if (pthread_setspecific(g_stateKey, state) != 0)
+		{
+			delete state;
+			BLOCXX_THROW(ShardedRWLockImplException, "pthread_setspecific() failed");
+		}
+	}
+	return *state;
+}
+
+LockerInfo* findLocker(ThreadLockState& state, const ShardedRWLockImpl* lock)
+{
+	for (size_t i = 0; i < state.locks.size(); ++i)
+	{
+		if (state.locks[i].lock == lock)
+		{
+			return &state.locks[i];
+		}
+	}
+	return 0;
+}
+
+void addLocker(ThreadLockState& state, const ShardedRWLockImpl* lock)
+{
+	LockerInfo info;
+	info.lock = lock;
+	info.readCount = 0;
+	info.writeCount = 0;
+	state.locks.push_back(info);
+}
+
+void removeLocker(ThreadLockState& state, LockerInfo* info)
+{
+	*info = state.locks.back();
+	state.locks.pop_back();
+}
+
+} // end unnamed namespace
+
+//////////////////////////////////////////////////////////////////////////////
+ShardedRWLockImpl::ShardedRWLockImpl()
+	: m_writerFlag(0)
+	, m_pendingWriters(0)
+	, m_writerOwned(false)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+ShardedRWLockImpl::~ShardedRWLockImpl()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+ShardedRWLockImpl::acquireReadLock(const Timeout& timeout)
+{
+	ThreadLockState& state = getThreadState();
+	LockerInfo* info = findLocker(state, this);
+	if (info)
+	{
+		// The thread already has a read or write lock, so just increment.
+		// This must not wait for a pending writer, which would be waiting
+		// for this thread.
+		BLOCXX_ASSERT(info->readCount > 0 || info->writeCount > 0);
+		++info->readCount;
+		return;
+	}
+
+	// Add the record first, so running out of memory can't leave the lock
+	// held without one.
+	addLocker(state, this);
+	Atomic<Int32>& shard = m_shards[state.shard].readers;
+	try
+	{
+		// This and the writer flag check are sequentially consistent, and so
+		// are the writer's flag store and its reads of the shards, so either
+		// this sees the writer or the writer sees this.
+		shard.fetchAdd(1);
+		if (m_writerFlag.load() != 0)
+		{
+			acquireSharedSlow(shard, timeout);
+		}
+	}
+	catch (...)
+	{
+		state.locks.pop_back();
+		throw;
+	}
+	state.locks.back().readCount = 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+ShardedRWLockImpl::acquireSharedSlow(Atomic<Int32>& shard, const Timeout& timeout)
+{
+	TimeoutTimer timer(timeout);
+	for (;;)
+	{
+		// Back out, so the writer can go ahead, and wait until it's done.
+		releaseShared(shard);
+		{
+			NonRecursiveMutexLock l(m_guard);
+			while (m_writerFlag.load() != 0)
+			{
+				if (!m_waitingReaders.timedWait(l, timer.asAbsoluteTimeout()))
+				{
+					BLOCXX_THROW(TimeoutException, "Timeout while waiting for read lock.");
+				}
+			}
+		}
+		shard.fetchAdd(1);
+		if (m_writerFlag.load() == 0)
+		{
+			return;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+ShardedRWLockImpl::releaseShared(Atomic<Int32>& shard)
+{
+	shard.fetchSub(1);
+	if (m_writerFlag.load() != 0)
+	{
+		// A writer may be waiting for this reader.
+		NonRecursiveMutexLock l(m_guard);
+		m_waitingWriters.notifyAll();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+ShardedRWLockImpl::readersActive() const
+{
+	for (size_t i = 0; i < E_NUM_SHARDS; ++i)
+	{
+		if (m_shards[i].readers.load() != 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// m_guard must be locked.
+void
+ShardedRWLockImpl::writerStateChanged()
+{
+	m_writerFlag.store(m_writerOwned || m_pendingWriters > 0 ? 1 : 0);
+	m_waitingReaders.notifyAll();
+	m_waitingWriters.notifyAll();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+ShardedRWLockImpl::releaseReadLock()
+{
+	ThreadLockState& state = getThreadState();
+	LockerInfo* info = findLocker(state, this);
+	if (!info || info->readCount == 0)
+	{
+		BLOCXX_THROW(ShardedRWLockImplException, "Cannot release a read lock when no read lock is held");
+	}
+
+	--info->readCount;
+	// While the thread is the writer its read locks aren't counted in the
+	// shard; releaseWriteLock() puts them back.
+	if (info->readCount == 0 && info->writeCount == 0)
+	{
+		removeLocker(state, info);
+		releaseShared(m_shards[state.shard].readers);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+ShardedRWLockImpl::acquireWriteLock(const Timeout& timeout)
+{
+	ThreadLockState& state = getThreadState();
+	LockerInfo* info = findLocker(state, this);
+	if (info && info->writeCount > 0)
+	{
+		++info->writeCount;
+		return;
+	}
+
+	TimeoutTimer timer(timeout);
+	if (info)
+	{
+		// The thread is upgrading a read lock.
+		BLOCXX_ASSERT(info->readCount > 0);
+		Atomic<Int32>& shard = m_shards[state.shard].readers;
+
+		NonRecursiveMutexLock l(m_guard);
+		// Nobody else can hold the write lock while this thread holds a read
+		// lock, so the owner must be another upgrader.
+		if (m_writerOwned)
+		{
+			BLOCXX_THROW(DeadlockException, "Upgrading read lock to a write lock failed, another upgrade is already in progress.");
+		}
+
+		// Mark us as the writer, which keeps other threads from becoming one
+		// and stops new readers, and stop counting our own read lock.
+		m_writerOwned = true;
+		m_writerFlag.store(1);
+		shard.fetchSub(1);
+
+		while (readersActive())
+		{
+			if (!m_waitingWriters.timedWait(l, timer.asAbsoluteTimeout()))
+			{
+				// undo changes
+				shard.fetchAdd(1);
+				m_writerOwned = false;
+				writerStateChanged();
+				BLOCXX_THROW(TimeoutException, "Timeout while waiting for write lock.");
+			}
+		}
+		++info->writeCount;
+	}
+	else
+	{
+		// The thread doesn't have any lock.
+		addLocker(state, this);
+
+		NonRecursiveMutexLock l(m_guard);
+		++m_pendingWriters;
+		// stop new readers
+		m_writerFlag.store(1);
+
+		while (m_writerOwned || readersActive())
+		{
+			if (!m_waitingWriters.timedWait(l, timer.asAbsoluteTimeout()))
+			{
+				--m_pendingWriters;
+				writerStateChanged();
+				state.locks.pop_back();
+				BLOCXX_THROW(TimeoutException, "Timeout while waiting for write lock.");
+			}
+		}
+		--m_pendingWriters;
+		m_writerOwned = true;
+		state.locks.back().writeCount = 1;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+ShardedRWLockImpl::releaseWriteLock()
+{
+	ThreadLockState& state = getThreadState();
+	LockerInfo* info = findLocker(state, this);
+	if (!info || info->writeCount == 0)
+	{
+		BLOCXX_THROW(ShardedRWLockImplException, "Cannot release a write lock when no write lock is held");
+	}
+
+	--info->writeCount;
+	if (info->writeCount > 0)
+	{
+		return;
+	}
+
+	bool stillReader = info->readCount > 0;
+	if (!stillReader)
+	{
+		// This thread no longer holds locks.
+		removeLocker(state, info);
+	}
+
+	NonRecursiveMutexLock l(m_guard);
+	BLOCXX_ASSERT(m_writerOwned);
+	if (stillReader)
+	{
+		// restore reader status
+		m_shards[state.shard].readers.fetchAdd(1);
+	}
+	m_writerOwned = false;
+	writerStateChanged();
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif // BLOCXX_HAVE_SHARDED_RWLOCK
+
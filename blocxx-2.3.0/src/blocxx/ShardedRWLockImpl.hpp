@@ -0,0 +1,141 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_SHARDED_RWLOCK_IMPL_HPP_INCLUDE_GUARD_
+#define BLOCXX_SHARDED_RWLOCK_IMPL_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/Types.hpp"
+#include "blocxx/NonRecursiveMutex.hpp"
+#include "blocxx/Condition.hpp"
+#include "blocxx/Exception.hpp"
+#include "blocxx/Timeout.hpp"
+
+// The per-thread records are kept with pthread thread-specific data.
+#if !defined(BLOCXX_WIN32) && !defined(BLOCXX_NCR)
+#define BLOCXX_HAVE_SHARDED_RWLOCK
+#endif
+
+#ifdef BLOCXX_HAVE_SHARDED_RWLOCK
+namespace BLOCXX_NAMESPACE
+{
+
+BLOCXX_DECLARE_APIEXCEPTION(ShardedRWLockImpl, BLOCXX_COMMON_API);
+
+/**
+ * A read/write lock held by threads, with the same semantics as
+ * GenericRWLockImpl<Thread_t>: it's recursive, a thread holding a write lock
+ * can also take read locks, and a read lock can be upgraded to a write lock.
+ *
+ * It's built for read-mostly data.  The reader count is split over
+ * E_NUM_SHARDS counters, each on its own cache line, and each thread always
+ * uses the same one, so readers on different CPUs don't contend.  A reader
+ * that finds no writer doesn't take a lock or touch shared memory other than
+ * its shard and the writer flag.  Which locks a thread holds, and how many
+ * times, is recorded in that thread's own thread-specific data, so there's no
+ * shared map to update.
+ *
+ * Writers are serialized by a mutex.  A writer raises the writer flag, which
+ * sends new readers to wait on a condition, then waits for the shard
+ * counters to drain.  Writers therefore take precedence over new readers,
+ * and a write lock costs a pass over all the shards.
+ */
+class BLOCXX_COMMON_API ShardedRWLockImpl
+{
+public:
+	ShardedRWLockImpl();
+	~ShardedRWLockImpl();
+
+	/**
+	 * @throws TimeoutException if the lock isn't acquired within the timeout.
+	 */
+	void acquireReadLock(const Timeout& timeout);
+
+	/**
+	 * @throws TimeoutException if the lock isn't acquired within the timeout.
+	 * @throws DeadlockException if this call would upgrade a read lock to a
+	 *   write lock and another thread is already upgrading. If this happens,
+	 *   the calling thread must release its read lock in order for forward
+	 *   progress to be made.
+	 */
+	void acquireWriteLock(const Timeout& timeout);
+
+	/**
+	 * @throws ShardedRWLockImplException if the calling thread doesn't hold
+	 *   a read lock.
+	 */
+	void releaseReadLock();
+
+	/**
+	 * @throws ShardedRWLockImplException if the calling thread doesn't hold
+	 *   a write lock.
+	 */
+	void releaseWriteLock();
+
+	enum { E_NUM_SHARDS = 16 };
+
+private:
+	void acquireSharedSlow(Atomic<Int32>& shard, const Timeout& timeout);
+	void releaseShared(Atomic<Int32>& shard);
+	bool readersActive() const;
+	void writerStateChanged();
+
+	struct Shard
+	{
+		Atomic<Int32> readers;
+		char pad[BLOCXX_CACHE_LINE_SIZE - sizeof(Atomic<Int32>)];
+	};
+
+	char m_pad0[BLOCXX_CACHE_LINE_SIZE];
+	Shard m_shards[E_NUM_SHARDS];
+
+	// Non-zero while a thread holds the write lock or waits for one.
+	// Readers that see it go to the slow path.
+	Atomic<Int32> m_writerFlag;
+
+	// The rest are protected by m_guard.
+	NonRecursiveMutex m_guard;
+	Condition m_waitingReaders;
+	Condition m_waitingWriters;
+	unsigned m_pendingWriters; // threads waiting in acquireWriteLock()
+	bool m_writerOwned; // the write lock is held or being upgraded to
+
+	// unimplemented
+	ShardedRWLockImpl(const ShardedRWLockImpl&);
+	ShardedRWLockImpl& operator=(const ShardedRWLockImpl&);
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif // BLOCXX_HAVE_SHARDED_RWLOCK
+
+#endif
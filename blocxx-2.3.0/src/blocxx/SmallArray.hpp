@@ -0,0 +1,297 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_SMALL_ARRAY_HPP_INCLUDE_GUARD_
+#define BLOCXX_SMALL_ARRAY_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Array.hpp"
+#include "blocxx/Types.hpp"
+#include "blocxx/StaticAssert.hpp"
+#include <cstddef>
+#include <new>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * SmallArray is a growable array with room for N elements inside the
+ * object.  Until it holds more than N elements it doesn't allocate, so a
+ * short list built on the stack costs nothing from the heap; past that it
+ * moves its elements to the heap like std::vector.  It's meant for
+ * collecting a few items before handing them on as an Array, which
+ * toArray() does with a single allocation of the right size.
+ *
+ * Only the parts of the std::vector interface that are needed for that are
+ * provided.  Iterators are pointers, and are invalidated by anything that
+ * makes the array grow.
+ *
+ * Invariants: See std::vector<>
+ * Thread safety: read
+ * Copy semantics: Value
+ * Exception safety: Strong for push_back() and reserve(), basic otherwise
+ */
+template <class T, size_t N>
+class SmallArray
+{
+	BLOCXX_STATIC_ASSERT(N > 0);
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T* iterator;
+	typedef const T* const_iterator;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	SmallArray()
+		: m_begin(inlineElements())
+		, m_size(0)
+		, m_capacity(N)
+	{
+	}
+	SmallArray(const SmallArray<T, N>& x)
+		: m_begin(inlineElements())
+		, m_size(0)
+		, m_capacity(N)
+	{
+		append(x.begin(), x.end());
+	}
+	template <class InputIterator>
+	SmallArray(InputIterator first, InputIterator last)
+		: m_begin(inlineElements())
+		, m_size(0)
+		, m_capacity(N)
+	{
+		append(first, last);
+	}
+	~SmallArray()
+	{
+		destroy(m_begin, m_begin + m_size);
+		deallocate();
+	}
+	SmallArray<T, N>& operator=(const SmallArray<T, N>& x)
+	{
+		if (this != &x)
+		{
+			clear();
+			append(x.begin(), x.end());
+		}
+		return *this;
+	}
+
+	iterator begin() { return m_begin; }
+	const_iterator begin() const { return m_begin; }
+	iterator end() { return m_begin + m_size; }
+	const_iterator end() const { return m_begin + m_size; }
+	size_type size() const { return m_size; }
+	size_type capacity() const { return m_capacity; }
+	bool empty() const { return m_size == 0; }
+
+	/**
+	 * @return true if the elements are still stored inside the object.
+	 */
+	bool isInline() const
+	{
+		return m_begin == inlineElements();
+	}
+
+	reference operator[](size_type n)
+	{
+#ifdef BLOCXX_CHECK_ARRAY_INDEXING
+		checkValidIndex(n);
+#endif
+		return m_begin[n];
+	}
+	const_reference operator[](size_type n) const
+	{
+#ifdef BLOCXX_CHECK_ARRAY_INDEXING
+		checkValidIndex(n);
+#endif
+		return m_begin[n];
+	}
+	reference front() { return m_begin[0]; }
+	const_reference front() const { return m_begin[0]; }
+	reference back() { return m_begin[m_size - 1]; }
+	const_reference back() const { return m_begin[m_size - 1]; }
+
+	void push_back(const T& x)
+	{
+		if (m_size == m_capacity)
+		{
+			// x may be one of the elements, so copy it before they move.
+			T copy(x);
+			grow(m_size + 1);
+			new (m_begin + m_size) T(copy);
+		}
+		else
+		{
+			new (m_begin + m_size) T(x);
+		}
+		++m_size;
+	}
+	void append(const T& x)
+	{
+		push_back(x);
+	}
+	template <class InputIterator>
+	void append(InputIterator first, InputIterator last)
+	{
+		for (; first != last; ++first)
+		{
+			push_back(*first);
+		}
+	}
+	void pop_back()
+	{
+		--m_size;
+		m_begin[m_size].~T();
+	}
+	void clear()
+	{
+		destroy(m_begin, m_begin + m_size);
+		m_size = 0;
+	}
+	void reserve(size_type n)
+	{
+		if (n > m_capacity)
+		{
+			grow(n);
+		}
+	}
+	void resize(size_type n, const T& x = T())
+	{
+		if (n < m_size)
+		{
+			destroy(m_begin + n, m_begin + m_size);
+			m_size = n;
+		}
+		else
+		{
+			reserve(n);
+			while (m_size < n)
+			{
+				new (m_begin + m_size) T(x);
+				++m_size;
+			}
+		}
+	}
+
+	/**
+	 * @return An Array with copies of the elements, which allocates its
+	 * storage once at the final size.
+	 */
+	Array<T> toArray() const
+	{
+		return Array<T>(begin(), end());
+	}
+
+private:
+	T* inlineElements()
+	{
+		return reinterpret_cast<T*>(m_storage.bytes);
+	}
+	const T* inlineElements() const
+	{
+		return reinterpret_cast<const T*>(m_storage.bytes);
+	}
+	static void destroy(T* first, T* last)
+	{
+		for (; first != last; ++first)
+		{
+			first->~T();
+		}
+	}
+	void deallocate()
+	{
+		if (!isInline())
+		{
+			::operator delete(m_begin);
+		}
+	}
+	void grow(size_type minCapacity)
+	{
+		size_type newCapacity = m_capacity * 2;
+		if (newCapacity < minCapacity)
+		{
+			newCapacity = minCapacity;
+		}
+		T* newBegin = static_cast<T*>(::operator new(newCapacity * sizeof(T)));
+		size_type copied = 0;
+		try
+		{
+			for (; copied < m_size; ++copied)
+			{
+				new (newBegin + copied) T(m_begin[copied]);
+			}
+		}
+		catch (...)
+		{
+			destroy(newBegin, newBegin + copied);
+			::operator delete(newBegin);
+			throw;
+		}
+		destroy(m_begin, m_begin + m_size);
+		deallocate();
+		m_begin = newBegin;
+		m_capacity = newCapacity;
+	}
+#ifdef BLOCXX_CHECK_ARRAY_INDEXING
+	void checkValidIndex(size_type i) const
+	{
+		if (i >= m_size)
+		{
+			throwArrayOutOfBoundsException(m_size, i);
+		}
+	}
+#endif
+
+	// The other members are only there to align the bytes for any T.
+	union Storage
+	{
+		char bytes[N * sizeof(T)];
+		long double ld;
+		Int64 i;
+		void* p;
+		void (*f)();
+	};
+
+	T* m_begin;
+	size_type m_size;
+	size_type m_capacity;
+	Storage m_storage;
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -0,0 +1,334 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/SmallObjectPool.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#include <pthread.h>
+
+namespace BLOCXX_NAMESPACE
+{
+
+#if !defined(BLOCXX_DEBUG_MEMORY) && !defined(BLOCXX_HEAP_PROFILER)
+namespace
+{
+	const size_t GRANULE = 16;
+	const size_t CLASS_COUNT = SmallObjectPool::MAX_SIZE / GRANULE;
+	// The most free objects of each class a thread keeps.  Past that, a
+	// batch of them goes back to the central list.
+	const size_t THREAD_CACHE_LIMIT = 64;
+	const size_t TRANSFER_BATCH = THREAD_CACHE_LIMIT / 2;
+	const size_t CHUNK_SIZE = 64 * 1024;
+
+	struct FreeObject
+	{
+		FreeObject* next;
+	};
+
+	struct FreeList
+	{
+		FreeObject* head;
+		size_t count;
+	};
+
+	struct ThreadCache
+	{
+		FreeList lists[CLASS_COUNT];
+	};
+
+	// Static destructors can free pooled objects after a GlobalMutex has
+	// been destroyed, so this is a pthread mutex that never is.
+	pthread_mutex_t g_centralMutex = PTHREAD_MUTEX_INITIALIZER;
+	// The rest are guarded by g_centralMutex.
+	FreeList g_central[CLASS_COUNT];
+	size_t g_reservedBytes = 0;
+
+	pthread_key_t g_cacheKey;
+	pthread_once_t g_cacheKeyOnce = PTHREAD_ONCE_INIT;
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+	__thread ThreadCache* t_cache = 0;
+#endif
+
+	class CentralLock
+	{
+	public:
+		CentralLock()
+		{
+			pthread_mutex_lock(&g_centralMutex);
+		}
+		~CentralLock()
+		{
+			pthread_mutex_unlock(&g_centralMutex);
+		}
+	private:
+		// noncopyable
+		CentralLock(const CentralLock&);
+		CentralLock& operator=(const CentralLock&);
+	};
+
+	inline size_t sizeClass(size_t size)
+	{
+		return size == 0 ? 0 : (size - 1) / GRANULE;
+	}
+
+	inline size_t classSize(size_t c)
+	{
+		return (c + 1) * GRANULE;
+	}
+
+	inline void push(FreeList& list, FreeObject* o)
+	{
+		o->next = list.head;
+		list.head = o;
+		++list.count;
+	}
+
+	// Moves up to n objects from the front of one list to another.
+	void transfer(FreeList& from, FreeList& to, size_t n)
+	{
+		for (; n > 0 && from.head != 0; --n)
+		{
+			FreeObject* o = from.head;
+			from.head = o->next;
+			--from.count;
+			push(to, o);
+		}
+	}
+
+	void releaseCache(void* p)
+	{
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+		t_cache = 0;
+#endif
+		ThreadCache* cache = static_cast<ThreadCache*>(p);
+		{
+			CentralLock lock;
+			for (size_t c = 0; c < CLASS_COUNT; ++c)
+			{
+				transfer(cache->lists[c], g_central[c], cache->lists[c].count);
+			}
+		}
+		::free(cache);
+	}
+
+	void createCacheKey()
+	{
+		pthread_key_create(&g_cacheKey, releaseCache);
+	}
+
+	inline ThreadCache* currentCache()
+	{
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+		return t_cache;
+#else
+		pthread_once(&g_cacheKeyOnce, createCacheKey);
+		return static_cast<ThreadCache*>(pthread_getspecific(g_cacheKey));
+#endif
+	}
+
+	// Returns 0 if the cache can't be allocated, in which case the caller
+	// uses the central lists directly.
+	ThreadCache* createCache()
+	{
+		pthread_once(&g_cacheKeyOnce, createCacheKey);
+		ThreadCache* cache = static_cast<ThreadCache*>(::calloc(1, sizeof(ThreadCache)));
+		if (cache != 0)
+		{
+			pthread_setspecific(g_cacheKey, cache);
+#ifdef BLOCXX_HAVE_THREAD_LOCAL_STORAGE
+			t_cache = cache;
+#endif
+		}
+		return cache;
+	}
+
+	// Fills list with a batch of class c objects, from the central list if
+	// it has any, and otherwise from a new chunk.
+	void refill(FreeList& list, size_t c)
+	{
+		{
+			CentralLock lock;
+			transfer(g_central[c], list, TRANSFER_BATCH);
+		}
+		if (list.head != 0)
+		{
+			return;
+		}
+
+		char* chunk = static_cast<char*>(::operator new(CHUNK_SIZE));
+		size_t const objectSize = classSize(c);
+		size_t const count = CHUNK_SIZE / objectSize;
+		FreeList carved = { 0, 0 };
+		for (size_t i = count; i > 0; --i)
+		{
+			push(carved, reinterpret_cast<FreeObject*>(chunk + (i - 1) * objectSize));
+		}
+		FreeObject* tail = reinterpret_cast<FreeObject*>(chunk + (count - 1) * objectSize);
+		transfer(carved, list, TRANSFER_BATCH);
+
+		CentralLock lock;
+		g_reservedBytes += CHUNK_SIZE;
+		tail->next = g_central[c].head;
+		g_central[c].head = carved.head;
+		g_central[c].count += carved.count;
+	}
+} // end unnamed namespace
+
+//////////////////////////////////////////////////////////////////////////////
+void*
+SmallObjectPool::allocate(size_t size)
+{
+	if (size > MAX_SIZE)
+	{
+		return ::operator new(size);
+	}
+	size_t const c = sizeClass(size);
+	ThreadCache* cache = currentCache();
+	if (cache == 0)
+	{
+		cache = createCache();
+		if (cache == 0)
+		{
+			FreeList list = { 0, 0 };
+			refill(list, c);
+			// Keep one object and give back the rest.
+			FreeObject* o = list.head;
+			list.head = o->next;
+			--list.count;
+			CentralLock lock;
+			transfer(list, g_central[c], list.count);
+			return o;
+		}
+	}
+	FreeList& list = cache->lists[c];
+	if (list.head == 0)
+	{
+		refill(list, c);
+	}
+	FreeObject* o = list.head;
+	list.head = o->next;
+	--list.count;
+	return o;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+SmallObjectPool::deallocate(void* p, size_t size)
+{
+	if (p == 0)
+	{
+		return;
+	}
+	if (size > MAX_SIZE)
+	{
+		::operator delete(p);
+		return;
+	}
+	size_t const c = sizeClass(size);
+	FreeObject* o = static_cast<FreeObject*>(p);
+	ThreadCache* cache = currentCache();
+	if (cache == 0)
+	{
+		cache = createCache();
+		if (cache == 0)
+		{
+			CentralLock lock;
+			push(g_central[c], o);
+			return;
+		}
+	}
+	FreeList& list = cache->lists[c];
+	push(list, o);
+	if (list.count > THREAD_CACHE_LIMIT)
+	{
+		CentralLock lock;
+		transfer(list, g_central[c], TRANSFER_BATCH);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t
+SmallObjectPool::getReservedBytes()
+{
+	CentralLock lock;
+	return g_reservedBytes;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t
+SmallObjectPool::getCentralFreeBytes()
+{
+	CentralLock lock;
+	size_t bytes = 0;
+	for (size_t c = 0; c < CLASS_COUNT; ++c)
+	{
+		bytes += g_central[c].count * classSize(c);
+	}
+	return bytes;
+}
+
+#else
+
+//////////////////////////////////////////////////////////////////////////////
+void*
+SmallObjectPool::allocate(size_t size)
+{
+	return ::operator new(size);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+SmallObjectPool::deallocate(void* p, size_t)
+{
+	::operator delete(p);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t
+SmallObjectPool::getReservedBytes()
+{
+	return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+size_t
+SmallObjectPool::getCentralFreeBytes()
+{
+	return 0;
+}
+
+#endif
+
+} // end namespace BLOCXX_NAMESPACE
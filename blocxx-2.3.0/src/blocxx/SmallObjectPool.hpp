@@ -0,0 +1,128 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_SMALL_OBJECT_POOL_HPP_INCLUDE_GUARD_
+#define BLOCXX_SMALL_OBJECT_POOL_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include <cstddef>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * A pool for small, frequently allocated objects.  Sizes up to MAX_SIZE are
+ * rounded up to a multiple of 16 bytes, and each of those size classes has
+ * its own free lists.  Every thread keeps a few free objects of each class
+ * to itself, so most allocations and frees don't take a lock; the threads
+ * exchange objects with a central list in batches, and a thread's objects
+ * go back to the central list when it exits.  Memory is carved out of
+ * 64 KiB chunks, which are kept for the life of the process.
+ *
+ * Classes normally use the pool by deriving from PooledObject rather than
+ * by calling allocate() and deallocate() themselves.
+ *
+ * When the library is configured with --enable-memory-debug-mode or
+ * --enable-heap-profiler every allocation is passed through to operator
+ * new, so MemTracer and HeapProfiler still see each object.
+ */
+namespace SmallObjectPool
+{
+	/**
+	 * The largest size that's pooled.  Larger allocations are passed through
+	 * to operator new.
+	 */
+	static const size_t MAX_SIZE = 256;
+
+	/**
+	 * Allocate size bytes, aligned for any type.
+	 * @throws std::bad_alloc
+	 */
+	BLOCXX_COMMON_API void* allocate(size_t size);
+
+	/**
+	 * Free memory from allocate().
+	 * @param size The size passed to allocate().
+	 */
+	BLOCXX_COMMON_API void deallocate(void* p, size_t size);
+
+	/**
+	 * @return The number of bytes of chunks the pool has taken from the heap.
+	 */
+	BLOCXX_COMMON_API size_t getReservedBytes();
+
+	/**
+	 * @return The number of free bytes in the central lists, which doesn't
+	 * count objects cached by threads or chunks not handed out yet.
+	 */
+	BLOCXX_COMMON_API size_t getCentralFreeBytes();
+
+} // end namespace SmallObjectPool
+
+/**
+ * Deriving from PooledObject makes new and delete allocate a class and its
+ * subclasses from the SmallObjectPool.  The class must have a virtual
+ * destructor if objects are deleted through a pointer to a base class, so
+ * the size of the object is known.
+ *
+ * Nothrow new isn't supported, since the pool can't be told the size of an
+ * object whose constructor throws.
+ */
+class BLOCXX_COMMON_API PooledObject
+{
+public:
+	static void* operator new(std::size_t size)
+	{
+		return SmallObjectPool::allocate(size);
+	}
+	static void operator delete(void* p, std::size_t size)
+	{
+		SmallObjectPool::deallocate(p, size);
+	}
+	static void* operator new(std::size_t, void* p)
+	{
+		return p;
+	}
+	static void operator delete(void*, void*)
+	{
+	}
+protected:
+	PooledObject()
+	{
+	}
+	~PooledObject()
+	{
+	}
+};
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
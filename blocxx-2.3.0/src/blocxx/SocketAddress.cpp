@@ -44,6 +44,7 @@
 #include "blocxx/MutexLock.hpp"
 #include "blocxx/ExceptionIds.hpp"
 #include "blocxx/Format.hpp"
+#include "blocxx/HostResolver.hpp"
 
 extern "C"
 {
@@ -156,64 +157,15 @@ namespace BLOCXX_NAMESPACE
 	SocketAddress
 	SocketAddress::getByName(const String& hostName, UInt16 port)
 	{
-#ifdef BLOCXX_HAVE_IPV6
-		// create SocketAddress structure for IPV6 protocol
-		InetSocketAddress_t sa;
-		memset(&sa, 0, sizeof(sa));
-		if( inet_pton(AF_INET6, hostName.c_str(), (void*)&(reinterpret_cast<sockaddr_in6*>(&sa)->sin6_addr)))
-		{
-			reinterpret_cast<sockaddr_in6*>(&sa)->sin6_family = AF_INET6;
-			reinterpret_cast<sockaddr_in6*>(&sa)->sin6_port   = htons(port);
-			SocketAddress p = SocketAddress(sa);
-			p.m_type = INET;
-			p.m_name = hostName;
-			return p;
-		}
-#endif
-#if defined(BLOCXX_HAVE_GETHOSTBYNAME_R) && defined(BLOCXX_GETHOSTBYNAME_R_ARGUMENTS)
-		hostent hostbuf;
-		hostent* host = &hostbuf;
-#if (BLOCXX_GETHOSTBYNAME_R_ARGUMENTS == 6)
-		char buf[2048];
-		int h_err = 0;
-		if (gethostbyname_r(hostName.c_str(), &hostbuf, buf, sizeof(buf),
-				&host, &h_err) == -1)
-		{
-			host = NULL;
-		}
-#elif (BLOCXX_GETHOSTBYNAME_R_ARGUMENTS == 5)
-
-		char buf[2048];
-		int h_err(0);
-		// returns NULL if not successful
-		host = gethostbyname_r(hostName.c_str(), &hostbuf, buf, sizeof(buf), &h_err);
-
-#elif (BLOCXX_GETHOSTBYNAME_R_ARGUMENTS == 3)
-		hostent_data hostdata;
-		if (gethostbyname_r(hostName.c_str(), &hostbuf, &hostdata) != 0)
-		{
-			host = NULL;
-		}
-
-#else
-#error Not yet supported: gethostbyname_r() with other argument counts.
-#endif /* BLOCXX_GETHOSTBYNAME_R_ARGUMENTS */
-#else
-		MutexLock mlock(gethostbynameMutex);
-#if defined(BLOCXX_NCR)
-		hostent* host = gethostbyname(const_cast<char *>(hostName.c_str()));
-#else
-		hostent* host = gethostbyname(hostName.c_str());
-#endif
-#endif /* defined(BLOCXX_HAVE_GETHOSTBYNAME_R) && defined(BLOCXX_GETHOSTBYNAME_R_ARGUMENTS) */
+		return HostResolver::getDefault().resolve(hostName, port)[0];
+	}
 
-		if (!host)
-		{
-			BLOCXX_THROW(UnknownHostException, String("Unknown host: ").concat(hostName).c_str());
-		}
-		in_addr addr;
-		memcpy(&addr, host->h_addr_list[0], sizeof(addr));
-		return getFromNativeForm(addr, port, host->h_name);
+	//////////////////////////////////////////////////////////////////////////////
+	//static
+	Array<SocketAddress>
+	SocketAddress::getAllByName(const String& hostName, UInt16 port)
+	{
+		return HostResolver::getDefault().resolve(hostName, port);
 	}
 
 	//////////////////////////////////////////////////////////////////////////////
@@ -74,6 +74,9 @@ public:
 	 * @param host The hostname
 	 * @param port The port
 	 *
+	 * Lookups go through HostResolver::getDefault(), so repeated calls
+	 * for the same host are answered from its cache.
+	 *
 	 * @return An SocketAddress for the host and port
 	 * @throws UnknownHostException
 	 */
@@ -86,7 +89,9 @@ public:
 	 * @param port The port
 	 *
 	 * @return An Array of SocketAddresses for the host and port
+	 * @throws UnknownHostException
 	 */
+	static Array<SocketAddress> getAllByName(const String& host, unsigned short port = 0);
 
 	/**
 	 * Get an SocketAddress appropriate for referring to the local host
@@ -127,8 +132,6 @@ public:
 	const InetSocketAddress_t* getInetAddress() const;
 
 #if !defined(BLOCXX_WIN32)
-	//static Array<SocketAddress> getAllByName(const String& hostName,
-	//		unsigned short port = 0);
 	static SocketAddress getUDS(const String& filename);
 
 	/**
@@ -150,6 +153,7 @@ public:
 
 	SocketAddress();
 private:
+	friend class HostResolver;
 	SocketAddress(const InetSocketAddress_t& nativeForm);
 
 #if !defined(BLOCXX_WIN32)
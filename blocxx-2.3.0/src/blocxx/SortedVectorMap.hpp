@@ -117,15 +117,13 @@ public:
 	SortedVectorMap() : m_impl(new container_t) {  }
 	explicit SortedVectorMap(container_t* toWrap) : m_impl(toWrap)
 	{
-		std::sort(m_impl->begin(), m_impl->end(), Compare());
-		m_impl->erase(std::unique(m_impl->begin(), m_impl->end(), &equivalent), m_impl->end());
+		sortAndUnique(*m_impl);
 	}
 	template <class InputIterator>
 	SortedVectorMap(InputIterator first, InputIterator last) :
 		m_impl(new container_t(first, last))
 	{
-		std::sort(m_impl->begin(), m_impl->end(), Compare());
-		m_impl->erase(std::unique(m_impl->begin(), m_impl->end(), &equivalent), m_impl->end());
+		sortAndUnique(*m_impl);
 	}
 	const_iterator begin() const
 	{
@@ -164,14 +162,17 @@ public:
 	{
 		return m_impl->max_size();
 	}
+	// The mutators below take the copy-on-write check once, through a
+	// single container_t reference, rather than on every m_impl-> access.
 	data_type& operator[](const key_type& k)
 	{
-		iterator i = std::lower_bound(m_impl->begin(), m_impl->end(), k, Compare());
-		if (i != m_impl->end() && equivalent(i->first, k))
+		container_t& v = *m_impl;
+		iterator i = std::lower_bound(v.begin(), v.end(), k, Compare());
+		if (i != v.end() && equivalent(i->first, k))
 		{
 			return i->second;
 		}
-		return (*(m_impl->insert(i, value_type(k, data_type())))).second;
+		return (*(v.insert(i, value_type(k, data_type())))).second;
 	}
 	void swap(SortedVectorMap<Key, T, Compare>& x)
 	{
@@ -179,28 +180,45 @@ public:
 	}
 	std::pair<iterator, bool> insert(const value_type& x)
 	{
-		iterator i = std::lower_bound(m_impl->begin(), m_impl->end(), x, Compare());
-		if (i != m_impl->end() && equivalent(i->first, x.first))
+		container_t& v = *m_impl;
+		iterator i = std::lower_bound(v.begin(), v.end(), x, Compare());
+		if (i != v.end() && equivalent(i->first, x.first))
 		{
 			return std::pair<iterator, bool>(i, false);
 		}
 		else
 		{
-			return std::pair<iterator, bool>(m_impl->insert(i, x), true);
+			return std::pair<iterator, bool>(v.insert(i, x), true);
 		}
 	}
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	std::pair<iterator, bool> insert(value_type&& x)
+	{
+		container_t& v = *m_impl;
+		iterator i = std::lower_bound(v.begin(), v.end(), x, Compare());
+		if (i != v.end() && equivalent(i->first, x.first))
+		{
+			return std::pair<iterator, bool>(i, false);
+		}
+		else
+		{
+			return std::pair<iterator, bool>(v.insert(i, std::move(x)), true);
+		}
+	}
+#endif
 	iterator insert(iterator, const value_type& x)
 	{
-		iterator i = std::lower_bound(m_impl->begin(), m_impl->end(), x, Compare());
+		container_t& v = *m_impl;
+		iterator i = std::lower_bound(v.begin(), v.end(), x, Compare());
 
-		return m_impl->insert(i, x);
+		return v.insert(i, x);
 	}
 	template <class InputIterator>
 	void insert(InputIterator first, InputIterator last)
 	{
-		m_impl->insert(m_impl->end(), first, last);
-		std::sort(m_impl->begin(), m_impl->end(), Compare());
-		m_impl->erase(std::unique(m_impl->begin(), m_impl->end(), &equivalent), m_impl->end());
+		container_t& v = *m_impl;
+		v.insert(v.end(), first, last);
+		sortAndUnique(v);
 	}
 	iterator erase(iterator position)
 	{
@@ -208,10 +226,15 @@ public:
 	}
 	size_type erase(const key_type& x)
 	{
-		iterator i = std::lower_bound(m_impl->begin(), m_impl->end(), x, Compare());
-		if (i != m_impl->end() && equivalent(i->first, x))
+		// Search through a const view first, so that erasing a key that
+		// isn't there doesn't force a shared map to be copied.
+		const container_t& cv = *static_cast<const COWReference<container_t>&>(m_impl);
+		const_iterator ci = std::lower_bound(cv.begin(), cv.end(), x, Compare());
+		if (ci != cv.end() && equivalent(ci->first, x))
 		{
-			m_impl->erase(i);
+			difference_type offset = ci - cv.begin();
+			container_t& v = *m_impl;
+			v.erase(v.begin() + offset);
 			return 1;
 		}
 		else
@@ -241,14 +264,15 @@ public:
 	}
 	iterator find(const key_type& x)
 	{
-		iterator pos = std::lower_bound(m_impl->begin(), m_impl->end(), x, Compare());
-		if (pos != m_impl->end() && equivalent(pos->first, x))
+		container_t& v = *m_impl;
+		iterator pos = std::lower_bound(v.begin(), v.end(), x, Compare());
+		if (pos != v.end() && equivalent(pos->first, x))
 		{
 			return pos;
 		}
 		else
 		{
-			return m_impl->end();
+			return v.end();
 		}
 	}
 	size_type count(const key_type& x) const
@@ -285,6 +309,11 @@ private:
 		// Strict weak ordering: Two objects x and y are equivalent if both f(x, y) and f(y, x) are false.
 		return (!Compare()(x, y) && !Compare()(y, x));
 	}
+	static void sortAndUnique(container_t& v)
+	{
+		std::sort(v.begin(), v.end(), Compare());
+		v.erase(std::unique(v.begin(), v.end(), &equivalent), v.end());
+	}
 };
 template<class Key, class T, class Compare>
 inline bool operator==(const SortedVectorMap<Key, T, Compare>& x,
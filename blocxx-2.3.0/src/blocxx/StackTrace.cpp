@@ -48,6 +48,30 @@ void StackTrace::printStackTrace(EDoStackTraceFlag)
 {
 	cerr << "StackTrace::printStackTrace not implemented yet" << endl;
 }
+
+size_t StackTrace::capture(void**, size_t, size_t)
+{
+	return 0;
+}
+String StackTrace::symbolize(void*)
+{
+	return String();
+}
+String StackTrace::symbolize(void* const*, size_t)
+{
+	return String();
+}
+StackTrace::CallStack::CallStack()
+	: m_size(0)
+{
+}
+void StackTrace::CallStack::capture(size_t)
+{
+}
+String StackTrace::CallStack::toString() const
+{
+	return String();
+}
 }
 #else
 
@@ -56,16 +80,27 @@ void StackTrace::printStackTrace(EDoStackTraceFlag)
 #include "blocxx/Format.hpp"
 #include "blocxx/Array.hpp"
 #include "blocxx/StringBuffer.hpp"
+#include "blocxx/Demangle.hpp"
+#include "blocxx/GlobalMutex.hpp"
+#include "blocxx/MutexLock.hpp"
 
+#include <cstdio>
 #include <fstream>
 #include <iostream>	// for cerr
+#include <map>
 
 #if defined(BLOCXX_HAVE_BACKTRACE)
 #include <execinfo.h>
 #endif
 
-#if defined(BLOCXX_HAVE_CXXABI_H)
-#include <cxxabi.h>
+#if defined(BLOCXX_HAVE_DLADDR)
+#include <dlfcn.h>
+#endif
+
+#if defined(__GNUC__)
+#define BLOCXX_STACK_TRACE_NOINLINE __attribute__((noinline))
+#else
+#define BLOCXX_STACK_TRACE_NOINLINE
 #endif
 
 #ifdef BLOCXX_HAVE_UNISTD_H
@@ -86,6 +121,67 @@ using std::flush;
 #define BLOCXX_DEFAULT_GDB_PATH "/usr/bin/gdb"
 #endif
 
+namespace
+{
+#ifdef BLOCXX_HAVE_BACKTRACE
+	// glibc loads the unwinder, allocating memory, the first time
+	// backtrace() is called.  Get that done when the library is loaded so
+	// capture() is safe in signal handlers and allocation hooks.
+	bool loadUnwinder()
+	{
+		void* frame;
+		::backtrace(&frame, 1);
+		return true;
+	}
+	bool g_unwinderLoaded = loadUnwinder();
+#endif
+
+	// Symbol lookups are slow, and traces tend to repeat the same frames, so
+	// every address looked up is remembered.  The cache is never freed so
+	// it can be used during static destruction.
+	typedef std::map<void*, String> SymbolCache;
+	SymbolCache* g_symbolCache = 0;
+	GlobalMutex g_symbolCacheGuard = BLOCXX_GLOBAL_MUTEX_INIT();
+
+	String hexAddress(const void* p, size_t offset = 0)
+	{
+		char buf[32];
+		std::snprintf(buf, sizeof(buf), "0x%lx",
+			static_cast<unsigned long>(reinterpret_cast<size_t>(p) + offset));
+		return String(buf);
+	}
+
+	String lookUpSymbol(void* address)
+	{
+		StringBuffer rv;
+#ifdef BLOCXX_HAVE_DLADDR
+		// address is a return address, which is just past the call, and if
+		// the call was the last instruction of a function that's the start
+		// of the next one, so look up the byte before.
+		const char* ip = static_cast<const char*>(address);
+		Dl_info info;
+		if (::dladdr(ip - 1, &info) != 0 && info.dli_fname != 0)
+		{
+			rv += info.dli_fname;
+			rv += '(';
+			const char* base = static_cast<const char*>(info.dli_fbase);
+			if (info.dli_sname != 0 && info.dli_saddr != 0)
+			{
+				rv += demangleTypeName(info.dli_sname);
+				base = static_cast<const char*>(info.dli_saddr);
+			}
+			rv += '+';
+			rv += hexAddress(0, ip - base);
+			rv += ") ";
+		}
+#endif
+		rv += '[';
+		rv += hexAddress(address);
+		rv += ']';
+		return rv.releaseString();
+	}
+} // end unnamed namespace
+
 // static
 void StackTrace::printStackTrace(EDoStackTraceFlag doStackTrace)
 {
@@ -101,39 +197,9 @@ String StackTrace::getStackTrace(EDoStackTraceFlag doStackTrace)
 		// as good information as gdb does, but they are orders of magnitude
 		// faster!
 #ifdef BLOCXX_HAVE_BACKTRACE
-		void *array[200];
-
-		size_t size = backtrace (array, 200);
-		char **strings = backtrace_symbols (array, size);
-
-		StringBuffer bt;
-
-		size_t i;
-		for (i = 0; i < size; i++)
-		{
-#if defined(BLOCXX_HAVE_CXXABI_H)
-			bt += strings[i];
-			int status;
-			// extract the identifier from strings[i].  It's inside of parens.
-			char* firstparen = ::strchr(strings[i], '(');
-			char* lastparen = ::strchr(strings[i], '+');
-			if (firstparen != 0 && lastparen != 0 && firstparen < lastparen)
-			{
-				bt += ": ";
-				*lastparen = '\0';
-				char* realname = abi::__cxa_demangle(firstparen+1, 0, 0, &status);
-				bt += realname;
-				free(realname);
-			}
-#else
-			bt += strings[i];
-#endif
-			bt += "\n";
-		}
-
-		free (strings);
-
-		return bt.releaseString();
+		void* frames[200];
+		size_t size = capture(frames, 200);
+		return symbolize(frames, size);
 #else
 		ifstream file(BLOCXX_DEFAULT_GDB_PATH);
 		if (file)
@@ -177,6 +243,95 @@ String StackTrace::getStackTrace(EDoStackTraceFlag doStackTrace)
 	return String();
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Not inlined, so the number of frames to skip is right.
+BLOCXX_STACK_TRACE_NOINLINE
+size_t StackTrace::capture(void** frames, size_t maxFrames, size_t skipFrames)
+{
+#ifdef BLOCXX_HAVE_BACKTRACE
+	enum { MAX_CAPTURE = 128 };
+	void* buf[MAX_CAPTURE];
+	size_t wanted = maxFrames + skipFrames + 1;
+	if (wanted > MAX_CAPTURE)
+	{
+		wanted = MAX_CAPTURE;
+	}
+	int got = ::backtrace(buf, int(wanted));
+	// buf[0] is this function.
+	size_t first = skipFrames + 1;
+	if (got <= 0 || size_t(got) <= first)
+	{
+		return 0;
+	}
+	size_t count = size_t(got) - first;
+	if (count > maxFrames)
+	{
+		count = maxFrames;
+	}
+	for (size_t i = 0; i < count; ++i)
+	{
+		frames[i] = buf[first + i];
+	}
+	return count;
+#else
+	return 0;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////
+String StackTrace::symbolize(void* address)
+{
+	{
+		MutexLock lock(g_symbolCacheGuard);
+		if (g_symbolCache == 0)
+		{
+			g_symbolCache = new SymbolCache;
+		}
+		SymbolCache::const_iterator it = g_symbolCache->find(address);
+		if (it != g_symbolCache->end())
+		{
+			return it->second;
+		}
+	}
+	// dladdr() can be slow, so don't hold the lock.  If another thread looks
+	// up the same address meanwhile, the results are the same.
+	String symbol = lookUpSymbol(address);
+	MutexLock lock(g_symbolCacheGuard);
+	g_symbolCache->insert(SymbolCache::value_type(address, symbol));
+	return symbol;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+String StackTrace::symbolize(void* const* frames, size_t count)
+{
+	StringBuffer rv;
+	for (size_t i = 0; i < count; ++i)
+	{
+		rv += symbolize(frames[i]);
+		rv += '\n';
+	}
+	return rv.releaseString();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+StackTrace::CallStack::CallStack()
+	: m_size(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+BLOCXX_STACK_TRACE_NOINLINE
+void StackTrace::CallStack::capture(size_t skipFrames)
+{
+	m_size = StackTrace::capture(m_frames, MAX_FRAMES, skipFrames + 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+String StackTrace::CallStack::toString() const
+{
+	return symbolize(m_frames, m_size);
+}
+
 } // end namespace BLOCXX_NAMESPACE
 
 #endif	// ifdef BLOCXX_WIN32
@@ -56,6 +56,68 @@ namespace StackTrace
 	};
 	BLOCXX_COMMON_API void printStackTrace(EDoStackTraceFlag = E_CHECK_ENV_VAR);
 	BLOCXX_COMMON_API String getStackTrace(EDoStackTraceFlag = E_NO_CHECK_ENV_VAR);
+
+	/**
+	 * Store the return addresses of the calling thread's stack in frames,
+	 * innermost first, omitting this function and the skipFrames callers
+	 * above it.  No symbols are looked up, so this is cheap enough to call
+	 * from allocation hooks.  The unwinder is loaded when the library is,
+	 * so this doesn't allocate and can be called from a signal handler.
+	 *
+	 * @return The number of addresses stored, at most maxFrames.  Always 0
+	 * on platforms without backtrace().
+	 */
+	BLOCXX_COMMON_API size_t capture(void** frames, size_t maxFrames, size_t skipFrames = 0);
+
+	/**
+	 * @return A description of the code at address, of the form
+	 * "module(function+0x1f) [address]" with the function name demangled.
+	 * Lookups are cached for the life of the process, so symbolizing the
+	 * same frames again is cheap.
+	 */
+	BLOCXX_COMMON_API String symbolize(void* address);
+
+	/**
+	 * @return symbolize() of each of the frames, one per line.
+	 */
+	BLOCXX_COMMON_API String symbolize(void* const* frames, size_t count);
+
+	/**
+	 * A call stack captured without being symbolized, so it can be kept
+	 * cheaply and only turned into text if someone looks at it.
+	 */
+	class BLOCXX_COMMON_API CallStack
+	{
+	public:
+		enum { MAX_FRAMES = 32 };
+
+		CallStack();
+
+		/**
+		 * Replace the contents with the calling thread's stack, omitting
+		 * this function and the skipFrames callers above it.
+		 * Async-signal-safe, like StackTrace::capture().
+		 */
+		void capture(size_t skipFrames = 0);
+
+		size_t size() const
+		{
+			return m_size;
+		}
+		void* operator[](size_t i) const
+		{
+			return m_frames[i];
+		}
+
+		/**
+		 * @return The frames symbolized, one per line.
+		 */
+		String toString() const;
+
+	private:
+		size_t m_size;
+		void* m_frames[MAX_FRAMES];
+	};
 } // end namespace StackTrace
 
 } // end namespace BLOCXX_NAMESPACE
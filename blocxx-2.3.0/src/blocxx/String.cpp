@@ -49,6 +49,8 @@
 #include "blocxx/UTF8Utils.hpp"
 #include "blocxx/ExceptionIds.hpp"
 #include "blocxx/COWIntrusiveCountableBase.hpp"
+#include "blocxx/SmallObjectPool.hpp"
+#include "blocxx/SmallArray.hpp"
 #include "blocxx/StringConversionImpl.hpp"
 
 #include <cstdio>
@@ -64,12 +66,9 @@
 #include <iostream>
 #endif
 
-#include <cfloat> // for DBL_MANT_DIG
-
-#ifdef BLOCXX_WIN32
-#define SNPRINTF _snprintf
-#else
-#define SNPRINTF snprintf
+#include <limits>
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+#include <utility>
 #endif
 
 namespace BLOCXX_NAMESPACE
@@ -91,7 +90,8 @@ strncmpi(const char* s1, const char* s2, size_t n)
 }
 
 // class invariant: m_buf points to a null-terminated sequence of characters. m_buf is m_len+1 bytes long.
-class String::ByteBuf : public COWIntrusiveCountableBase
+// Every non-empty String has one, so they come from the SmallObjectPool.
+class String::ByteBuf : public COWIntrusiveCountableBase, public PooledObject
 {
 public:
 	ByteBuf(const char* s) :
@@ -146,27 +146,42 @@ String::String(const std::string& str) :
 	m_buf(str.empty() ? 0 : new ByteBuf(str.c_str()))
 {
 }
-#if defined(BLOCXX_WIN32)
-#define snprintf _snprintf // stupid windoze...
-#endif
+//////////////////////////////////////////////////////////////////////////////
+// Allocates the buffer for a ByteBuf and writes val into it in decimal.
+static char*
+newDecimalString(Int64 val, size_t& len)
+{
+	const UInt64 magnitude = val < 0 ? 0 - static_cast<UInt64>(val) : static_cast<UInt64>(val);
+	len = decimalDigitCount(magnitude) + (val < 0 ? 1 : 0);
+	char* bfr = new char[len+1];
+	bfr[len] = '\0';
+	formatSignedDecimal(val, bfr + len);
+	return bfr;
+}
+//////////////////////////////////////////////////////////////////////////////
+static char*
+newDecimalString(UInt64 val, size_t& len)
+{
+	len = decimalDigitCount(val);
+	char* bfr = new char[len+1];
+	bfr[len] = '\0';
+	formatUnsignedDecimal(val, bfr + len);
+	return bfr;
+}
 //////////////////////////////////////////////////////////////////////////////
 String::String(Int32 val) :
 	m_buf(NULL)
 {
-	char tmpbuf[32];
-	int len = snprintf(tmpbuf, sizeof(tmpbuf), "%d", val);
-	AutoPtrVec<char> bfr(new char[len+1]);
-	::snprintf(bfr.get(), len+1, "%d", val);
+	size_t len;
+	AutoPtrVec<char> bfr(newDecimalString(Int64(val), len));
 	m_buf = new ByteBuf(bfr, len);
 }
 //////////////////////////////////////////////////////////////////////////////
 String::String(UInt32 val) :
 	m_buf(NULL)
 {
-	char tmpbuf[32];
-	int len = ::snprintf(tmpbuf, sizeof(tmpbuf), "%u", val);
-	AutoPtrVec<char> bfr(new char[len+1]);
-	::snprintf(bfr.get(), len+1, "%u", val);
+	size_t len;
+	AutoPtrVec<char> bfr(newDecimalString(UInt64(val), len));
 	m_buf = new ByteBuf(bfr, len);
 }
 #if defined(BLOCXX_INT32_IS_INT) && defined(BLOCXX_INT64_IS_LONG_LONG)
@@ -174,81 +189,49 @@ String::String(UInt32 val) :
 String::String(long val) :
 	m_buf(NULL)
 {
-	char tmpbuf[32];
-	int len = snprintf(tmpbuf, sizeof(tmpbuf), "%ld", val);
-	AutoPtrVec<char> bfr(new char[len+1]);
-	::snprintf(bfr.get(), len+1, "%ld", val);
+	size_t len;
+	AutoPtrVec<char> bfr(newDecimalString(Int64(val), len));
 	m_buf = new ByteBuf(bfr, len);
 }
 //////////////////////////////////////////////////////////////////////////////
 String::String(unsigned long val) :
 	m_buf(NULL)
 {
-	char tmpbuf[32];
-	int len = ::snprintf(tmpbuf, sizeof(tmpbuf), "%lu", val);
-	AutoPtrVec<char> bfr(new char[len+1]);
-	::snprintf(bfr.get(), len+1, "%lu", val);
+	size_t len;
+	AutoPtrVec<char> bfr(newDecimalString(UInt64(val), len));
 	m_buf = new ByteBuf(bfr, len);
 }
 #endif
-#if defined(BLOCXX_WIN32)
-#undef snprintf
-#endif
 //////////////////////////////////////////////////////////////////////////////
 String::String(Int64 val) :
 	m_buf(NULL)
 {
-	OStringStream ss(33);
-	ss << val;
-	m_buf = new ByteBuf(ss.c_str());
+	size_t len;
+	AutoPtrVec<char> bfr(newDecimalString(val, len));
+	m_buf = new ByteBuf(bfr, len);
 }
 //////////////////////////////////////////////////////////////////////////////
 String::String(UInt64 val) :
 	m_buf(NULL)
 {
-#if defined(BLOCXX_INT64_IS_LONG)
-	char tmpbuf[32];
-	::snprintf(tmpbuf, sizeof(tmpbuf), "%lu", val);
-	m_buf = new ByteBuf(tmpbuf);
-#elif defined(BLOCXX_INT64_IS_LONG_LONG)
-	// unfortunately not all C libraries support long long with snprintf().
-	// but the C++ iostream library handles it.
-	OStringStream ss;
-	ss << val;
-	m_buf = new ByteBuf(ss.c_str());
-#endif
+	size_t len;
+	AutoPtrVec<char> bfr(newDecimalString(val, len));
+	m_buf = new ByteBuf(bfr, len);
 }
 //////////////////////////////////////////////////////////////////////////////
-// decimal digits = ceiling((bits)*ln(2)/ln(10))
 String::String(Real32 val) :
 	m_buf(NULL)
 {
-	char tmpbuf[128];
-#if FLT_RADIX == 2
-#if defined(BLOCXX_REAL32_IS_FLOAT)
-	::SNPRINTF(tmpbuf, sizeof(tmpbuf), "%.*g", FLT_MANT_DIG * 3 / 10 + 1, static_cast<double>(val));
-#elif defined(BLOCXX_REAL32_IS_DOUBLE)
-	::SNPRINTF(tmpbuf, sizeof(tmpbuf), "%.*g", DBL_MANT_DIG * 3 / 10 + 1, val);
-#endif
-#else
-#error "The formula for computing the number of digits of precision for a floating point needs to be implmented. It's ceiling(bits * log(FLT_RADIX) / log(10))"
-#endif
+	char tmpbuf[MAX_REAL_STRING_SIZE];
+	formatReal(val, tmpbuf);
 	m_buf = new ByteBuf(tmpbuf);
 }
 //////////////////////////////////////////////////////////////////////////////
 String::String(Real64 val) :
 	m_buf(NULL)
 {
-	char tmpbuf[128];
-#if FLT_RADIX == 2
-#if defined(BLOCXX_REAL64_IS_DOUBLE)
-	::SNPRINTF(tmpbuf, sizeof(tmpbuf), "%.*g", DBL_MANT_DIG * 3 / 10 + 1, val);
-#elif defined(BLOCXX_REAL64_IS_LONG_DOUBLE)
-	::SNPRINTF(tmpbuf, sizeof(tmpbuf), "%.*Lg", LDBL_MANT_DIG * 3 / 10 + 1, val);
-#endif
-#else
-#error "The formula for computing the number of digits of precision for a floating point needs to be implmented. It's ceiling(bits * log(FLT_RADIX) / log(10))"
-#endif
+	char tmpbuf[MAX_REAL_STRING_SIZE];
+	formatReal(val, tmpbuf);
 	m_buf = new ByteBuf(tmpbuf);
 }
 //////////////////////////////////////////////////////////////////////////////
@@ -286,6 +269,13 @@ String::String(const String& arg) :
 	m_buf(arg.m_buf)
 {
 }
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+//////////////////////////////////////////////////////////////////////////////
+String::String(String&& arg) BLOCXX_NOEXCEPT :
+	m_buf(std::move(arg.m_buf))
+{
+}
+#endif
 //////////////////////////////////////////////////////////////////////////////
 String::String(char c) :
 	m_buf(NULL)
@@ -849,6 +839,12 @@ String::readObject(streambuf & istrm)
 {
 	UInt32 len;
 	BinarySerialization::readLen(istrm, len);
+	if (len == 0)
+	{
+		m_buf = 0;
+		return;
+	}
+	// read straight into the buffer the ByteBuf will own
 	AutoPtrVec<char> bfr(new char[len+1]);
 	BinarySerialization::read(istrm, bfr.get(), len);
 	bfr[len] = '\0';
@@ -872,6 +868,15 @@ String::operator= (const String& arg)
 	m_buf = arg.m_buf;
 	return *this;
 }
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+//////////////////////////////////////////////////////////////////////////////
+String&
+String::operator= (String&& arg) BLOCXX_NOEXCEPT
+{
+	m_buf = std::move(arg.m_buf);
+	return *this;
+}
+#endif
 //////////////////////////////////////////////////////////////////////////////
 const char*
 String::c_str() const
@@ -963,6 +968,37 @@ String::toBool() const
 	}
 	return false; // to make compiler happy
 }
+// Converts the common case of a plain decimal number without strto*().
+// @return false if m_buf isn't one or the value doesn't fit in a T.
+template <typename T>
+static inline
+bool convertSimpleDecimal(const String::buf_t& m_buf, T& result)
+{
+	bool negative;
+	UInt64 magnitude;
+	if (!parseSimpleDecimal(m_buf->data(), m_buf->length(), negative, magnitude))
+	{
+		return false;
+	}
+	if (negative)
+	{
+		// Leave the strtoul() treatment of negative unsigned values alone.
+		if (!std::numeric_limits<T>::is_signed || magnitude > UInt64(std::numeric_limits<T>::max()) + 1)
+		{
+			return false;
+		}
+		result = static_cast<T>(0 - magnitude);
+	}
+	else
+	{
+		if (magnitude > UInt64(std::numeric_limits<T>::max()))
+		{
+			return false;
+		}
+		result = static_cast<T>(magnitude);
+	}
+	return true;
+}
 template <typename T, typename FP, typename FPRT>
 static inline
 T doConvertToIntType(const String::buf_t& m_buf, const char* type, FP fp, int base)
@@ -971,6 +1007,12 @@ T doConvertToIntType(const String::buf_t& m_buf, const char* type, FP fp, int ba
 	// we have to check for it explicitly.
 	if (m_buf && m_buf->length() > 0)
 	{
+		T simple;
+		if (base == 10 && convertSimpleDecimal(m_buf, simple))
+		{
+			return simple;
+		}
+
 		char* endptr(0);
 		errno = 0;		// errno is thread local
 		FPRT v = fp(m_buf->data(), &endptr, base);
@@ -1079,61 +1121,61 @@ String::toInt(int base) const
 StringArray
 String::tokenize(const char* delims, EReturnDelimitersFlag returnDelimitersAsTokens, EEmptyTokenReturnFlag returnEmptyTokens) const
 {
-	StringArray ra;
 	if (empty())
 	{
-		return ra;
+		return StringArray();
 	}
 	if (delims == 0)
 	{
-		ra.append(*this);
-		return ra;
+		return StringArray(1, *this);
 	}
 	// Don't need to check m_buf for NULL, because if length() == 0,
 	// this code won't be executed.
-	char* pstr = m_buf->data();
-	AutoPtrVec<char> data(new char[m_buf->length()+1]);
-	data[0] = 0;
-	int i = 0;
+	const char* pstr = m_buf->data();
+	bool isDelim[256] = { false };
+	for (const char* d = delims; *d; ++d)
+	{
+		isDelim[static_cast<unsigned char>(*d)] = true;
+	}
+	// Most strings only have a few tokens, so they're collected on the stack
+	// and copied into an Array of the right size at the end.
+	SmallArray<String, 16> tokens;
+	const char* tokenStart = pstr;
   	bool last_was_delim = false;
-	while (*pstr)
+	for (; *pstr; ++pstr)
 	{
-		if (String::strchr(delims, *pstr))
+		if (isDelim[static_cast<unsigned char>(*pstr)])
 		{
-			if (data[0] != 0)
+			if (pstr != tokenStart)
 			{
-				ra.append(String(data.get()));
-				data[0] = 0;
+				tokens.push_back(String(tokenStart, pstr - tokenStart));
 			}
 			if ( (returnEmptyTokens == E_RETURN_EMPTY_TOKENS) && last_was_delim )
 			{
-				ra.append(String());
+				tokens.push_back(String());
 			}
 			if ( returnDelimitersAsTokens == E_RETURN_DELIMITERS )
 			{
-				ra.append(String(*pstr));
+				tokens.push_back(String(*pstr));
 			}
-			i = 0;
+			tokenStart = pstr + 1;
 			last_was_delim = true;
 		}
 		else
 		{
 			last_was_delim = false;
-			data[i++] = *pstr;
-			data[i] = 0;
 		}
-		pstr++;
 	}
-	if (data[0] != 0)
+	if (pstr != tokenStart)
 	{
-		ra.append(String(data.get()));
+		tokens.push_back(String(tokenStart, pstr - tokenStart));
 	}
 	else if( (returnEmptyTokens == E_RETURN_EMPTY_TOKENS) && last_was_delim )
 	{
 		// It ended with a delimiter so there should be an empty token at the end.
-		ra.append(String());
+		tokens.push_back(String());
 	}
-	return ra;
+	return tokens.toArray();
 }
 
 //////////////////////////////////////////////////////////////////////////////
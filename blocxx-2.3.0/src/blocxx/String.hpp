@@ -176,6 +176,14 @@ public:
 	 * @param arg	The String object to make a copy of.
 	 */
 	String(const String& arg);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Create a new String object that takes over the buffer of another
+	 * String object, leaving it empty.  No reference counts are touched.
+	 * @param arg	The String object to move from.
+	 */
+	String(String&& arg) BLOCXX_NOEXCEPT;
+#endif
 	/**
 	 * Create a new String object that contains a single character.
 	 * @param c		The character that this string will contain.
@@ -548,6 +556,16 @@ public:
 	 * taken place.
 	 */
 	String& operator= (const String & arg);
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+	/**
+	 * Move assignment operator.
+	 * @param arg		The String object to move from. Its contents are
+	 * 					unspecified afterwards.
+	 * @return A reference to this String object after the assignment has
+	 * taken place.
+	 */
+	String& operator= (String&& arg) BLOCXX_NOEXCEPT;
+#endif
 	/**
 	 * Operator [].
 	 * @param ndx		The index of the character to retrieve from the underlying
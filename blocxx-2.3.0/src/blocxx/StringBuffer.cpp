@@ -39,6 +39,7 @@
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/StringBuffer.hpp"
 #include "blocxx/Char16.hpp"
+#include "blocxx/StringConversionImpl.hpp"
 
 #include <cstring>
 #include <cstdio>
@@ -50,7 +51,6 @@
 #include <iostream>
 #endif
 #include <algorithm> // for std::swap
-#include <cfloat> // for DBL_MANT_DIG
 
 namespace BLOCXX_NAMESPACE
 {
@@ -62,7 +62,29 @@ const size_t StringBuffer::BLOCXX_DEFAULT_ALLOCATION_UNIT = 128;
 StringBuffer::StringBuffer(size_t allocSize) :
 	m_len(0),
 	m_allocated(allocSize > 0 ? allocSize : BLOCXX_DEFAULT_ALLOCATION_UNIT),
-	m_bfr(new char[m_allocated])
+	m_bfr(new char[m_allocated]),
+	m_arena(0),
+	m_inline(0)
+{
+	m_bfr[0] = 0;
+}
+//////////////////////////////////////////////////////////////////////////////
+StringBuffer::StringBuffer(Arena& arena, size_t allocSize) :
+	m_len(0),
+	m_allocated(allocSize > 0 ? allocSize : BLOCXX_DEFAULT_ALLOCATION_UNIT),
+	m_bfr(static_cast<char*>(arena.allocate(m_allocated))),
+	m_arena(&arena),
+	m_inline(0)
+{
+	m_bfr[0] = 0;
+}
+//////////////////////////////////////////////////////////////////////////////
+StringBuffer::StringBuffer(char* inlineBuffer, size_t size) :
+	m_len(0),
+	m_allocated(size),
+	m_bfr(inlineBuffer),
+	m_arena(0),
+	m_inline(inlineBuffer)
 {
 	m_bfr[0] = 0;
 }
@@ -70,7 +92,9 @@ StringBuffer::StringBuffer(size_t allocSize) :
 StringBuffer::StringBuffer(const char* arg) :
 	m_len(strlen(arg)),
 	m_allocated(m_len + BLOCXX_DEFAULT_ALLOCATION_UNIT),
-	m_bfr(new char[m_allocated])
+	m_bfr(new char[m_allocated]),
+	m_arena(0),
+	m_inline(0)
 {
 	::strcpy(m_bfr, arg);
 }
@@ -78,14 +102,18 @@ StringBuffer::StringBuffer(const char* arg) :
 StringBuffer::StringBuffer(const String& arg) :
 	m_len(arg.length()),
 	m_allocated(m_len + BLOCXX_DEFAULT_ALLOCATION_UNIT),
-	m_bfr(new char[m_allocated])
+	m_bfr(new char[m_allocated]),
+	m_arena(0),
+	m_inline(0)
 {
 	::strcpy(m_bfr, arg.c_str());
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer::StringBuffer(const StringBuffer& arg) :
 	m_len(arg.m_len), m_allocated(arg.m_allocated),
-	m_bfr(new char[arg.m_allocated])
+	m_bfr(new char[arg.m_allocated]),
+	m_arena(0),
+	m_inline(0)
 {
 	::memmove(m_bfr, arg.m_bfr, arg.m_len + 1);
 }
@@ -114,9 +142,33 @@ StringBuffer::operator =(const StringBuffer& arg)
 void
 StringBuffer::swap(StringBuffer& x)
 {
+	// A buffer inside one of the objects can't change hands, so copy.
+	if ((m_inline != 0 && m_bfr == m_inline) || (x.m_inline != 0 && x.m_bfr == x.m_inline))
+	{
+		StringBuffer tmp(*this);
+		assign(x.m_bfr, x.m_len);
+		x.assign(tmp.m_bfr, tmp.m_len);
+		return;
+	}
 	std::swap(m_len, x.m_len);
 	std::swap(m_allocated, x.m_allocated);
 	std::swap(m_bfr, x.m_bfr);
+	std::swap(m_arena, x.m_arena);
+}
+//////////////////////////////////////////////////////////////////////////////
+void
+StringBuffer::assign(const char* str, size_t len)
+{
+	if (len + 1 > m_allocated)
+	{
+		char* bfr = allocBuffer(len + 1);
+		freeBuffer(m_bfr);
+		m_bfr = bfr;
+		m_allocated = len + 1;
+	}
+	::memmove(m_bfr, str, len);
+	m_len = len;
+	m_bfr[m_len] = '\0';
 }
 //////////////////////////////////////////////////////////////////////////////
 void
@@ -150,135 +202,112 @@ StringBuffer::operator += (Bool v)
 {
 	return append(v.toString());
 }
-#if defined(BLOCXX_WIN32)
-#define snprintf _snprintf // stupid windoze...
-#endif
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (UInt8 v)
 {
-	char bfr[6];
-	::snprintf(bfr, sizeof(bfr), "%u", UInt32(v));
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatUnsignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (Int8 v)
 {
-	char bfr[6];
-	::snprintf(bfr, sizeof(bfr), "%d", Int32(v));
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatSignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (UInt16 v)
 {
-	char bfr[16];
-	::snprintf(bfr, sizeof(bfr), "%u", UInt32(v));
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatUnsignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (Int16 v)
 {
-	char bfr[16];
-	::snprintf(bfr, sizeof(bfr), "%d", Int32(v));
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatSignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (UInt32 v)
 {
-	char bfr[16];
-	::snprintf(bfr, sizeof(bfr), "%u", v);
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatUnsignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (Int32 v)
 {
-	char bfr[16];
-	::snprintf(bfr, sizeof(bfr), "%d", v);
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatSignedDecimal(v, end);
+	return append(start, end - start);
 }
 #if defined(BLOCXX_INT32_IS_INT) && defined(BLOCXX_INT64_IS_LONG_LONG)
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (unsigned long v)
 {
-	char bfr[28];
-	::snprintf(bfr, sizeof(bfr), "%lu", v);
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatUnsignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (long v)
 {
-	char bfr[28];
-	::snprintf(bfr, sizeof(bfr), "%ld", v);
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatSignedDecimal(v, end);
+	return append(start, end - start);
 }
 #endif
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (UInt64 v)
 {
-	char bfr[28];
-#if BLOCXX_SIZEOF_LONG_INT == 8
-	::snprintf(bfr, sizeof(bfr), "%lu", v);
-#else
-	::snprintf(bfr, sizeof(bfr), "%llu", v);
-#endif
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatUnsignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (Int64 v)
 {
-	char bfr[28];
-#if BLOCXX_SIZEOF_LONG_INT == 8
-	::snprintf(bfr, sizeof(bfr), "%ld", v);
-#else
-	::snprintf(bfr, sizeof(bfr), "%lld", v);
-#endif
-	return append(bfr);
+	char bfr[24];
+	char* end = bfr + sizeof(bfr);
+	const char* start = formatSignedDecimal(v, end);
+	return append(start, end - start);
 }
 //////////////////////////////////////////////////////////////////////////////
-// decimal digits = ceiling((bits)*ln(2)/ln(10))
 StringBuffer&
 StringBuffer::operator += (Real32 v)
 {
-	char bfr[128];
-#if FLT_RADIX == 2
-#if defined(BLOCXX_REAL32_IS_FLOAT)
-	::snprintf(bfr, sizeof(bfr), "%.*g", FLT_MANT_DIG * 3 / 10 + 1, static_cast<double>(v));
-#elif defined(BLOCXX_REAL32_IS_DOUBLE)
-	::snprintf(bfr, sizeof(bfr), "%.*g", DBL_MANT_DIG * 3 / 10 + 1, v);
-#endif
-#else
-#error "The formula for computing the number of digits of precision for a floating point needs to be implmented. It's ceiling(bits * log(FLT_RADIX) / log(10))"
-#endif
-	return append(bfr);
+	char bfr[MAX_REAL_STRING_SIZE];
+	return append(bfr, formatReal(v, bfr));
 }
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::operator += (Real64 v)
 {
-	char bfr[32];
-#if FLT_RADIX == 2
-#if defined(BLOCXX_REAL64_IS_DOUBLE)
-	::snprintf(bfr, sizeof(bfr), "%.*g", DBL_MANT_DIG * 3 / 10 + 1, v);
-#elif defined(BLOCXX_REAL64_IS_LONG_DOUBLE)
-	::snprintf(bfr, sizeof(bfr), "%.*Lg", LDBL_MANT_DIG * 3 / 10 + 1, v);
-#endif
-#else
-#error "The formula for computing the number of digits of precision for a floating point needs to be implmented. It's ceiling(bits * log(FLT_RADIX) / log(10))"
-#endif
-	return append(bfr);
+	char bfr[MAX_REAL_STRING_SIZE];
+	return append(bfr, formatReal(v, bfr));
 }
-#if defined(BLOCXX_WIN32)
-#undef snprintf
-#endif
 //////////////////////////////////////////////////////////////////////////////
 StringBuffer&
 StringBuffer::append(const char* str, const size_t len)
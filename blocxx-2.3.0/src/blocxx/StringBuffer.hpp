@@ -42,6 +42,7 @@
 #include "blocxx/String.hpp"
 #include "blocxx/Char16.hpp"
 #include "blocxx/Bool.hpp"
+#include "blocxx/Arena.hpp"
 #include <iosfwd>
 #include <cstring>
 
@@ -57,10 +58,17 @@ public:
 	static const size_t BLOCXX_DEFAULT_ALLOCATION_UNIT = 128;
 #endif // BLOCXX_AIX
 	StringBuffer(size_t allocSize = BLOCXX_DEFAULT_ALLOCATION_UNIT);
+	/**
+	 * Construct a StringBuffer that allocates its buffer from an Arena
+	 * instead of the heap, so it doesn't free it.  The arena must outlive
+	 * the StringBuffer.  Copies of the StringBuffer and the String from
+	 * releaseString() are allocated from the heap as usual.
+	 */
+	explicit StringBuffer(Arena& arena, size_t allocSize = BLOCXX_DEFAULT_ALLOCATION_UNIT);
 	StringBuffer(const char* arg);
 	StringBuffer(const String& arg);
 	StringBuffer(const StringBuffer& arg);
-	~StringBuffer() { delete [] m_bfr; }
+	~StringBuffer() { freeBuffer(m_bfr); }
 	StringBuffer& operator= (const StringBuffer& arg);
 	StringBuffer& operator= (const String& arg);
 	StringBuffer& operator= (const char* str);
@@ -123,6 +131,10 @@ public:
 	{
 		char * bfr = m_bfr;
 		m_bfr = 0;
+		if (m_arena || bfr == m_inline)
+		{
+			return String(bfr, m_len);
+		}
 		return String(String::E_TAKE_OWNERSHIP, bfr, m_len);
 	}
 	size_t length() const {  return m_len; }
@@ -155,6 +167,18 @@ public:
 	bool equals(const char* arg) const;
 	bool equals(const StringBuffer& arg) const;
 	friend BLOCXX_COMMON_API std::ostream& operator<<(std::ostream& ostr, const StringBuffer& b);
+protected:
+	/**
+	 * For InlineStringBuffer: start out with the size bytes at inlineBuffer,
+	 * which the StringBuffer doesn't own, and only allocate from the heap if
+	 * it needs more.
+	 */
+	StringBuffer(char* inlineBuffer, size_t size);
+	/**
+	 * Replace the contents with len characters from str, reusing the
+	 * current buffer if it's big enough.
+	 */
+	void assign(const char* str, size_t len);
 private:
 	void checkAvail(size_t len=1)
 	{
@@ -163,16 +187,83 @@ private:
 		if (len > freeSpace)
 		{
 			size_t toalloc = m_allocated * 2 + len;
-			char* bfr = new char[toalloc];
+			char* bfr = allocBuffer(toalloc);
 			::memmove(bfr, m_bfr, m_len);
-			delete [] m_bfr;
+			freeBuffer(m_bfr);
 			m_allocated = toalloc;
 			m_bfr = bfr;
 		}
 	}
+	char* allocBuffer(size_t size)
+	{
+		return m_arena ? static_cast<char*>(m_arena->allocate(size)) : new char[size];
+	}
+	void freeBuffer(char* bfr)
+	{
+		if (!m_arena && bfr != m_inline)
+		{
+			delete [] bfr;
+		}
+	}
 	size_t m_len;
 	size_t m_allocated;
 	char* m_bfr;
+	Arena* m_arena;
+	char* m_inline;
+};
+
+/**
+ * A StringBuffer with room for N - 1 characters inside the object, so a
+ * short string can be built on the stack without allocating.  If it grows
+ * past that it moves to the heap like any other StringBuffer.
+ * releaseString() copies a string that's still inside the object, and
+ * takes over the buffer of one that isn't.
+ */
+template <size_t N>
+class InlineStringBuffer : public StringBuffer
+{
+public:
+	InlineStringBuffer()
+		: StringBuffer(m_storage, N)
+	{
+	}
+	explicit InlineStringBuffer(const char* arg)
+		: StringBuffer(m_storage, N)
+	{
+		append(arg);
+	}
+	explicit InlineStringBuffer(const String& arg)
+		: StringBuffer(m_storage, N)
+	{
+		append(arg);
+	}
+	InlineStringBuffer(const InlineStringBuffer<N>& arg)
+		: StringBuffer(m_storage, N)
+	{
+		append(arg);
+	}
+	InlineStringBuffer<N>& operator=(const InlineStringBuffer<N>& arg)
+	{
+		assign(arg.c_str(), arg.length());
+		return *this;
+	}
+	InlineStringBuffer<N>& operator=(const StringBuffer& arg)
+	{
+		assign(arg.c_str(), arg.length());
+		return *this;
+	}
+	InlineStringBuffer<N>& operator=(const String& arg)
+	{
+		assign(arg.c_str(), arg.length());
+		return *this;
+	}
+	InlineStringBuffer<N>& operator=(const char* arg)
+	{
+		assign(arg, ::strlen(arg));
+		return *this;
+	}
+private:
+	char m_storage[N];
 };
 
 BLOCXX_COMMON_API bool operator==(const StringBuffer& x, const StringBuffer& y);
@@ -47,6 +47,16 @@
 #include <cfloat> // for DBL_MANT_DIG
 #include <limits>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <algorithm> // for std::min
+
+// The fast path of parseSimpleReal() relies on each floating point operation
+// being rounded once, to the precision of its type (i.e. not through the
+// 80 bit x87 registers).
+#if (defined(__FLT_EVAL_METHOD__) && __FLT_EVAL_METHOD__ == 0) || defined(_M_X64)
+#define BLOCXX_FLOAT_EVAL_IS_EXACT
+#endif
 
 namespace BLOCXX_NAMESPACE
 {
@@ -60,6 +70,12 @@ namespace BLOCXX_NAMESPACE
 		{
 			if (!str.empty())
 			{
+				T simple;
+				if (parseSimpleReal(str.c_str(), str.length(), simple))
+				{
+					return simple;
+				}
+
 				const char* begin = str.c_str();
 				const char* end = str.c_str() + str.length();
 				const char* current = begin;
@@ -444,4 +460,722 @@ yy56:
 		return convertToRealTypeHelper<Real64>(str, "Real64", &strtold);
 #endif
 	}
+
+	namespace // anonymous
+	{
+		// Pairs of decimal digits, "00" through "99".
+		const char DIGIT_PAIRS[] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+
+		// True if all 8 bytes of chunk are '0' to '9'.
+		inline bool isEightDigits(UInt64 chunk)
+		{
+			return (chunk & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL
+				&& ((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL;
+		}
+
+		// Converts 8 digits loaded little endian, so the first digit is in the
+		// low byte, by combining neighbouring digits, then pairs, then quads.
+		inline UInt32 parseEightDigits(UInt64 chunk)
+		{
+			chunk -= 0x3030303030303030ULL;
+			chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FFULL;
+			chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+			chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+			return static_cast<UInt32>(chunk);
+		}
+
+		inline bool isDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		// Lays out the digits of digits * 10^exponent the way printf's %g
+		// does with the given precision, except that the digits are never
+		// padded to the precision.
+		size_t layoutReal(bool negative, const char* digits, int len, int exponent, int precision, char* buf)
+		{
+			// Trailing zeros are only in the way.
+			while (len > 1 && digits[len - 1] == '0')
+			{
+				--len;
+				++exponent;
+			}
+
+			char* p = buf;
+			if (negative)
+			{
+				*p++ = '-';
+			}
+			// The exponent of the first digit.
+			int x = len + exponent - 1;
+			if (x >= -4 && x < precision)
+			{
+				if (exponent >= 0)
+				{
+					memcpy(p, digits, len);
+					p += len;
+					memset(p, '0', exponent);
+					p += exponent;
+				}
+				else if (x >= 0)
+				{
+					memcpy(p, digits, x + 1);
+					p += x + 1;
+					*p++ = '.';
+					memcpy(p, digits + x + 1, len - x - 1);
+					p += len - x - 1;
+				}
+				else
+				{
+					*p++ = '0';
+					*p++ = '.';
+					memset(p, '0', -x - 1);
+					p += -x - 1;
+					memcpy(p, digits, len);
+					p += len;
+				}
+			}
+			else
+			{
+				*p++ = digits[0];
+				if (len > 1)
+				{
+					*p++ = '.';
+					memcpy(p, digits + 1, len - 1);
+					p += len - 1;
+				}
+				*p++ = 'e';
+				if (x < 0)
+				{
+					*p++ = '-';
+					x = -x;
+				}
+				else
+				{
+					*p++ = '+';
+				}
+				if (x < 10)
+				{
+					*p++ = '0';
+				}
+				p += decimalDigitCount(x);
+				formatUnsignedDecimal(x, p);
+			}
+			*p = '\0';
+			return p - buf;
+		}
+
+		// The shortest digits are found with Florian Loitsch's Grisu2
+		// algorithm ("Printing Floating-Point Numbers Quickly and
+		// Accurately with Integers", PLDI 2010).  The digits always read back
+		// as the original value and are the shortest such digits for all but
+		// a tiny fraction of values.
+
+		// A floating point number f * 2^e with a 64 bit significand.
+		struct DiyFp
+		{
+			DiyFp(UInt64 f_, int e_)
+				: f(f_)
+				, e(e_)
+			{
+			}
+			UInt64 f;
+			int e;
+		};
+
+		inline DiyFp sub(const DiyFp& x, const DiyFp& y)
+		{
+			return DiyFp(x.f - y.f, x.e);
+		}
+
+		// x * y, rounded to the upper 64 bits of the product.
+		DiyFp mul(const DiyFp& x, const DiyFp& y)
+		{
+			const UInt64 xLo = x.f & 0xFFFFFFFFU;
+			const UInt64 xHi = x.f >> 32;
+			const UInt64 yLo = y.f & 0xFFFFFFFFU;
+			const UInt64 yHi = y.f >> 32;
+
+			const UInt64 p0 = xLo * yLo;
+			const UInt64 p1 = xLo * yHi;
+			const UInt64 p2 = xHi * yLo;
+			const UInt64 p3 = xHi * yHi;
+
+			UInt64 q = (p0 >> 32) + (p1 & 0xFFFFFFFFU) + (p2 & 0xFFFFFFFFU);
+			q += UInt64(1) << 31; // round
+			const UInt64 h = p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32);
+			return DiyFp(h, x.e + y.e + 64);
+		}
+
+		DiyFp normalize(DiyFp x)
+		{
+			while ((x.f >> 63) == 0)
+			{
+				x.f <<= 1;
+				--x.e;
+			}
+			return x;
+		}
+
+		DiyFp normalizeTo(const DiyFp& x, int e)
+		{
+			return DiyFp(x.f << (x.e - e), e);
+		}
+
+		// The value, and the boundaries half way to its neighbours, which
+		// share the exponent of the upper one.
+		struct Boundaries
+		{
+			Boundaries(const DiyFp& w_, const DiyFp& minus_, const DiyFp& plus_)
+				: w(w_)
+				, minus(minus_)
+				, plus(plus_)
+			{
+			}
+			DiyFp w;
+			DiyFp minus;
+			DiyFp plus;
+		};
+
+		// fraction and biasedExponent are the raw fields of an IEEE 754 value
+		// > 0 whose significand has precision bits, including the hidden one.
+		Boundaries computeBoundaries(UInt64 fraction, int biasedExponent, int precision, int maxExponent)
+		{
+			const int bias = maxExponent - 1 + (precision - 1);
+			const UInt64 hiddenBit = UInt64(1) << (precision - 1);
+			const DiyFp v = biasedExponent == 0
+				? DiyFp(fraction, 1 - bias)
+				: DiyFp(fraction + hiddenBit, biasedExponent - bias);
+
+			// The gap to the next lower value is half as big when v is a
+			// power of two (and not the smallest normal value).
+			const bool lowerBoundaryIsCloser = fraction == 0 && biasedExponent > 1;
+			const DiyFp mPlus(2 * v.f + 1, v.e - 1);
+			const DiyFp mMinus = lowerBoundaryIsCloser
+				? DiyFp(4 * v.f - 1, v.e - 2)
+				: DiyFp(2 * v.f - 1, v.e - 1);
+
+			const DiyFp plus = normalize(mPlus);
+			return Boundaries(normalize(v), normalizeTo(mMinus, plus.e), plus);
+		}
+
+		// The range the scaled upper boundary's exponent is brought into, so
+		// its integral part fits in 32 bits.
+		const int ALPHA = -60;
+		const int GAMMA = -32;
+
+		struct CachedPower
+		{
+			UInt64 f;
+			int e;
+			int k;
+		};
+
+		// Normalized approximations of 10^k for every 8th k, which is enough
+		// to scale any double into [ALPHA, GAMMA].
+		const int CACHED_POWERS_MIN_DEC_EXP = -300;
+		const int CACHED_POWERS_DEC_STEP = 8;
+		const CachedPower CACHED_POWERS[] =
+		{
+		{ 0xAB70FE17C79AC6CAULL, -1060, -300 },
+		{ 0xFF77B1FCBEBCDC4FULL, -1034, -292 },
+		{ 0xBE5691EF416BD60CULL, -1007, -284 },
+		{ 0x8DD01FAD907FFC3CULL, -980, -276 },
+		{ 0xD3515C2831559A83ULL, -954, -268 },
+		{ 0x9D71AC8FADA6C9B5ULL, -927, -260 },
+		{ 0xEA9C227723EE8BCBULL, -901, -252 },
+		{ 0xAECC49914078536DULL, -874, -244 },
+		{ 0x823C12795DB6CE57ULL, -847, -236 },
+		{ 0xC21094364DFB5637ULL, -821, -228 },
+		{ 0x9096EA6F3848984FULL, -794, -220 },
+		{ 0xD77485CB25823AC7ULL, -768, -212 },
+		{ 0xA086CFCD97BF97F4ULL, -741, -204 },
+		{ 0xEF340A98172AACE5ULL, -715, -196 },
+		{ 0xB23867FB2A35B28EULL, -688, -188 },
+		{ 0x84C8D4DFD2C63F3BULL, -661, -180 },
+		{ 0xC5DD44271AD3CDBAULL, -635, -172 },
+		{ 0x936B9FCEBB25C996ULL, -608, -164 },
+		{ 0xDBAC6C247D62A584ULL, -582, -156 },
+		{ 0xA3AB66580D5FDAF6ULL, -555, -148 },
+		{ 0xF3E2F893DEC3F126ULL, -529, -140 },
+		{ 0xB5B5ADA8AAFF80B8ULL, -502, -132 },
+		{ 0x87625F056C7C4A8BULL, -475, -124 },
+		{ 0xC9BCFF6034C13053ULL, -449, -116 },
+		{ 0x964E858C91BA2655ULL, -422, -108 },
+		{ 0xDFF9772470297EBDULL, -396, -100 },
+		{ 0xA6DFBD9FB8E5B88FULL, -369, -92 },
+		{ 0xF8A95FCF88747D94ULL, -343, -84 },
+		{ 0xB94470938FA89BCFULL, -316, -76 },
+		{ 0x8A08F0F8BF0F156BULL, -289, -68 },
+		{ 0xCDB02555653131B6ULL, -263, -60 },
+		{ 0x993FE2C6D07B7FACULL, -236, -52 },
+		{ 0xE45C10C42A2B3B06ULL, -210, -44 },
+		{ 0xAA242499697392D3ULL, -183, -36 },
+		{ 0xFD87B5F28300CA0EULL, -157, -28 },
+		{ 0xBCE5086492111AEBULL, -130, -20 },
+		{ 0x8CBCCC096F5088CCULL, -103, -12 },
+		{ 0xD1B71758E219652CULL, -77, -4 },
+		{ 0x9C40000000000000ULL, -50, 4 },
+		{ 0xE8D4A51000000000ULL, -24, 12 },
+		{ 0xAD78EBC5AC620000ULL, 3, 20 },
+		{ 0x813F3978F8940984ULL, 30, 28 },
+		{ 0xC097CE7BC90715B3ULL, 56, 36 },
+		{ 0x8F7E32CE7BEA5C70ULL, 83, 44 },
+		{ 0xD5D238A4ABE98068ULL, 109, 52 },
+		{ 0x9F4F2726179A2245ULL, 136, 60 },
+		{ 0xED63A231D4C4FB27ULL, 162, 68 },
+		{ 0xB0DE65388CC8ADA8ULL, 189, 76 },
+		{ 0x83C7088E1AAB65DBULL, 216, 84 },
+		{ 0xC45D1DF942711D9AULL, 242, 92 },
+		{ 0x924D692CA61BE758ULL, 269, 100 },
+		{ 0xDA01EE641A708DEAULL, 295, 108 },
+		{ 0xA26DA3999AEF774AULL, 322, 116 },
+		{ 0xF209787BB47D6B85ULL, 348, 124 },
+		{ 0xB454E4A179DD1877ULL, 375, 132 },
+		{ 0x865B86925B9BC5C2ULL, 402, 140 },
+		{ 0xC83553C5C8965D3DULL, 428, 148 },
+		{ 0x952AB45CFA97A0B3ULL, 455, 156 },
+		{ 0xDE469FBD99A05FE3ULL, 481, 164 },
+		{ 0xA59BC234DB398C25ULL, 508, 172 },
+		{ 0xF6C69A72A3989F5CULL, 534, 180 },
+		{ 0xB7DCBF5354E9BECEULL, 561, 188 },
+		{ 0x88FCF317F22241E2ULL, 588, 196 },
+		{ 0xCC20CE9BD35C78A5ULL, 614, 204 },
+		{ 0x98165AF37B2153DFULL, 641, 212 },
+		{ 0xE2A0B5DC971F303AULL, 667, 220 },
+		{ 0xA8D9D1535CE3B396ULL, 694, 228 },
+		{ 0xFB9B7CD9A4A7443CULL, 720, 236 },
+		{ 0xBB764C4CA7A44410ULL, 747, 244 },
+		{ 0x8BAB8EEFB6409C1AULL, 774, 252 },
+		{ 0xD01FEF10A657842CULL, 800, 260 },
+		{ 0x9B10A4E5E9913129ULL, 827, 268 },
+		{ 0xE7109BFBA19C0C9DULL, 853, 276 },
+		{ 0xAC2820D9623BF429ULL, 880, 284 },
+		{ 0x80444B5E7AA7CF85ULL, 907, 292 },
+		{ 0xBF21E44003ACDD2DULL, 933, 300 },
+		{ 0x8E679C2F5E44FF8FULL, 960, 308 },
+		{ 0xD433179D9C8CB841ULL, 986, 316 },
+		{ 0x9E19DB92B4E31BA9ULL, 1013, 324 },
+		};
+
+		// @return A power of ten c such that the exponent of a number with
+		//   binary exponent e multiplied by c is in [ALPHA, GAMMA].
+		const CachedPower& getCachedPowerForBinaryExponent(int e)
+		{
+			// k = ceil((ALPHA - e - 1) * log10(2)); 78913 / 2^18 approximates
+			// log10(2), and the division rounds toward zero, which is the
+			// ceiling for negative values.
+			const int f = ALPHA - e - 1;
+			const int k = (f * 78913) / (1 << 18) + (f > 0);
+			const int index = (-CACHED_POWERS_MIN_DEC_EXP + k + (CACHED_POWERS_DEC_STEP - 1)) / CACHED_POWERS_DEC_STEP;
+			return CACHED_POWERS[index];
+		}
+
+		// @return The number of digits of n, and pow10 = 10^(that - 1).
+		int findLargestPow10(UInt32 n, UInt32& pow10)
+		{
+			static const UInt32 POWERS[] =
+			{
+				1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+			};
+			int digits = 10;
+			while (digits > 1 && n < POWERS[digits - 1])
+			{
+				--digits;
+			}
+			pow10 = POWERS[digits - 1];
+			return digits;
+		}
+
+		// Moves the last digit towards w while that stays inside the
+		// boundaries.
+		void grisu2Round(char* buf, int len, UInt64 dist, UInt64 delta, UInt64 rest, UInt64 tenK)
+		{
+			while (rest < dist && delta - rest >= tenK
+				&& (rest + tenK < dist || dist - rest > rest + tenK - dist))
+			{
+				--buf[len - 1];
+				rest += tenK;
+			}
+		}
+
+		// Generates the digits of mPlus until they are within mMinus.
+		void grisu2DigitGen(char* buf, int& len, int& decimalExponent, const DiyFp& mMinus, const DiyFp& w, const DiyFp& mPlus)
+		{
+			UInt64 delta = sub(mPlus, mMinus).f;
+			UInt64 dist = sub(mPlus, w).f;
+
+			// Split mPlus into its integral part p1 and fractional part p2.
+			const DiyFp one(UInt64(1) << -mPlus.e, mPlus.e);
+			UInt32 p1 = static_cast<UInt32>(mPlus.f >> -one.e);
+			UInt64 p2 = mPlus.f & (one.f - 1);
+
+			UInt32 pow10;
+			int n = findLargestPow10(p1, pow10);
+			while (n > 0)
+			{
+				const UInt32 d = p1 / pow10;
+				p1 %= pow10;
+				buf[len++] = static_cast<char>('0' + d);
+				--n;
+
+				const UInt64 rest = (UInt64(p1) << -one.e) + p2;
+				if (rest <= delta)
+				{
+					decimalExponent += n;
+					grisu2Round(buf, len, dist, delta, rest, UInt64(pow10) << -one.e);
+					return;
+				}
+				pow10 /= 10;
+			}
+
+			int m = 0;
+			for (;;)
+			{
+				p2 *= 10;
+				const UInt64 d = p2 >> -one.e;
+				p2 &= one.f - 1;
+				buf[len++] = static_cast<char>('0' + d);
+				++m;
+
+				delta *= 10;
+				dist *= 10;
+				if (p2 <= delta)
+				{
+					break;
+				}
+			}
+			decimalExponent -= m;
+			grisu2Round(buf, len, dist, delta, p2, one.f);
+		}
+
+		// Writes the digits of a value > 0 to buf (at least 17 chars).  The
+		// value is digits * 10^decimalExponent.
+		void grisu2(char* buf, int& len, int& decimalExponent, const Boundaries& b)
+		{
+			const CachedPower& cached = getCachedPowerForBinaryExponent(b.plus.e);
+			const DiyFp c(cached.f, cached.e);
+
+			const DiyFp w = mul(b.w, c);
+			const DiyFp wMinus = mul(b.minus, c);
+			const DiyFp wPlus = mul(b.plus, c);
+
+			// The products may be off by one in the last place; shrink the
+			// boundaries so the result is inside the real ones.
+			const DiyFp mMinus(wMinus.f + 1, wMinus.e);
+			const DiyFp mPlus(wPlus.f - 1, wPlus.e);
+
+			len = 0;
+			decimalExponent = -cached.k;
+			grisu2DigitGen(buf, len, decimalExponent, mMinus, w, mPlus);
+		}
+
+		template <typename T>
+		size_t formatNonFinite(T val, char* buf)
+		{
+			// Keep whatever the C library calls these.
+			return ::snprintf(buf, MAX_REAL_STRING_SIZE, "%g", static_cast<double>(val));
+		}
+
+		// The precision %g would be given to print all of a type's digits:
+		// ceiling(bits * log10(2)).
+		const int FLOAT_PRECISION = FLT_MANT_DIG * 3 / 10 + 1;
+		const int DOUBLE_PRECISION = DBL_MANT_DIG * 3 / 10 + 1;
+
+		// Exactly representable powers of ten, for parseSimpleReal().
+		const double DOUBLE_POWERS_OF_TEN[] =
+		{
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+		const float FLOAT_POWERS_OF_TEN[] =
+		{
+			1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+		};
+
+		// mantissa is the value of the digits ignoring the decimal point, and
+		// must not exceed maxMantissa for the conversion to it to be exact.
+		template <typename T>
+		bool parseSimpleRealImpl(const char* str, size_t len, UInt64 maxMantissa,
+			const T* powersOfTen, int maxPowerOfTen, T& result)
+		{
+			const char* p = str;
+			const char* end = str + len;
+			bool negative = false;
+			if (p != end && (*p == '-' || *p == '+'))
+			{
+				negative = *p == '-';
+				++p;
+			}
+
+			UInt64 mantissa = 0;
+			int exponent = 0;
+			bool haveDigits = false;
+			for (; p != end && isDigit(*p); ++p)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa > maxMantissa)
+				{
+					return false;
+				}
+				haveDigits = true;
+			}
+			if (p != end && *p == '.')
+			{
+				for (++p; p != end && isDigit(*p); ++p)
+				{
+					mantissa = mantissa * 10 + (*p - '0');
+					if (mantissa > maxMantissa)
+					{
+						return false;
+					}
+					--exponent;
+					haveDigits = true;
+				}
+			}
+			if (!haveDigits)
+			{
+				return false;
+			}
+
+			if (p != end && (*p == 'e' || *p == 'E'))
+			{
+				++p;
+				bool negativeExponent = false;
+				if (p != end && (*p == '-' || *p == '+'))
+				{
+					negativeExponent = *p == '-';
+					++p;
+				}
+				if (p == end || !isDigit(*p))
+				{
+					return false;
+				}
+				int e = 0;
+				for (; p != end && isDigit(*p); ++p)
+				{
+					// Anything this large is out of range anyway.
+					if (e < 100000)
+					{
+						e = e * 10 + (*p - '0');
+					}
+				}
+				exponent += negativeExponent ? -e : e;
+			}
+			if (p != end)
+			{
+				return false;
+			}
+
+			if (mantissa == 0)
+			{
+				result = negative ? -T(0) : T(0);
+				return true;
+			}
+			if (exponent < -maxPowerOfTen || exponent > maxPowerOfTen)
+			{
+				return false;
+			}
+			// Both the mantissa and the power of ten are exact, so this is
+			// the one rounding strtod() would do.
+			T v = static_cast<T>(mantissa);
+			if (exponent >= 0)
+			{
+				v *= powersOfTen[exponent];
+			}
+			else
+			{
+				v /= powersOfTen[-exponent];
+			}
+			result = negative ? -v : v;
+			return true;
+		}
+	}
+
+	unsigned decimalDigitCount(UInt64 val)
+	{
+		unsigned n = 1;
+		while (val >= 10000)
+		{
+			val /= 10000;
+			n += 4;
+		}
+		if (val >= 1000)
+		{
+			return n + 3;
+		}
+		if (val >= 100)
+		{
+			return n + 2;
+		}
+		if (val >= 10)
+		{
+			return n + 1;
+		}
+		return n;
+	}
+
+	char* formatUnsignedDecimal(UInt64 val, char* end)
+	{
+		while (val >= 100)
+		{
+			const unsigned idx = static_cast<unsigned>(val % 100) * 2;
+			val /= 100;
+			*--end = DIGIT_PAIRS[idx + 1];
+			*--end = DIGIT_PAIRS[idx];
+		}
+		if (val >= 10)
+		{
+			const unsigned idx = static_cast<unsigned>(val) * 2;
+			*--end = DIGIT_PAIRS[idx + 1];
+			*--end = DIGIT_PAIRS[idx];
+		}
+		else
+		{
+			*--end = static_cast<char>('0' + val);
+		}
+		return end;
+	}
+
+	char* formatSignedDecimal(Int64 val, char* end)
+	{
+		const UInt64 magnitude = val < 0 ? 0 - static_cast<UInt64>(val) : static_cast<UInt64>(val);
+		char* start = formatUnsignedDecimal(magnitude, end);
+		if (val < 0)
+		{
+			*--start = '-';
+		}
+		return start;
+	}
+
+	bool parseSimpleDecimal(const char* str, size_t len, bool& negative, UInt64& magnitude)
+	{
+		const char* p = str;
+		const char* end = str + len;
+		negative = false;
+		if (p != end && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			++p;
+		}
+		// 19 digits always fit in 64 bits.
+		const size_t digits = end - p;
+		if (digits == 0 || digits > 19)
+		{
+			return false;
+		}
+
+		UInt64 val = 0;
+#if !defined(BLOCXX_WORDS_BIGENDIAN)
+		while (end - p >= 8)
+		{
+			UInt64 chunk;
+			memcpy(&chunk, p, sizeof(chunk));
+			if (!isEightDigits(chunk))
+			{
+				return false;
+			}
+			val = val * 100000000 + parseEightDigits(chunk);
+			p += 8;
+		}
+#endif
+		for (; p != end; ++p)
+		{
+			if (!isDigit(*p))
+			{
+				return false;
+			}
+			val = val * 10 + (*p - '0');
+		}
+		magnitude = val;
+		return true;
+	}
+
+	size_t formatReal(float val, char* buf)
+	{
+		UInt32 bits;
+		memcpy(&bits, &val, sizeof(bits));
+		const bool negative = (bits >> 31) != 0;
+		bits &= 0x7FFFFFFFU;
+		const int biasedExponent = static_cast<int>(bits >> (FLT_MANT_DIG - 1));
+		if (biasedExponent == 0xFF)
+		{
+			return formatNonFinite(val, buf);
+		}
+		if (bits == 0)
+		{
+			return layoutReal(negative, "0", 1, 0, FLOAT_PRECISION, buf);
+		}
+		char digits[32];
+		int len;
+		int decimalExponent;
+		grisu2(digits, len, decimalExponent, computeBoundaries(bits & ((1U << (FLT_MANT_DIG - 1)) - 1),
+			biasedExponent, FLT_MANT_DIG, FLT_MAX_EXP));
+		return layoutReal(negative, digits, len, decimalExponent, FLOAT_PRECISION, buf);
+	}
+
+	size_t formatReal(double val, char* buf)
+	{
+		UInt64 bits;
+		memcpy(&bits, &val, sizeof(bits));
+		const bool negative = (bits >> 63) != 0;
+		bits &= 0x7FFFFFFFFFFFFFFFULL;
+		const int biasedExponent = static_cast<int>(bits >> (DBL_MANT_DIG - 1));
+		if (biasedExponent == 0x7FF)
+		{
+			return formatNonFinite(val, buf);
+		}
+		if (bits == 0)
+		{
+			return layoutReal(negative, "0", 1, 0, DOUBLE_PRECISION, buf);
+		}
+		char digits[32];
+		int len;
+		int decimalExponent;
+		grisu2(digits, len, decimalExponent, computeBoundaries(bits & ((UInt64(1) << (DBL_MANT_DIG - 1)) - 1),
+			biasedExponent, DBL_MANT_DIG, DBL_MAX_EXP));
+		return layoutReal(negative, digits, len, decimalExponent, DOUBLE_PRECISION, buf);
+	}
+
+	size_t formatReal(long double val, char* buf)
+	{
+		// Too rare to be worth an exact implementation.
+		const int len = ::snprintf(buf, MAX_REAL_STRING_SIZE, "%.*Lg", LDBL_MANT_DIG * 3 / 10 + 1, val);
+		return std::min(static_cast<size_t>(len), MAX_REAL_STRING_SIZE - 1);
+	}
+
+	bool parseSimpleReal(const char* str, size_t len, float& result)
+	{
+#if defined(BLOCXX_FLOAT_EVAL_IS_EXACT)
+		return parseSimpleRealImpl(str, len, UInt64(1) << FLT_MANT_DIG,
+			FLOAT_POWERS_OF_TEN, sizeof(FLOAT_POWERS_OF_TEN) / sizeof(FLOAT_POWERS_OF_TEN[0]) - 1, result);
+#else
+		return false;
+#endif
+	}
+
+	bool parseSimpleReal(const char* str, size_t len, double& result)
+	{
+#if defined(BLOCXX_FLOAT_EVAL_IS_EXACT)
+		return parseSimpleRealImpl(str, len, UInt64(1) << DBL_MANT_DIG,
+			DOUBLE_POWERS_OF_TEN, sizeof(DOUBLE_POWERS_OF_TEN) / sizeof(DOUBLE_POWERS_OF_TEN[0]) - 1, result);
+#else
+		return false;
+#endif
+	}
+
+	bool parseSimpleReal(const char*, size_t, long double&)
+	{
+		return false;
+	}
 }
@@ -54,6 +54,62 @@ namespace BLOCXX_NAMESPACE
 
 	template<> Real32 convertToRealType<Real32>(const String& str);
 	template<> Real64 convertToRealType<Real64>(const String& str);
+
+	/**
+	 * @return The number of decimal digits in val (1 for 0).
+	 */
+	unsigned decimalDigitCount(UInt64 val);
+
+	/**
+	 * Write the decimal digits of val so that they end just before end.
+	 * Nothing is written at end itself.
+	 * @return A pointer to the first digit.
+	 */
+	char* formatUnsignedDecimal(UInt64 val, char* end);
+
+	/**
+	 * Like formatUnsignedDecimal(), with a leading '-' if val is negative.
+	 */
+	char* formatSignedDecimal(Int64 val, char* end);
+
+	/**
+	 * Parse str if it consists of nothing but an optional sign followed by
+	 * at most 19 decimal digits.  Anything else (white space, other bases,
+	 * longer numbers) is left to the strtol() family, which is also what
+	 * reports errors.
+	 * @param len The length of str.
+	 * @return true if str had that form, and negative and magnitude were set.
+	 */
+	bool parseSimpleDecimal(const char* str, size_t len, bool& negative, UInt64& magnitude);
+
+	/**
+	 * The size of a buffer that is large enough for formatReal().
+	 */
+	const size_t MAX_REAL_STRING_SIZE = 32;
+
+	/**
+	 * Write the shortest decimal representation of val that reads back as
+	 * val, laid out like printf's %g does at the type's full precision
+	 * (e.g. "0.1", "1e+16", "-4.56e+80").
+	 * @param buf At least MAX_REAL_STRING_SIZE chars.  The result is nul
+	 *   terminated.
+	 * @return The length of the result.
+	 */
+	size_t formatReal(float val, char* buf);
+	size_t formatReal(double val, char* buf);
+	size_t formatReal(long double val, char* buf);
+
+	/**
+	 * Convert str if it is a plain decimal number ([+-]digits[.digits][e[+-]digits])
+	 * that can be converted exactly with one floating point operation, which
+	 * is the case for most numbers with up to 15 significant digits.  Other
+	 * strings are left to strtod() and friends.
+	 * @param len The length of str.
+	 * @return true if str was converted.
+	 */
+	bool parseSimpleReal(const char* str, size_t len, float& result);
+	bool parseSimpleReal(const char* str, size_t len, double& result);
+	bool parseSimpleReal(const char* str, size_t len, long double& result);
 }
 
 #endif
@@ -0,0 +1,113 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+
+#ifndef BLOCXX_STRING_VIEW_HPP_INCLUDE_GUARD_
+#define BLOCXX_STRING_VIEW_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/String.hpp"
+#include <cstring>
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * A non-owning reference to a sequence of characters.  A StringView does
+ * not copy the data it refers to and does not require it to be NULL
+ * terminated, so the referenced buffer must outlive the view.  Use
+ * toString() to obtain an owning copy.
+ *
+ * Thread safety: read
+ * Copy semantics: Value (the referenced data is not copied)
+ * Exception safety: No-throw, except toString()
+ */
+class StringView
+{
+public:
+	typedef const char* const_iterator;
+
+	StringView()
+		: m_data(""), m_len(0)
+	{
+	}
+	StringView(const char* str)
+		: m_data(str ? str : ""), m_len(str ? ::strlen(str) : 0)
+	{
+	}
+	StringView(const char* str, size_t len)
+		: m_data(str), m_len(len)
+	{
+	}
+	StringView(const String& str)
+		: m_data(str.c_str()), m_len(str.length())
+	{
+	}
+
+	const char* data() const { return m_data; }
+	size_t size() const { return m_len; }
+	size_t length() const { return m_len; }
+	bool empty() const { return m_len == 0; }
+	const_iterator begin() const { return m_data; }
+	const_iterator end() const { return m_data + m_len; }
+	char operator[](size_t ndx) const { return m_data[ndx]; }
+
+	/**
+	 * @return A String containing a copy of the referenced characters.
+	 */
+	String toString() const
+	{
+		return String(m_data, m_len);
+	}
+
+	bool equals(const StringView& arg) const
+	{
+		return m_len == arg.m_len && ::memcmp(m_data, arg.m_data, m_len) == 0;
+	}
+
+private:
+	const char* m_data;
+	size_t m_len;
+};
+
+inline bool operator==(const StringView& x, const StringView& y)
+{
+	return x.equals(y);
+}
+
+inline bool operator!=(const StringView& x, const StringView& y)
+{
+	return !x.equals(y);
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -42,7 +42,11 @@
 #include "blocxx/ExceptionIds.hpp"
 #include "blocxx/IntrusiveCountableBase.hpp"
 
-#if defined(BLOCXX_USE_PTHREAD) && defined(BLOCXX_HAVE_PTHREAD_BARRIER) && !defined(BLOCXX_VALGRIND_SUPPORT)
+#include "blocxx/EventCount.hpp"
+
+#if defined(BLOCXX_EVENT_COUNT_USE_FUTEX)
+ #include "blocxx/Atomic.hpp"
+#elif defined(BLOCXX_USE_PTHREAD) && defined(BLOCXX_HAVE_PTHREAD_BARRIER) && !defined(BLOCXX_VALGRIND_SUPPORT)
  #include <pthread.h>
  #include <cstring>
 #else
@@ -58,7 +62,71 @@ namespace BLOCXX_NAMESPACE
 
 BLOCXX_DEFINE_EXCEPTION_WITH_ID(ThreadBarrier);
 
-#if defined(BLOCXX_USE_PTHREAD) && defined(BLOCXX_HAVE_PTHREAD_BARRIER) && !defined(BLOCXX_VALGRIND_SUPPORT) // valgrind doesn't support pthread_barrier_*()
+#if defined(BLOCXX_EVENT_COUNT_USE_FUTEX)
+
+class ThreadBarrierImpl : public IntrusiveCountableBase
+{
+public:
+	/**
+	 * The round number and the number of threads that have arrived in it
+	 * are kept together in one word, so that each arriving thread is
+	 * counted in exactly one round, even if a thread from the next round
+	 * arrives while the last one of this round is still releasing it.
+	 * Only the threads that have to wait for others enter the kernel.
+	 */
+	ThreadBarrierImpl(UInt32 threshold)
+		: m_threshold(threshold)
+		, m_state(0)
+	{
+		BLOCXX_ASSERT(threshold != 0);
+	}
+	void wait()
+	{
+		UInt64 state = m_state.load(E_MEMORY_ORDER_RELAXED);
+		UInt64 newState;
+		do
+		{
+			if ((state & COUNT_MASK) + 1 == m_threshold)
+			{
+				// the last thread starts the next round
+				newState = (state & ~COUNT_MASK) + ROUND_INCREMENT;
+			}
+			else
+			{
+				newState = state + 1;
+			}
+		} while (!m_state.compareExchangeWeak(state, newState, E_MEMORY_ORDER_ACQ_REL, E_MEMORY_ORDER_RELAXED));
+
+		const UInt64 round = state & ~COUNT_MASK;
+		if ((newState & ~COUNT_MASK) != round)
+		{
+			m_roundDone.notifyAll();
+			return;
+		}
+		for (;;)
+		{
+			EventCount::Key key = m_roundDone.prepareWait();
+			if ((m_state.load(E_MEMORY_ORDER_ACQUIRE) & ~COUNT_MASK) != round)
+			{
+				m_roundDone.cancelWait();
+				return;
+			}
+			m_roundDone.wait(key, Timeout::infinite);
+		}
+	}
+private:
+	static const UInt64 COUNT_MASK = 0xFFFFFFFFULL;
+	static const UInt64 ROUND_INCREMENT = 0x100000000ULL;
+
+	/// The number of threads to synchronize
+	UInt32 m_threshold;
+	/// The round number in the high 32 bits, the number of threads waiting
+	/// in it in the low 32 bits.
+	Atomic<UInt64> m_state;
+	EventCount m_roundDone;
+};
+
+#elif defined(BLOCXX_USE_PTHREAD) && defined(BLOCXX_HAVE_PTHREAD_BARRIER) && !defined(BLOCXX_VALGRIND_SUPPORT) // valgrind doesn't support pthread_barrier_*()
 class ThreadBarrierImpl : public IntrusiveCountableBase
 {
 public:
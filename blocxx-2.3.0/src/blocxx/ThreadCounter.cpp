@@ -37,10 +37,10 @@
 
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/ThreadCounter.hpp"
-#include "blocxx/NonRecursiveMutexLock.hpp"
 #include "blocxx/Assertion.hpp"
 #include "blocxx/TimeoutException.hpp"
 #include "blocxx/Timeout.hpp"
+#include "blocxx/TimeoutTimer.hpp"
 
 namespace BLOCXX_NAMESPACE
 {
@@ -54,49 +54,76 @@ ThreadCounter::~ThreadCounter()
 void
 ThreadCounter::incThreadCount(const Timeout& timeout)
 {
-	NonRecursiveMutexLock l(m_runCountGuard);
-	while (m_runCount >= m_maxThreads)
+	TimeoutTimer timer(timeout);
+	for (;;)
 	{
-		if (!m_runCountCondition.timedWait(l, timeout))
+		Int32 count = m_runCount.load(E_MEMORY_ORDER_RELAXED);
+		while (count < m_maxThreads.load(E_MEMORY_ORDER_RELAXED))
 		{
+			if (m_runCount.compareExchangeWeak(count, count + 1, E_MEMORY_ORDER_ACQUIRE, E_MEMORY_ORDER_RELAXED))
+			{
+				return;
+			}
+		}
+		EventCount::Key key = m_runCountChanged.prepareWait();
+		if (m_runCount.load() < m_maxThreads.load())
+		{
+			m_runCountChanged.cancelWait();
+			continue;
+		}
+		timer.loop();
+		if (timer.expired())
+		{
+			m_runCountChanged.cancelWait();
 			BLOCXX_THROW(TimeoutException, "ThreadCounter::incThreadCount timedout");
 		}
+		m_runCountChanged.wait(key, timer.asRelativeTimeout());
 	}
-	++m_runCount;
 }
 void
 ThreadCounter::decThreadCount()
 {
-	NonRecursiveMutexLock l(m_runCountGuard);
-	BLOCXX_ASSERT(m_runCount > 0);
-	--m_runCount;
-	m_runCountCondition.notifyAll();
+	Int32 prev = m_runCount.fetchSub(1, E_MEMORY_ORDER_RELEASE);
+	BLOCXX_ASSERT(prev > 0);
+	// Wakes both incThreadCount() and waitForAll().
+	m_runCountChanged.notifyAll();
 }
 Int32
 ThreadCounter::getThreadCount()
 {
-	NonRecursiveMutexLock l(m_runCountGuard);
-	return m_runCount;
+	return m_runCount.load(E_MEMORY_ORDER_ACQUIRE);
 }
 
 void
 ThreadCounter::waitForAll(const Timeout& timeout)
 {
-	NonRecursiveMutexLock runCountLock(m_runCountGuard);
-	while (m_runCount > 0)
+	TimeoutTimer timer(timeout);
+	for (;;)
 	{
-		if (!m_runCountCondition.timedWait(runCountLock, timeout))
+		if (m_runCount.load(E_MEMORY_ORDER_ACQUIRE) <= 0)
+		{
+			return;
+		}
+		EventCount::Key key = m_runCountChanged.prepareWait();
+		if (m_runCount.load(E_MEMORY_ORDER_ACQUIRE) <= 0)
+		{
+			m_runCountChanged.cancelWait();
+			return;
+		}
+		timer.loop();
+		if (timer.expired())
 		{
+			m_runCountChanged.cancelWait();
 			BLOCXX_THROW(TimeoutException, "ThreadCounter::waitForAll timedout");
 		}
+		m_runCountChanged.wait(key, timer.asRelativeTimeout());
 	}
 }
 void
 ThreadCounter::setMax(Int32 maxThreads)
 {
-	NonRecursiveMutexLock runCountLock(m_runCountGuard);
-	m_maxThreads = maxThreads;
-	m_runCountCondition.notifyAll();
+	m_maxThreads.store(maxThreads, E_MEMORY_ORDER_RELEASE);
+	m_runCountChanged.notifyAll();
 }
 ThreadCountDecrementer::ThreadCountDecrementer(ThreadCounterRef const& x)
 	: m_counter(x)
@@ -39,8 +39,8 @@
 #define BLOCXX_THREAD_COUNTER_HPP_INCLUDE_GUARD_
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/Types.hpp"
-#include "blocxx/NonRecursiveMutex.hpp"
-#include "blocxx/Condition.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/EventCount.hpp"
 #include "blocxx/IntrusiveReference.hpp"
 #include "blocxx/IntrusiveCountableBase.hpp"
 #include "blocxx/ThreadDoneCallback.hpp"
@@ -64,10 +64,11 @@ public:
 	void waitForAll(const Timeout& timeout);
 	void setMax(Int32 maxThreads);
 private:
-	Int32 m_maxThreads;
-	Int32 m_runCount;
-	NonRecursiveMutex m_runCountGuard;
-	Condition m_runCountCondition;
+	// The counts are atomics, so only threads that have to block (and
+	// threads that wake them) go through m_runCountChanged.
+	Atomic<Int32> m_maxThreads;
+	Atomic<Int32> m_runCount;
+	EventCount m_runCountChanged;
 	// noncopyable
 	ThreadCounter(ThreadCounter const&) BLOCXX_FUNCTION_NOT_IMPLEMENTED;
 	ThreadCounter& operator=(ThreadCounter const&) BLOCXX_FUNCTION_NOT_IMPLEMENTED;
@@ -132,14 +132,16 @@ private:
 template <typename FuncT>
 inline void callOnce(OnceFlag& flag, FuncT f)
 {
-	readWriteMemoryBarrier();
-	if (flag.flag == 0)
+	// Once f() has run this is just a load and a branch.  The release store
+	// below makes sure anything f() wrote is visible to a thread that sees
+	// flag.flag != 0 here, without taking the mutex.
+	if (acquireLoad(flag.flag) == 0)
 	{
 		CallOnce_pthread_MutexLock lock(&flag.mtx);
 		if (flag.flag == 0)
 		{
 			f();
-			flag.flag = 1;
+			releaseStore(flag.flag, static_cast< ::sig_atomic_t>(1));
 		}
 	}
 }
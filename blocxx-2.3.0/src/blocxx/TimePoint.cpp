@@ -0,0 +1,138 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/TimePoint.hpp"
+
+#ifdef BLOCXX_HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+#include <limits>
+
+namespace BLOCXX_NAMESPACE
+{
+	namespace Time
+	{
+		namespace
+		{
+			const Int64 MICROSECONDS_PER_SECOND = 1000000;
+
+#if defined(BLOCXX_HAVE_CLOCK_MONOTONIC)
+			inline TimePoint readClock(clockid_t clock)
+			{
+				::timespec ts;
+				::clock_gettime(clock, &ts);
+				return TimePoint(Int64(ts.tv_sec) * MICROSECONDS_PER_SECOND + ts.tv_nsec / 1000);
+			}
+#else
+			inline TimePoint readWallClock()
+			{
+				::timeval tv;
+				::gettimeofday(&tv, 0);
+				return TimePoint(Int64(tv.tv_sec) * MICROSECONDS_PER_SECOND + tv.tv_usec);
+			}
+#endif
+		}
+
+		TimePoint TimePoint::now()
+		{
+#if defined(BLOCXX_HAVE_CLOCK_MONOTONIC)
+			return readClock(CLOCK_MONOTONIC);
+#else
+			return readWallClock();
+#endif
+		}
+
+		TimePoint TimePoint::nowCoarse()
+		{
+#if defined(BLOCXX_HAVE_CLOCK_MONOTONIC) && defined(CLOCK_MONOTONIC_COARSE)
+			return readClock(CLOCK_MONOTONIC_COARSE);
+#else
+			return now();
+#endif
+		}
+
+		TimePoint TimePoint::maxValue()
+		{
+			return TimePoint((std::numeric_limits<Int64>::max)());
+		}
+
+		::timespec* TimePoint::toTimespec(::timespec& ts) const
+		{
+			Int64 seconds = m_microseconds / MICROSECONDS_PER_SECOND;
+			Int64 micros = m_microseconds % MICROSECONDS_PER_SECOND;
+			if (micros < 0)
+			{
+				--seconds;
+				micros += MICROSECONDS_PER_SECOND;
+			}
+			if (seconds > (std::numeric_limits<time_t>::max)())
+			{
+				seconds = (std::numeric_limits<time_t>::max)();
+			}
+			ts.tv_sec = static_cast<time_t>(seconds);
+			ts.tv_nsec = static_cast<long>(micros * 1000);
+			return &ts;
+		}
+
+		TimePoint& TimePoint::operator+=(const TimeDuration& d)
+		{
+			m_microseconds += d.microseconds();
+			return *this;
+		}
+
+		TimePoint& TimePoint::operator-=(const TimeDuration& d)
+		{
+			m_microseconds -= d.microseconds();
+			return *this;
+		}
+
+		TimeDuration operator-(const TimePoint& x, const TimePoint& y)
+		{
+			return TimeDuration(x.microseconds() - y.microseconds());
+		}
+
+		TimePoint operator+(const TimePoint& x, const TimeDuration& d)
+		{
+			TimePoint rv(x);
+			return rv += d;
+		}
+
+		TimePoint operator-(const TimePoint& x, const TimeDuration& d)
+		{
+			TimePoint rv(x);
+			return rv -= d;
+		}
+
+	} // end namespace Time
+} // end namespace BLOCXX_NAMESPACE
+
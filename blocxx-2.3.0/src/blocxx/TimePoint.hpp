@@ -0,0 +1,139 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_TIME_POINT_HPP_INCLUDE_GUARD_
+#define BLOCXX_TIME_POINT_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/Types.hpp"
+#include "blocxx/TimeDuration.hpp"
+
+#include <time.h> // for timespec
+
+namespace BLOCXX_NAMESPACE
+{
+	namespace Time
+	{
+		/**
+		 * A point in time on the system's monotonic clock
+		 * (CLOCK_MONOTONIC where available), with microsecond resolution.
+		 * Unlike DateTime, a TimePoint doesn't move when the system time is
+		 * changed, so it's what timeouts should be measured with.  Its epoch
+		 * is unspecified, which makes a TimePoint only useful for comparing
+		 * with other TimePoints; the difference between two of them is a
+		 * TimeDuration.
+		 *
+		 * Where no monotonic clock is available, TimePoint falls back to
+		 * the wall clock.
+		 */
+		class BLOCXX_COMMON_API TimePoint
+		{
+		public:
+			TimePoint()
+				: m_microseconds(0)
+			{
+			}
+			explicit TimePoint(Int64 microseconds)
+				: m_microseconds(microseconds)
+			{
+			}
+
+			/**
+			 * Read the monotonic clock.  On Linux this doesn't enter the
+			 * kernel.
+			 */
+			static TimePoint now();
+
+			/**
+			 * Read the coarse version of the monotonic clock if there is one
+			 * (CLOCK_MONOTONIC_COARSE), which is cheaper than now() but only
+			 * accurate to a few milliseconds.  Otherwise the same as now().
+			 */
+			static TimePoint nowCoarse();
+
+			/**
+			 * @return A TimePoint later than any now() will return.
+			 */
+			static TimePoint maxValue();
+
+			Int64 microseconds() const
+			{
+				return m_microseconds;
+			}
+
+			/**
+			 * Fill out ts with this time, on the clock now() reads.
+			 */
+			::timespec* toTimespec(::timespec& ts) const;
+
+			TimePoint& operator+=(const TimeDuration& d);
+			TimePoint& operator-=(const TimeDuration& d);
+
+		private:
+			Int64 m_microseconds;
+		};
+
+		/**
+		 * Time elapsed from y to x.
+		 */
+		BLOCXX_COMMON_API TimeDuration operator-(const TimePoint& x, const TimePoint& y);
+		BLOCXX_COMMON_API TimePoint operator+(const TimePoint& x, const TimeDuration& d);
+		BLOCXX_COMMON_API TimePoint operator-(const TimePoint& x, const TimeDuration& d);
+
+		inline bool operator<(const TimePoint& x, const TimePoint& y)
+		{
+			return x.microseconds() < y.microseconds();
+		}
+		inline bool operator>(const TimePoint& x, const TimePoint& y)
+		{
+			return y < x;
+		}
+		inline bool operator<=(const TimePoint& x, const TimePoint& y)
+		{
+			return !(y < x);
+		}
+		inline bool operator>=(const TimePoint& x, const TimePoint& y)
+		{
+			return !(x < y);
+		}
+		inline bool operator==(const TimePoint& x, const TimePoint& y)
+		{
+			return x.microseconds() == y.microseconds();
+		}
+		inline bool operator!=(const TimePoint& x, const TimePoint& y)
+		{
+			return !(x == y);
+		}
+
+	} // end namespace Time
+} // end namespace BLOCXX_NAMESPACE
+
+#endif
@@ -48,7 +48,7 @@ namespace BLOCXX_NAMESPACE
 
 TimeoutTimer::TimeoutTimer(const Timeout& x)
 	: m_timeout(x)
-	, m_start(getCurrentTime())
+	, m_start(getCurrentMonotonicTime())
 	, m_loopTime(m_start)
 {
 }
@@ -60,7 +60,7 @@ TimeoutTimer::~TimeoutTimer()
 void
 TimeoutTimer::start()
 {
-	m_start = m_loopTime = getCurrentTime();
+	m_start = m_loopTime = getCurrentMonotonicTime();
 }
 
 void
@@ -76,7 +76,11 @@ TimeoutTimer::resetOnLoop()
 void
 TimeoutTimer::loop()
 {
-	m_loopTime = getCurrentTime();
+	// an absolute timeout reads the wall clock when it's queried instead.
+	if (m_timeout.getType() != Timeout::E_ABSOLUTE)
+	{
+		m_loopTime = getCurrentMonotonicTime();
+	}
 }
 
 namespace
@@ -99,7 +103,7 @@ void safeAssign(T& x, U y)
 	}
 }
 
-bool compareInterval(const DateTime& first, const DateTime& timeToTest, double seconds)
+bool compareInterval(const Time::TimePoint& first, const Time::TimePoint& timeToTest, double seconds)
 {
 	// Return first + seconds < timeToTest <==> timeToTest - first >= seconds.
 	// The latter form avoids overflow problems.
@@ -120,7 +124,7 @@ TimeoutTimer::expired() const
 	switch (m_timeout.getType())
 	{
 		case Timeout::E_ABSOLUTE:
-			return m_loopTime >= m_timeout.getAbsolute();
+			return getCurrentTime() >= m_timeout.getAbsolute();
 		case Timeout::E_RELATIVE:
 		case Timeout::E_RELATIVE_WITH_RESET:
 			return compareInterval(m_start, m_loopTime, m_timeout.getRelative());
@@ -174,11 +178,12 @@ TimeoutTimer::asTimeval(::timeval& tv) const
 
 	if (m_timeout.getType() == Timeout::E_ABSOLUTE)
 	{
-		// convert the difference between the last loop and the absolute timeout into a timeval
+		// convert the difference between now and the absolute timeout into a timeval
 		DateTime timeoutTime = m_timeout.getAbsolute();
-		if (timeoutTime > m_loopTime)
+		DateTime now = getCurrentTime();
+		if (timeoutTime > now)
 		{
-			Time::TimeDuration diff = m_timeout.getAbsolute() - m_loopTime;
+			Time::TimeDuration diff = timeoutTime - now;
 			tv.tv_sec = diff.completeSeconds();
 			tv.tv_usec = diff.microsecondInSecond();
 		}
@@ -215,12 +220,12 @@ TimeoutTimer::calcSeconds() const
 	double seconds;
 	if (m_timeout.getType() == Timeout::E_ABSOLUTE)
 	{
-		seconds = Time::timeBetween(m_loopTime, m_timeout.getAbsolute()).realSeconds();
+		seconds = Time::timeBetween(getCurrentTime(), m_timeout.getAbsolute()).realSeconds();
 	}
 	else
 	{
 		// seconds = (m_start + m_timeout.getRelative()) - m_loopTime
-		seconds = Time::timeBetween(m_loopTime, m_start).realSeconds() + m_timeout.getRelative();
+		seconds = (m_start - m_loopTime).realSeconds() + m_timeout.getRelative();
 	}
 	return seconds;
 }
@@ -259,7 +264,37 @@ TimeoutTimer::asAbsoluteTimeout() const
 	}
 	else
 	{
-		return Timeout::absolute(m_start + m_timeout.getRelative());
+		return Timeout::absolute(wallClockStart() + m_timeout.getRelative());
+	}
+}
+
+Time::TimePoint
+TimeoutTimer::asTimePoint() const
+{
+	if (infinite())
+	{
+		return Time::TimePoint::maxValue();
+	}
+	if (m_timeout.getType() == Timeout::E_ABSOLUTE)
+	{
+		// the deadline is on the wall clock, so translate it using the
+		// current distance to it.
+		Time::TimeDuration remaining = m_timeout.getAbsolute() - getCurrentTime();
+		if (remaining.isSpecial())
+		{
+			return Time::TimePoint::maxValue();
+		}
+		return getCurrentMonotonicTime() + remaining;
+	}
+	else
+	{
+		Time::TimeDuration relative(m_timeout.getRelative());
+		if (relative.isSpecial() || relative.microseconds() >
+			Time::TimePoint::maxValue().microseconds() - m_start.microseconds())
+		{
+			return Time::TimePoint::maxValue();
+		}
+		return m_start + relative;
 	}
 }
 
@@ -316,7 +351,7 @@ TimeoutTimer::asTimespec(::timespec& ts) const
 	{
 		// convert the timeout to a timespec
 		DateTime timeoutTime = m_timeout.getAbsolute();
-		if (timeoutTime > m_loopTime)
+		if (timeoutTime > getCurrentTime())
 		{
 			ts.tv_sec = timeoutTime.get();
 			ts.tv_nsec = timeoutTime.getMicrosecond() * NANOSECONDS_PER_MICROSECOND;
@@ -330,10 +365,11 @@ TimeoutTimer::asTimespec(::timespec& ts) const
 	}
 	else // relative
 	{
-		safeAssign(ts.tv_sec, m_start.get() + static_cast<double>(m_timeout.getRelative()));
+		DateTime start = wallClockStart();
+		safeAssign(ts.tv_sec, start.get() + static_cast<double>(m_timeout.getRelative()));
 		double dummy;
 		safeAssign(ts.tv_nsec, 
-			static_cast<double>(m_start.getMicrosecond()) * NANOSECONDS_PER_MICROSECOND +
+			static_cast<double>(start.getMicrosecond()) * NANOSECONDS_PER_MICROSECOND +
 			modf(m_timeout.getRelative(), &dummy) * NANOSECONDS_PER_SECOND);
 
 		// handle any overflow because ts.tv_nsec has to be in the correct range.
@@ -345,12 +381,25 @@ TimeoutTimer::asTimespec(::timespec& ts) const
 }
 #endif
 
+DateTime
+TimeoutTimer::wallClockStart() const
+{
+	// the wall clock isn't kept, so work back from it to the monotonic start.
+	return getCurrentTime() - (getCurrentMonotonicTime() - m_start);
+}
+
 DateTime
 TimeoutTimer::getCurrentTime() const
 {
 	return DateTime::getCurrent();
 }
 
+Time::TimePoint
+TimeoutTimer::getCurrentMonotonicTime() const
+{
+	return Time::TimePoint::now();
+}
+
 } // end namespace BLOCXX_NAMESPACE
 
 
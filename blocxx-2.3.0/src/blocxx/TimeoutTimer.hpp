@@ -42,6 +42,7 @@
 #include "blocxx/CommonFwd.hpp"
 #include "blocxx/Timeout.hpp"
 #include "blocxx/DateTime.hpp"
+#include "blocxx/TimePoint.hpp"
 
 #ifdef BLOCXX_HAVE_SYS_TIME_H
 #include <sys/time.h> // for timeval
@@ -102,7 +103,8 @@ public:
 	void loop();
 
 	/**
-	 * Indicates whether the last loop time has exceeded the timeout. The current time is not used, but the time when resetOnLoop() or loop() was called.
+	 * Indicates whether the last loop time has exceeded the timeout. For a relative timeout the current time is not used, but the time when resetOnLoop() or loop() was called.
+	 * An absolute timeout is compared with the current wall clock time.
 	 */
 	bool expired() const;
 
@@ -132,6 +134,14 @@ public:
 	 */
 	Timeout asAbsoluteTimeout() const;
 
+	/**
+	 * @return The time the timeout expires, on the monotonic clock
+	 * Time::TimePoint::now() reads.  An infinite timeout yields
+	 * Time::TimePoint::maxValue().  An absolute timeout is converted using
+	 * the current offset between the wall clock and the monotonic clock.
+	 */
+	Time::TimePoint asTimePoint() const;
+
 #ifdef BLOCXX_WIN32
 	// returns INFINITE for an infinite timeout.
 	::DWORD asDWORDMs() const;
@@ -145,13 +155,19 @@ private:
 
 	double calcSeconds() const;
 	double calcSeconds(double maxSeconds) const;
+	DateTime wallClockStart() const;
 
 	// for test purposes, the current time can be faked by a derived class.
 	virtual DateTime getCurrentTime() const;
+	virtual Time::TimePoint getCurrentMonotonicTime() const;
 
 	Timeout m_timeout;
-	DateTime m_start;
-	DateTime m_loopTime;
+	// Relative timeouts are measured on the monotonic clock, so they aren't
+	// affected by changes to the system time.  The wall clock is only read
+	// when it's needed: for absolute timeouts, and to convert a relative
+	// timeout to an absolute one.
+	Time::TimePoint m_start;
+	Time::TimePoint m_loopTime;
 };
 
 } // end namespace BLOCXX_NAMESPACE
@@ -29,6 +29,7 @@
 #include "blocxx/BLOCXX_config.h"
 #include "TmUtils.hpp"
 #include <limits>
+#include <cstring>
 #include "blocxx/StaticAssert.hpp"
 #include "blocxx/DivRem.hpp"
 #include "blocxx/Format.hpp"
@@ -43,7 +44,6 @@ using namespace blocxx;
 
 namespace
 {
-	int const epochYear = 1970;
 	int const tmYearBase = 1900;
 
 	/** 
@@ -66,24 +66,6 @@ namespace
 		31  // dec
 	};
 
-	// first index: month (0 to 11)
-	// second index: 0 == not leap year, 1 == leap year
-	int daysToMonthStartArr[][2] =
-	{
-		{   0,   0 }, // jan
-		{  31,  31 }, // feb
-		{  59,  60 }, // mar
-		{  90,  91 }, // apr
-		{ 120, 121 }, // may
-		{ 151, 152 }, // jun
-		{ 181, 182 }, // jul
-		{ 212, 213 }, // aug
-		{ 243, 244 }, // sep
-		{ 273, 274 }, // oct
-		{ 304, 305 }, // nov
-		{ 334, 335 }  // dec
-	};
-
 	inline int year(struct tm const & tm)
 	{
 		return tm.tm_year + tmYearBase;
@@ -97,20 +79,6 @@ namespace
 			(remFloor(y, 100) != 0 || remFloor(y, 400) == 0));
 	}
 
-	inline int daysToMonthStart(struct tm const & tm)
-	{
-		return daysToMonthStartArr[tm.tm_mon][isLeapYear(tm)];
-	}
-
-	inline int leapDaysFromEpochToYear(int year)
-	{
-		int const year1 = year - 1;
-		int const ep1 = epochYear - 1;
-		int const leapDaysBeforeEpoch = ep1 / 4 - ep1 / 100 + ep1 / 400;
-		int const leapDaysBeforeYear = year1 / 4 - year1 / 100 + year1 / 400;
-		return leapDaysBeforeYear - leapDaysBeforeEpoch;
-	}
-
 	int daysInMonth(struct tm const & tm)
 	{
 		int mon = tm.tm_mon;
@@ -167,7 +135,6 @@ namespace BLOCXX_NAMESPACE
 
 	time_t timeGm(struct tm & tm)
 	{
-		time_t const daysInNonLeapYear = 365;
 		time_t const secsInDay = 86400;
 		time_t const secsInHour = 3600;
 		time_t const secsInMinute = 60;
@@ -180,10 +147,57 @@ namespace BLOCXX_NAMESPACE
 			BLOCXX_THROW(DateTimeException,
 				Format("invalid year: %1", y).c_str());
 		}
-		time_t days = time_t(y - epochYear) * daysInNonLeapYear +
-		              leapDaysFromEpochToYear(y) +
-		              daysToMonthStart(tm) + (tm.tm_mday - 1);
+		time_t days = daysFromCivil(y, tm.tm_mon + 1, tm.tm_mday);
 		return days * secsInDay + tm.tm_hour * secsInHour +
 		       tm.tm_min * secsInMinute + tm.tm_sec;
 	}
+
+	// Howard Hinnant's algorithms
+	// (http://howardhinnant.github.io/date_algorithms.html), which work
+	// in 400 year eras starting on March 1st, so the leap day is at the end
+	// of the year.
+	long daysFromCivil(long year, int month, int day)
+	{
+		year -= month <= 2;
+		long const era = divFloor(year, 400L);
+		long const yoe = year - era * 400;                                   // [0, 399]
+		long const doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // [0, 365]
+		long const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;              // [0, 146096]
+		return era * 146097 + doe - 719468;
+	}
+
+	void civilFromDays(long days, long & year, int & month, int & day)
+	{
+		days += 719468;
+		long const era = divFloor(days, 146097L);
+		long const doe = days - era * 146097;                                    // [0, 146096]
+		long const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365; // [0, 399]
+		long const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                // [0, 365]
+		long const mp = (5 * doy + 2) / 153;                                     // [0, 11]
+		day = int(doy - (153 * mp + 2) / 5 + 1);
+		month = int(mp < 10 ? mp + 3 : mp - 9);
+		year = yoe + era * 400 + (month <= 2);
+	}
+
+	void utcTm(time_t t, struct tm & tm)
+	{
+		time_t const secsInDay = 86400;
+		time_t const days = divFloor(t, secsInDay);
+		int const secs = int(t - days * secsInDay);
+
+		memset(&tm, 0, sizeof(tm));
+		long y;
+		int m;
+		int d;
+		civilFromDays(long(days), y, m, d);
+		tm.tm_year = int(y - tmYearBase);
+		tm.tm_mon = m - 1;
+		tm.tm_mday = d;
+		tm.tm_hour = secs / 3600;
+		tm.tm_min = secs / 60 % 60;
+		tm.tm_sec = secs % 60;
+		// 1970-01-01 was a Thursday.
+		tm.tm_wday = int(remFloor(long(days) + 4, 7L));
+		tm.tm_yday = int(days - daysFromCivil(y, 1, 1));
+	}
 }
@@ -57,6 +57,25 @@ namespace BLOCXX_NAMESPACE
 	// REQUIRE: any normalization will not cause integer flow.
 	//
 	std::time_t timeGm(struct std::tm & tm);
+
+	// PURPOSE: Count days in the proleptic Gregorian calendar.
+	// RETURNS: the number of days from 1970-01-01 to the given date (negative
+	// for earlier dates).
+	// REQUIRE: 1 <= month <= 12.  day is not range checked; it is simply added.
+	//
+	long daysFromCivil(long year, int month, int day);
+
+	// PURPOSE: Inverse of daysFromCivil.
+	// PROMISE: 1 <= month <= 12, 1 <= day <= days in that month.
+	//
+	void civilFromDays(long days, long & year, int & month, int & day);
+
+	// PURPOSE: Replacement for gmtime_r that needs no locking or time zone
+	// data.
+	// PROMISE: sets all of the standard tm fields; tm_isdst is 0.  Any other
+	// (platform specific) fields are zeroed.
+	//
+	void utcTm(std::time_t t, struct std::tm & tm);
 } // end namespace BLOCXX_NAMESPACE
 
 #endif
@@ -0,0 +1,664 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/UserCache.hpp"
+
+#ifndef BLOCXX_WIN32
+
+#include "blocxx/UserUtils.hpp"
+#include "blocxx/MutexLock.hpp"
+#include "blocxx/GlobalMutex.hpp"
+#include "blocxx/LazyGlobal.hpp"
+#include "blocxx/FileSystem.hpp"
+#include "blocxx/Array.hpp"
+
+#ifdef BLOCXX_HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef BLOCXX_HAVE_SYS_TYPES_H
+#include <sys/types.h>
+#endif
+
+#ifdef BLOCXX_HAVE_PWD_H
+#include <pwd.h>
+#endif
+
+#ifdef BLOCXX_HAVE_GRP_H
+#include <grp.h>
+#endif
+
+#include <cerrno>
+#include <vector>
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace
+{
+	DefaultConstructedLazyGlobal<UserCache>::type g_defaultUserCache = BLOCXX_LAZY_GLOBAL_DEFAULT_INIT;
+
+	GlobalMutex g_getpwMutex = BLOCXX_GLOBAL_MUTEX_INIT();
+	GlobalMutex g_getgrMutex = BLOCXX_GLOBAL_MUTEX_INIT();
+
+	Int64 const MICROSECONDS_PER_SECOND = 1000000;
+
+	// Get a sysconf value.  If no value is set (or another error occurs), return the default value.
+	long getSysconfValue(int name, long default_value)
+	{
+		errno = 0;
+		long l = sysconf(name);
+		return l == -1 ? default_value : l;
+	}
+
+	UInt32 hashId(UInt64 id)
+	{
+		// Fibonacci hashing, so that consecutive ids spread out.
+		return UInt32(id >> 32) ^ (UInt32(id) * 2654435761U);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+struct UserCache::Entry
+{
+	UInt64 id;
+	String name;
+	bool found;
+	UInt32 generation;
+	// microseconds, on the clock getCurrentTime() reads
+	Int64 expires;
+
+	static void destroy(void* p)
+	{
+		delete static_cast<Entry*>(p);
+	}
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// A direct mapped table of entries.  Readers protect the entry they look at
+// with a hazard pointer, and replaced entries are retired, not deleted.
+class UserCache::Table
+{
+public:
+	explicit Table(size_t maxEntries)
+		: m_mask(1)
+	{
+		while (m_mask < maxEntries)
+		{
+			m_mask <<= 1;
+		}
+		m_slots = new Atomic<Entry*>[m_mask];
+		--m_mask;
+	}
+
+	~Table()
+	{
+		for (size_t i = 0; i <= m_mask; ++i)
+		{
+			delete m_slots[i].load(E_MEMORY_ORDER_RELAXED);
+		}
+		delete [] m_slots;
+	}
+
+	Atomic<Entry*>& slot(UInt32 hash)
+	{
+		return m_slots[hash & m_mask];
+	}
+
+private:
+	size_t m_mask;
+	Atomic<Entry*>* m_slots;
+
+	// noncopyable
+	Table(const Table&);
+	Table& operator=(const Table&);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::Config::Config()
+	: maxEntries(1024)
+	, positiveTTL(600)
+	, negativeTTL(20)
+	, checkFiles(true)
+	, fileCheckInterval(1)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::UserCache()
+{
+	init();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::UserCache(const Config& config)
+	: m_config(config)
+{
+	init();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+UserCache::init()
+{
+	m_usersById = 0;
+	m_usersByName = 0;
+	m_groupsById = 0;
+	m_groupsByName = 0;
+	if (m_config.maxEntries > 0)
+	{
+		m_usersById = new Table(m_config.maxEntries);
+		m_usersByName = new Table(m_config.maxEntries);
+		m_groupsById = new Table(m_config.maxEntries);
+		m_groupsByName = new Table(m_config.maxEntries);
+	}
+	for (int i = 0; i < 2; ++i)
+	{
+		m_passwdSignature[i] = -1;
+		m_groupSignature[i] = -1;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::~UserCache()
+{
+	delete m_usersById;
+	delete m_usersByName;
+	delete m_groupsById;
+	delete m_groupsByName;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// static
+UserCache&
+UserCache::getDefault()
+{
+	return g_defaultUserCache;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Time::TimePoint
+UserCache::getCurrentTime() const
+{
+	return Time::TimePoint::nowCoarse();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+UserCache::invalidate()
+{
+	m_generation.fetchAdd(1, E_MEMORY_ORDER_ACQ_REL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+String
+UserCache::getUserName(UserId uid, bool& success)
+{
+	success = false;
+	if (uid == UserUtils::INVALID_USERID)
+	{
+		return String();
+	}
+	Int64 now = getCurrentTime().microseconds();
+	checkFiles(now);
+	String name;
+	if (!m_usersById || !findId(*m_usersById, uid, name, success, now))
+	{
+		UInt32 generation = m_generation.load(E_MEMORY_ORDER_ACQUIRE);
+		ELookupResult result = lookupUser(uid, name);
+		success = result == E_FOUND;
+		Entry* entry = new Entry;
+		entry->id = uid;
+		entry->name = name;
+		store(m_usersById, entry, generation, result, now);
+	}
+	return name;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+String
+UserCache::getGroupName(GroupId gid, bool& success)
+{
+	success = false;
+	if (gid == UserUtils::INVALID_GROUPID)
+	{
+		return String();
+	}
+	Int64 now = getCurrentTime().microseconds();
+	checkFiles(now);
+	String name;
+	if (!m_groupsById || !findId(*m_groupsById, gid, name, success, now))
+	{
+		UInt32 generation = m_generation.load(E_MEMORY_ORDER_ACQUIRE);
+		ELookupResult result = lookupGroup(gid, name);
+		success = result == E_FOUND;
+		Entry* entry = new Entry;
+		entry->id = gid;
+		entry->name = name;
+		store(m_groupsById, entry, generation, result, now);
+	}
+	return name;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserId
+UserCache::getUserId(const String& userName, bool& success)
+{
+	Int64 now = getCurrentTime().microseconds();
+	checkFiles(now);
+	UInt64 id = 0;
+	if (m_usersByName && findName(*m_usersByName, userName, id, success, now))
+	{
+		return success ? UserId(id) : UserUtils::INVALID_USERID;
+	}
+	UInt32 generation = m_generation.load(E_MEMORY_ORDER_ACQUIRE);
+	UserId uid = UserUtils::INVALID_USERID;
+	ELookupResult result = lookupUser(userName, uid);
+	success = result == E_FOUND;
+	Entry* entry = new Entry;
+	entry->id = uid;
+	entry->name = userName;
+	store(m_usersByName, entry, generation, result, now);
+	return success ? uid : UserUtils::INVALID_USERID;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+GroupId
+UserCache::getGroupId(const String& groupName, bool& success)
+{
+	Int64 now = getCurrentTime().microseconds();
+	checkFiles(now);
+	UInt64 id = 0;
+	if (m_groupsByName && findName(*m_groupsByName, groupName, id, success, now))
+	{
+		return success ? GroupId(id) : UserUtils::INVALID_GROUPID;
+	}
+	UInt32 generation = m_generation.load(E_MEMORY_ORDER_ACQUIRE);
+	GroupId gid = UserUtils::INVALID_GROUPID;
+	ELookupResult result = lookupGroup(groupName, gid);
+	success = result == E_FOUND;
+	Entry* entry = new Entry;
+	entry->id = gid;
+	entry->name = groupName;
+	store(m_groupsByName, entry, generation, result, now);
+	return success ? gid : UserUtils::INVALID_GROUPID;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+UserCache::findId(Table& table, UInt64 id, String& name, bool& found, Int64 now)
+{
+	HazardPointerDomain::Guard guard(m_hazards);
+	const Entry* entry = guard.protect(table.slot(hashId(id)));
+	if (entry && entry->id == id && now < entry->expires &&
+		entry->generation == m_generation.load(E_MEMORY_ORDER_ACQUIRE))
+	{
+		name = entry->name;
+		found = entry->found;
+		return true;
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+UserCache::findName(Table& table, const String& name, UInt64& id, bool& found, Int64 now)
+{
+	HazardPointerDomain::Guard guard(m_hazards);
+	const Entry* entry = guard.protect(table.slot(name.hashCode()));
+	if (entry && entry->name == name && now < entry->expires &&
+		entry->generation == m_generation.load(E_MEMORY_ORDER_ACQUIRE))
+	{
+		id = entry->id;
+		found = entry->found;
+		return true;
+	}
+	return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Takes ownership of entry, which has its key set.  generation is the one
+// that was current before the lookup started, so that the entry is ignored
+// if the cache was invalidated meanwhile.
+void
+UserCache::store(Table* table, Entry* entry, UInt32 generation, ELookupResult result, Int64 now)
+{
+	if (!table || result == E_LOOKUP_FAILED)
+	{
+		delete entry;
+		return;
+	}
+	entry->found = result == E_FOUND;
+	entry->generation = generation;
+	entry->expires = now + MICROSECONDS_PER_SECOND *
+		(entry->found ? m_config.positiveTTL : m_config.negativeTTL);
+	UInt32 hash = table == m_usersById || table == m_groupsById ?
+		hashId(entry->id) : entry->name.hashCode();
+	Entry* old = table->slot(hash).exchange(entry, E_MEMORY_ORDER_ACQ_REL);
+	if (old)
+	{
+		HazardPointerDomain::Guard guard(m_hazards);
+		guard.retire(old, &Entry::destroy);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Invalidate the cache if the passwd or group file has changed since the
+// last check.
+void
+UserCache::checkFiles(Int64 now)
+{
+	if (!m_config.checkFiles)
+	{
+		return;
+	}
+	Int64 next = m_nextFileCheck.load(E_MEMORY_ORDER_RELAXED);
+	if (now < next ||
+		!m_nextFileCheck.compareExchangeStrong(next,
+			now + MICROSECONDS_PER_SECOND * m_config.fileCheckInterval,
+			E_MEMORY_ORDER_RELAXED))
+	{
+		return;
+	}
+
+	MutexLock lock(m_fileCheckGuard);
+	bool changed = false;
+	String paths[] = {
+		m_config.passwdFile.empty() ? String("/etc/passwd") : m_config.passwdFile,
+		m_config.groupFile.empty() ? String("/etc/group") : m_config.groupFile
+	};
+	Int64* signatures[] = { m_passwdSignature, m_groupSignature };
+	for (int i = 0; i < 2; ++i)
+	{
+		Int64 mtime = -1;
+		Int64 size = -1;
+		try
+		{
+			FileSystem::FileInformation info = FileSystem::getFileInformation(paths[i]);
+			mtime = info.mtime.get();
+			size = Int64(info.size);
+		}
+		catch (const FileSystemException&)
+		{
+			// a missing file is a state like any other
+		}
+		if (signatures[i][0] != mtime || signatures[i][1] != size)
+		{
+			signatures[i][0] = mtime;
+			signatures[i][1] = size;
+			changed = true;
+		}
+	}
+	if (changed)
+	{
+		invalidate();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Look up name (if it's not null) or id in the passwd or group file path.
+// Both formats start with name:password:id.
+UserCache::ELookupResult
+UserCache::lookupFile(const String& path, const String* name, UInt64 id,
+	String& nameOut, UInt64& idOut) const
+{
+	StringArray lines;
+	try
+	{
+		lines = FileSystem::getFileLines(path);
+	}
+	catch (const Exception&)
+	{
+		return E_LOOKUP_FAILED;
+	}
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		if (lines[i].empty() || lines[i][0] == '#')
+		{
+			continue;
+		}
+		StringArray fields = lines[i].tokenize(":", String::E_DISCARD_DELIMITERS,
+			String::E_RETURN_EMPTY_TOKENS);
+		if (fields.size() < 3)
+		{
+			continue;
+		}
+		UInt64 lineId;
+		try
+		{
+			lineId = fields[2].toUInt64();
+		}
+		catch (const StringConversionException&)
+		{
+			continue;
+		}
+		if (name ? fields[0] == *name : lineId == id)
+		{
+			nameOut = fields[0];
+			idOut = lineId;
+			return E_FOUND;
+		}
+	}
+	return E_NOT_FOUND;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::ELookupResult
+UserCache::lookupUser(UserId uid, String& name) const
+{
+	if (!m_config.passwdFile.empty())
+	{
+		UInt64 id;
+		return lookupFile(m_config.passwdFile, 0, uid, name, id);
+	}
+
+#ifdef BLOCXX_HAVE_GETPWUID_R
+	passwd pw;
+	size_t const additionalSize =
+#ifdef _SC_GETPW_R_SIZE_MAX
+		getSysconfValue(_SC_GETPW_R_SIZE_MAX, 10240);
+#else
+		10240;
+#endif
+	std::vector<char> additional(additionalSize);
+	passwd* result = 0;
+	int rv = 0;
+	do
+	{
+		rv = ::getpwuid_r(uid, &pw, &additional[0], additional.size(), &result);
+		if (rv == ERANGE)
+		{
+			additional.resize(additional.size() * 2);
+		}
+	} while (rv == ERANGE);
+#else
+	MutexLock lock(g_getpwMutex);
+	errno = 0;
+	passwd* result = ::getpwuid(uid);
+	int rv = result ? 0 : errno;
+#endif
+	if (result)
+	{
+		name = result->pw_name;
+		return E_FOUND;
+	}
+	return rv == 0 ? E_NOT_FOUND : E_LOOKUP_FAILED;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::ELookupResult
+UserCache::lookupUser(const String& name, UserId& uid) const
+{
+	if (!m_config.passwdFile.empty())
+	{
+		String unused;
+		UInt64 id = 0;
+		ELookupResult result = lookupFile(m_config.passwdFile, &name, 0, unused, id);
+		uid = UserId(id);
+		return result;
+	}
+
+#ifdef BLOCXX_HAVE_GETPWNAM_R
+	size_t bufsize =
+#ifdef _SC_GETPW_R_SIZE_MAX
+		getSysconfValue(_SC_GETPW_R_SIZE_MAX, 10240);
+#else
+		1024;
+#endif
+	std::vector<char> buf(bufsize);
+	struct passwd pwd;
+	passwd* result = 0;
+	int rv = 0;
+	do
+	{
+		rv = ::getpwnam_r(name.c_str(), &pwd, &buf[0], buf.size(), &result);
+		if (rv == ERANGE)
+		{
+			buf.resize(buf.size() * 2);
+		}
+	} while (rv == ERANGE);
+#else
+	MutexLock ml(g_getpwMutex);
+	errno = 0;
+	struct passwd* result = ::getpwnam(name.c_str());
+	int rv = result ? 0 : errno;
+#endif
+	if (rv != 0)
+	{
+		return E_LOOKUP_FAILED;
+	}
+	if (result)
+	{
+		uid = result->pw_uid;
+		return E_FOUND;
+	}
+	return E_NOT_FOUND;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::ELookupResult
+UserCache::lookupGroup(GroupId gid, String& name) const
+{
+	if (!m_config.groupFile.empty())
+	{
+		UInt64 id;
+		return lookupFile(m_config.groupFile, 0, gid, name, id);
+	}
+
+#ifdef BLOCXX_HAVE_GETGRGID_R
+	group gr;
+	size_t const additionalSize =
+#ifdef _SC_GETGR_R_SIZE_MAX
+		getSysconfValue(_SC_GETGR_R_SIZE_MAX, 10240);
+#else
+		10240;
+#endif
+	std::vector<char> additional(additionalSize);
+	group* result = 0;
+	int rv = 0;
+	do
+	{
+		rv = ::getgrgid_r(gid, &gr, &additional[0], additional.size(), &result);
+		if (rv == ERANGE)
+		{
+			additional.resize(additional.size() * 2);
+		}
+	} while (rv == ERANGE);
+#else
+	MutexLock lock(g_getgrMutex);
+	errno = 0;
+	group* result = ::getgrgid(gid);
+	int rv = result ? 0 : errno;
+#endif
+	if (result)
+	{
+		name = result->gr_name;
+		return E_FOUND;
+	}
+	return rv == 0 ? E_NOT_FOUND : E_LOOKUP_FAILED;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UserCache::ELookupResult
+UserCache::lookupGroup(const String& name, GroupId& gid) const
+{
+	if (!m_config.groupFile.empty())
+	{
+		String unused;
+		UInt64 id = 0;
+		ELookupResult result = lookupFile(m_config.groupFile, &name, 0, unused, id);
+		gid = GroupId(id);
+		return result;
+	}
+
+	group* result = NULL;
+
+#ifdef BLOCXX_HAVE_GETGRNAM_R
+	size_t bufsize =
+#ifdef _SC_GETGR_R_SIZE_MAX
+		getSysconfValue(_SC_GETGR_R_SIZE_MAX, 10240);
+#else
+		1024;
+#endif
+	std::vector<char> buf(bufsize);
+	struct group grp;
+	int rv = 0;
+	do
+	{
+		rv = ::getgrnam_r(name.c_str(), &grp, &buf[0], buf.size(), &result);
+		if (rv == ERANGE)
+		{
+			buf.resize(buf.size() * 2);
+		}
+	} while (rv == ERANGE);
+#else
+	MutexLock ml(g_getgrMutex);
+	errno = 0;
+	result = ::getgrnam(name.c_str());
+	int rv = result ? 0 : errno;
+#endif
+	if (rv != 0)
+	{
+		return E_LOOKUP_FAILED;
+	}
+	if (result)
+	{
+		gid = result->gr_gid;
+		return E_FOUND;
+	}
+	return E_NOT_FOUND;
+}
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif // BLOCXX_WIN32
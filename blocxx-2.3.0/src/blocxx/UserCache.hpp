@@ -0,0 +1,190 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_USER_CACHE_HPP_INCLUDE_GUARD_
+#define BLOCXX_USER_CACHE_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/CommonFwd.hpp"
+#include "blocxx/Types.hpp"
+#include "blocxx/IntrusiveCountableBase.hpp"
+#include "blocxx/IntrusiveReference.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/HazardPointer.hpp"
+#include "blocxx/Mutex.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/TimePoint.hpp"
+
+#ifndef BLOCXX_WIN32
+
+namespace BLOCXX_NAMESPACE
+{
+
+/**
+ * Looks up users and groups (getpwuid_r(), getpwnam_r(), getgrgid_r() and
+ * getgrnam_r()) and caches the results, the way nscd does.  The
+ * UserUtils functions use the default cache.
+ *
+ * Both successful lookups and failures are cached, each for its own TTL.
+ * Each kind of lookup (user by id, user by name, group by id, group by
+ * name) has a fixed size table, so the cache is bounded; an entry may be
+ * replaced by another one that hashes to the same slot.  Finding an entry
+ * takes no locks.  All member functions are thread safe.
+ *
+ * Entries are dropped when invalidate() is called, and optionally when the
+ * passwd or group file changes.
+ *
+ * For testing, a cache can be pointed at files in /etc/passwd and
+ * /etc/group format, which are read through FileSystem (and so can be
+ * mocked) instead of asking the system.
+ */
+class BLOCXX_COMMON_API UserCache : public IntrusiveCountableBase
+{
+public:
+	struct Config
+	{
+		Config();
+
+		/// Maximum number of entries kept for each kind of lookup.
+		size_t maxEntries;
+		/// How long, in seconds, a successful lookup is cached.
+		UInt32 positiveTTL;
+		/// How long, in seconds, a failed lookup is cached.
+		UInt32 negativeTTL;
+		/**
+		 * If true, the modification time and size of the passwd and group
+		 * files are checked, at most once every fileCheckInterval seconds,
+		 * and the cache is invalidated when either changes.
+		 */
+		bool checkFiles;
+		UInt32 fileCheckInterval;
+		/**
+		 * If not empty, users are looked up in this file (in /etc/passwd
+		 * format) instead of with getpwuid_r() and getpwnam_r().  It is
+		 * also the file checked for changes; the default is /etc/passwd.
+		 */
+		String passwdFile;
+		/**
+		 * Like passwdFile, for groups (in /etc/group format).
+		 */
+		String groupFile;
+	};
+
+	UserCache();
+	explicit UserCache(const Config& config);
+	virtual ~UserCache();
+
+	/**
+	 * Same as UserUtils::getUserName().
+	 */
+	String getUserName(UserId uid, bool& success);
+
+	/**
+	 * Same as UserUtils::getGroupName().
+	 */
+	String getGroupName(GroupId gid, bool& success);
+
+	/**
+	 * Same as UserUtils::getUserId().
+	 */
+	UserId getUserId(const String& userName, bool& success);
+
+	/**
+	 * Same as UserUtils::getGroupId().
+	 */
+	GroupId getGroupId(const String& groupName, bool& success);
+
+	/**
+	 * Drop all cached entries.  Call this after changing users or groups.
+	 */
+	void invalidate();
+
+	/**
+	 * The cache used by the UserUtils functions.
+	 */
+	static UserCache& getDefault();
+
+protected:
+	/**
+	 * Used to decide when cache entries expire and when to check the files.
+	 * Subclasses may override it for testing.
+	 */
+	virtual Time::TimePoint getCurrentTime() const;
+
+private:
+	// noncopyable
+	UserCache(const UserCache&);
+	UserCache& operator=(const UserCache&);
+
+	struct Entry;
+	class Table;
+	enum ELookupResult
+	{
+		E_FOUND,
+		E_NOT_FOUND,
+		// the lookup failed for some other reason and shouldn't be cached
+		E_LOOKUP_FAILED
+	};
+
+	void init();
+	void checkFiles(Int64 now);
+	bool findId(Table& table, UInt64 id, String& name, bool& found, Int64 now);
+	bool findName(Table& table, const String& name, UInt64& id, bool& found, Int64 now);
+	void store(Table* table, Entry* entry, UInt32 generation, ELookupResult result, Int64 now);
+
+	ELookupResult lookupUser(UserId uid, String& name) const;
+	ELookupResult lookupUser(const String& name, UserId& uid) const;
+	ELookupResult lookupGroup(GroupId gid, String& name) const;
+	ELookupResult lookupGroup(const String& name, GroupId& gid) const;
+	ELookupResult lookupFile(const String& path, const String* name, UInt64 id,
+		String& nameOut, UInt64& idOut) const;
+
+	Config m_config;
+	HazardPointerDomain m_hazards;
+	Table* m_usersById;
+	Table* m_usersByName;
+	Table* m_groupsById;
+	Table* m_groupsByName;
+	// Entries from an older generation are ignored.
+	Atomic<UInt32> m_generation;
+	Atomic<Int64> m_nextFileCheck;
+	Mutex m_fileCheckGuard;
+	Int64 m_passwdSignature[2];
+	Int64 m_groupSignature[2];
+};
+BLOCXX_EXPORT_TEMPLATE(BLOCXX_COMMON_API, IntrusiveReference, UserCache);
+typedef IntrusiveReference<UserCache> UserCacheRef;
+
+} // end namespace BLOCXX_NAMESPACE
+
+#endif // BLOCXX_WIN32
+
+#endif
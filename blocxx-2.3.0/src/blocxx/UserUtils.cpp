@@ -39,9 +39,7 @@
 
 #include "blocxx/BLOCXX_config.h"
 #include "blocxx/UserUtils.hpp"
-#include "blocxx/Mutex.hpp"
-#include "blocxx/MutexLock.hpp"
-#include "blocxx/GlobalMutex.hpp"
+#include "blocxx/UserCache.hpp"
 #include "blocxx/String.hpp"
 
 #ifdef BLOCXX_HAVE_UNISTD_H
@@ -52,17 +50,6 @@
 #include <sys/types.h>
 #endif
 
-#ifdef BLOCXX_HAVE_PWD_H
-#include <pwd.h>
-#endif
-
-#ifdef BLOCXX_HAVE_GRP_H
-#include <grp.h>
-#endif
-
-#include <cerrno>
-#include <vector>
-
 #ifdef BLOCXX_WIN32
 /////////////////////////////////////////////////////////////////////////////
 BLOCXX_NAMESPACE::UserId geteuid(void )
@@ -186,55 +173,6 @@ String getCurrentGroupName()
 #endif
 }
 
-namespace
-{
-GlobalMutex g_getpwMutex = BLOCXX_GLOBAL_MUTEX_INIT();
-GlobalMutex g_getgrMutex = BLOCXX_GLOBAL_MUTEX_INIT();
-}
-
-namespace // anonymous
-{
-	// Get a sysconf value.  If no value is set (or another error occurs), return the default value.
-	long getSysconfValue(int name, long default_value, int& error)
-	{
-#ifdef BLOCXX_WIN32
-#pragma message(Reminder "TODO: Implement for Win if you use getSysconfValue not only for _SC_GETPW_R_SIZE_MAX")
-		error = 0;
-		return default_value;
-#else
-		errno = 0;
-
-		long l = sysconf(name);
-
-		if( l == -1 )
-		{
-			if( errno == 0 )
-			{
-				// The POSIX standard says this means the limit is indefinite (not infinite).
-				error = 0;
-				return default_value;
-			}
-			else
-			{
-				error = errno;
-				return default_value;
-			}
-		}
-		else
-		{
-			error = 0;
-			return l;
-		}
-#endif
-	}
-
-	long getSysconfValue(int name, long default_value)
-	{
-		int unused;
-		return getSysconfValue(name, default_value, unused);
-	}
-} // end annymous namespace
-
 //////////////////////////////////////////////////////////////////////////////
 String getUserName(uid_t uid,bool& ok)
 {
@@ -257,44 +195,7 @@ String getUserName(uid_t uid,bool& ok)
 				&snuOutVar);
 	return String(cchName);
 #else
-
-	if( uid == INVALID_USERID )
-	{
-		ok = false;
-		return "";
-	}
-
-
-#ifdef BLOCXX_HAVE_GETPWUID_R
-	passwd pw;
-	size_t const additionalSize =
-#ifdef _SC_GETPW_R_SIZE_MAX
-		getSysconfValue(_SC_GETPW_R_SIZE_MAX, 10240);
-#else
-		10240;
-#endif
-	std::vector<char> additional(additionalSize);
-	passwd* result;
-	int rv = 0;
-	do
-	{
-		rv = ::getpwuid_r(uid, &pw, &additional[0], additional.size(), &result);
-		if (rv == ERANGE)
-		{
-			additional.resize(additional.size() * 2);
-		}
-	} while (rv == ERANGE);
-#else
-	MutexLock lock(g_getpwMutex);
-	passwd* result = ::getpwuid(uid);
-#endif
-	if (result)
-	{
-		ok = true;
-		return result->pw_name;
-	}
-	ok = false;
-	return "";
+	return UserCache::getDefault().getUserName(uid, ok);
 #endif
 }
 
@@ -305,42 +206,7 @@ String getGroupName(gid_t gid,bool& ok)
 #pragma message ("Not implemented")
 	return String();
 #else
-	if( gid == INVALID_GROUPID )
-	{
-		ok = false;
-		return "";
-	}
-
-#ifdef BLOCXX_HAVE_GETGRGID_R
-	group gr;
-	size_t const additionalSize =
-#ifdef _SC_GETGR_R_SIZE_MAX
-		getSysconfValue(_SC_GETGR_R_SIZE_MAX, 10240);
-#else
-		10240;
-#endif
-	std::vector<char> additional(additionalSize);
-	group* result;
-	int rv = 0;
-	do
-	{
-		rv = ::getgrgid_r(gid, &gr, &additional[0], additional.size(), &result);
-		if (rv == ERANGE)
-		{
-			additional.resize(additional.size() * 2);
-		}
-	} while (rv == ERANGE);
-#else
-	MutexLock lock(g_getgrMutex);
-	group* result = ::getgrgid(gid);
-#endif
-	if (result)
-	{
-		ok = true;
-		return result->gr_name;
-	}
-	ok = false;
-	return "";
+	return UserCache::getDefault().getGroupName(gid, ok);
 #endif
 }
 
@@ -368,44 +234,7 @@ getUserId(const String& userName, bool& validUserName)
 			&snuOutVar))? &uid : NULL;
 
 #else
-
-
-#ifdef BLOCXX_HAVE_GETPWNAM_R
-	size_t bufsize =
-#ifdef _SC_GETPW_R_SIZE_MAX
-		getSysconfValue(_SC_GETPW_R_SIZE_MAX, 10240);
-#else
-		1024;
-#endif
-	std::vector<char> buf(bufsize);
-	struct passwd pwd;
-	passwd* result = 0;
-	int rv = 0;
-	do
-	{
-		rv = ::getpwnam_r(userName.c_str(), &pwd, &buf[0], buf.size(), &result);
-		if (rv == ERANGE)
-		{
-			buf.resize(buf.size() * 2);
-		}
-	} while (rv == ERANGE);
-
-	if (rv != 0)
-	{
-		return INVALID_USERID;
-	}
-
-#else
-	MutexLock ml(g_getpwMutex);
-	struct passwd* result;
-	result = ::getpwnam(userName.c_str());
-#endif
-	if (result)
-	{
-		validUserName = true;
-		return result->pw_uid;
-	}
-	return INVALID_USERID;
+	return UserCache::getDefault().getUserId(userName, validUserName);
 #endif
 }
 
@@ -419,43 +248,15 @@ getGroupId(const String& groupName, bool& validGroupName)
 #pragma message ("Not implemented")
 	return 0;
 #else
-
-	group* result = NULL;
-
-#ifdef BLOCXX_HAVE_GETGRNAM_R
-	size_t bufsize =
-#ifdef _SC_GETGR_R_SIZE_MAX
-		getSysconfValue(_SC_GETGR_R_SIZE_MAX, 10240);
-#else
-		1024;
+	return UserCache::getDefault().getGroupId(groupName, validGroupName);
 #endif
-	std::vector<char> buf(bufsize);
-	struct group grp;
-	int rv = 0;
-	do
-	{
-		rv = ::getgrnam_r(groupName.c_str(), &grp, &buf[0], buf.size(), &result);
-		if (rv == ERANGE)
-		{
-			buf.resize(buf.size() * 2);
-		}
-	} while (rv == ERANGE);
-
-	if (rv != 0)
-	{
-		return INVALID_USERID;
-	}
+}
 
-#else
-	MutexLock ml(g_getgrMutex);
-	result = ::getgrnam(groupName.c_str());
-#endif
-	if (result)
-	{
-		validGroupName = true;
-		return result->gr_gid;
-	}
-	return INVALID_GROUPID;
+//////////////////////////////////////////////////////////////////////////////
+void invalidateCache()
+{
+#ifndef BLOCXX_WIN32
+	UserCache::getDefault().invalidate();
 #endif
 }
 } // end namespace UserUtils
@@ -49,7 +49,13 @@ BLOCXX_COMMON_API BLOCXX_NAMESPACE::UserId geteuid(void);
 
 namespace BLOCXX_NAMESPACE
 {
-	/// Facade encapsulating OS specific user functionality.
+	/**
+	 * Facade encapsulating OS specific user functionality.
+	 *
+	 * On POSIX platforms getUserName(), getGroupName(), getUserId() and
+	 * getGroupId() are answered from UserCache::getDefault(), so a change
+	 * to the user database may not be seen for a while; see UserCache.
+	 */
 	namespace UserUtils
 	{
 #if !defined( BLOCXX_WIN32 )
@@ -124,6 +130,12 @@ namespace BLOCXX_NAMESPACE
 		 */
 		BLOCXX_COMMON_API UserId getGroupId(const String& groupName, bool& validGroupName);
 
+		/**
+		 * Forget cached user and group lookups, so that the next ones see
+		 * any changes to the user database.
+		 */
+		BLOCXX_COMMON_API void invalidateCache();
+
 	} // end namespace UserUtils
 } // end namespace BLOCXX_NAMESPACE
 
@@ -0,0 +1,189 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Arena.hpp"
+#include "blocxx/IntrusiveCountableBase.hpp"
+#include "blocxx/SmallObjectPool.hpp"
+#include "blocxx/StringBuffer.hpp"
+#include "blocxx/String.hpp"
+
+#include <vector>
+
+using namespace blocxx;
+
+namespace
+{
+	//////////////////////////////////////////////////////////////////////////
+	// Small reference counted objects, the size of a typical Runnable,
+	// from the heap and from the SmallObjectPool.
+
+	class HeapObject : public IntrusiveCountableBase
+	{
+	public:
+		virtual ~HeapObject()
+		{
+		}
+	private:
+		void* m_data[4];
+	};
+
+	class PooledHeapObject : public HeapObject, public PooledObject
+	{
+	};
+
+	template <typename T>
+	void newDelete(Bench::State& state)
+	{
+		for (UInt64 i = state.iterations(); i > 0; --i)
+		{
+			HeapObject* p = new T;
+			Bench::doNotOptimize(p);
+			delete p;
+		}
+	}
+
+	const size_t BATCH_SIZE = 256;
+
+	// Allocates BATCH_SIZE objects before freeing any, which a thread's
+	// cache can't hold, so the pool has to go to its central lists.
+	template <typename T>
+	void newDeleteBatch(Bench::State& state)
+	{
+		std::vector<HeapObject*> objects(BATCH_SIZE);
+		for (UInt64 i = state.iterations(); i > 0; --i)
+		{
+			for (size_t j = 0; j < BATCH_SIZE; ++j)
+			{
+				objects[j] = new T;
+			}
+			for (size_t j = 0; j < BATCH_SIZE; ++j)
+			{
+				delete objects[j];
+			}
+		}
+		state.setItemsProcessed(state.iterations() * BATCH_SIZE);
+	}
+
+	template <typename T>
+	class NewDeleteBody : public Bench::ParallelBody
+	{
+	public:
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				HeapObject* p = new T;
+				Bench::doNotOptimize(p);
+				delete p;
+			}
+		}
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Request-scoped string building: a few messages of about a hundred
+	// characters each, with StringBuffers from the heap or from an Arena.
+
+	const int MESSAGES_PER_REQUEST = 8;
+
+	void buildMessage(StringBuffer& sb, int i)
+	{
+		sb += "request ";
+		sb += i;
+		sb += ": component=bench.component.100 category=DEBUG ";
+		sb += "message=a typical debug message";
+	}
+}
+
+BLOCXX_BENCHMARK(Alloc_heapNewDelete)
+{
+	newDelete<HeapObject>(state);
+}
+
+BLOCXX_BENCHMARK(Alloc_pooledNewDelete)
+{
+	newDelete<PooledHeapObject>(state);
+}
+
+BLOCXX_BENCHMARK(Alloc_heapNewDeleteBatch)
+{
+	newDeleteBatch<HeapObject>(state);
+}
+
+BLOCXX_BENCHMARK(Alloc_pooledNewDeleteBatch)
+{
+	newDeleteBatch<PooledHeapObject>(state);
+	state.setCounter("pool_reserved_bytes", double(SmallObjectPool::getReservedBytes()));
+}
+
+BLOCXX_BENCHMARK_RANGE(Alloc_heapNewDeleteParallel, 1, 8, 2)
+{
+	NewDeleteBody<HeapObject> body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK_RANGE(Alloc_pooledNewDeleteParallel, 1, 8, 2)
+{
+	NewDeleteBody<PooledHeapObject> body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK(Alloc_heapStringBuffers)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		for (int j = 0; j < MESSAGES_PER_REQUEST; ++j)
+		{
+			StringBuffer sb(64);
+			buildMessage(sb, j);
+			Bench::doNotOptimize(sb.c_str());
+		}
+	}
+}
+
+BLOCXX_BENCHMARK(Alloc_arenaStringBuffers)
+{
+	size_t arenaBytes = 0;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Arena arena;
+		for (int j = 0; j < MESSAGES_PER_REQUEST; ++j)
+		{
+			StringBuffer sb(arena, 64);
+			buildMessage(sb, j);
+			Bench::doNotOptimize(sb.c_str());
+		}
+		arenaBytes = arena.getBytesAllocated();
+	}
+	state.setCounter("arena_bytes_per_op", double(arenaBytes));
+}
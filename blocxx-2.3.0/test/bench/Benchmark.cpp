@@ -0,0 +1,867 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/CmdLineParser.hpp"
+#include "blocxx/DateTime.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/HeapProfiler.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/ThreadBarrier.hpp"
+#include "blocxx/TimePoint.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#ifdef BLOCXX_HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#if defined(BLOCXX_HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#define BLOCXX_BENCH_HAVE_PERF_EVENTS 1
+#endif
+
+// Every allocation the benchmark program makes goes through these, so the
+// runner can report allocations per operation and HeapProfiler can sample
+// them.  The counters are plain
+// integers rather than Atomic<UInt64>s so they're usable by allocations made
+// during static initialization.
+namespace
+{
+	BLOCXX_NAMESPACE::UInt64 g_allocations = 0;
+	BLOCXX_NAMESPACE::UInt64 g_allocatedBytes = 0;
+	bool g_countAllocations = true;
+
+	inline void* countedNew(std::size_t size)
+	{
+		if (g_countAllocations)
+		{
+			using namespace BLOCXX_NAMESPACE;
+			AtomicImpl::fetchAdd(g_allocations, UInt64(1), E_MEMORY_ORDER_RELAXED);
+			AtomicImpl::fetchAdd(g_allocatedBytes, UInt64(size), E_MEMORY_ORDER_RELAXED);
+		}
+		void* p = BLOCXX_NAMESPACE::HeapProfiler::allocate(size);
+		if (!p)
+		{
+			throw std::bad_alloc();
+		}
+		return p;
+	}
+}
+
+void*
+operator new(std::size_t size) BLOCXX_THROW_BAD_ALLOC
+{
+	return countedNew(size);
+}
+
+void*
+operator new[](std::size_t size) BLOCXX_THROW_BAD_ALLOC
+{
+	return countedNew(size);
+}
+
+void
+operator delete(void* p) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+
+void
+operator delete[](void* p) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+
+void
+operator delete(void* p, std::size_t) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+
+void
+operator delete[](void* p, std::size_t) throw()
+{
+	BLOCXX_NAMESPACE::HeapProfiler::deallocate(p);
+}
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace Bench
+{
+
+namespace
+{
+	struct Benchmark
+	{
+		Benchmark(const String& name_, BenchmarkFunc func_, Int32 arg_)
+			: name(name_)
+			, func(func_)
+			, arg(arg_)
+		{
+		}
+		String name;
+		BenchmarkFunc func;
+		Int32 arg;
+	};
+
+	// A function local static, so registrations from other translation
+	// units' static initializers don't depend on initialization order.
+	std::vector<Benchmark>& registry()
+	{
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	Int64 nowMicroseconds()
+	{
+		return Time::TimePoint::now().microseconds();
+	}
+
+	UInt64 allocationCount()
+	{
+		return AtomicImpl::load(g_allocations, E_MEMORY_ORDER_RELAXED);
+	}
+
+	UInt64 allocatedByteCount()
+	{
+		return AtomicImpl::load(g_allocatedBytes, E_MEMORY_ORDER_RELAXED);
+	}
+
+	/**
+	 * Counts the CPU cycles used by this process, including threads it
+	 * creates after the counter is opened.  Not available if the kernel
+	 * doesn't allow it (see perf_event_paranoid), or in a VM without a PMU.
+	 */
+	class CycleCounter
+	{
+	public:
+		CycleCounter()
+			: m_fd(-1)
+		{
+#ifdef BLOCXX_BENCH_HAVE_PERF_EVENTS
+			struct perf_event_attr attr;
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			attr.inherit = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			m_fd = ::syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+		}
+
+		~CycleCounter()
+		{
+			if (m_fd >= 0)
+			{
+				::close(m_fd);
+			}
+		}
+
+		bool valid() const
+		{
+			return m_fd >= 0;
+		}
+
+		UInt64 read() const
+		{
+			UInt64 count = 0;
+			if (m_fd >= 0 && ::read(m_fd, &count, sizeof(count)) != ssize_t(sizeof(count)))
+			{
+				count = 0;
+			}
+			return count;
+		}
+
+	private:
+		int m_fd;
+	};
+
+	CycleCounter* g_cycleCounter = 0;
+
+	UInt64 cycleCount()
+	{
+		return g_cycleCounter ? g_cycleCounter->read() : 0;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+State::State(UInt64 iterations, Int32 arg)
+	: m_iterations(iterations)
+	, m_arg(arg)
+	, m_running(false)
+	, m_startMicroseconds(0)
+	, m_microseconds(0)
+	, m_startCycles(0)
+	, m_cycles(0)
+	, m_cyclesValid(g_cycleCounter && g_cycleCounter->valid())
+	, m_startAllocations(0)
+	, m_allocations(0)
+	, m_startAllocatedBytes(0)
+	, m_allocatedBytes(0)
+	, m_items(0)
+	, m_bytes(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+State::pauseTiming()
+{
+	if (m_running)
+	{
+		m_microseconds += nowMicroseconds() - m_startMicroseconds;
+		m_cycles += cycleCount() - m_startCycles;
+		m_allocations += allocationCount() - m_startAllocations;
+		m_allocatedBytes += allocatedByteCount() - m_startAllocatedBytes;
+		m_running = false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+State::resumeTiming()
+{
+	if (!m_running)
+	{
+		m_running = true;
+		m_startAllocatedBytes = allocatedByteCount();
+		m_startAllocations = allocationCount();
+		m_startCycles = cycleCount();
+		m_startMicroseconds = nowMicroseconds();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+State::setCounter(const char* name, double value)
+{
+	for (size_t i = 0; i < m_counters.size(); ++i)
+	{
+		if (m_counters[i].first == name)
+		{
+			m_counters[i].second = value;
+			return;
+		}
+	}
+	m_counters.push_back(std::make_pair(String(name), value));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+State::skip(const String& reason)
+{
+	m_skipReason = reason.empty() ? String("skipped") : reason;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+State::start()
+{
+	m_microseconds = 0;
+	m_cycles = 0;
+	m_allocations = 0;
+	m_allocatedBytes = 0;
+	resumeTiming();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+State::stop()
+{
+	pauseTiming();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+double
+State::seconds() const
+{
+	return m_microseconds / 1e6;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UInt64
+State::cycles() const
+{
+	return m_cycles;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool
+State::cyclesValid() const
+{
+	return m_cyclesValid;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UInt64
+State::allocations() const
+{
+	return m_allocations;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+UInt64
+State::allocatedBytes() const
+{
+	return m_allocatedBytes;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Registration::Registration(const char* name, BenchmarkFunc func)
+{
+	registry().push_back(Benchmark(name, func, 0));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+Registration::Registration(const char* name, BenchmarkFunc func, Int32 first, Int32 last, Int32 multiplier)
+{
+	if (multiplier < 2)
+	{
+		multiplier = 2;
+	}
+	// A range starting at 0 continues with 1, so it can't get stuck.
+	for (Int32 arg = first; arg <= last; arg = arg > 0 ? arg * multiplier : 1)
+	{
+		registry().push_back(Benchmark(Format("%1/%2", name, arg), func, arg));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////
+ParallelBody::~ParallelBody()
+{
+}
+
+namespace
+{
+	class BodyThread : public Thread
+	{
+	public:
+		BodyThread(ParallelBody& body, ThreadBarrier& barrier, UInt32 index, UInt64 iterations)
+			: m_body(body)
+			, m_barrier(barrier)
+			, m_index(index)
+			, m_iterations(iterations)
+		{
+		}
+
+	private:
+		virtual Int32 run()
+		{
+			m_barrier.wait();
+			m_body.run(m_index, m_iterations);
+			return 0;
+		}
+
+		ParallelBody& m_body;
+		ThreadBarrier& m_barrier;
+		UInt32 m_index;
+		UInt64 m_iterations;
+	};
+	typedef IntrusiveReference<BodyThread> BodyThreadRef;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void
+runParallel(State& state, UInt32 threads, ParallelBody& body)
+{
+	if (threads == 0)
+	{
+		threads = 1;
+	}
+	state.pauseTiming();
+	ThreadBarrier barrier(threads + 1);
+	std::vector<BodyThreadRef> workers;
+	UInt64 perThread = state.iterations() / threads;
+	UInt64 extra = state.iterations() % threads;
+	for (UInt32 i = 0; i < threads; ++i)
+	{
+		BodyThreadRef t(new BodyThread(body, barrier, i, perThread + (i < extra ? 1 : 0)));
+		t->start();
+		workers.push_back(t);
+	}
+	state.resumeTiming();
+	barrier.wait();
+	for (UInt32 i = 0; i < threads; ++i)
+	{
+		workers[i]->join();
+	}
+	state.pauseTiming();
+	workers.clear();
+	state.resumeTiming();
+}
+
+namespace
+{
+	struct Options
+	{
+		StringArray filters;
+		UInt32 repetitions;
+		UInt32 warmup;
+		double minTime;
+		String output;
+	};
+
+	struct Result
+	{
+		Result()
+			: iterations(0)
+			, cyclesValid(false)
+		{
+		}
+		String name;
+		String skipReason;
+		UInt64 iterations;
+		std::vector<double> nsPerOp;
+		std::vector<double> cyclesPerOp;
+		bool cyclesValid;
+		double allocationsPerOp;
+		double bytesAllocatedPerOp;
+		double itemsPerSecond;
+		double bytesPerSecond;
+		std::vector<std::pair<String, double> > counters;
+	};
+
+	bool selected(const Benchmark& b, const Options& opts)
+	{
+		if (opts.filters.empty())
+		{
+			return true;
+		}
+		for (size_t i = 0; i < opts.filters.size(); ++i)
+		{
+			if (b.name.indexOf(opts.filters[i]) != String::npos)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	State runOnce(const Benchmark& b, UInt64 iterations)
+	{
+		State state(iterations, b.arg);
+		state.start();
+		b.func(state);
+		state.stop();
+		return state;
+	}
+
+	const UInt64 MAX_ITERATIONS = 1000000000;
+
+	/**
+	 * Pick an iteration count for which one run takes at least minTime,
+	 * starting from 1 and growing by at most a factor of 10 each step.
+	 */
+	UInt64 calibrate(const Benchmark& b, double minTime, State& last)
+	{
+		UInt64 iterations = 1;
+		while (true)
+		{
+			last = runOnce(b, iterations);
+			double seconds = last.seconds();
+			if (last.skipped() || seconds >= minTime || iterations >= MAX_ITERATIONS)
+			{
+				return iterations;
+			}
+			double multiplier = seconds <= minTime / 10 ? 10.0 : minTime * 1.4 / seconds;
+			UInt64 next = UInt64(iterations * multiplier);
+			iterations = std::min(std::max(next, iterations + 1), MAX_ITERATIONS);
+		}
+	}
+
+	double percentile(const std::vector<double>& sorted, double p)
+	{
+		if (sorted.empty())
+		{
+			return 0;
+		}
+		size_t rank = size_t(std::ceil(p * sorted.size()));
+		return sorted[rank > 0 ? rank - 1 : 0];
+	}
+
+	double mean(const std::vector<double>& v)
+	{
+		double sum = 0;
+		for (size_t i = 0; i < v.size(); ++i)
+		{
+			sum += v[i];
+		}
+		return v.empty() ? 0 : sum / v.size();
+	}
+
+	double stddev(const std::vector<double>& v)
+	{
+		if (v.size() < 2)
+		{
+			return 0;
+		}
+		double m = mean(v);
+		double sum = 0;
+		for (size_t i = 0; i < v.size(); ++i)
+		{
+			sum += (v[i] - m) * (v[i] - m);
+		}
+		return std::sqrt(sum / (v.size() - 1));
+	}
+
+	Result run(const Benchmark& b, const Options& opts)
+	{
+		Result r;
+		r.name = b.name;
+		State state(0, b.arg);
+		r.iterations = calibrate(b, opts.minTime, state);
+		if (state.skipped())
+		{
+			r.skipReason = state.skipReason();
+			return r;
+		}
+		for (UInt32 i = 0; i < opts.warmup; ++i)
+		{
+			runOnce(b, r.iterations);
+		}
+
+		UInt64 allocations = 0;
+		UInt64 allocatedBytes = 0;
+		UInt64 items = 0;
+		UInt64 bytes = 0;
+		double seconds = 0;
+		r.cyclesValid = state.cyclesValid();
+		for (UInt32 i = 0; i < opts.repetitions; ++i)
+		{
+			state = runOnce(b, r.iterations);
+			r.nsPerOp.push_back(state.seconds() * 1e9 / r.iterations);
+			r.cyclesPerOp.push_back(double(state.cycles()) / r.iterations);
+			allocations += state.allocations();
+			allocatedBytes += state.allocatedBytes();
+			items += state.items();
+			bytes += state.bytes();
+			seconds += state.seconds();
+			const std::vector<std::pair<String, double> >& counters = state.counters();
+			for (size_t j = 0; j < counters.size(); ++j)
+			{
+				size_t k = 0;
+				while (k < r.counters.size() && r.counters[k].first != counters[j].first)
+				{
+					++k;
+				}
+				if (k == r.counters.size())
+				{
+					r.counters.push_back(std::make_pair(counters[j].first, 0.0));
+				}
+				r.counters[k].second += counters[j].second / opts.repetitions;
+			}
+		}
+		// A counter that reads zero on every run means the PMU isn't really
+		// counting (some VMs allow opening the event but never count).
+		if (r.cyclesValid && *std::max_element(r.cyclesPerOp.begin(), r.cyclesPerOp.end()) == 0)
+		{
+			r.cyclesValid = false;
+		}
+		double totalIterations = double(r.iterations) * opts.repetitions;
+		r.allocationsPerOp = allocations / totalIterations;
+		r.bytesAllocatedPerOp = allocatedBytes / totalIterations;
+		r.itemsPerSecond = seconds > 0 ? items / seconds : 0;
+		r.bytesPerSecond = seconds > 0 ? bytes / seconds : 0;
+		std::sort(r.nsPerOp.begin(), r.nsPerOp.end());
+		std::sort(r.cyclesPerOp.begin(), r.cyclesPerOp.end());
+		return r;
+	}
+
+	String jsonString(const String& s)
+	{
+		StringBuffer buf(s.length() + 2);
+		buf += '"';
+		for (size_t i = 0; i < s.length(); ++i)
+		{
+			unsigned char c = s[i];
+			switch (c)
+			{
+				case '"': buf += "\\\""; break;
+				case '\\': buf += "\\\\"; break;
+				case '\n': buf += "\\n"; break;
+				case '\t': buf += "\\t"; break;
+				default:
+					if (c < 0x20)
+					{
+						char esc[8];
+						std::sprintf(esc, "\\u%04x", c);
+						buf += esc;
+					}
+					else
+					{
+						buf += char(c);
+					}
+			}
+		}
+		buf += '"';
+		return buf.releaseString();
+	}
+
+	void writeStats(std::ostream& out, const char* name, const std::vector<double>& sorted, bool valid)
+	{
+		out << "      \"" << name << "\": ";
+		if (!valid)
+		{
+			out << "null";
+			return;
+		}
+		out << "{\"min\": " << sorted.front()
+			<< ", \"median\": " << percentile(sorted, 0.5)
+			<< ", \"p90\": " << percentile(sorted, 0.9)
+			<< ", \"p99\": " << percentile(sorted, 0.99)
+			<< ", \"max\": " << sorted.back()
+			<< ", \"mean\": " << mean(sorted)
+			<< ", \"stddev\": " << stddev(sorted) << "}";
+	}
+
+	void writeJSON(std::ostream& out, const Options& opts, const std::vector<Result>& results)
+	{
+		char host[256] = "";
+#ifdef BLOCXX_HAVE_UNISTD_H
+		::gethostname(host, sizeof(host) - 1);
+#endif
+		long cpus = 0;
+#if defined(_SC_NPROCESSORS_ONLN)
+		cpus = ::sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		out.precision(6);
+		out << "{\n"
+			<< "  \"context\": {\n"
+			<< "    \"date\": " << jsonString(DateTime::getCurrent().toISO8601String(DateTime::E_UTC_TIME)) << ",\n"
+			<< "    \"host\": " << jsonString(host) << ",\n"
+			<< "    \"cpus\": " << cpus << ",\n"
+			<< "    \"blocxx_version\": " << jsonString(BLOCXX_PACKAGE_VERSION) << ",\n"
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+			<< "    \"rvalue_references\": true,\n"
+#else
+			<< "    \"rvalue_references\": false,\n"
+#endif
+			<< "    \"cycle_counter\": " << (g_cycleCounter && g_cycleCounter->valid() ? "true" : "false") << ",\n"
+			<< "    \"allocation_counts\": " << (g_countAllocations ? "true" : "false") << ",\n"
+			<< "    \"repetitions\": " << opts.repetitions << ",\n"
+			<< "    \"warmup\": " << opts.warmup << ",\n"
+			<< "    \"min_time\": " << opts.minTime << "\n"
+			<< "  },\n"
+			<< "  \"benchmarks\": [";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& r = results[i];
+			out << (i ? ",\n" : "\n") << "    {\n"
+				<< "      \"name\": " << jsonString(r.name) << ",\n";
+			if (!r.skipReason.empty())
+			{
+				out << "      \"skipped\": " << jsonString(r.skipReason) << "\n    }";
+				continue;
+			}
+			out << "      \"iterations\": " << r.iterations << ",\n"
+				<< "      \"repetitions\": " << r.nsPerOp.size() << ",\n";
+			writeStats(out, "ns_per_op", r.nsPerOp, true);
+			out << ",\n";
+			writeStats(out, "cycles_per_op", r.cyclesPerOp, r.cyclesValid);
+			out << ",\n";
+			if (g_countAllocations)
+			{
+				out << "      \"allocations_per_op\": " << r.allocationsPerOp << ",\n"
+					<< "      \"bytes_allocated_per_op\": " << r.bytesAllocatedPerOp;
+			}
+			else
+			{
+				out << "      \"allocations_per_op\": null,\n"
+					<< "      \"bytes_allocated_per_op\": null";
+			}
+			if (r.itemsPerSecond > 0)
+			{
+				out << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+			}
+			if (r.bytesPerSecond > 0)
+			{
+				out << ",\n      \"bytes_per_second\": " << r.bytesPerSecond;
+			}
+			if (!r.counters.empty())
+			{
+				out << ",\n      \"counters\": {";
+				for (size_t j = 0; j < r.counters.size(); ++j)
+				{
+					out << (j ? ", " : "") << jsonString(r.counters[j].first) << ": " << r.counters[j].second;
+				}
+				out << "}";
+			}
+			out << "\n    }";
+		}
+		out << "\n  ]\n}\n";
+	}
+
+	void printProgress(const Result& r)
+	{
+		if (!r.skipReason.empty())
+		{
+			std::cerr << Format("%1 skipped: %2", r.name.c_str(), r.skipReason) << std::endl;
+			return;
+		}
+		String cycles = r.cyclesValid ? String(Format("%1", UInt64(percentile(r.cyclesPerOp, 0.5)))) : String("-");
+		String allocs = g_countAllocations ? String(Format("%1", r.allocationsPerOp)) : String("-");
+		std::cerr << Format("%1 %2 ns/op  %3 cycles/op  %4 allocs/op  (%5 iterations)",
+			r.name.c_str(), percentile(r.nsPerOp, 0.5), cycles, allocs, r.iterations) << std::endl;
+	}
+
+	enum
+	{
+		E_HELP_OPT,
+		E_LIST_OPT,
+		E_FILTER_OPT,
+		E_REPETITIONS_OPT,
+		E_WARMUP_OPT,
+		E_MIN_TIME_OPT,
+		E_OUTPUT_OPT,
+		E_NO_ALLOCATION_COUNTS_OPT
+	};
+
+	CmdLineParser::Option g_options[] =
+	{
+		{E_HELP_OPT, 'h', "help", CmdLineParser::E_NO_ARG, 0, "Show this help."},
+		{E_LIST_OPT, 'l', "list", CmdLineParser::E_NO_ARG, 0, "List the benchmarks and exit."},
+		{E_FILTER_OPT, 'f', "filter", CmdLineParser::E_REQUIRED_ARG, 0,
+			"Only run benchmarks whose name contains one of these comma separated strings."},
+		{E_REPETITIONS_OPT, 'r', "repetitions", CmdLineParser::E_REQUIRED_ARG, 0,
+			"Number of measured runs of each benchmark.  Default 10."},
+		{E_WARMUP_OPT, 'w', "warmup", CmdLineParser::E_REQUIRED_ARG, 0,
+			"Number of unmeasured runs before the measured ones.  Default 1."},
+		{E_MIN_TIME_OPT, 't', "min-time", CmdLineParser::E_REQUIRED_ARG, 0,
+			"Minimum time in seconds of one run, used to pick the iteration count.  Default 0.05."},
+		{E_OUTPUT_OPT, 'o', "output", CmdLineParser::E_REQUIRED_ARG, 0,
+			"Write the JSON results to this file instead of stdout."},
+		{E_NO_ALLOCATION_COUNTS_OPT, 0, "no-allocation-counts", CmdLineParser::E_NO_ARG, 0,
+			"Don't count allocations, which slightly slows down allocating benchmarks."},
+		{0, 0, 0, CmdLineParser::E_NO_ARG, 0, 0}
+	};
+}
+
+//////////////////////////////////////////////////////////////////////////////
+int
+runBenchmarks(int argc, char** argv)
+{
+	Options opts;
+	try
+	{
+		CmdLineParser parser(argc, argv, g_options, CmdLineParser::E_NON_OPTION_ARGS_INVALID);
+		if (parser.isSet(E_HELP_OPT))
+		{
+			std::cout << "Usage: " << argv[0] << " [options]\n" << CmdLineParser::getUsage(g_options);
+			return 0;
+		}
+		if (parser.isSet(E_FILTER_OPT))
+		{
+			opts.filters = parser.getOptionValue(E_FILTER_OPT).tokenize(",");
+		}
+		opts.repetitions = parser.getOptionValue(E_REPETITIONS_OPT, "10").toUInt32();
+		opts.warmup = parser.getOptionValue(E_WARMUP_OPT, "1").toUInt32();
+		opts.minTime = parser.getOptionValue(E_MIN_TIME_OPT, "0.05").toReal64();
+		opts.output = parser.getOptionValue(E_OUTPUT_OPT);
+		g_countAllocations = !parser.isSet(E_NO_ALLOCATION_COUNTS_OPT);
+		if (opts.repetitions == 0)
+		{
+			opts.repetitions = 1;
+		}
+
+		std::vector<Benchmark>& benchmarks = registry();
+		if (parser.isSet(E_LIST_OPT))
+		{
+			for (size_t i = 0; i < benchmarks.size(); ++i)
+			{
+				if (selected(benchmarks[i], opts))
+				{
+					std::cout << benchmarks[i].name << '\n';
+				}
+			}
+			return 0;
+		}
+
+		CycleCounter cycleCounter;
+		g_cycleCounter = &cycleCounter;
+		std::vector<Result> results;
+		for (size_t i = 0; i < benchmarks.size(); ++i)
+		{
+			if (selected(benchmarks[i], opts))
+			{
+				results.push_back(run(benchmarks[i], opts));
+				printProgress(results.back());
+			}
+		}
+
+		if (opts.output.empty())
+		{
+			writeJSON(std::cout, opts, results);
+		}
+		else
+		{
+			std::ofstream out(opts.output.c_str());
+			writeJSON(out, opts, results);
+			if (!out)
+			{
+				std::cerr << "Failed writing " << opts.output << std::endl;
+				return 1;
+			}
+		}
+		g_cycleCounter = 0;
+	}
+	catch (CmdLineParserException& e)
+	{
+		std::cerr << e.getMessage() << '\n' << "Usage: " << argv[0] << " [options]\n" << CmdLineParser::getUsage(g_options);
+		return 1;
+	}
+	catch (Exception& e)
+	{
+		std::cerr << e << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+} // end namespace Bench
+
+} // end namespace BLOCXX_NAMESPACE
@@ -0,0 +1,255 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#ifndef BLOCXX_BENCHMARK_HPP_INCLUDE_GUARD_
+#define BLOCXX_BENCHMARK_HPP_INCLUDE_GUARD_
+#include "blocxx/BLOCXX_config.h"
+#include "blocxx/String.hpp"
+#include "blocxx/Types.hpp"
+
+#include <utility>
+#include <vector>
+
+/**
+ * A small microbenchmark framework.
+ *
+ * A benchmark is a function that performs the operation being measured
+ * state.iterations() times:
+ *
+ * @code
+ * BLOCXX_BENCHMARK(String_hashCode)
+ * {
+ *    String s("some string");
+ *    for (UInt64 i = state.iterations(); i > 0; --i)
+ *    {
+ *       Bench::doNotOptimize(s.hashCode());
+ *    }
+ * }
+ * @endcode
+ *
+ * The runner picks an iteration count that makes one run take at least the
+ * minimum time, does warmup runs, then repeats the run and reports the
+ * distribution of the time per iteration (and, where the hardware counters
+ * can be read, CPU cycles per iteration), along with the number of
+ * allocations per iteration.
+ */
+
+namespace BLOCXX_NAMESPACE
+{
+
+namespace Bench
+{
+
+class State
+{
+public:
+	State(UInt64 iterations, Int32 arg);
+
+	/// The number of times to perform the operation.
+	UInt64 iterations() const
+	{
+		return m_iterations;
+	}
+
+	/// The argument the benchmark was registered with, or 0.
+	Int32 arg() const
+	{
+		return m_arg;
+	}
+
+	/**
+	 * Stop measuring time, cycles and allocations, e.g. during setup that
+	 * shouldn't be counted.
+	 */
+	void pauseTiming();
+
+	/// Undo pauseTiming().
+	void resumeTiming();
+
+	/// Report how many items were processed, to get items per second.
+	void setItemsProcessed(UInt64 items)
+	{
+		m_items = items;
+	}
+
+	/// Report how many bytes were processed, to get bytes per second.
+	void setBytesProcessed(UInt64 bytes)
+	{
+		m_bytes = bytes;
+	}
+
+	/**
+	 * Report some other value, such as a hit rate.  The value reported for
+	 * each run is averaged over the repetitions.
+	 */
+	void setCounter(const char* name, double value);
+
+	/**
+	 * Don't report this benchmark, e.g. because the system doesn't support
+	 * what it measures.  The benchmark function should return after calling
+	 * this.
+	 */
+	void skip(const String& reason);
+
+	// The rest is used by the runner.
+	void start();
+	void stop();
+	double seconds() const;
+	UInt64 cycles() const;
+	bool cyclesValid() const;
+	UInt64 allocations() const;
+	UInt64 allocatedBytes() const;
+	UInt64 items() const
+	{
+		return m_items;
+	}
+	UInt64 bytes() const
+	{
+		return m_bytes;
+	}
+	const std::vector<std::pair<String, double> >& counters() const
+	{
+		return m_counters;
+	}
+	bool skipped() const
+	{
+		return !m_skipReason.empty();
+	}
+	const String& skipReason() const
+	{
+		return m_skipReason;
+	}
+
+private:
+	UInt64 m_iterations;
+	Int32 m_arg;
+	bool m_running;
+	Int64 m_startMicroseconds;
+	Int64 m_microseconds;
+	UInt64 m_startCycles;
+	UInt64 m_cycles;
+	bool m_cyclesValid;
+	UInt64 m_startAllocations;
+	UInt64 m_allocations;
+	UInt64 m_startAllocatedBytes;
+	UInt64 m_allocatedBytes;
+	UInt64 m_items;
+	UInt64 m_bytes;
+	std::vector<std::pair<String, double> > m_counters;
+	String m_skipReason;
+};
+
+typedef void (*BenchmarkFunc)(State& state);
+
+/**
+ * Adds a benchmark to the list the runner runs.  Use the BLOCXX_BENCHMARK
+ * macros instead of creating these directly.
+ */
+class Registration
+{
+public:
+	Registration(const char* name, BenchmarkFunc func);
+
+	/**
+	 * Register func once for each argument first, first * multiplier, ...
+	 * up to and including last.
+	 */
+	Registration(const char* name, BenchmarkFunc func, Int32 first, Int32 last, Int32 multiplier);
+};
+
+/**
+ * Work divided between threads by runParallel().
+ */
+class ParallelBody
+{
+public:
+	virtual ~ParallelBody();
+
+	/**
+	 * Called on each thread, with a thread index in [0, threads) and that
+	 * thread's share of the iterations.
+	 */
+	virtual void run(UInt32 thread, UInt64 iterations) = 0;
+};
+
+/**
+ * Run body on the given number of threads, splitting state.iterations()
+ * between them.  Only the time from when the threads are released to when
+ * the last one finishes is measured; creating and joining the threads isn't.
+ */
+void runParallel(State& state, UInt32 threads, ParallelBody& body);
+
+/**
+ * Keep the compiler from optimizing away the computation of value.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__)
+	__asm__ __volatile__("" : : "r"(&value) : "memory");
+#else
+	volatile const char* p = reinterpret_cast<volatile const char*>(&value);
+	(void)*p;
+#endif
+}
+
+/**
+ * Parse the command line, run the benchmarks it selects and write the
+ * results.
+ * @return The exit status for main().
+ */
+int runBenchmarks(int argc, char** argv);
+
+} // end namespace Bench
+
+} // end namespace BLOCXX_NAMESPACE
+
+/**
+ * Define and register a benchmark function called name.  The function's
+ * parameter is named state.
+ */
+#define BLOCXX_BENCHMARK(name) \
+	static void name(::BLOCXX_NAMESPACE::Bench::State& state); \
+	static ::BLOCXX_NAMESPACE::Bench::Registration name##Registration(#name, &name); \
+	static void name(::BLOCXX_NAMESPACE::Bench::State& state)
+
+/**
+ * Like BLOCXX_BENCHMARK, but runs the benchmark once for each of the
+ * arguments first, first * multiplier, ... up to last, which the function
+ * gets from state.arg().  Reported as name/arg.
+ */
+#define BLOCXX_BENCHMARK_RANGE(name, first, last, multiplier) \
+	static void name(::BLOCXX_NAMESPACE::Bench::State& state); \
+	static ::BLOCXX_NAMESPACE::Bench::Registration name##Registration(#name, &name, first, last, multiplier); \
+	static void name(::BLOCXX_NAMESPACE::Bench::State& state)
+
+#endif
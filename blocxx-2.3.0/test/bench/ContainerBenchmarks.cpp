@@ -0,0 +1,280 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/SmallArray.hpp"
+#include "blocxx/SortedVectorMap.hpp"
+#include "blocxx/String.hpp"
+
+using namespace blocxx;
+
+namespace
+{
+	/**
+	 * Counts how often it's copied and moved, to show what Array does
+	 * with its elements.
+	 */
+	struct Counted
+	{
+		Counted()
+			: value(0)
+		{
+		}
+		explicit Counted(int v)
+			: value(v)
+		{
+		}
+		Counted(const Counted& x)
+			: value(x.value)
+		{
+			++copies;
+		}
+		Counted& operator=(const Counted& x)
+		{
+			value = x.value;
+			++copies;
+			return *this;
+		}
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+		Counted(Counted&& x)
+			: value(x.value)
+		{
+			++moves;
+		}
+		Counted& operator=(Counted&& x)
+		{
+			value = x.value;
+			++moves;
+			return *this;
+		}
+#endif
+		int value;
+		static UInt64 copies;
+		static UInt64 moves;
+	};
+	UInt64 Counted::copies = 0;
+	UInt64 Counted::moves = 0;
+
+	void resetCounts()
+	{
+		Counted::copies = 0;
+		Counted::moves = 0;
+	}
+
+	void reportCounts(Bench::State& state)
+	{
+		state.setCounter("copies_per_op", double(Counted::copies) / state.iterations());
+		state.setCounter("moves_per_op", double(Counted::moves) / state.iterations());
+	}
+
+	Array<Counted> makeCountedArray(int n)
+	{
+		Array<Counted> a;
+		a.reserve(n);
+		for (int i = 0; i < n; ++i)
+		{
+			a.push_back(Counted(i));
+		}
+		return a;
+	}
+
+	const Int32 ARRAY_SIZE = 1000;
+}
+
+BLOCXX_BENCHMARK_RANGE(Array_pushBackCounted, 16, 4096, 16)
+{
+	resetCounts();
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Array<Counted> a;
+		for (Int32 j = 0; j < state.arg(); ++j)
+		{
+			a.push_back(Counted(j));
+		}
+		Bench::doNotOptimize(a);
+	}
+	reportCounts(state);
+}
+
+// Building a short StringArray, directly or in a SmallArray that's
+// converted at the end.
+
+BLOCXX_BENCHMARK_RANGE(Array_buildShort, 1, 16, 2)
+{
+	String element("element");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		StringArray a;
+		for (Int32 j = 0; j < state.arg(); ++j)
+		{
+			a.push_back(element);
+		}
+		Bench::doNotOptimize(a);
+	}
+}
+
+BLOCXX_BENCHMARK_RANGE(SmallArray_buildShort, 1, 16, 2)
+{
+	String element("element");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		SmallArray<String, 8> small;
+		for (Int32 j = 0; j < state.arg(); ++j)
+		{
+			small.push_back(element);
+		}
+		StringArray a = small.toArray();
+		Bench::doNotOptimize(a);
+	}
+}
+
+BLOCXX_BENCHMARK(Array_returnByValue)
+{
+	resetCounts();
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Array<Counted> a = makeCountedArray(16);
+		Bench::doNotOptimize(a);
+	}
+	reportCounts(state);
+}
+
+// Copies share the elements until one of them is written to.
+
+BLOCXX_BENCHMARK(Array_copyShared)
+{
+	StringArray a(ARRAY_SIZE, String("element"));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		StringArray copy(a);
+		Bench::doNotOptimize(copy);
+	}
+}
+
+BLOCXX_BENCHMARK(Array_copyAndDetach)
+{
+	StringArray a(ARRAY_SIZE, String("element"));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		StringArray copy(a);
+		copy[0] = "changed";
+		Bench::doNotOptimize(copy);
+	}
+}
+
+// Three ways of looping over an unshared Array.  The non-const operator[]
+// does a copy-on-write check on every call, mutableView() does it once and
+// the const operator[] doesn't need it.
+
+BLOCXX_BENCHMARK(Array_writeLoopIndex)
+{
+	Array<Int32> a(ARRAY_SIZE, 0);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		for (size_t j = 0; j < a.size(); ++j)
+		{
+			a[j] += 1;
+		}
+		Bench::doNotOptimize(a);
+	}
+	state.setItemsProcessed(state.iterations() * ARRAY_SIZE);
+}
+
+BLOCXX_BENCHMARK(Array_writeLoopMutableView)
+{
+	Array<Int32> a(ARRAY_SIZE, 0);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		std::pair<Array<Int32>::iterator, Array<Int32>::iterator> view = a.mutableView();
+		for (Array<Int32>::iterator it = view.first; it != view.second; ++it)
+		{
+			*it += 1;
+		}
+		Bench::doNotOptimize(a);
+	}
+	state.setItemsProcessed(state.iterations() * ARRAY_SIZE);
+}
+
+BLOCXX_BENCHMARK(Array_readLoopConst)
+{
+	const Array<Int32> a(ARRAY_SIZE, 1);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Int32 sum = 0;
+		for (size_t j = 0; j < a.size(); ++j)
+		{
+			sum += a[j];
+		}
+		Bench::doNotOptimize(sum);
+	}
+	state.setItemsProcessed(state.iterations() * ARRAY_SIZE);
+}
+
+BLOCXX_BENCHMARK_RANGE(SortedVectorMap_find, 8, 4096, 8)
+{
+	typedef SortedVectorMap<String, Int32> map_t;
+	map_t m;
+	StringArray keys;
+	for (Int32 j = 0; j < state.arg(); ++j)
+	{
+		keys.push_back(String(j * 7919));
+		m.insert(map_t::value_type(keys.back(), j));
+	}
+	const map_t& cm = m;
+	size_t k = 0;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(cm.find(keys[k]));
+		if (++k == keys.size())
+		{
+			k = 0;
+		}
+	}
+}
+
+BLOCXX_BENCHMARK(SortedVectorMap_copyAndInsert)
+{
+	typedef SortedVectorMap<String, Int32> map_t;
+	map_t m;
+	for (Int32 j = 0; j < 100; ++j)
+	{
+		m.insert(map_t::value_type(String(j * 2), j));
+	}
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		map_t copy(m);
+		copy.insert(map_t::value_type(String("51"), 0));
+		Bench::doNotOptimize(copy);
+	}
+}
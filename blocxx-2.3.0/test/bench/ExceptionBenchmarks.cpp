@@ -0,0 +1,140 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Exception.hpp"
+#include "blocxx/StackTrace.hpp"
+#include "blocxx/String.hpp"
+
+using namespace blocxx;
+
+// Exceptions per second with and without a call stack captured in each, at
+// various depths below the catch.  items_per_second is exceptions/sec.
+
+BLOCXX_DECLARE_EXCEPTION(Bench);
+BLOCXX_DEFINE_EXCEPTION(Bench);
+
+namespace
+{
+#if defined(__GNUC__)
+	__attribute__((noinline))
+#endif
+	int throwAtDepth(int depth)
+	{
+		if (depth <= 1)
+		{
+			BLOCXX_THROW(BenchException, "benchmark");
+		}
+		// Keeps the compiler from turning the recursion into a loop, so
+		// each level is a frame to unwind.
+		int rv = throwAtDepth(depth - 1);
+		Bench::doNotOptimize(rv);
+		return rv + 1;
+	}
+
+	class CaptureCallStacksScope
+	{
+	public:
+		CaptureCallStacksScope(bool capture)
+			: m_saved(Exception::getCaptureCallStacks())
+		{
+			Exception::setCaptureCallStacks(capture);
+		}
+		~CaptureCallStacksScope()
+		{
+			Exception::setCaptureCallStacks(m_saved);
+		}
+	private:
+		bool m_saved;
+	};
+
+	void throwAndCatch(Bench::State& state, bool symbolize)
+	{
+		for (UInt64 i = state.iterations(); i > 0; --i)
+		{
+			try
+			{
+				Bench::doNotOptimize(throwAtDepth(state.arg()));
+			}
+			catch (const BenchException& e)
+			{
+				if (symbolize && e.getCallStack())
+				{
+					Bench::doNotOptimize(e.getCallStack()->toString());
+				}
+				Bench::doNotOptimize(e.getCallStack());
+			}
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+}
+
+BLOCXX_BENCHMARK_RANGE(Exception_throwCatch, 1, 64, 8)
+{
+	CaptureCallStacksScope scope(false);
+	throwAndCatch(state, false);
+}
+
+BLOCXX_BENCHMARK_RANGE(Exception_throwCatchCallStack, 1, 64, 8)
+{
+	CaptureCallStacksScope scope(true);
+	throwAndCatch(state, false);
+}
+
+// Symbolizing every exception's stack, which after the first one is all
+// symbol cache hits.
+BLOCXX_BENCHMARK_RANGE(Exception_throwCatchSymbolize, 1, 64, 8)
+{
+	CaptureCallStacksScope scope(true);
+	throwAndCatch(state, true);
+}
+
+BLOCXX_BENCHMARK(StackTrace_capture)
+{
+	StackTrace::CallStack stack;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		stack.capture();
+		Bench::doNotOptimize(stack);
+	}
+}
+
+// The old way of getting a trace, which now captures and symbolizes
+// through the cache.
+BLOCXX_BENCHMARK(StackTrace_getStackTrace)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(StackTrace::getStackTrace());
+	}
+}
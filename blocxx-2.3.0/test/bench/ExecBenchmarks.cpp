@@ -0,0 +1,160 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/Exec.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/Process.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Timeout.hpp"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+#ifdef BLOCXX_HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+
+using namespace blocxx;
+
+namespace
+{
+	/**
+	 * Raises the open file limit to WANTED_FILE_LIMIT, or to the hard limit
+	 * if that can't be raised, for the lifetime of the object.  This shows
+	 * whether spawning depends on the limit rather than on the number of
+	 * descriptors actually open.
+	 */
+	class RaisedFileLimit
+	{
+	public:
+		RaisedFileLimit()
+			: m_raised(false)
+		{
+#ifdef BLOCXX_HAVE_SYS_RESOURCE_H
+			if (::getrlimit(RLIMIT_NOFILE, &m_old) == 0)
+			{
+				struct rlimit rl = m_old;
+				if (rl.rlim_cur < WANTED_FILE_LIMIT)
+				{
+					rl.rlim_cur = WANTED_FILE_LIMIT;
+				}
+				if (rl.rlim_max < rl.rlim_cur)
+				{
+					rl.rlim_max = rl.rlim_cur;
+				}
+				m_raised = ::setrlimit(RLIMIT_NOFILE, &rl) == 0;
+				if (!m_raised)
+				{
+					// raising the hard limit needs privileges
+					rl = m_old;
+					rl.rlim_cur = rl.rlim_max;
+					m_raised = ::setrlimit(RLIMIT_NOFILE, &rl) == 0;
+				}
+			}
+#endif
+		}
+		~RaisedFileLimit()
+		{
+#ifdef BLOCXX_HAVE_SYS_RESOURCE_H
+			if (m_raised)
+			{
+				::setrlimit(RLIMIT_NOFILE, &m_old);
+			}
+#endif
+		}
+	private:
+		bool m_raised;
+#ifdef BLOCXX_HAVE_SYS_RESOURCE_H
+		static const rlim_t WANTED_FILE_LIMIT = rlim_t(1) << 20;
+		struct rlimit m_old;
+#endif
+	};
+}
+
+// Spawns /bin/true from a parent with arg() MB of touched memory, up to
+// 4 GB, which shows how much the cost of fork() grows with the parent's size.
+BLOCXX_BENCHMARK_RANGE(Exec_spawnTrue, 0, 4096, 16)
+{
+	state.pauseTiming();
+	RaisedFileLimit limit;
+	UInt64 const bytes = UInt64(state.arg()) * 1024 * 1024;
+	std::vector<char> rss;
+	try
+	{
+		if (bytes > size_t(-1))
+		{
+			throw std::bad_alloc();
+		}
+		rss.resize(size_t(bytes));
+	}
+	catch (const std::bad_alloc&)
+	{
+		state.skip(Format("can't allocate %1 MB", state.arg()));
+		return;
+	}
+	if (!rss.empty())
+	{
+		std::memset(&rss[0], 1, rss.size());
+	}
+	StringArray cmd(1, String("/bin/true"));
+	state.resumeTiming();
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		ProcessRef proc = Exec::spawn(cmd);
+		proc->waitCloseTerm();
+	}
+	Bench::doNotOptimize(rss);
+}
+
+BLOCXX_BENCHMARK_RANGE(Exec_gatherOutput, 4096, 16777216, 64)
+{
+	StringArray cmd;
+	cmd.push_back("/bin/sh");
+	cmd.push_back("-c");
+	cmd.push_back(Format("yes | head -c %1", state.arg()));
+	String output;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		output.erase();
+		Exec::executeProcessAndGatherOutput(cmd, output, Timeout::infinite, -1, "");
+		if (output.length() != size_t(state.arg()))
+		{
+			state.skip(Format("expected %1 bytes of output, got %2", state.arg(), output.length()));
+			return;
+		}
+	}
+	state.setBytesProcessed(state.iterations() * state.arg());
+}
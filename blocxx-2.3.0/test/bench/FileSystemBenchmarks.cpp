@@ -0,0 +1,172 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/File.hpp"
+#include "blocxx/FileSystem.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/UserCache.hpp"
+#include "blocxx/UserUtils.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#ifdef BLOCXX_HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef BLOCXX_HAVE_SYS_STAT_H
+#include <sys/stat.h>
+#endif
+
+using namespace blocxx;
+
+namespace
+{
+	/**
+	 * A private directory in /tmp holding a file four directories down and
+	 * a chain of two symlinks to it.
+	 */
+	class PathFixture
+	{
+	public:
+		PathFixture()
+		{
+			char tmpl[] = "/tmp/blocxx_benchXXXXXX";
+			if (::mkdtemp(tmpl))
+			{
+				m_base = tmpl;
+				::mkdir((m_base + "/a").c_str(), 0755);
+				::mkdir((m_base + "/a/b").c_str(), 0755);
+				::mkdir((m_base + "/a/b/c").c_str(), 0755);
+				::mkdir((m_base + "/a/b/c/d").c_str(), 0755);
+				FileSystem::createFile(m_base + "/a/b/c/d/file").close();
+				::symlink("a/b/c/d/file", (m_base + "/link1").c_str());
+				::symlink((m_base + "/link1").c_str(), (m_base + "/link2").c_str());
+			}
+		}
+
+		~PathFixture()
+		{
+			if (!m_base.empty())
+			{
+				::unlink((m_base + "/link2").c_str());
+				::unlink((m_base + "/link1").c_str());
+				::unlink((m_base + "/a/b/c/d/file").c_str());
+				::rmdir((m_base + "/a/b/c/d").c_str());
+				::rmdir((m_base + "/a/b/c").c_str());
+				::rmdir((m_base + "/a/b").c_str());
+				::rmdir((m_base + "/a").c_str());
+				::rmdir(m_base.c_str());
+			}
+		}
+
+		const String& base() const
+		{
+			return m_base;
+		}
+
+	private:
+		String m_base;
+	};
+
+	void runSecurity(Bench::State& state, const String& path)
+	{
+		for (UInt64 i = state.iterations(); i > 0; --i)
+		{
+			std::pair<FileSystem::Path::ESecurity, String> result =
+				FileSystem::Path::security(path, FileSystem::Path::E_SECURITY_DO_NOTHING);
+			Bench::doNotOptimize(result);
+		}
+	}
+}
+
+BLOCXX_BENCHMARK(PathSecurity_usrSbin)
+{
+	runSecurity(state, "/usr/sbin");
+}
+
+BLOCXX_BENCHMARK(PathSecurity_nestedFile)
+{
+	PathFixture fixture;
+	if (fixture.base().empty())
+	{
+		state.skip("couldn't create a directory in /tmp");
+		return;
+	}
+	runSecurity(state, fixture.base() + "/a/b/c/d/file");
+}
+
+BLOCXX_BENCHMARK(PathSecurity_symlinkChain)
+{
+	PathFixture fixture;
+	if (fixture.base().empty())
+	{
+		state.skip("couldn't create a directory in /tmp");
+		return;
+	}
+	runSecurity(state, fixture.base() + "/link2");
+}
+
+BLOCXX_BENCHMARK(UserCache_getUserNameCached)
+{
+	UserCache cache;
+	bool success = false;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String name = cache.getUserName(0, success);
+		Bench::doNotOptimize(name);
+	}
+}
+
+BLOCXX_BENCHMARK(UserCache_getUserNameUncached)
+{
+	UserCache::Config config;
+	config.maxEntries = 0;
+	UserCache cache(config);
+	bool success = false;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String name = cache.getUserName(0, success);
+		Bench::doNotOptimize(name);
+	}
+}
+
+BLOCXX_BENCHMARK(UserCache_getGroupIdCached)
+{
+	UserCache cache;
+	bool success = false;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(cache.getGroupId("root", success));
+	}
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/HeapProfiler.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/String.hpp"
+
+#include <cstdlib>
+
+using namespace blocxx;
+
+// The benchmark program's operator new and delete go through HeapProfiler,
+// so these show what it costs when it's stopped and when it's sampling at
+// the default interval.  The *Sampling runs should be within a couple of
+// percent of the *Stopped ones.
+
+namespace
+{
+	const size_t SMALL_OBJECT = 64;
+
+	UInt64 totalSamples()
+	{
+		HeapProfiler::Profile profile = HeapProfiler::getProfile();
+		UInt64 samples = 0;
+		for (size_t i = 0; i < profile.size(); ++i)
+		{
+			samples += profile[i].allocCount;
+		}
+		return samples;
+	}
+
+	// Starts the profiler for the lifetime of a benchmark and reports how
+	// many allocations it sampled.
+	class SamplingScope
+	{
+	public:
+		SamplingScope(Bench::State& state)
+			: m_state(state)
+			, m_samples(totalSamples())
+		{
+			HeapProfiler::start();
+		}
+		~SamplingScope()
+		{
+			HeapProfiler::stop();
+			m_state.setCounter("samples", double(totalSamples() - m_samples));
+		}
+	private:
+		Bench::State& m_state;
+		UInt64 m_samples;
+	};
+
+	void newDelete(Bench::State& state)
+	{
+		for (UInt64 i = state.iterations(); i > 0; --i)
+		{
+			char* p = new char[SMALL_OBJECT];
+			Bench::doNotOptimize(p);
+			delete[] p;
+		}
+	}
+
+	// A more typical mix: short-lived Strings of varying sizes.
+	void formatStrings(Bench::State& state)
+	{
+		for (UInt64 i = state.iterations(); i > 0; --i)
+		{
+			String s = Format("%1: %2", "item", i);
+			s += String(char('a' + i % 26)) + s;
+			Bench::doNotOptimize(s);
+		}
+	}
+}
+
+BLOCXX_BENCHMARK(HeapProfiler_mallocFree)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		void* p = std::malloc(SMALL_OBJECT);
+		Bench::doNotOptimize(p);
+		std::free(p);
+	}
+}
+
+BLOCXX_BENCHMARK(HeapProfiler_newDeleteStopped)
+{
+	newDelete(state);
+}
+
+BLOCXX_BENCHMARK(HeapProfiler_newDeleteSampling)
+{
+	SamplingScope sampling(state);
+	newDelete(state);
+}
+
+BLOCXX_BENCHMARK(HeapProfiler_formatStringsStopped)
+{
+	formatStrings(state);
+}
+
+BLOCXX_BENCHMARK(HeapProfiler_formatStringsSampling)
+{
+	SamplingScope sampling(state);
+	formatStrings(state);
+}
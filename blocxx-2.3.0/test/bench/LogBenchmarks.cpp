@@ -0,0 +1,143 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/LogAppender.hpp"
+#include "blocxx/LogMessage.hpp"
+#include "blocxx/Logger.hpp"
+#include "blocxx/String.hpp"
+
+#include <cerrno>
+
+using namespace blocxx;
+
+namespace
+{
+	/**
+	 * Formats every message it's given, then throws it away, so the
+	 * benchmarks measure the logging path without any I/O.
+	 */
+	class DiscardAppender : public LogAppender
+	{
+	public:
+		DiscardAppender(const StringArray& components, const StringArray& categories)
+			: LogAppender(components, categories, STR_TTCC_MESSAGE_FORMAT)
+		{
+		}
+	private:
+		virtual void doProcessLogMessage(const String& formattedMessage, const LogMessage&) const
+		{
+			Bench::doNotOptimize(formattedMessage);
+		}
+	};
+
+	const int COMPONENT_COUNT = 200;
+
+	/// An appender enabled for COMPONENT_COUNT components and all categories.
+	LogAppenderRef manyComponentsAppender()
+	{
+		StringArray components;
+		for (int i = 0; i < COMPONENT_COUNT; ++i)
+		{
+			components.push_back(Format("bench.component.%1", i));
+		}
+		return LogAppenderRef(new DiscardAppender(components, LogAppender::ALL_CATEGORIES));
+	}
+}
+
+BLOCXX_BENCHMARK(Logger_debugEnabled)
+{
+	Logger logger("bench.component.100", manyComponentsAppender());
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		BLOCXX_LOG_DEBUG(logger, "a typical debug message");
+	}
+}
+
+// "INFO" is padded to the width of "%-5p" in the TTCC format.
+BLOCXX_BENCHMARK(Logger_infoEnabled)
+{
+	Logger logger("bench.component.100", manyComponentsAppender());
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		BLOCXX_LOG_INFO(logger, "a typical info message");
+	}
+}
+
+BLOCXX_BENCHMARK(Logger_debugEnabledAllComponents)
+{
+	Logger logger("bench.component.100",
+		LogAppenderRef(new DiscardAppender(LogAppender::ALL_COMPONENTS, LogAppender::ALL_CATEGORIES)));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		BLOCXX_LOG_DEBUG(logger, "a typical debug message");
+	}
+}
+
+// The appender is at debug level, but not for this component, so the
+// message is built and then dropped by the component filter.
+BLOCXX_BENCHMARK(Logger_componentFilteredOut)
+{
+	Logger logger("bench.other", manyComponentsAppender());
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		BLOCXX_LOG_DEBUG(logger, "a typical debug message");
+	}
+}
+
+// The level check in the macro rejects the message before it's built.
+BLOCXX_BENCHMARK(Logger_levelDisabled)
+{
+	StringArray categories;
+	categories.push_back(Logger::STR_ERROR_CATEGORY);
+	Logger logger("bench.component.100",
+		LogAppenderRef(new DiscardAppender(LogAppender::ALL_COMPONENTS, categories)));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		// Otherwise the level check is hoisted out of the loop.
+		Bench::doNotOptimize(logger);
+		BLOCXX_LOG_DEBUG(logger, Format("value %1", i));
+	}
+}
+
+BLOCXX_BENCHMARK(Logger_construct)
+{
+	LogAppenderRef appender = manyComponentsAppender();
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Logger logger("bench.component.100", appender);
+		Bench::doNotOptimize(logger);
+	}
+}
@@ -0,0 +1,139 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/Select.hpp"
+#include "blocxx/SelectEngine.hpp"
+#include "blocxx/SelectableCallbackIFC.hpp"
+#include "blocxx/Timeout.hpp"
+#include "blocxx/UnnamedPipe.hpp"
+
+using namespace blocxx;
+
+namespace
+{
+	/**
+	 * arg() pipes, of which only the last has data waiting, so each wait
+	 * returns at once but has to look at every pipe.
+	 */
+	class Pipes
+	{
+	public:
+		explicit Pipes(Int32 count)
+		{
+			for (Int32 i = 0; i < count; ++i)
+			{
+				m_pipes.push_back(UnnamedPipe::createUnnamedPipe());
+			}
+			m_pipes.back()->writeString("x");
+		}
+
+		size_t size() const
+		{
+			return m_pipes.size();
+		}
+
+		Select_t readSelectObj(size_t i) const
+		{
+			return m_pipes[i]->getReadSelectObj();
+		}
+
+	private:
+		Array<UnnamedPipeRef> m_pipes;
+	};
+
+	class CountingCallback : public SelectableCallbackIFC
+	{
+	public:
+		CountingCallback(SelectEngine& engine, UInt64 limit)
+			: m_engine(engine)
+			, m_count(0)
+			, m_limit(limit)
+		{
+		}
+	private:
+		virtual void doSelected(Select_t&, EEventType)
+		{
+			if (++m_count >= m_limit)
+			{
+				m_engine.stop();
+			}
+		}
+		SelectEngine& m_engine;
+		UInt64 m_count;
+		UInt64 m_limit;
+	};
+}
+
+BLOCXX_BENCHMARK_RANGE(Select_selectRW, 1, 256, 4)
+{
+	Pipes pipes(state.arg());
+	Select::SelectObjectArray objs;
+	for (size_t i = 0; i < pipes.size(); ++i)
+	{
+		Select::SelectObject obj(pipes.readSelectObj(i));
+		obj.waitForRead = true;
+		objs.push_back(obj);
+	}
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(Select::selectRW(objs, Timeout::infinite));
+	}
+}
+
+BLOCXX_BENCHMARK_RANGE(Select_SelectSet, 1, 256, 4)
+{
+	Pipes pipes(state.arg());
+	Select::SelectSet set;
+	for (size_t i = 0; i < pipes.size(); ++i)
+	{
+		set.add(pipes.readSelectObj(i), true, false);
+	}
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(set.selectRW(Timeout::infinite));
+	}
+}
+
+BLOCXX_BENCHMARK_RANGE(SelectEngine_go, 1, 256, 4)
+{
+	Pipes pipes(state.arg());
+	SelectEngine engine;
+	SelectableCallbackIFCRef callback(new CountingCallback(engine, state.iterations()));
+	for (size_t i = 0; i < pipes.size(); ++i)
+	{
+		engine.addSelectableObject(pipes.readSelectObj(i), callback, SelectableCallbackIFC::E_READ_EVENT);
+	}
+	engine.go(Timeout::infinite);
+}
@@ -0,0 +1,163 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/BinarySerialization.hpp"
+#include "blocxx/String.hpp"
+
+#include <streambuf>
+#include <vector>
+
+using namespace blocxx;
+
+namespace
+{
+	/**
+	 * A streambuf over a fixed buffer that can be rewound, so the
+	 * benchmarks measure serialization rather than buffer management.
+	 */
+	class MemoryBuf : public std::streambuf
+	{
+	public:
+		explicit MemoryBuf(size_t size)
+			: m_buf(size)
+		{
+			rewind();
+		}
+
+		void rewind()
+		{
+			char* p = &m_buf[0];
+			setp(p, p + m_buf.size());
+			setg(p, p, p + m_buf.size());
+		}
+
+		size_t written() const
+		{
+			return pptr() - pbase();
+		}
+
+	private:
+		std::vector<char> m_buf;
+	};
+}
+
+BLOCXX_BENCHMARK(BinarySerialization_writeUInt32)
+{
+	MemoryBuf buf(4096);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		if (buf.written() == 4096)
+		{
+			buf.rewind();
+		}
+		BinarySerialization::write(buf, UInt32(i));
+	}
+	state.setBytesProcessed(state.iterations() * sizeof(UInt32));
+}
+
+BLOCXX_BENCHMARK(BinarySerialization_readUInt32)
+{
+	MemoryBuf buf(4096);
+	for (UInt32 j = 0; j < 1024; ++j)
+	{
+		BinarySerialization::write(buf, j);
+	}
+	UInt32 v = 0;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		if ((i & 1023) == 0)
+		{
+			buf.rewind();
+		}
+		BinarySerialization::read(buf, v);
+		Bench::doNotOptimize(v);
+	}
+	state.setBytesProcessed(state.iterations() * sizeof(UInt32));
+}
+
+BLOCXX_BENCHMARK(BinarySerialization_writeReadString)
+{
+	MemoryBuf buf(256);
+	String s("a string of typical length for a property");
+	String r;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		buf.rewind();
+		BinarySerialization::writeString(buf, s);
+		BinarySerialization::read(buf, r);
+		Bench::doNotOptimize(r);
+	}
+	state.setBytesProcessed(state.iterations() * s.length());
+}
+
+BLOCXX_BENCHMARK_RANGE(BinarySerialization_writeReadUInt32Array, 16, 65536, 16)
+{
+	MemoryBuf buf(state.arg() * sizeof(UInt32) + 16);
+	UInt32Array a;
+	for (Int32 j = 0; j < state.arg(); ++j)
+	{
+		a.push_back(j);
+	}
+	UInt32Array r;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		buf.rewind();
+		BinarySerialization::writeArray(buf, a);
+		BinarySerialization::readArray(buf, r);
+		Bench::doNotOptimize(r);
+	}
+	state.setBytesProcessed(state.iterations() * state.arg() * sizeof(UInt32));
+}
+
+BLOCXX_BENCHMARK_RANGE(BinarySerialization_writeReadStringArray, 16, 4096, 16)
+{
+	StringArray a;
+	size_t bytes = 0;
+	for (Int32 j = 0; j < state.arg(); ++j)
+	{
+		a.push_back(String("element ") + String(j));
+		bytes += a.back().length();
+	}
+	MemoryBuf buf(bytes + 8 * a.size() + 16);
+	StringArray r;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		buf.rewind();
+		BinarySerialization::writeArray(buf, a);
+		BinarySerialization::readArray(buf, r);
+		Bench::doNotOptimize(r);
+	}
+	state.setBytesProcessed(state.iterations() * bytes);
+}
@@ -0,0 +1,296 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/StringBuffer.hpp"
+#include "blocxx/Array.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+using namespace blocxx;
+
+namespace
+{
+	const char* const SENTENCE = "The quick brown fox jumps over the lazy dog, "
+		"then runs back through the field and over the hill";
+}
+
+BLOCXX_BENCHMARK(String_copy)
+{
+	String s(SENTENCE);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String copy(s);
+		Bench::doNotOptimize(copy);
+	}
+}
+
+BLOCXX_BENCHMARK(String_fromCString)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s(SENTENCE);
+		Bench::doNotOptimize(s);
+	}
+	state.setBytesProcessed(state.iterations() * ::strlen(SENTENCE));
+}
+
+BLOCXX_BENCHMARK(String_concat)
+{
+	String a("key");
+	String b("value");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = a + "=" + b;
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK_RANGE(StringBuffer_append, 8, 4096, 8)
+{
+	String piece("abcdefgh");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		StringBuffer buf;
+		for (Int32 j = 0; j < state.arg(); j += 8)
+		{
+			buf += piece;
+		}
+		Bench::doNotOptimize(buf);
+	}
+	state.setBytesProcessed(state.iterations() * state.arg());
+}
+
+BLOCXX_BENCHMARK_RANGE(InlineStringBuffer_append, 8, 4096, 8)
+{
+	String piece("abcdefgh");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		InlineStringBuffer<256> buf;
+		for (Int32 j = 0; j < state.arg(); j += 8)
+		{
+			buf += piece;
+		}
+		Bench::doNotOptimize(buf);
+	}
+	state.setBytesProcessed(state.iterations() * state.arg());
+}
+
+BLOCXX_BENCHMARK(String_indexOf)
+{
+	String s(SENTENCE);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(s.indexOf("hill"));
+	}
+}
+
+BLOCXX_BENCHMARK(String_compareToIgnoreCase)
+{
+	String a(SENTENCE);
+	String b(a);
+	b.toUpperCase();
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(a.compareToIgnoreCase(b));
+	}
+}
+
+BLOCXX_BENCHMARK(String_toUpperCase)
+{
+	String s(SENTENCE);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String t(s);
+		t.toUpperCase();
+		Bench::doNotOptimize(t);
+	}
+}
+
+BLOCXX_BENCHMARK(String_hashCode)
+{
+	String s(SENTENCE);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(s.hashCode());
+	}
+}
+
+BLOCXX_BENCHMARK(String_tokenize)
+{
+	String s(SENTENCE);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		StringArray tokens = s.tokenize(" ,");
+		Bench::doNotOptimize(tokens);
+	}
+}
+
+BLOCXX_BENCHMARK(String_tokenizeShort)
+{
+	String s("key=value");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		StringArray tokens = s.tokenize("=");
+		Bench::doNotOptimize(tokens);
+	}
+}
+
+BLOCXX_BENCHMARK(String_trim)
+{
+	String s("   \t padded value \n  ");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String t(s);
+		t.trim();
+		Bench::doNotOptimize(t);
+	}
+}
+
+// Number conversions, with the C library equivalents as a baseline.
+
+BLOCXX_BENCHMARK(String_fromInt32)
+{
+	Int32 v = -123456789;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s(v);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(Baseline_snprintfInt32)
+{
+	Int32 v = -123456789;
+	char buf[16];
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		::snprintf(buf, sizeof(buf), "%d", v);
+		Bench::doNotOptimize(buf);
+	}
+}
+
+BLOCXX_BENCHMARK(String_fromUInt64)
+{
+	UInt64 v = 18446744073709551557ULL;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s(v);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(String_fromReal64)
+{
+	Real64 v = 3.14159265358979;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s(v);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(Baseline_snprintfReal64)
+{
+	Real64 v = 3.14159265358979;
+	char buf[32];
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		::snprintf(buf, sizeof(buf), "%.17g", v);
+		Bench::doNotOptimize(buf);
+	}
+}
+
+BLOCXX_BENCHMARK(String_toInt32)
+{
+	String s("-123456789");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(s.toInt32());
+	}
+}
+
+BLOCXX_BENCHMARK(Baseline_strtol)
+{
+	const char* s = "-123456789";
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(::strtol(s, 0, 10));
+	}
+}
+
+BLOCXX_BENCHMARK(String_toReal64)
+{
+	String s("3.14159265358979");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(s.toReal64());
+	}
+}
+
+BLOCXX_BENCHMARK(Baseline_strtod)
+{
+	const char* s = "3.14159265358979";
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(::strtod(s, 0));
+	}
+}
+
+// Formatting a typical log line.
+
+BLOCXX_BENCHMARK(Format_message)
+{
+	String name("eth0");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = Format("interface %1 has %2 packets (%3 dropped)", name, 123456, 0.25);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(Baseline_ostringstream)
+{
+	String name("eth0");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		std::ostringstream os;
+		os << "interface " << name << " has " << 123456 << " packets (" << 0.25 << " dropped)";
+		String s(os.str().c_str());
+		Bench::doNotOptimize(s);
+	}
+}
@@ -0,0 +1,491 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/LazyGlobal.hpp"
+#include "blocxx/LockFreeMTQueue.hpp"
+#include "blocxx/LockFreeQueue.hpp"
+#include "blocxx/LockFreeStack.hpp"
+#include "blocxx/MTQueue.hpp"
+#include "blocxx/Mutex.hpp"
+#include "blocxx/MutexLock.hpp"
+#include "blocxx/NonRecursiveMutex.hpp"
+#include "blocxx/NonRecursiveMutexLock.hpp"
+#include "blocxx/RWLocker.hpp"
+#include "blocxx/Runnable.hpp"
+#include "blocxx/Semaphore.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/ThreadBarrier.hpp"
+#include "blocxx/ThreadOnce.hpp"
+#include "blocxx/ThreadPool.hpp"
+#include "blocxx/Timeout.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace blocxx;
+
+namespace
+{
+	const Int32 MAX_THREADS = 64;
+
+	//////////////////////////////////////////////////////////////////////////
+	// ThreadPool dispatch: the time from addWork() until the work has run.
+
+	class SignalRunnable : public Runnable
+	{
+	public:
+		explicit SignalRunnable(Semaphore& done)
+			: m_done(done)
+		{
+		}
+		virtual void run()
+		{
+			m_done.signal();
+		}
+	private:
+		Semaphore& m_done;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Queues: arg() producer/consumer pairs moving iterations() items.
+
+	template <typename Queue>
+	class QueuePairs : public Bench::ParallelBody
+	{
+	public:
+		QueuePairs(Queue& queue, UInt32 pairs, UInt64 perPair)
+			: m_queue(queue)
+			, m_pairs(pairs)
+			, m_perPair(perPair)
+		{
+		}
+		virtual void run(UInt32 thread, UInt64)
+		{
+			if (thread < m_pairs)
+			{
+				for (UInt64 i = 0; i < m_perPair; ++i)
+				{
+					m_queue.pushBack(int(i));
+				}
+			}
+			else
+			{
+				int v;
+				for (UInt64 i = 0; i < m_perPair; ++i)
+				{
+					m_queue.popFront(Timeout::infinite, v);
+				}
+			}
+		}
+	private:
+		Queue& m_queue;
+		UInt32 m_pairs;
+		UInt64 m_perPair;
+	};
+
+	template <typename Queue>
+	void runQueuePairs(Bench::State& state, Queue& queue)
+	{
+		UInt32 pairs = state.arg();
+		UInt64 perPair = state.iterations() / pairs + 1;
+		QueuePairs<Queue> body(queue, pairs, perPair);
+		Bench::runParallel(state, pairs * 2, body);
+		state.setItemsProcessed(perPair * pairs);
+	}
+
+	const UInt32 QUEUE_SIZE = 1024;
+	const size_t BATCH_SIZE = 64;
+
+	/**
+	 * Like QueuePairs, but moving BATCH_SIZE items at a time.  A consumer
+	 * can get fewer items than it asks for, so the consumers share a count
+	 * of the items still to be taken instead of each taking a fixed share.
+	 * Whoever takes the last one shuts the queue down to release the rest.
+	 */
+	class LockFreeQueueBatchPairs : public Bench::ParallelBody
+	{
+	public:
+		LockFreeQueueBatchPairs(LockFreeMTQueue<int>& queue, UInt32 pairs, UInt64 perPair)
+			: m_queue(queue)
+			, m_pairs(pairs)
+			, m_perPair(perPair)
+			, m_remaining(Int64(perPair * pairs))
+		{
+		}
+		virtual void run(UInt32 thread, UInt64)
+		{
+			if (thread < m_pairs)
+			{
+				std::vector<int> batch(BATCH_SIZE);
+				for (UInt64 i = 0; i < m_perPair; i += BATCH_SIZE)
+				{
+					size_t n = size_t(std::min(UInt64(BATCH_SIZE), m_perPair - i));
+					m_queue.pushBackBatch(batch.begin(), batch.begin() + n);
+				}
+			}
+			else
+			{
+				std::vector<int> values;
+				while (m_queue.popFrontBatch(Timeout::infinite, BATCH_SIZE, values) == MTQueueEnum::E_VALUE)
+				{
+					Int64 n = Int64(values.size());
+					values.clear();
+					if (m_remaining.fetchSub(n, E_MEMORY_ORDER_RELAXED) == n)
+					{
+						m_queue.shutdown();
+					}
+				}
+			}
+		}
+	private:
+		LockFreeMTQueue<int>& m_queue;
+		UInt32 m_pairs;
+		UInt64 m_perPair;
+		Atomic<Int64> m_remaining;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// Synchronization primitives under contention from arg() threads.
+
+	class RWLockerReaders : public Bench::ParallelBody
+	{
+	public:
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				m_locker.getReadLock(Timeout::infinite);
+				m_locker.releaseReadLock();
+			}
+		}
+	private:
+		RWLocker m_locker;
+	};
+
+	class SemaphoreSignalWait : public Bench::ParallelBody
+	{
+	public:
+		SemaphoreSignalWait()
+			: m_sem(0)
+		{
+		}
+		// Every wait() is preceded by the same thread's signal(), so the
+		// count can't stay at zero with every thread waiting.
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				m_sem.signal();
+				m_sem.wait();
+			}
+		}
+	private:
+		Semaphore m_sem;
+	};
+
+	class BarrierRounds : public Bench::ParallelBody
+	{
+	public:
+		BarrierRounds(UInt32 threads, UInt64 rounds)
+			: m_barrier(threads)
+			, m_rounds(rounds)
+		{
+		}
+		// Every thread must wait the same number of times, so this ignores
+		// runParallel()'s division of the iterations.
+		virtual void run(UInt32, UInt64)
+		{
+			for (UInt64 i = 0; i < m_rounds; ++i)
+			{
+				m_barrier.wait();
+			}
+		}
+	private:
+		ThreadBarrier m_barrier;
+		UInt64 m_rounds;
+	};
+
+	class AtomicIncrements : public Bench::ParallelBody
+	{
+	public:
+		AtomicIncrements()
+			: m_counter(0)
+		{
+		}
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				m_counter.fetchAdd(1, E_MEMORY_ORDER_RELAXED);
+			}
+		}
+	private:
+		Atomic<UInt64> m_counter;
+	};
+
+	class MutexIncrements : public Bench::ParallelBody
+	{
+	public:
+		MutexIncrements()
+			: m_counter(0)
+		{
+		}
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				NonRecursiveMutexLock lock(m_mutex);
+				++m_counter;
+			}
+		}
+	private:
+		NonRecursiveMutex m_mutex;
+		UInt64 m_counter;
+	};
+
+	class LockFreeStackPushPop : public Bench::ParallelBody
+	{
+	public:
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			int v;
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				m_stack.push(int(i));
+				m_stack.pop(v);
+			}
+		}
+	private:
+		LockFreeStack<int> m_stack;
+	};
+
+	class BoundedMPMCQueuePushPop : public Bench::ParallelBody
+	{
+	public:
+		BoundedMPMCQueuePushPop()
+			: m_queue(QUEUE_SIZE)
+		{
+		}
+		// Each thread pushes before it pops and there are far fewer threads
+		// than slots, so neither operation can fail for long.  Yielding
+		// keeps a spinning thread from using up a whole time slice when
+		// there are more threads than CPUs.
+		virtual void run(UInt32, UInt64 iterations)
+		{
+			int v;
+			for (UInt64 i = 0; i < iterations; ++i)
+			{
+				while (!m_queue.push(int(i)))
+				{
+					Thread::yield();
+				}
+				while (!m_queue.pop(v))
+				{
+					Thread::yield();
+				}
+			}
+		}
+	private:
+		BoundedMPMCQueue<int> m_queue;
+	};
+
+	class SPSCTransfer : public Bench::ParallelBody
+	{
+	public:
+		explicit SPSCTransfer(UInt64 items)
+			: m_ring(QUEUE_SIZE)
+			, m_items(items)
+		{
+		}
+		virtual void run(UInt32 thread, UInt64)
+		{
+			if (thread == 0)
+			{
+				for (UInt64 i = 0; i < m_items; ++i)
+				{
+					while (!m_ring.push(int(i)))
+					{
+						Thread::yield();
+					}
+				}
+			}
+			else
+			{
+				int v;
+				for (UInt64 i = 0; i < m_items; ++i)
+				{
+					while (!m_ring.pop(v))
+					{
+						Thread::yield();
+					}
+				}
+			}
+		}
+	private:
+		SPSCRingBuffer<int> m_ring;
+		UInt64 m_items;
+	};
+
+	//////////////////////////////////////////////////////////////////////////
+	// One time initialization, after the first call.
+
+	OnceFlag g_onceFlag = BLOCXX_ONCE_INIT;
+	int g_onceValue = 0;
+	void initOnceValue()
+	{
+		g_onceValue = 42;
+	}
+
+	DefaultConstructedLazyGlobal<String>::type g_lazyString = BLOCXX_LAZY_GLOBAL_DEFAULT_INIT;
+}
+
+BLOCXX_BENCHMARK_RANGE(ThreadPool_dispatch, 1, 16, 4)
+{
+	Semaphore done(0);
+	ThreadPool pool(ThreadPool::FIXED_SIZE, state.arg(), ThreadPool::UNLIMITED_QUEUE_SIZE);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		pool.addWork(RunnableRef(new SignalRunnable(done)));
+	}
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		done.wait();
+	}
+	state.pauseTiming();
+	pool.shutdown();
+	state.resumeTiming();
+}
+
+BLOCXX_BENCHMARK_RANGE(MTQueue_pairs, 1, 32, 2)
+{
+	MTQueue<int> queue(QUEUE_SIZE);
+	runQueuePairs(state, queue);
+}
+
+BLOCXX_BENCHMARK_RANGE(LockFreeMTQueue_pairs, 1, 32, 2)
+{
+	LockFreeMTQueue<int> queue(QUEUE_SIZE);
+	runQueuePairs(state, queue);
+}
+
+BLOCXX_BENCHMARK_RANGE(LockFreeMTQueue_batchPairs, 1, 32, 2)
+{
+	UInt32 pairs = state.arg();
+	UInt64 perPair = state.iterations() / pairs + 1;
+	LockFreeMTQueue<int> queue(QUEUE_SIZE);
+	LockFreeQueueBatchPairs body(queue, pairs, perPair);
+	Bench::runParallel(state, pairs * 2, body);
+	state.setItemsProcessed(perPair * pairs);
+}
+
+BLOCXX_BENCHMARK_RANGE(RWLocker_readLock, 1, MAX_THREADS, 2)
+{
+	RWLockerReaders body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK_RANGE(Semaphore_signalWait, 2, MAX_THREADS, 2)
+{
+	SemaphoreSignalWait body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK_RANGE(ThreadBarrier_wait, 2, MAX_THREADS, 2)
+{
+	UInt64 rounds = state.iterations() / state.arg() + 1;
+	BarrierRounds body(state.arg(), rounds);
+	Bench::runParallel(state, state.arg(), body);
+	state.setItemsProcessed(rounds);
+}
+
+BLOCXX_BENCHMARK_RANGE(Atomic_fetchAdd, 1, MAX_THREADS, 2)
+{
+	AtomicIncrements body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK_RANGE(NonRecursiveMutex_lock, 1, MAX_THREADS, 2)
+{
+	MutexIncrements body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK_RANGE(LockFreeStack_pushPop, 1, MAX_THREADS, 2)
+{
+	LockFreeStackPushPop body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK_RANGE(BoundedMPMCQueue_pushPop, 1, MAX_THREADS, 2)
+{
+	BoundedMPMCQueuePushPop body;
+	Bench::runParallel(state, state.arg(), body);
+}
+
+BLOCXX_BENCHMARK(SPSCRingBuffer_transfer)
+{
+	SPSCTransfer body(state.iterations());
+	Bench::runParallel(state, 2, body);
+	state.setItemsProcessed(state.iterations());
+}
+
+BLOCXX_BENCHMARK(ThreadOnce_callOnceDone)
+{
+	callOnce(g_onceFlag, initOnceValue);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		callOnce(g_onceFlag, initOnceValue);
+		Bench::doNotOptimize(g_onceValue);
+	}
+}
+
+BLOCXX_BENCHMARK(LazyGlobal_get)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(g_lazyString.get());
+	}
+}
+
+BLOCXX_BENCHMARK(Mutex_lockUncontended)
+{
+	Mutex mutex;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		MutexLock lock(mutex);
+		Bench::doNotOptimize(lock);
+	}
+}
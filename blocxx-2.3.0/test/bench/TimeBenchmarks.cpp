@@ -0,0 +1,137 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/DateTime.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/TimePoint.hpp"
+#include "blocxx/Timeout.hpp"
+#include "blocxx/TimeoutTimer.hpp"
+
+using namespace blocxx;
+
+BLOCXX_BENCHMARK(TimePoint_now)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(Time::TimePoint::now());
+	}
+}
+
+BLOCXX_BENCHMARK(TimePoint_nowCoarse)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(Time::TimePoint::nowCoarse());
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_getCurrent)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(DateTime::getCurrent());
+	}
+}
+
+// What a loop waiting on a relative timeout pays per pass.
+BLOCXX_BENCHMARK(TimeoutTimer_loopExpired)
+{
+	TimeoutTimer timer(Timeout::relativeWithReset(60.0));
+	timer.start();
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		timer.loop();
+		Bench::doNotOptimize(timer.expired());
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_parseCIM)
+{
+	String s("19980525133015.123456-300");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		DateTime dt(s);
+		Bench::doNotOptimize(dt);
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_parseISO8601)
+{
+	String s("1998-05-25T13:30:15.123456-05:00");
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		DateTime dt(s);
+		Bench::doNotOptimize(dt);
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_toCIMStringUTC)
+{
+	DateTime dt(String("19980525133015.123456-300"));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = dt.toCIMString(DateTime::E_UTC_TIME);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_toCIMStringLocal)
+{
+	DateTime dt(String("19980525133015.123456-300"));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = dt.toCIMString(DateTime::E_LOCAL_TIME);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_toISO8601String)
+{
+	DateTime dt(String("19980525133015.123456-300"));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = dt.toISO8601String(DateTime::E_UTC_TIME);
+		Bench::doNotOptimize(s);
+	}
+}
+
+BLOCXX_BENCHMARK(DateTime_toString)
+{
+	DateTime dt(String("19980525133015.123456-300"));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = dt.toString(DateTime::E_UTC_TIME);
+		Bench::doNotOptimize(s);
+	}
+}
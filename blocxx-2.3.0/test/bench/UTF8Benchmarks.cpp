@@ -0,0 +1,138 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#include "Benchmark.hpp"
+#include "blocxx/Array.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/UTF8Utils.hpp"
+
+using namespace blocxx;
+
+namespace
+{
+	// Mostly ASCII with some two and three byte sequences, like typical
+	// European text.
+	const char* const MIXED_TEXT =
+		"Gr\xc3\xbc\xc3\x9f" "e aus M\xc3\xbcnchen, "
+		"na\xc3\xafve caf\xc3\xa9 \xe2\x82\xac" "100, "
+		"\xc3\x85ngstr\xc3\xb6m and the quick brown fox";
+
+	const char* const ASCII_TEXT =
+		"The quick brown fox jumps over the lazy dog, again and again";
+
+	size_t textLength(const char* s)
+	{
+		return String(s).length();
+	}
+}
+
+BLOCXX_BENCHMARK(UTF8_charCountASCII)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(UTF8Utils::charCount(ASCII_TEXT));
+	}
+	state.setBytesProcessed(state.iterations() * textLength(ASCII_TEXT));
+}
+
+BLOCXX_BENCHMARK(UTF8_charCountMixed)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(UTF8Utils::charCount(MIXED_TEXT));
+	}
+	state.setBytesProcessed(state.iterations() * textLength(MIXED_TEXT));
+}
+
+BLOCXX_BENCHMARK(UTF8_toUpperCaseASCII)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = UTF8Utils::toUpperCase(ASCII_TEXT);
+		Bench::doNotOptimize(s);
+	}
+	state.setBytesProcessed(state.iterations() * textLength(ASCII_TEXT));
+}
+
+BLOCXX_BENCHMARK(UTF8_toUpperCaseMixed)
+{
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = UTF8Utils::toUpperCase(MIXED_TEXT);
+		Bench::doNotOptimize(s);
+	}
+	state.setBytesProcessed(state.iterations() * textLength(MIXED_TEXT));
+}
+
+BLOCXX_BENCHMARK(UTF8_compareToIgnoreCase)
+{
+	String upper = UTF8Utils::toUpperCase(MIXED_TEXT);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(UTF8Utils::compareToIgnoreCase(MIXED_TEXT, upper.c_str()));
+	}
+	state.setBytesProcessed(state.iterations() * textLength(MIXED_TEXT));
+}
+
+BLOCXX_BENCHMARK(UTF8_StringToUCS2)
+{
+	String s(MIXED_TEXT);
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Array<UInt16> ucs2 = UTF8Utils::StringToUCS2(s);
+		Bench::doNotOptimize(ucs2);
+	}
+	state.setBytesProcessed(state.iterations() * s.length());
+}
+
+BLOCXX_BENCHMARK(UTF8_UCS2ToString)
+{
+	Array<UInt16> ucs2 = UTF8Utils::StringToUCS2(String(MIXED_TEXT));
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		String s = UTF8Utils::UCS2ToString(ucs2);
+		Bench::doNotOptimize(s);
+	}
+	state.setBytesProcessed(state.iterations() * textLength(MIXED_TEXT));
+}
+
+BLOCXX_BENCHMARK(UTF8_decodeUCS4)
+{
+	const char* const chars[] = { "A", "\xc3\xbc", "\xe2\x82\xac", "\xf0\x9f\x98\x80" };
+	size_t k = 0;
+	for (UInt64 i = state.iterations(); i > 0; --i)
+	{
+		Bench::doNotOptimize(UTF8Utils::UTF8toUCS4(chars[k]));
+		k = (k + 1) & 3;
+	}
+}
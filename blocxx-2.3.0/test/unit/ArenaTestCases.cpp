@@ -0,0 +1,141 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/Arena.hpp"
+#include "blocxx/StringBuffer.hpp"
+#include "blocxx/String.hpp"
+
+#include <cstring>
+
+using namespace blocxx;
+
+namespace
+{
+	inline bool isAligned(void* p)
+	{
+		return reinterpret_cast<size_t>(p) % 16 == 0;
+	}
+}
+
+AUTO_UNIT_TEST(ArenaTestCases_testAllocate)
+{
+	Arena arena(1024);
+	unitAssertEquals(0u, arena.getChunkCount());
+
+	char* a = static_cast<char*>(arena.allocate(1));
+	char* b = static_cast<char*>(arena.allocate(17));
+	char* c = static_cast<char*>(arena.allocate(100));
+	unitAssert(isAligned(a));
+	unitAssert(isAligned(b));
+	unitAssert(isAligned(c));
+	unitAssert(b == a + 16);
+	unitAssert(c == b + 32);
+	unitAssertEquals(1u, arena.getChunkCount());
+	unitAssertEquals(16u + 32 + 112, arena.getBytesAllocated());
+
+	// Fill the first chunk, so the next allocation needs another.
+	for (int i = 0; i < 1024 / 16; ++i)
+	{
+		std::memset(arena.allocate(16), 'x', 16);
+	}
+	unitAssertEquals(2u, arena.getChunkCount());
+	unitAssertEquals(2048u, arena.getBytesReserved());
+}
+
+AUTO_UNIT_TEST(ArenaTestCases_testLargeAllocation)
+{
+	Arena arena(1024);
+	char* a = static_cast<char*>(arena.allocate(16));
+	// More than a quarter of a chunk gets a chunk of its own...
+	char* big = static_cast<char*>(arena.allocate(4000));
+	unitAssert(isAligned(big));
+	std::memset(big, 'b', 4000);
+	unitAssertEquals(2u, arena.getChunkCount());
+	unitAssertEquals(1024u + 4000, arena.getBytesReserved());
+	// ...and the current chunk is still used after it.
+	char* b = static_cast<char*>(arena.allocate(16));
+	unitAssert(b == a + 16);
+}
+
+AUTO_UNIT_TEST(ArenaTestCases_testRelease)
+{
+	Arena arena;
+	arena.allocate(100);
+	arena.allocate(10000);
+	arena.release();
+	unitAssertEquals(0u, arena.getChunkCount());
+	unitAssertEquals(0u, arena.getBytesAllocated());
+	unitAssertEquals(0u, arena.getBytesReserved());
+	unitAssert(arena.allocate(10) != 0);
+	unitAssertEquals(1u, arena.getChunkCount());
+}
+
+AUTO_UNIT_TEST(ArenaTestCases_testStringBuffer)
+{
+	Arena arena;
+	String expected;
+	{
+		StringBuffer sb(arena, 8);
+		for (int i = 0; i < 100; ++i)
+		{
+			sb += "word ";
+			sb += i;
+			expected += "word ";
+			expected += String(i);
+		}
+		unitAssert(sb.equals(expected.c_str()));
+		unitAssert(arena.getBytesAllocated() > sb.length());
+
+		StringBuffer copy(sb);
+		unitAssert(copy.equals(sb));
+		sb.reset();
+		unitAssertEquals(0u, sb.length());
+		unitAssertEquals(expected, copy.toString());
+
+		// Swapping exchanges which buffer is in the arena.
+		StringBuffer heap("heap");
+		heap.swap(copy);
+		unitAssertEquals(String("heap"), copy.toString());
+		heap += '!';
+		unitAssertEquals(expected + "!", heap.toString());
+	}
+
+	StringBuffer sb(arena);
+	sb += "released";
+	String s = sb.releaseString();
+	arena.release();
+	unitAssertEquals(String("released"), s);
+}
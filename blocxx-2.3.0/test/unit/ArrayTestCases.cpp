@@ -0,0 +1,111 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/Array.hpp"
+#include "blocxx/SortedVectorMap.hpp"
+#include "blocxx/String.hpp"
+
+#include <algorithm>
+
+using namespace blocxx;
+
+AUTO_UNIT_TEST(ArrayTestCases_testMutableView)
+{
+	Int32Array a;
+	for (Int32 i = 0; i < 10; ++i)
+	{
+		a.push_back(i);
+	}
+	std::pair<Int32Array::iterator, Int32Array::iterator> view = a.mutableView();
+	unitAssertEquals(10, view.second - view.first);
+	for (Int32Array::iterator i = view.first; i != view.second; ++i)
+	{
+		*i *= 2;
+	}
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		unitAssertEquals(Int32(i * 2), a[i]);
+	}
+}
+
+AUTO_UNIT_TEST(ArrayTestCases_testMutableViewUnshares)
+{
+	Int32Array a(5, 1);
+	Int32Array b(a);
+	std::pair<Int32Array::iterator, Int32Array::iterator> view = a.mutableView();
+	std::fill(view.first, view.second, 7);
+
+	const Int32Array& ca(a);
+	const Int32Array& cb(b);
+	unitAssertEquals(7, ca[0]);
+	unitAssertEquals(7, ca[4]);
+	unitAssertEquals(1, cb[0]);
+	unitAssertEquals(1, cb[4]);
+}
+
+AUTO_UNIT_TEST(ArrayTestCases_testUnshare)
+{
+	StringArray a;
+	a.push_back("x");
+	StringArray b(a);
+	const StringArray& cb(b);
+	const String* before = &cb[0];
+	a.unshare();
+	const StringArray& ca(a);
+	unitAssert(&ca[0] != before);
+	unitAssert(&cb[0] == before);
+	unitAssertEquals(ca[0], cb[0]);
+}
+
+AUTO_UNIT_TEST(ArrayTestCases_testSortedVectorMapEraseMissingKey)
+{
+	typedef SortedVectorMap<String, int> map_t;
+	map_t m;
+	m["a"] = 1;
+	m["b"] = 2;
+	map_t copy(m);
+	const map_t& cm(m);
+	const map_t& ccopy(copy);
+
+	// Erasing a key that isn't present mustn't separate the two copies.
+	unitAssertEquals(0U, m.erase("z"));
+	unitAssert(&*cm.begin() == &*ccopy.begin());
+
+	unitAssertEquals(1U, m.erase("a"));
+	unitAssertEquals(1U, cm.size());
+	unitAssertEquals(2U, ccopy.size());
+	unitAssertEquals(2, ccopy.find("b")->second);
+}
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/Atomic.hpp"
+#include "blocxx/Types.hpp"
+#include "blocxx/Runnable.hpp"
+#include "blocxx/ThreadPool.hpp"
+#include "blocxx/ThreadBarrier.hpp"
+
+#include <cstdlib>
+
+using namespace blocxx;
+
+AUTO_UNIT_TEST(AtomicTestCases_testIntegerOperations)
+{
+	Atomic<int> x;
+	unitAssertEquals(0, x.load());
+	x.store(5, E_MEMORY_ORDER_RELEASE);
+	unitAssertEquals(5, x.load(E_MEMORY_ORDER_ACQUIRE));
+	unitAssertEquals(5, x.exchange(7));
+	unitAssertEquals(7, x.load(E_MEMORY_ORDER_RELAXED));
+
+	int expected = 6;
+	unitAssert(!x.compareExchangeStrong(expected, 10));
+	unitAssertEquals(7, expected);
+	unitAssert(x.compareExchangeStrong(expected, 10, E_MEMORY_ORDER_ACQ_REL));
+	unitAssertEquals(10, x.load());
+
+	// a weak compare and exchange may fail spuriously, so retry.
+	expected = 10;
+	while (!x.compareExchangeWeak(expected, 12, E_MEMORY_ORDER_SEQ_CST, E_MEMORY_ORDER_RELAXED))
+	{
+		unitAssertEquals(10, expected);
+	}
+	unitAssertEquals(12, x.load());
+
+	unitAssertEquals(12, x.fetchAdd(3));
+	unitAssertEquals(15, x.fetchSub(5, E_MEMORY_ORDER_RELAXED));
+	unitAssertEquals(10, x.fetchAnd(6));
+	unitAssertEquals(2, x.fetchOr(9));
+	unitAssertEquals(11, x.fetchXor(1));
+	unitAssertEquals(10, x.load());
+
+	Atomic<UInt64> big(0xFFFFFFFFULL);
+	unitAssert(big.fetchAdd(1) == 0xFFFFFFFFULL);
+	unitAssert(big.load() == 0x100000000ULL);
+
+	Atomic<bool> flag;
+	unitAssert(!flag.load());
+	unitAssert(!flag.exchange(true));
+	bool expectedFlag = true;
+	unitAssert(flag.compareExchangeStrong(expectedFlag, false));
+	unitAssert(!flag.load());
+}
+
+AUTO_UNIT_TEST(AtomicTestCases_testPointerOperations)
+{
+	int values[4] = { 0, 1, 2, 3 };
+	Atomic<int*> p(values);
+	unitAssert(p.load() == values);
+	unitAssert(p.fetchAdd(2) == values);
+	unitAssert(p.load() == values + 2);
+	unitAssertEquals(2, *p.load());
+	unitAssert(p.fetchSub(1) == values + 2);
+	unitAssert(p.load() == values + 1);
+
+	int* expected = values + 1;
+	unitAssert(p.compareExchangeStrong(expected, values + 3));
+	unitAssert(p.exchange(0) == values + 3);
+	unitAssert(p.load() == 0);
+
+	Atomic<int*> empty;
+	unitAssert(empty.load() == 0);
+}
+
+namespace
+{
+	// Increments with a compare and exchange loop on one counter, and with
+	// fetchAdd() on another.
+	class CounterThread : public Runnable
+	{
+	public:
+		CounterThread(Atomic<long>& casCounter, Atomic<long>& addCounter, int iterations, ThreadBarrier& barrier)
+			: m_casCounter(casCounter)
+			, m_addCounter(addCounter)
+			, m_iterations(iterations)
+			, m_barrier(barrier)
+		{
+		}
+
+		void run()
+		{
+			m_barrier.wait();
+			for (int i = 0; i < m_iterations; ++i)
+			{
+				long value = m_casCounter.load(E_MEMORY_ORDER_RELAXED);
+				while (!m_casCounter.compareExchangeWeak(value, value + 1, E_MEMORY_ORDER_RELAXED))
+				{
+				}
+				m_addCounter.fetchAdd(1, E_MEMORY_ORDER_RELAXED);
+			}
+		}
+	private:
+		Atomic<long>& m_casCounter;
+		Atomic<long>& m_addCounter;
+		int m_iterations;
+		ThreadBarrier& m_barrier;
+	};
+}
+
+AUTO_UNIT_TEST(AtomicTestCases_testAtomicity)
+{
+	const int threadCount = 6;
+	int iterations = 100000;
+	if (getenv("BLOCXXLONGTEST"))
+	{
+		iterations = 10000000;
+	}
+
+	Atomic<long> casCounter;
+	Atomic<long> addCounter;
+	ThreadPool pool(ThreadPool::FIXED_SIZE, threadCount, threadCount, NullLogger(), "AtomicTestPool");
+	ThreadBarrier barrier(threadCount + 1);
+	for (int i = 0; i < threadCount; ++i)
+	{
+		pool.addWork(new CounterThread(casCounter, addCounter, iterations, barrier));
+	}
+	barrier.wait(); // Kick off the threads.
+	pool.shutdown();
+
+	unitAssert(casCounter.load() == long(threadCount) * iterations);
+	unitAssert(addCounter.load() == long(threadCount) * iterations);
+}
+
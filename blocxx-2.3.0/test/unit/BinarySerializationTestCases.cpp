@@ -0,0 +1,164 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/BinarySerialization.hpp"
+#include "blocxx/DataStreams.hpp"
+#include "blocxx/StringView.hpp"
+
+using namespace blocxx;
+
+namespace
+{
+	UInt32 roundTripLen(UInt32 len, int & encodedSize)
+	{
+		DataOStream ostrm;
+		BinarySerialization::writeLen(*ostrm.rdbuf(), len);
+		encodedSize = ostrm.length();
+		DataIStream istrm(ostrm.length(), ostrm.getData());
+		UInt32 rv = 0;
+		BinarySerialization::readLen(*istrm.rdbuf(), rv);
+		return rv;
+	}
+}
+
+AUTO_UNIT_TEST(BinarySerializationTestCases_testLengthEncoding)
+{
+	int encodedSize = 0;
+	unitAssertEquals(0U, roundTripLen(0, encodedSize));
+	unitAssertEquals(1, encodedSize);
+	unitAssertEquals(127U, roundTripLen(127, encodedSize));
+	unitAssertEquals(1, encodedSize);
+	unitAssertEquals(128U, roundTripLen(128, encodedSize));
+	unitAssertEquals(2, encodedSize);
+	unitAssertEquals(65535U, roundTripLen(65535, encodedSize));
+	unitAssertEquals(3, encodedSize);
+	unitAssertEquals(65536U, roundTripLen(65536, encodedSize));
+	unitAssertEquals(4, encodedSize);
+	unitAssertEquals(0xffffffffU, roundTripLen(0xffffffffU, encodedSize));
+	unitAssertEquals(5, encodedSize);
+}
+
+AUTO_UNIT_TEST(BinarySerializationTestCases_testDataOStreamGrows)
+{
+	DataOStream ostrm(1);
+	for (int i = 0; i < 1000; ++i)
+	{
+		ostrm.put(static_cast<char>(i));
+	}
+	ostrm.write("abcdefghij", 10);
+	unitAssertEquals(1010, ostrm.length());
+	unitAssertEquals(static_cast<unsigned char>(999 & 0xff), ostrm.getData()[999]);
+	unitAssertEquals('j', static_cast<char>(ostrm.getData()[1009]));
+
+	ostrm.clearData();
+	unitAssertEquals(0, ostrm.length());
+	ostrm.put('x');
+	unitAssertEquals(1, ostrm.length());
+	unitAssertEquals('x', static_cast<char>(ostrm.getData()[0]));
+}
+
+AUTO_UNIT_TEST(BinarySerializationTestCases_testIntegerArrays)
+{
+	// The bulk path must produce the same bytes as writing each element.
+	UInt32Array a;
+	for (UInt32 i = 0; i < 1000; ++i)
+	{
+		a.push_back(i * 2654435761U);
+	}
+	DataOStream bulk;
+	BinarySerialization::writeArray(*bulk.rdbuf(), a);
+	DataOStream single;
+	BinarySerialization::writeLen(*single.rdbuf(), a.size());
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		BinarySerialization::write(*single.rdbuf(), a[i]);
+	}
+	unitAssertEquals(single.length(), bulk.length());
+	unitAssert(::memcmp(single.getData(), bulk.getData(), bulk.length()) == 0);
+
+	DataIStream istrm(bulk.length(), bulk.getData());
+	UInt32Array b;
+	BinarySerialization::readArray(*istrm.rdbuf(), b);
+	unitAssert(a == b);
+
+	Int16Array c;
+	c.push_back(-1);
+	c.push_back(12345);
+	c.push_back(-32768);
+	DataOStream ostrm;
+	BinarySerialization::writeArray(*ostrm.rdbuf(), c);
+	DataIStream istrm2(ostrm.length(), ostrm.getData());
+	Int16Array d(5, 7);
+	BinarySerialization::readArray(*istrm2.rdbuf(), d);
+	unitAssert(c == d);
+
+	UInt8Array empty;
+	DataOStream ostrm3;
+	BinarySerialization::writeArray(*ostrm3.rdbuf(), empty);
+	unitAssertEquals(1, ostrm3.length());
+}
+
+AUTO_UNIT_TEST(BinarySerializationTestCases_testStrings)
+{
+	StringArray strs;
+	strs.push_back("");
+	strs.push_back("a");
+	strs.push_back(String(std::string(300, 'x')));
+	DataOStream ostrm;
+	BinarySerialization::writeStringArray(*ostrm.rdbuf(), strs);
+	BinarySerialization::write(*ostrm.rdbuf(), String("view"));
+
+	DataIStream istrm(ostrm.length(), ostrm.getData());
+	StringArray result = BinarySerialization::readStringArray(*istrm.rdbuf());
+	unitAssert(strs == result);
+
+	StringView v = BinarySerialization::readStringView(istrm);
+	unitAssertEquals(4U, v.size());
+	unitAssertEquals(String("view"), v.toString());
+	// the view points into the original buffer
+	unitAssert(v.data() > reinterpret_cast<const char*>(ostrm.getData()));
+	unitAssert(v.data() < reinterpret_cast<const char*>(ostrm.getData()) + ostrm.length());
+
+	unitAssertThrows(BinarySerialization::readStringView(istrm));
+}
+
+AUTO_UNIT_TEST(BinarySerializationTestCases_testTruncatedStringView)
+{
+	DataOStream ostrm;
+	BinarySerialization::write(*ostrm.rdbuf(), String("truncated"));
+	DataIStream istrm(ostrm.length() - 1, ostrm.getData());
+	unitAssertThrowsEx(BinarySerialization::readStringView(istrm), IOException);
+}
@@ -1445,3 +1445,83 @@ AUTO_UNIT_TEST(DateTimeTestCases_testNormalization)
 	unitAssertThrowsEx(DateTime(dtmax, imax), DateTimeException);
 	unitAssertThrowsEx(DateTime(tmax, imax), DateTimeException);
 }
+
+AUTO_UNIT_TEST(DateTimeTestCases_testCIMAsterisks)
+{
+	DateTime d(String("1998052513****.******+000"));
+	unitAssertEquals(calcTimeT(1998, 5, 25, 13, 0, 0), d.get());
+	unitAssertEquals(0, d.getMicrosecond());
+
+	DateTime d2(String("19980525133015.012***-300"));
+	unitAssertEquals(calcTimeT(1998, 5, 25, 18, 30, 15), d2.get());
+	unitAssertEquals(12000, d2.getMicrosecond());
+}
+
+AUTO_UNIT_TEST(DateTimeTestCases_testISO8601)
+{
+	DateTime::ETimeOffset const utc = DateTime::E_UTC_TIME;
+	{
+		DateTime d(String("1998-05-25T13:30:15Z"));
+		unitAssertEquals(calcTimeT(1998, 5, 25, 13, 30, 15), d.get());
+		unitAssertEquals(0, d.getMicrosecond());
+	}
+	{
+		DateTime d(String("1998-05-25T13:30:15.5-05:00"));
+		unitAssertEquals(calcTimeT(1998, 5, 25, 18, 30, 15), d.get());
+		unitAssertEquals(500000, d.getMicrosecond());
+	}
+	{
+		// digits past microseconds are dropped
+		DateTime d(String("2000-01-01T02:29:59.123456789+02:30"));
+		unitAssertEquals(calcTimeT(1999, 12, 31, 23, 59, 59), d.get());
+		unitAssertEquals(123456, d.getMicrosecond());
+	}
+	unitAssertThrowsEx(DateTime(String("1998-13-25T13:30:15Z")), DateTimeException);
+	unitAssertThrowsEx(DateTime(String("1998-05-25T13:30:15")), DateTimeException);
+	unitAssertThrowsEx(DateTime(String("1998-05-25T13:30:15.Z")), DateTimeException);
+	unitAssertThrowsEx(DateTime(String("1998-05-25T13:30:15+0500")), DateTimeException);
+
+	DateTime d(calcTimeT(1998, 5, 25, 13, 30, 15), 12345);
+	unitAssertEquals("1998-05-25T13:30:15.012345Z", d.toISO8601String(utc));
+	unitAssertEquals("19980525133015.012345+000", d.toCIMString(utc));
+	unitAssertEquals(Time::getDescriptionForFlag(Time::E_TIME_NADT),
+		DateTime::getNADT().toISO8601String());
+}
+
+AUTO_UNIT_TEST(DateTimeTestCases_testFormatRoundTrip)
+{
+	DateTime::ETimeOffset const utc = DateTime::E_UTC_TIME;
+	DateTime::ETimeOffset const local = DateTime::E_LOCAL_TIME;
+	time_t const times[] = {
+		0, 1, -1, 951782400, 951868799, 1000000000,
+		BLOCXX_DATETIME_MINIMUM_TIME + 86400, BLOCXX_DATETIME_MAXIMUM_TIME - 86400
+	};
+	for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); ++i)
+	{
+		DateTime d(times[i], 654321);
+		unitAssert(DateTime(d.toCIMString(utc)) == d);
+		unitAssert(DateTime(d.toCIMString(local)) == d);
+		unitAssert(DateTime(d.toISO8601String(utc)) == d);
+		unitAssert(DateTime(d.toISO8601String(local)) == d);
+
+		// the cached local time agrees with localtime_r
+		struct tm loc;
+		d.toLocal(loc);
+		unitAssertEquals(loc.tm_year + 1900, d.getYear(local));
+		unitAssertEquals(loc.tm_mon + 1, d.getMonth(local));
+		unitAssertEquals(loc.tm_mday, d.getDay(local));
+		unitAssertEquals(loc.tm_hour, d.getHour(local));
+		unitAssertEquals(loc.tm_min, d.getMinute(local));
+		unitAssertEquals(loc.tm_sec, d.getSecond(local));
+		unitAssertEquals(loc.tm_wday, d.getDow(local));
+
+		struct tm gmt;
+		time_t t = d.get();
+		gmtime_r(&t, &gmt);
+		unitAssertEquals(gmt.tm_year + 1900, d.getYear(utc));
+		unitAssertEquals(gmt.tm_mon + 1, d.getMonth(utc));
+		unitAssertEquals(gmt.tm_mday, d.getDay(utc));
+		unitAssertEquals(gmt.tm_hour, d.getHour(utc));
+		unitAssertEquals(gmt.tm_wday, d.getDow(utc));
+	}
+}
@@ -41,6 +41,7 @@
 
 #include "blocxx/Semaphore.hpp"
 #include "blocxx/Exception.hpp"
+#include "blocxx/StackTrace.hpp"
 #include "blocxx/Thread.hpp"
 #include "blocxx/String.hpp"
 
@@ -137,3 +138,68 @@ AUTO_UNIT_TEST(ExceptionTestCases_testSubException)
 	}
 
 }
+
+#if defined(BLOCXX_HAVE_BACKTRACE) && defined(BLOCXX_HAVE_DLADDR)
+// Not static, so dladdr() can find its name.
+#if defined(__GNUC__)
+__attribute__((noinline, noclone))
+#endif
+void throwFromNamedFunction()
+{
+	BLOCXX_THROW(TestException, "with a call stack");
+}
+
+namespace
+{
+	// Restores the process-wide setting when a test finishes.
+	struct CaptureCallStacksScope
+	{
+		CaptureCallStacksScope(bool capture)
+			: m_saved(Exception::getCaptureCallStacks())
+		{
+			Exception::setCaptureCallStacks(capture);
+		}
+		~CaptureCallStacksScope()
+		{
+			Exception::setCaptureCallStacks(m_saved);
+		}
+		bool m_saved;
+	};
+}
+
+AUTO_UNIT_TEST(ExceptionTestCases_testCallStack)
+{
+	CaptureCallStacksScope scope(true);
+	try
+	{
+		throwFromNamedFunction();
+		unitAssert(false);
+	}
+	catch (const TestException& e)
+	{
+		const StackTrace::CallStack* stack = e.getCallStack();
+		unitAssert(stack != 0);
+		unitAssert(stack->size() > 0);
+		unitAssert(stack->toString().indexOf("throwFromNamedFunction") != String::npos);
+
+		AutoPtr<Exception> copy(e.clone());
+		unitAssert(copy->getCallStack() != 0);
+		unitAssert(copy->getCallStack() != stack);
+		unitAssertEquals(stack->toString(), copy->getCallStack()->toString());
+	}
+}
+
+AUTO_UNIT_TEST(ExceptionTestCases_testNoCallStack)
+{
+	CaptureCallStacksScope scope(false);
+	try
+	{
+		throwFromNamedFunction();
+		unitAssert(false);
+	}
+	catch (const TestException& e)
+	{
+		unitAssert(e.getCallStack() == 0);
+	}
+}
+#endif
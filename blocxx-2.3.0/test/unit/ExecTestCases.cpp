@@ -52,6 +52,11 @@
 #include <sys/wait.h>
 #endif
 
+#ifndef BLOCXX_WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
 using namespace blocxx;
 using namespace std;
 
@@ -325,3 +330,56 @@ AUTO_UNIT_TEST(ExecTestCases_testgatherOutput)
 
 
 }
+
+#ifndef BLOCXX_WIN32
+AUTO_UNIT_TEST(ExecTestCases_testLargeOutput)
+{
+	// Much larger than a pipe buffer or a single read.
+	const int OUTPUT_SIZE = 1000000;
+	StringArray cmd;
+	cmd.push_back("/bin/sh");
+	cmd.push_back("-c");
+	cmd.push_back(Format("head -c %1 /dev/zero | tr '\\0' a; echo err >&2", OUTPUT_SIZE));
+
+	{
+		String output;
+		String erroutput;
+		Process::Status status = Exec::executeProcessAndGatherOutput(cmd, output, erroutput);
+		unitAssert(status.terminatedSuccessfully());
+		unitAssertEquals(size_t(OUTPUT_SIZE), output.length());
+		unitAssertEquals('a', output[0]);
+		unitAssertEquals('a', output[OUTPUT_SIZE / 2]);
+		unitAssertEquals('a', output[OUTPUT_SIZE - 1]);
+		unitAssertEquals("err\n", erroutput);
+	}
+
+	{
+		int devnull = ::open("/dev/null", O_WRONLY);
+		unitAssert(devnull >= 0);
+		Exec::DescriptorOutputCallback callback(devnull, devnull);
+		ProcessRef proc = Exec::spawn(cmd);
+		Exec::processInputOutput(String(), callback, proc, Timeout::relative(60));
+		proc->waitCloseTerm();
+		::close(devnull);
+		unitAssert(proc->processStatus().terminatedSuccessfully());
+		unitAssertEquals(UInt64(OUTPUT_SIZE + 4), callback.bytesWritten());
+	}
+}
+
+AUTO_UNIT_TEST(ExecTestCases_testDescriptorsNotInherited)
+{
+	// A descriptor without FD_CLOEXEC must still not leak into the child.
+	int fds[2];
+	unitAssert(::pipe(fds) == 0);
+	StringArray cmd;
+	cmd.push_back("/bin/sh");
+	cmd.push_back("-c");
+	cmd.push_back(Format("if (: >&%1) 2>/dev/null; then echo open; else echo closed; fi", fds[1]));
+	String output;
+	Process::Status status = Exec::executeProcessAndGatherOutput(cmd, output);
+	::close(fds[0]);
+	::close(fds[1]);
+	unitAssert(status.terminatedSuccessfully());
+	unitAssertEquals("closed\n", output);
+}
+#endif
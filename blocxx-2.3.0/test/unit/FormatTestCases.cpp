@@ -42,6 +42,7 @@
 #include "blocxx/Format.hpp"
 #define _USE_MATH_DEFINES // For windows to define M_PI, shouldn't hurt any other platform.
 #include <cmath>
+#include <limits>
 
 using namespace blocxx;
 
@@ -226,6 +227,17 @@ AUTO_UNIT_TEST(FormatTestCases_testPrecision)
 	unitAssertEquals( "   3.1415926536", Format("%<1:15.10>", M_PI) );
 }
 
+AUTO_UNIT_TEST(FormatTestCases_integerLimits)
+{
+	unitAssertEquals( "-9223372036854775808", Format("%1", std::numeric_limits<long long>::min()) );
+	unitAssertEquals( "18446744073709551615", Format("%1", std::numeric_limits<unsigned long long>::max()) );
+	unitAssertEquals( "-2147483648 2147483647", Format("%1 %2", std::numeric_limits<int>::min(), std::numeric_limits<int>::max()) );
+	unitAssertEquals( "[000xfffb]", Format("[%<1:08x!>]", short(-5)) );
+	unitAssertEquals( "[000000-5]", Format("[%<1:08>]", -5) );
+	unitAssertEquals( "1777777777777777777777", Format("%<1:o>", std::numeric_limits<unsigned long long>::max()) );
+	unitAssertEquals( "0 +0 99 100", Format("%<1:x!> %<2:+1> %3 %4", 0U, 0, 99, 100) );
+}
+
 AUTO_UNIT_TEST(FormatTestCases_testFormatModifiers)
 {
 	// Yes, void pointers can be output, but their output depends on the
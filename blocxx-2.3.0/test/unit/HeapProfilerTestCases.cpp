@@ -0,0 +1,342 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/HeapProfiler.hpp"
+#include "blocxx/FileSystem.hpp"
+#include "blocxx/Format.hpp"
+#include "blocxx/String.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <signal.h>
+#include <unistd.h>
+
+using namespace blocxx;
+
+// The library only sends allocations to the profiler when it's configured
+// with --enable-heap-profiler, so do it here.
+void*
+operator new(std::size_t size) BLOCXX_THROW_BAD_ALLOC
+{
+	void* p = HeapProfiler::allocate(size);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void*
+operator new[](std::size_t size) BLOCXX_THROW_BAD_ALLOC
+{
+	void* p = HeapProfiler::allocate(size);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void
+operator delete(void* p) throw()
+{
+	HeapProfiler::deallocate(p);
+}
+
+void
+operator delete[](void* p) throw()
+{
+	HeapProfiler::deallocate(p);
+}
+
+void
+operator delete(void* p, std::size_t) throw()
+{
+	HeapProfiler::deallocate(p);
+}
+
+void
+operator delete[](void* p, std::size_t) throw()
+{
+	HeapProfiler::deallocate(p);
+}
+
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline, noclone))
+#else
+#define TEST_NOINLINE
+#endif
+
+namespace
+{
+	const size_t OBJECT_SIZE = 1024;
+	const size_t COUNT_B = 4000;
+	const size_t COUNT_A = 3 * COUNT_B;
+
+	char* keptA[COUNT_A];
+	char* keptB[COUNT_B];
+
+	// allocateA() and allocateB() are the synthetic workload.  They differ
+	// so the compiler can't merge them, and mustn't be inlined or cloned so
+	// every call allocates from the same frame.
+	TEST_NOINLINE void allocateA(size_t count, size_t size)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			keptA[i] = new char[size];
+			keptA[i][0] = 'a';
+		}
+	}
+
+	TEST_NOINLINE void allocateB(size_t count, size_t size)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			keptB[i] = new char[size];
+			keptB[i][size - 1] = 'b';
+		}
+	}
+
+	void freeAll(char** kept, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			delete[] kept[i];
+		}
+	}
+
+	const HeapProfiler::StackProfile* findStack(const HeapProfiler::Profile& profile,
+		UInt64 count, UInt64 bytes)
+	{
+		for (size_t i = 0; i < profile.size(); ++i)
+		{
+			if (profile[i].allocCount == count && profile[i].allocBytes == bytes)
+			{
+				return &profile[i];
+			}
+		}
+		return 0;
+	}
+
+	// Finds the stacks of single allocations made by allocateA() and
+	// allocateB() with odd sizes, and the first frame where they differ,
+	// which is the one in allocateA() or allocateB().  Any other stack
+	// through the same code has the same frame there.
+	class Attributor
+	{
+	public:
+		Attributor()
+			: m_frame(0)
+		{
+			HeapProfiler::start(1);
+			allocateA(1, 4099);
+			allocateB(1, 4111);
+			HeapProfiler::stop();
+			HeapProfiler::Profile profile = HeapProfiler::getProfile();
+			freeAll(keptA, 1);
+			freeAll(keptB, 1);
+
+			const HeapProfiler::StackProfile* a = findStack(profile, 1, 4099);
+			const HeapProfiler::StackProfile* b = findStack(profile, 1, 4111);
+			if (a && b)
+			{
+				m_a = a->frames;
+				m_b = b->frames;
+				while (m_frame < m_a.size() && m_frame < m_b.size() &&
+					m_a[m_frame] == m_b[m_frame])
+				{
+					++m_frame;
+				}
+			}
+		}
+
+		bool valid() const
+		{
+			return m_frame < m_a.size() && m_frame < m_b.size();
+		}
+		bool isA(const HeapProfiler::StackProfile& sp) const
+		{
+			return m_frame < sp.frames.size() && sp.frames[m_frame] == m_a[m_frame];
+		}
+		bool isB(const HeapProfiler::StackProfile& sp) const
+		{
+			return m_frame < sp.frames.size() && sp.frames[m_frame] == m_b[m_frame];
+		}
+
+	private:
+		Array<void*> m_a;
+		Array<void*> m_b;
+		size_t m_frame;
+	};
+
+	struct Totals
+	{
+		UInt64 allocCount;
+		UInt64 allocBytes;
+		UInt64 inUseCount;
+
+		Totals()
+			: allocCount(0)
+			, allocBytes(0)
+			, inUseCount(0)
+		{
+		}
+		void add(const HeapProfiler::StackProfile& sp)
+		{
+			allocCount += sp.allocCount;
+			allocBytes += sp.allocBytes;
+			inUseCount += sp.inUseCount();
+		}
+	};
+
+	String readAndRemove(const String& path)
+	{
+		String contents = FileSystem::getFileContents(path);
+		FileSystem::removeFile(path);
+		return contents;
+	}
+}
+
+#ifdef BLOCXX_HAVE_BACKTRACE
+
+AUTO_UNIT_TEST(HeapProfilerTestCases_testAttribution)
+{
+	HeapProfiler::start(16 * 1024);
+	allocateA(COUNT_A, OBJECT_SIZE);
+	allocateB(COUNT_B, OBJECT_SIZE);
+	HeapProfiler::stop();
+	HeapProfiler::Profile live = HeapProfiler::getProfile();
+	freeAll(keptA, COUNT_A);
+	freeAll(keptB, COUNT_B);
+	HeapProfiler::Profile freed = HeapProfiler::getProfile();
+
+	Attributor attributor;
+	unitAssert(attributor.valid());
+
+	Totals a;
+	Totals b;
+	for (size_t i = 0; i < live.size(); ++i)
+	{
+		if (attributor.isA(live[i]))
+		{
+			a.add(live[i]);
+		}
+		else if (attributor.isB(live[i]))
+		{
+			b.add(live[i]);
+		}
+	}
+	// About one in 16 allocations of 1 KiB is sampled.
+	unitAssert(b.allocCount > COUNT_B / 64);
+	unitAssertEquals(a.allocCount * OBJECT_SIZE, a.allocBytes);
+	unitAssertEquals(b.allocCount * OBJECT_SIZE, b.allocBytes);
+	unitAssertEquals(a.allocCount, a.inUseCount);
+	unitAssertEquals(b.allocCount, b.inUseCount);
+	// allocateA() allocated 3 times as much.
+	double ratio = double(a.allocBytes) / double(b.allocBytes);
+	unitAssert(ratio > 2.25 && ratio < 4.0);
+
+	Totals aFreed;
+	for (size_t i = 0; i < freed.size(); ++i)
+	{
+		if (attributor.isA(freed[i]))
+		{
+			aFreed.add(freed[i]);
+		}
+	}
+	unitAssertEquals(a.allocCount, aFreed.allocCount);
+	unitAssertEquals(UInt64(0), aFreed.inUseCount);
+}
+
+AUTO_UNIT_TEST(HeapProfilerTestCases_testSampleEverything)
+{
+	HeapProfiler::start(1);
+	allocateB(10, 333);
+	HeapProfiler::stop();
+	HeapProfiler::Profile profile = HeapProfiler::getProfile();
+	freeAll(keptB, 10);
+
+	const HeapProfiler::StackProfile* sp = findStack(profile, 10, 3330);
+	unitAssert(sp != 0);
+	unitAssert(sp->frames.size() > 0);
+	unitAssertEquals(UInt64(10), sp->inUseCount());
+}
+
+#endif
+
+AUTO_UNIT_TEST(HeapProfilerTestCases_testStartStop)
+{
+	unitAssert(!HeapProfiler::isRunning());
+	HeapProfiler::start();
+	unitAssert(HeapProfiler::isRunning());
+	unitAssertEquals(HeapProfiler::DEFAULT_SAMPLE_INTERVAL, HeapProfiler::getSampleInterval());
+	HeapProfiler::stop();
+	unitAssert(!HeapProfiler::isRunning());
+}
+
+AUTO_UNIT_TEST(HeapProfilerTestCases_testWriteProfile)
+{
+	HeapProfiler::start(1);
+	allocateB(1, 100);
+	HeapProfiler::stop();
+
+	String path("HeapProfilerTestCases.heap");
+	HeapProfiler::writeProfile(path);
+	String contents = readAndRemove(path);
+	freeAll(keptB, 1);
+
+	unitAssert(contents.startsWith("heap profile: "));
+	unitAssert(contents.indexOf(" @ heap_v2/1\n") != String::npos);
+	unitAssert(contents.indexOf("\nMAPPED_LIBRARIES:\n") != String::npos);
+#ifdef BLOCXX_HAVE_BACKTRACE
+	unitAssert(contents.indexOf(" @ 0x") != String::npos);
+#endif
+}
+
+AUTO_UNIT_TEST(HeapProfilerTestCases_testDumpOnSignal)
+{
+	HeapProfiler::installDumpSignalHandler(SIGUSR2, "HeapProfilerTestCases");
+	::raise(SIGUSR2);
+	::raise(SIGUSR2);
+
+	String first = Format("HeapProfilerTestCases.%1.1.heap", ::getpid());
+	String second = Format("HeapProfilerTestCases.%1.2.heap", ::getpid());
+	unitAssert(FileSystem::exists(first));
+	unitAssert(FileSystem::exists(second));
+	unitAssert(readAndRemove(first).startsWith("heap profile: "));
+	unitAssert(readAndRemove(second).startsWith("heap profile: "));
+	::signal(SIGUSR2, SIG_DFL);
+}
@@ -0,0 +1,276 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/HostResolver.hpp"
+#include "blocxx/FileSystem.hpp"
+#include "blocxx/File.hpp"
+#include "blocxx/ThreadPool.hpp"
+#include "blocxx/Condition.hpp"
+#include "blocxx/NonRecursiveMutex.hpp"
+#include "blocxx/NonRecursiveMutexLock.hpp"
+
+#include <fstream>
+
+using namespace blocxx;
+
+namespace
+{
+	// A hosts file fixture, removed when it goes out of scope.
+	class HostsFile
+	{
+	public:
+		HostsFile()
+		{
+			FileSystem::createTempFile(m_path).close();
+		}
+		~HostsFile()
+		{
+			FileSystem::removeFile(m_path);
+		}
+		void write(const char* contents)
+		{
+			std::ofstream out(m_path.c_str());
+			out << contents;
+		}
+		const String& path() const
+		{
+			return m_path;
+		}
+	private:
+		String m_path;
+	};
+
+	class TestResolver : public HostResolver
+	{
+	public:
+		TestResolver(const Config& config)
+			: HostResolver(config)
+			, m_now(DateTime::getCurrent())
+		{
+		}
+		void advance(long seconds)
+		{
+			m_now += seconds;
+		}
+	protected:
+		virtual DateTime getCurrentTime() const
+		{
+			return m_now;
+		}
+	private:
+		DateTime m_now;
+	};
+
+	HostResolver::Config fixtureConfig(const HostsFile& hosts)
+	{
+		HostResolver::Config config;
+		config.hostsFile = hosts.path();
+		config.positiveTTL = 60;
+		config.negativeTTL = 10;
+		return config;
+	}
+
+	class TestCallback : public HostResolverCallback
+	{
+	public:
+		TestCallback()
+			: m_failed(false)
+			, m_done(false)
+		{
+		}
+		bool waitDone()
+		{
+			NonRecursiveMutexLock lock(m_guard);
+			while (!m_done)
+			{
+				if (!m_cond.timedWait(lock, Timeout::relative(10)))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		Array<SocketAddress> m_addresses;
+		bool m_failed;
+	protected:
+		virtual void doResolved(const String&, const Array<SocketAddress>& addresses)
+		{
+			NonRecursiveMutexLock lock(m_guard);
+			m_addresses = addresses;
+			m_done = true;
+			m_cond.notifyAll();
+		}
+		virtual void doFailed(const String&, const String&)
+		{
+			NonRecursiveMutexLock lock(m_guard);
+			m_failed = true;
+			m_done = true;
+			m_cond.notifyAll();
+		}
+	private:
+		NonRecursiveMutex m_guard;
+		Condition m_cond;
+		bool m_done;
+	};
+	typedef IntrusiveReference<TestCallback> TestCallbackRef;
+}
+
+AUTO_UNIT_TEST(HostResolverTestCases_testHostsFile)
+{
+	HostsFile hosts;
+	hosts.write(
+		"# comment line\n"
+		"192.0.2.1 alpha.example.test alpha # trailing comment\n"
+		"192.0.2.2\tbeta.example.test\n"
+		"192.0.2.3 beta.example.test\n"
+		"::1 ipv6only.example.test\n");
+	HostResolver resolver(fixtureConfig(hosts));
+
+	Array<SocketAddress> addrs = resolver.resolve("alpha", 80);
+	unitAssertEquals(size_t(1), addrs.size());
+	unitAssertEquals("192.0.2.1", addrs[0].getAddress());
+	unitAssertEquals(80, addrs[0].getPort());
+	unitAssertEquals("alpha.example.test", addrs[0].getName());
+
+	// case insensitive, multiple lines
+	addrs = resolver.resolve("BETA.example.test", 443);
+	unitAssertEquals(size_t(2), addrs.size());
+	unitAssertEquals("192.0.2.2", addrs[0].getAddress());
+	unitAssertEquals("192.0.2.3", addrs[1].getAddress());
+	unitAssertEquals(443, addrs[1].getPort());
+
+	// the cached entry gets the port of each call
+	addrs = resolver.resolve("alpha", 8080);
+	unitAssertEquals(8080, addrs[0].getPort());
+
+	// numeric addresses don't need the file
+	addrs = resolver.resolve("198.51.100.7", 22);
+	unitAssertEquals("198.51.100.7", addrs[0].getAddress());
+
+#ifdef BLOCXX_HAVE_IPV6
+	addrs = resolver.resolve("ipv6only.example.test");
+	unitAssertEquals(size_t(1), addrs.size());
+	unitAssertEquals("::1", addrs[0].getAddress());
+#else
+	unitAssertThrows(resolver.resolve("ipv6only.example.test"));
+#endif
+
+	unitAssertThrows(resolver.resolve("missing.example.test"));
+}
+
+AUTO_UNIT_TEST(HostResolverTestCases_testCacheExpiry)
+{
+	HostsFile hosts;
+	hosts.write("192.0.2.1 alpha\n");
+	TestResolver resolver(fixtureConfig(hosts));
+
+	unitAssertEquals("192.0.2.1", resolver.resolve("alpha")[0].getAddress());
+	unitAssertThrows(resolver.resolve("beta"));
+	unitAssertEquals(size_t(2), resolver.cacheSize());
+
+	// Changes aren't seen while the entries are cached.
+	hosts.write("192.0.2.9 alpha\n192.0.2.2 beta\n");
+	unitAssertEquals("192.0.2.1", resolver.resolve("alpha")[0].getAddress());
+	unitAssertThrows(resolver.resolve("beta"));
+
+	// The negative entry expires first.
+	resolver.advance(11);
+	unitAssertEquals("192.0.2.1", resolver.resolve("alpha")[0].getAddress());
+	unitAssertEquals("192.0.2.2", resolver.resolve("beta")[0].getAddress());
+
+	resolver.advance(50);
+	unitAssertEquals("192.0.2.9", resolver.resolve("alpha")[0].getAddress());
+
+	resolver.clearCache();
+	unitAssertEquals(size_t(0), resolver.cacheSize());
+}
+
+AUTO_UNIT_TEST(HostResolverTestCases_testCacheSizeLimit)
+{
+	HostsFile hosts;
+	hosts.write("192.0.2.1 a\n192.0.2.2 b\n192.0.2.3 c\n");
+	HostResolver::Config config(fixtureConfig(hosts));
+	config.maxEntries = 2;
+	HostResolver resolver(config);
+
+	resolver.resolve("a");
+	resolver.resolve("b");
+	resolver.resolve("a"); // b is now the least recently used
+	resolver.resolve("c");
+	unitAssertEquals(size_t(2), resolver.cacheSize());
+
+	hosts.write("192.0.2.11 a\n192.0.2.12 b\n192.0.2.13 c\n");
+	unitAssertEquals("192.0.2.1", resolver.resolve("a")[0].getAddress());
+	unitAssertEquals("192.0.2.3", resolver.resolve("c")[0].getAddress());
+	unitAssertEquals("192.0.2.12", resolver.resolve("b")[0].getAddress());
+}
+
+AUTO_UNIT_TEST(HostResolverTestCases_testResolveAsync)
+{
+	HostsFile hosts;
+	hosts.write("192.0.2.1 alpha\n");
+	HostResolver resolver(fixtureConfig(hosts));
+	ThreadPoolRef pool(new ThreadPool(ThreadPool::FIXED_SIZE, 2, 10));
+
+	TestCallbackRef cb(new TestCallback);
+	resolver.resolveAsync("alpha", 25, cb, pool);
+	unitAssert(cb->waitDone());
+	unitAssert(!cb->m_failed);
+	unitAssertEquals(size_t(1), cb->m_addresses.size());
+	unitAssertEquals("192.0.2.1", cb->m_addresses[0].getAddress());
+	unitAssertEquals(25, cb->m_addresses[0].getPort());
+
+	// A cached answer is delivered right away.
+	TestCallbackRef cached(new TestCallback);
+	resolver.resolveAsync("alpha", 26, cached, pool);
+	unitAssert(cached->waitDone());
+	unitAssertEquals(26, cached->m_addresses[0].getPort());
+
+	TestCallbackRef missing(new TestCallback);
+	resolver.resolveAsync("missing", 0, missing, pool);
+	unitAssert(missing->waitDone());
+	unitAssert(missing->m_failed);
+
+	pool->shutdown(ThreadPool::E_FINISH_WORK_IN_QUEUE);
+}
+
+AUTO_UNIT_TEST(HostResolverTestCases_testGetByNameNumeric)
+{
+	SocketAddress addr = SocketAddress::getByName("127.0.0.1", 1234);
+	unitAssertEquals("127.0.0.1", addr.getAddress());
+	unitAssertEquals(1234, addr.getPort());
+	unitAssertEquals(size_t(1), SocketAddress::getAllByName("127.0.0.1").size());
+}
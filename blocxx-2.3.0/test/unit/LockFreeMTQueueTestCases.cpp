@@ -0,0 +1,335 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/LockFreeMTQueue.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/DateTime.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/Timeout.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace blocxx;
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testPushAndPop)
+{
+	LockFreeMTQueue<int> q(3);
+	unitAssertEquals(4U, q.capacity());
+	int n = 0;
+
+	q.pushBack(1);
+	q.pushBack(2);
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFront(Timeout::relative(1.0), n));
+	unitAssertEquals(1, n);
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFront(Timeout::infinite, n));
+	unitAssertEquals(2, n);
+
+	n = 29347;
+	unitAssertEquals(MTQueueEnum::E_TIMED_OUT, q.popFront(Timeout::relative(0.01), n));
+	unitAssertEquals(29347, n);
+
+	DateTime wakeup = DateTime::getCurrent();
+	wakeup.addMicroseconds(50000);
+	unitAssertEquals(MTQueueEnum::E_TIMED_OUT, q.popFront(Timeout::absolute(wakeup), n));
+	unitAssertEquals(29347, n);
+}
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testShutdown)
+{
+	LockFreeMTQueue<String> q(4);
+	String s;
+
+	q.pushBack("a");
+	q.shutdown();
+	unitAssertEquals(MTQueueEnum::E_SHUT_DOWN, q.popFront(Timeout::infinite, s));
+	q.pushBack("b");
+	unitAssertEquals(MTQueueEnum::E_SHUT_DOWN, q.popFront(Timeout::infinite, s));
+	unitAssertEquals("", s);
+}
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testBatch)
+{
+	LockFreeMTQueue<int> q(8);
+	int items[] = { 1, 2, 3, 4, 5 };
+	q.pushBackBatch(items, items + 5);
+
+	std::vector<int> values;
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFrontBatch(Timeout::relative(1.0), 3, values));
+	unitAssertEquals(3U, values.size());
+	unitAssertEquals(1, values[0]);
+	unitAssertEquals(3, values[2]);
+
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFrontBatch(Timeout::infinite, 10, values));
+	unitAssertEquals(5U, values.size());
+	unitAssertEquals(5, values[4]);
+
+	unitAssertEquals(MTQueueEnum::E_TIMED_OUT, q.popFrontBatch(Timeout::relative(0.01), 10, values));
+	unitAssertEquals(5U, values.size());
+}
+
+namespace
+{
+	// Pushes count items, producer * count + i, one at a time or in batches.
+	class PushThread : public Thread
+	{
+	public:
+		PushThread(LockFreeMTQueue<int> & q, int producer, int count, bool batch)
+			: m_done(false)
+			, m_q(q)
+			, m_producer(producer)
+			, m_count(count)
+			, m_batch(batch)
+		{
+		}
+
+		Atomic<bool> m_done;
+
+	private:
+		virtual Int32 run()
+		{
+			if (m_batch)
+			{
+				std::vector<int> items;
+				for (int i = 0; i < m_count; ++i)
+				{
+					items.push_back(m_producer * m_count + i);
+				}
+				m_q.pushBackBatch(items.begin(), items.end());
+			}
+			else
+			{
+				for (int i = 0; i < m_count; ++i)
+				{
+					m_q.pushBack(m_producer * m_count + i);
+				}
+			}
+			m_done.store(true);
+			return 0;
+		}
+
+		LockFreeMTQueue<int> & m_q;
+		int m_producer;
+		int m_count;
+		bool m_batch;
+	};
+
+	// Pops until shutdown, recording what it got and whether the items
+	// from each producer arrived in order.
+	class PopThread : public Thread
+	{
+	public:
+		PopThread(LockFreeMTQueue<int> & q, int count, bool batch, Atomic<int> & consumed)
+			: m_inOrder(true)
+			, m_q(q)
+			, m_count(count)
+			, m_batch(batch)
+			, m_consumed(consumed)
+		{
+		}
+
+		std::vector<int> m_values;
+		bool m_inOrder;
+
+	private:
+		virtual Int32 run()
+		{
+			std::vector<int> last;
+			std::vector<int> batch;
+			for (;;)
+			{
+				batch.clear();
+				MTQueueEnum::EPopResult rv;
+				if (m_batch)
+				{
+					rv = m_q.popFrontBatch(Timeout::infinite, 16, batch);
+				}
+				else
+				{
+					int n;
+					rv = m_q.popFront(Timeout::infinite, n);
+					batch.push_back(n);
+				}
+				if (rv != MTQueueEnum::E_VALUE)
+				{
+					return 0;
+				}
+				for (size_t i = 0; i < batch.size(); ++i)
+				{
+					size_t producer = batch[i] / m_count;
+					if (last.size() <= producer)
+					{
+						last.resize(producer + 1, -1);
+					}
+					if (batch[i] <= last[producer])
+					{
+						m_inOrder = false;
+					}
+					last[producer] = batch[i];
+					m_values.push_back(batch[i]);
+				}
+				m_consumed.fetchAdd(int(batch.size()));
+			}
+		}
+
+		LockFreeMTQueue<int> & m_q;
+		int m_count;
+		bool m_batch;
+		Atomic<int> & m_consumed;
+	};
+}
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testPushBlocksWhenQueueFull)
+{
+	LockFreeMTQueue<int> q(2);
+	q.pushBack(0);
+	q.pushBack(1);
+
+	PushThread th(q, 1, 1, false);
+	th.start();
+	Thread::sleep(50);
+	unitAssert(!th.m_done.load());
+
+	int n;
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFront(Timeout::infinite, n));
+	unitAssertEquals(0, n);
+	th.join();
+	unitAssert(th.m_done.load());
+}
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testShutdownUnblocksPushesAndPops)
+{
+	{
+		LockFreeMTQueue<int> q(2);
+		q.pushBack(0);
+		q.pushBack(1);
+		PushThread th(q, 1, 1, false);
+		th.start();
+		Thread::sleep(50);
+		unitAssert(!th.m_done.load());
+		q.shutdown();
+		th.join();
+	}
+	{
+		LockFreeMTQueue<int> q(2);
+		Atomic<int> consumed;
+		PopThread th1(q, 1, false, consumed);
+		PopThread th2(q, 1, true, consumed);
+		th1.start();
+		th2.start();
+		Thread::sleep(50);
+		q.shutdown();
+		th1.join();
+		th2.join();
+		unitAssert(th1.m_values.empty());
+		unitAssert(th2.m_values.empty());
+	}
+}
+
+namespace
+{
+	// Runs producers and consumers against one queue.
+	// @return whether every item pushed was popped exactly once, and in order
+	// for each producer.
+	bool producersAndConsumers(bool batch)
+	{
+		const int PRODUCERS = 4;
+		const int CONSUMERS = 4;
+		const int COUNT = getenv("BLOCXXLONGTEST") ? 1000000 : 20000;
+		LockFreeMTQueue<int> q(64);
+		Atomic<int> consumed;
+
+		std::vector<PopThread*> consumers;
+		for (int i = 0; i < CONSUMERS; ++i)
+		{
+			consumers.push_back(new PopThread(q, COUNT, batch, consumed));
+			consumers.back()->start();
+		}
+		std::vector<PushThread*> producers;
+		for (int i = 0; i < PRODUCERS; ++i)
+		{
+			producers.push_back(new PushThread(q, i, COUNT, batch));
+			producers.back()->start();
+		}
+		for (int i = 0; i < PRODUCERS; ++i)
+		{
+			producers[i]->join();
+			delete producers[i];
+		}
+		// shutting down discards what's left, so wait for the consumers first.
+		while (consumed.load() < PRODUCERS * COUNT)
+		{
+			Thread::yield();
+		}
+		q.shutdown();
+
+		bool inOrder = true;
+		std::vector<int> all;
+		for (int i = 0; i < CONSUMERS; ++i)
+		{
+			consumers[i]->join();
+			inOrder = inOrder && consumers[i]->m_inOrder;
+			all.insert(all.end(), consumers[i]->m_values.begin(), consumers[i]->m_values.end());
+			delete consumers[i];
+		}
+		std::sort(all.begin(), all.end());
+		if (!inOrder || all.size() != size_t(PRODUCERS * COUNT))
+		{
+			return false;
+		}
+		for (size_t i = 0; i < all.size(); ++i)
+		{
+			if (all[i] != int(i))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testProducersAndConsumers)
+{
+	unitAssert(producersAndConsumers(false));
+}
+
+AUTO_UNIT_TEST(LockFreeMTQueueTestCases_testProducersAndConsumersBatch)
+{
+	unitAssert(producersAndConsumers(true));
+}
+
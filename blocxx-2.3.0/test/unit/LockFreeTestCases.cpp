@@ -0,0 +1,303 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/LockFreeQueue.hpp"
+#include "blocxx/LockFreeStack.hpp"
+#include "blocxx/Atomic.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Runnable.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/ThreadPool.hpp"
+#include "blocxx/ThreadBarrier.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace blocxx;
+
+namespace
+{
+	int getIterations()
+	{
+		return getenv("BLOCXXLONGTEST") ? 1000000 : 20000;
+	}
+
+	// LockFreeStack::push() can't fail, so these give the containers the
+	// same interface for Producer.
+	bool push(LockFreeStack<int>& c, int x)
+	{
+		c.push(x);
+		return true;
+	}
+
+	bool push(BoundedMPMCQueue<int>& c, int x)
+	{
+		return c.push(x);
+	}
+
+	bool push(SPSCRingBuffer<int>& c, int x)
+	{
+		return c.push(x);
+	}
+
+	// Each producer pushes iterations values, producer * iterations + i.
+	// Each consumer pops until consumed reaches total, checking that the
+	// values from any one producer arrive in increasing order when fifo is
+	// set.
+	template <typename Container>
+	class Producer : public Runnable
+	{
+	public:
+		Producer(Container& c, int id, int iterations, ThreadBarrier& barrier)
+			: m_c(c)
+			, m_id(id)
+			, m_iterations(iterations)
+			, m_barrier(barrier)
+		{
+		}
+		void run()
+		{
+			m_barrier.wait();
+			for (int i = 0; i < m_iterations; ++i)
+			{
+				while (!push(m_c, m_id * m_iterations + i))
+				{
+					Thread::yield();
+				}
+			}
+		}
+	private:
+		Container& m_c;
+		int m_id;
+		int m_iterations;
+		ThreadBarrier& m_barrier;
+	};
+
+	template <typename Container>
+	class Consumer : public Runnable
+	{
+	public:
+		Consumer(Container& c, Atomic<int>& consumed, int total, int iterations, bool fifo,
+			std::vector<int>& values, Atomic<int>& outOfOrder, ThreadBarrier& barrier)
+			: m_c(c)
+			, m_consumed(consumed)
+			, m_total(total)
+			, m_iterations(iterations)
+			, m_fifo(fifo)
+			, m_values(values)
+			, m_outOfOrder(outOfOrder)
+			, m_barrier(barrier)
+		{
+		}
+		void run()
+		{
+			m_barrier.wait();
+			std::vector<int> lastFromProducer;
+			while (m_consumed.load(E_MEMORY_ORDER_RELAXED) < m_total)
+			{
+				int value;
+				if (!m_c.pop(value))
+				{
+					Thread::yield();
+					continue;
+				}
+				m_consumed.fetchAdd(1, E_MEMORY_ORDER_RELAXED);
+				if (m_fifo)
+				{
+					size_t producer = value / m_iterations;
+					if (lastFromProducer.size() <= producer)
+					{
+						lastFromProducer.resize(producer + 1, -1);
+					}
+					if (value <= lastFromProducer[producer])
+					{
+						m_outOfOrder.fetchAdd(1);
+					}
+					lastFromProducer[producer] = value;
+				}
+				m_values.push_back(value);
+			}
+		}
+	private:
+		Container& m_c;
+		Atomic<int>& m_consumed;
+		int m_total;
+		int m_iterations;
+		bool m_fifo;
+		std::vector<int>& m_values;
+		Atomic<int>& m_outOfOrder;
+		ThreadBarrier& m_barrier;
+	};
+
+	// Runs producers and consumers against c.
+	// @return whether every value pushed was popped exactly once (and in
+	// order if fifo is set), leaving c empty.
+	template <typename Container>
+	bool stress(Container& c, int producers, int consumers, bool fifo)
+	{
+		int iterations = getIterations();
+		int total = producers * iterations;
+		Atomic<int> consumed;
+		Atomic<int> outOfOrder;
+		std::vector<std::vector<int> > values(consumers);
+
+		ThreadPool pool(ThreadPool::FIXED_SIZE, producers + consumers, producers + consumers, NullLogger(), "LockFreeTestPool");
+		ThreadBarrier barrier(producers + consumers + 1);
+		for (int i = 0; i < producers; ++i)
+		{
+			pool.addWork(new Producer<Container>(c, i, iterations, barrier));
+		}
+		for (int i = 0; i < consumers; ++i)
+		{
+			pool.addWork(new Consumer<Container>(c, consumed, total, iterations, fifo, values[i], outOfOrder, barrier));
+		}
+		barrier.wait(); // Kick off the threads.
+		pool.shutdown();
+
+		std::vector<int> all;
+		for (int i = 0; i < consumers; ++i)
+		{
+			all.insert(all.end(), values[i].begin(), values[i].end());
+		}
+		std::sort(all.begin(), all.end());
+		if (all.size() != size_t(total))
+		{
+			return false;
+		}
+		for (int i = 0; i < total; ++i)
+		{
+			if (all[i] != i)
+			{
+				return false;
+			}
+		}
+		int dummy;
+		return outOfOrder.load() == 0 && !c.pop(dummy);
+	}
+}
+
+AUTO_UNIT_TEST(LockFreeTestCases_testStack)
+{
+	LockFreeStack<String> s;
+	unitAssert(s.empty());
+	String x;
+	unitAssert(!s.pop(x));
+	s.push("a");
+	s.push("b");
+	s.push("c");
+	unitAssert(!s.empty());
+	unitAssert(s.pop(x));
+	unitAssertEquals("c", x);
+	unitAssert(s.pop(x));
+	unitAssertEquals("b", x);
+	s.push("d");
+	unitAssert(s.pop(x));
+	unitAssertEquals("d", x);
+	unitAssert(s.pop(x));
+	unitAssertEquals("a", x);
+	unitAssert(!s.pop(x));
+
+	// the destructor frees nodes still on the stack.
+	s.push("e");
+}
+
+AUTO_UNIT_TEST(LockFreeTestCases_testStackStress)
+{
+	LockFreeStack<int> s;
+	unitAssert(stress(s, 4, 4, false));
+	unitAssert(s.empty());
+}
+
+AUTO_UNIT_TEST(LockFreeTestCases_testBoundedMPMCQueue)
+{
+	BoundedMPMCQueue<String> q(3);
+	unitAssertEquals(size_t(4), q.capacity());
+	String x;
+	unitAssert(!q.pop(x));
+	unitAssert(q.push("1"));
+	unitAssert(q.push("2"));
+	unitAssert(q.push("3"));
+	unitAssert(q.push("4"));
+	unitAssert(!q.push("5"));
+	unitAssert(q.pop(x));
+	unitAssertEquals("1", x);
+	unitAssert(q.push("5"));
+	for (int i = 2; i <= 5; ++i)
+	{
+		unitAssert(q.pop(x));
+		unitAssertEquals(String(i), x);
+	}
+	unitAssert(!q.pop(x));
+}
+
+AUTO_UNIT_TEST(LockFreeTestCases_testBoundedMPMCQueueStress)
+{
+	BoundedMPMCQueue<int> q(64);
+	unitAssert(stress(q, 4, 4, true));
+}
+
+AUTO_UNIT_TEST(LockFreeTestCases_testSPSCRingBuffer)
+{
+	SPSCRingBuffer<String> r(4);
+	unitAssertEquals(size_t(4), r.capacity());
+	String x;
+	unitAssert(!r.pop(x));
+	for (int i = 0; i < 4; ++i)
+	{
+		unitAssert(r.push(String(i)));
+	}
+	unitAssert(!r.push("full"));
+	unitAssertEquals(size_t(4), r.size());
+	for (int lap = 0; lap < 3; ++lap)
+	{
+		unitAssert(r.pop(x));
+		unitAssert(r.push(String(4 + lap)));
+	}
+	for (int i = 3; i < 7; ++i)
+	{
+		unitAssert(r.pop(x));
+		unitAssertEquals(String(i), x);
+	}
+	unitAssert(!r.pop(x));
+}
+
+AUTO_UNIT_TEST(LockFreeTestCases_testSPSCRingBufferStress)
+{
+	SPSCRingBuffer<int> r(16);
+	unitAssert(stress(r, 1, 1, true));
+}
+
@@ -36,6 +36,14 @@
 #include "AutoTest.hpp"
 #include "blocxx/LogAppender.hpp"
 #include "blocxx/NullAppender.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/Semaphore.hpp"
+#include "blocxx/Logger.hpp"
+#include "blocxx/LogMessage.hpp"
+#include "blocxx/LogSymbol.hpp"
+#include "blocxx/Format.hpp"
+
+#include <vector>
 
 using namespace blocxx;
 
@@ -66,3 +74,187 @@ AUTO_UNIT_TEST(LogAppenderTestCases_testThread)
 	LogAppender::setThreadLogAppender(LogAppenderRef());
 	unitAssert( !LogAppender::getThreadLogAppender() );
 }
+
+namespace
+{
+	class DefaultAppenderReader : public Thread
+	{
+	public:
+		DefaultAppenderReader(Semaphore& cached, Semaphore& changed)
+		: m_cached(cached)
+		, m_changed(changed)
+		{
+		}
+		LogAppenderRef first;
+		LogAppenderRef second;
+	protected:
+		virtual Int32 run()
+		{
+			first = LogAppender::getDefaultLogAppender();
+			m_cached.signal();
+			m_changed.wait();
+			second = LogAppender::getDefaultLogAppender();
+			return 0;
+		}
+	private:
+		Semaphore& m_cached;
+		Semaphore& m_changed;
+	};
+}
+
+AUTO_UNIT_TEST(LogAppenderTestCases_testDefaultChangeSeenByOtherThreads)
+{
+	LogAppenderRef a(new TestLogAppender);
+	LogAppenderRef b(new TestLogAppender);
+	LogAppender::setDefaultLogAppender(a);
+	unitAssert( LogAppender::getDefaultLogAppender() == a );
+
+	Semaphore cached;
+	Semaphore changed;
+	DefaultAppenderReader reader(cached, changed);
+	reader.start();
+	cached.wait();
+	LogAppender::setDefaultLogAppender(b);
+	changed.signal();
+	reader.join();
+
+	unitAssert( reader.first == a );
+	unitAssert( reader.second == b );
+	unitAssert( LogAppender::getDefaultLogAppender() == b );
+	unitAssert( LogAppender::getCurrentLogAppender() == b );
+}
+
+namespace
+{
+	class CountingAppender : public LogAppender
+	{
+	public:
+		CountingAppender(const StringArray& components, const StringArray& categories)
+		: LogAppender(components, categories, "%m")
+		, count(0)
+		{
+		}
+		mutable int count;
+	private:
+		virtual void doProcessLogMessage(const String& formattedMessage, const LogMessage& message) const
+		{
+			++count;
+		}
+	};
+}
+
+AUTO_UNIT_TEST(LogAppenderTestCases_testSymbolIds)
+{
+	LogComponentId a("LogAppenderTestCases.a");
+	unitAssert( a.isValid() );
+	unitAssert( a == LogComponentId("LogAppenderTestCases.a") );
+	unitAssert( a == LogComponentId::find("LogAppenderTestCases.a") );
+	unitAssertEquals( String("LogAppenderTestCases.a"), a.toString() );
+	unitAssert( !LogComponentId::find("LogAppenderTestCases.never.interned").isValid() );
+	unitAssert( !LogComponentId().isValid() );
+
+	for (int level = E_FATAL_ERROR_LEVEL; level < E_ALL_LEVEL; ++level)
+	{
+		String name = Logger::logLevelToString(ELogLevel(level));
+		unitAssert( LogCategoryId::forLevel(ELogLevel(level)) == LogCategoryId(name) );
+		unitAssertEquals( name, LogCategoryId::forLevel(ELogLevel(level)).toString() );
+	}
+	unitAssert( !LogCategoryId::forLevel(E_NONE_LEVEL).isValid() );
+}
+
+AUTO_UNIT_TEST(LogAppenderTestCases_testComponentFiltering)
+{
+	StringArray components;
+	components.push_back("LogAppenderTestCases.enabled");
+	StringArray categories;
+	categories.push_back(Logger::STR_ERROR_CATEGORY);
+	categories.push_back("custom");
+	IntrusiveReference<CountingAppender> appender(new CountingAppender(components, categories));
+
+	unitAssert( appender->componentAndCategoryAreEnabled("LogAppenderTestCases.enabled", "custom") );
+	unitAssert( !appender->componentAndCategoryAreEnabled("LogAppenderTestCases.disabled", "custom") );
+	unitAssert( !appender->componentAndCategoryAreEnabled("LogAppenderTestCases.enabled", Logger::STR_INFO_CATEGORY) );
+	unitAssert( appender->componentAndCategoryAreEnabled(
+		LogComponentId("LogAppenderTestCases.enabled"), LogCategoryId::forLevel(E_ERROR_LEVEL)) );
+	unitAssert( !appender->componentAndCategoryAreEnabled(
+		LogComponentId("LogAppenderTestCases.disabled"), LogCategoryId::forLevel(E_ERROR_LEVEL)) );
+	unitAssert( !appender->categoryIsEnabled(LogCategoryId()) );
+
+	Logger enabled("LogAppenderTestCases.enabled", LogAppenderRef(appender));
+	Logger disabled("LogAppenderTestCases.disabled", LogAppenderRef(appender));
+	enabled.logError("one");
+	disabled.logError("two");
+	unitAssertEquals(1, appender->count);
+
+	enabled.logMessage("custom", "three");
+	disabled.logMessage("custom", "four");
+	unitAssertEquals(2, appender->count);
+
+	// the macros, and a category no appender names
+	BLOCXX_LOG_ERROR(enabled, "five");
+	BLOCXX_LOG_ERROR(disabled, "six");
+	BLOCXX_LOG(enabled, "custom", "seven");
+	BLOCXX_LOG(enabled, "LogAppenderTestCases.never.interned", "eight");
+	unitAssertEquals(4, appender->count);
+
+	enabled.setDefaultComponent("LogAppenderTestCases.disabled");
+	enabled.logError("nine");
+	unitAssertEquals(4, appender->count);
+}
+
+namespace
+{
+	// Interns names of its own while other threads do the same, and checks
+	// that every name keeps its id.
+	class SymbolInterner : public Thread
+	{
+	public:
+		SymbolInterner(int id)
+		: failures(0)
+		, m_id(id)
+		{
+		}
+		int failures;
+	protected:
+		virtual Int32 run()
+		{
+			const int NAMES = 200;
+			std::vector<LogComponentId> ids;
+			for (int i = 0; i < NAMES; ++i)
+			{
+				String name = Format("LogAppenderTestCases.interner%1.%2", m_id, i);
+				ids.push_back(LogComponentId(name));
+				for (int j = 0; j <= i; ++j)
+				{
+					String earlier = Format("LogAppenderTestCases.interner%1.%2", m_id, j);
+					if (LogComponentId::find(earlier) != ids[j] || ids[j].toString() != earlier)
+					{
+						++failures;
+					}
+				}
+			}
+			return 0;
+		}
+	private:
+		int m_id;
+	};
+}
+
+AUTO_UNIT_TEST(LogAppenderTestCases_testConcurrentInterning)
+{
+	std::vector<SymbolInterner*> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.push_back(new SymbolInterner(i));
+	}
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		threads[i]->start();
+	}
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		threads[i]->join();
+		unitAssertEquals(0, threads[i]->failures);
+		delete threads[i];
+	}
+}
@@ -36,6 +36,7 @@
 #include "blocxx/ThreadBarrier.hpp"
 #include "blocxx/Thread.hpp"
 #include "blocxx/Timeout.hpp"
+#include <vector>
 
 using namespace blocxx;
 
@@ -387,3 +388,29 @@ AUTO_UNIT_TEST(MTQueueTestCases_testShutdownUnblocksAllPops)
 	unitAssertEquals(1U, th1.count());
 	unitAssertEquals(1U, th2.count());
 }
+
+AUTO_UNIT_TEST(MTQueueTestCases_testBatch)
+{
+	MTQueue<int> q(10);
+	int items[] = { 1, 2, 3, 4, 5 };
+	q.pushBackBatch(items, items + 5);
+
+	std::vector<int> values;
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFrontBatch(Timeout::relative(1.0), 3, values));
+	unitAssertEquals(3U, values.size());
+	unitAssertEquals(1, values[0]);
+	unitAssertEquals(3, values[2]);
+
+	// fewer items than asked for doesn't wait
+	unitAssertEquals(MTQueueEnum::E_VALUE, q.popFrontBatch(Timeout::infinite, 10, values));
+	unitAssertEquals(5U, values.size());
+	unitAssertEquals(5, values[4]);
+
+	unitAssertEquals(MTQueueEnum::E_TIMED_OUT, q.popFrontBatch(Timeout::relative(0.01), 10, values));
+	unitAssertEquals(5U, values.size());
+
+	q.shutdown();
+	q.pushBackBatch(items, items + 5);
+	unitAssertEquals(MTQueueEnum::E_SHUT_DOWN, q.popFrontBatch(Timeout::infinite, 10, values));
+	unitAssertEquals(5U, values.size());
+}
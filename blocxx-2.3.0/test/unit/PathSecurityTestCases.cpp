@@ -39,7 +39,13 @@
 #define PROVIDE_AUTO_TEST_MAIN
 #include "AutoTest.hpp"
 #include "blocxx/FileSystem.hpp"
+#include "blocxx/File.hpp"
 #include "blocxx/RandomNumber.hpp"
+#ifndef BLOCXX_WIN32
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
 
 using namespace blocxx;
 
@@ -156,3 +162,75 @@ AUTO_UNIT_TEST(PathSecurityTestCases_testInvalidPaths)
 		}
 	}
 }
+
+#ifndef BLOCXX_WIN32
+AUTO_UNIT_TEST(PathSecurityTestCases_testSymlinksAndParents)
+{
+	using namespace FileSystem::Path;
+	typedef std::pair<ESecurity, String> result_t;
+
+	// /tmp is sticky, so a directory of ours in it is secure.
+	char tmpl[] = "/tmp/blocxx_pathsecurity_XXXXXX";
+	unitAssert(::mkdtemp(tmpl) != 0);
+	unitAssert(::chmod(tmpl, 0755) == 0);
+	const String base(tmpl);
+	const String baseName = base.substring(base.lastIndexOf('/') + 1);
+	unitAssert(::mkdir((base + "/sub").c_str(), 0755) == 0);
+	unitAssert(::chmod((base + "/sub").c_str(), 0755) == 0);
+	unitAssert(::mkdir((base + "/open").c_str(), 0755) == 0);
+	unitAssert(::chmod((base + "/open").c_str(), 0777) == 0);
+	{
+		File f(FileSystem::createFile(base + "/sub/file"));
+		File g(FileSystem::createFile(base + "/open/file"));
+	}
+	unitAssert(::chmod((base + "/sub/file").c_str(), 0644) == 0);
+	unitAssert(::chmod((base + "/open/file").c_str(), 0644) == 0);
+	unitAssert(::symlink("sub", (base + "/link").c_str()) == 0);
+	unitAssert(::symlink((base + "/sub").c_str(), (base + "/abs").c_str()) == 0);
+
+	result_t r;
+	r = security(base + "/sub");
+	unitAssertEquals(E_SECURE_DIR, r.first);
+	unitAssertEquals(base + "/sub", r.second);
+
+	// twice, so the second time the link target may come from a cache
+	for (int i = 0; i < 2; ++i)
+	{
+		r = security(base + "/link/file");
+		unitAssertEquals(E_SECURE_FILE, r.first);
+		unitAssertEquals(base + "/sub/file", r.second);
+	}
+	r = security(base + "/abs/./file");
+	unitAssertEquals(E_SECURE_FILE, r.first);
+	unitAssertEquals(base + "/sub/file", r.second);
+	r = security(base + "/sub/../link/../abs/file");
+	unitAssertEquals(E_SECURE_FILE, r.first);
+	unitAssertEquals(base + "/sub/file", r.second);
+
+	// climbing above base_dir
+	r = security(base + "/sub", "../../" + baseName + "/link/file");
+	unitAssertEquals(E_SECURE_FILE, r.first);
+	unitAssertEquals(base + "/sub/file", r.second);
+
+	r = security(base + "/open", E_SECURITY_DO_NOTHING);
+	unitAssertEquals(E_INSECURE, r.first);
+
+	// A replaced link is followed to its new target.
+	unitAssert(::unlink((base + "/link").c_str()) == 0);
+	unitAssert(::symlink("open", (base + "/link").c_str()) == 0);
+	r = security(base + "/link", E_SECURITY_DO_NOTHING);
+	unitAssertEquals(E_INSECURE, r.first);
+	unitAssertEquals(base + "/open", r.second);
+
+	unitAssertThrowsEx(security(base + "/missing"), FileSystemException);
+	unitAssertThrowsEx(security(base + "/sub/file/x"), FileSystemException);
+
+	::unlink((base + "/link").c_str());
+	::unlink((base + "/abs").c_str());
+	::unlink((base + "/sub/file").c_str());
+	::unlink((base + "/open/file").c_str());
+	::rmdir((base + "/sub").c_str());
+	::rmdir((base + "/open").c_str());
+	::rmdir(tmpl);
+}
+#endif
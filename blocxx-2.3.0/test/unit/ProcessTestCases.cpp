@@ -42,6 +42,7 @@
 #include "blocxx/Timeout.hpp"
 #include "blocxx/UnnamedPipe.hpp"
 #include "blocxx/Exec.hpp"
+#include "blocxx/Select.hpp"
 
 #include <iostream>
 
@@ -86,3 +87,29 @@ AUTO_UNIT_TEST(ProcessTestCases_testSpawn)
 	unitAssert(out == "hello world\n");
 	unitAssertThrows(Exec::spawn(StringArray(1,"/a/non-existent/binary")));
 }
+
+#ifndef BLOCXX_WIN32
+AUTO_UNIT_TEST(ProcessTestCases_testExitSelectObj)
+{
+	ProcessRef rval = Exec::spawn(StringArray(1,APP2_NAME));
+	Select_t exitObj = rval->getExitSelectObj();
+	if (exitObj == BLOCXX_INVALID_HANDLE)
+	{
+		// Not supported by this platform or kernel.
+		rval->in()->close();
+		rval->waitCloseTerm();
+		return;
+	}
+	SelectTypeArray selObjs;
+	selObjs.push_back(exitObj);
+
+	// cat is waiting for input, so it must not be reported as terminated.
+	unitAssertEquals(Select::SELECT_TIMEOUT, Select::select(selObjs, Timeout::relative(0.1)));
+	unitAssert(rval->processStatus().running());
+
+	rval->in()->close();
+	unitAssertEquals(0, Select::select(selObjs, Timeout::relative(30.0)));
+	rval->waitCloseTerm(Timeout::relative(5.0), Timeout::relative(0.0), Timeout::relative(0.0));
+	unitAssert(rval->processStatus().terminatedSuccessfully());
+}
+#endif
@@ -50,6 +50,8 @@
 #include "blocxx/TimeoutTimer.hpp"
 #include "blocxx/RandomNumber.hpp"
 
+#include <vector>
+
 extern "C"
 {
 #ifdef BLOCXX_HAVE_SYS_RESOURCE_H
@@ -519,3 +521,112 @@ AUTO_UNIT_TEST(RWLockerTestCases_testRWLockerException)
 	unitAssertThrows(rwl.releaseReadLock());
 	unitAssertThrows(rwl.releaseWriteLock());
 }
+
+class WaitingWriterThread : public Thread
+{
+public:
+	WaitingWriterThread(RWLocker& locker)
+		: m_locker(locker)
+	{
+	}
+
+protected:
+	virtual Int32 run()
+	{
+		m_locker.getWriteLock(Timeout::relative(100));
+		m_locker.releaseWriteLock();
+		return 0;
+	}
+
+	RWLocker& m_locker;
+};
+
+AUTO_UNIT_TEST(RWLockerTestCases_testRecursiveReadWithWaitingWriter)
+{
+	RWLocker locker;
+	locker.getReadLock(Timeout::relative(0));
+	WaitingWriterThread writer(locker);
+	writer.start();
+	Thread::sleep(50); // give the writer a chance to start waiting
+
+	// A thread that already has a read lock doesn't wait for the writer,
+	// which is waiting for it.
+	locker.getReadLock(Timeout::relative(0));
+	locker.releaseReadLock();
+
+	locker.releaseReadLock();
+	unitAssert(writer.join() == 0);
+}
+
+class HoldingReaderThread : public Thread
+{
+public:
+	HoldingReaderThread(RWLocker& locker, const ThreadBarrier& bar)
+		: m_locker(locker)
+		, m_bar(bar)
+	{
+	}
+
+protected:
+	virtual Int32 run()
+	{
+		m_locker.getReadLock(Timeout::relative(10));
+		m_bar.wait(); // every reader holds the lock at once
+		m_locker.releaseReadLock();
+		return 0;
+	}
+
+	RWLocker& m_locker;
+	ThreadBarrier m_bar;
+};
+
+AUTO_UNIT_TEST(RWLockerTestCases_testConcurrentReaders)
+{
+	// More threads than there are reader shards.
+	const int NUM_READERS = 24;
+	RWLocker locker;
+	ThreadBarrier bar(NUM_READERS);
+	std::vector<ThreadRef> readers;
+	for (int i = 0; i < NUM_READERS; ++i)
+	{
+		readers.push_back(ThreadRef(new HoldingReaderThread(locker, bar)));
+		readers.back()->start();
+	}
+	for (int i = 0; i < NUM_READERS; ++i)
+	{
+		unitAssert(readers[i]->join() == 0);
+	}
+
+	// Everyone has released it.
+	locker.getWriteLock(Timeout::relative(0));
+	locker.releaseWriteLock();
+}
+
+AUTO_UNIT_TEST(RWLockerTestCases_testSeveralLocksPerThread)
+{
+	const int NUM_LOCKS = 8;
+	RWLocker lockers[NUM_LOCKS];
+	for (int i = 0; i < NUM_LOCKS; ++i)
+	{
+		lockers[i].getReadLock(Timeout::relative(0));
+	}
+	lockers[3].getWriteLock(Timeout::relative(0));
+	lockers[3].getReadLock(Timeout::relative(0));
+	for (int i = NUM_LOCKS - 1; i >= 0; i -= 2)
+	{
+		lockers[i].releaseReadLock();
+	}
+	unitAssertThrows(lockers[NUM_LOCKS - 1].releaseReadLock());
+	lockers[3].releaseReadLock();
+	lockers[3].releaseWriteLock();
+	for (int i = 0; i < NUM_LOCKS; i += 2)
+	{
+		lockers[i].releaseReadLock();
+	}
+	for (int i = 0; i < NUM_LOCKS; ++i)
+	{
+		unitAssertThrows(lockers[i].releaseReadLock());
+		lockers[i].getWriteLock(Timeout::relative(0));
+		lockers[i].releaseWriteLock();
+	}
+}
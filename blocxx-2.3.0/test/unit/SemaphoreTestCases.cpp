@@ -0,0 +1,139 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/Semaphore.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/Timeout.hpp"
+#include "blocxx/TimeoutTimer.hpp"
+
+#include <vector>
+
+using namespace blocxx;
+
+AUTO_UNIT_TEST(SemaphoreTestCases_testCount)
+{
+	Semaphore sem(2);
+	unitAssertEquals(2, sem.getCount());
+	sem.wait();
+	unitAssert(sem.timedWait(Timeout::relative(0)));
+	unitAssertEquals(0, sem.getCount());
+	unitAssert(!sem.timedWait(Timeout::relative(0)));
+
+	sem.signal();
+	unitAssertEquals(1, sem.getCount());
+	unitAssert(sem.timedWait(Timeout::infinite));
+	unitAssertEquals(0, sem.getCount());
+}
+
+AUTO_UNIT_TEST(SemaphoreTestCases_testTimedWaitTimesOut)
+{
+	Semaphore sem;
+	TimeoutTimer timer(Timeout::relative(0.05));
+	unitAssert(!sem.timedWait(Timeout::relative(0.05)));
+	timer.loop();
+	unitAssert(timer.expired());
+	unitAssertEquals(0, sem.getCount());
+}
+
+namespace
+{
+	// Waits on or signals a semaphore count times.
+	class SemaphoreThread : public Thread
+	{
+	public:
+		SemaphoreThread(Semaphore& sem, int count, bool signal)
+			: m_sem(sem)
+			, m_count(count)
+			, m_signal(signal)
+		{
+		}
+
+	private:
+		virtual Int32 run()
+		{
+			for (int i = 0; i < m_count; ++i)
+			{
+				if (m_signal)
+				{
+					m_sem.signal();
+				}
+				else if (!m_sem.timedWait(Timeout::relative(60)))
+				{
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		Semaphore& m_sem;
+		int m_count;
+		bool m_signal;
+	};
+}
+
+AUTO_UNIT_TEST(SemaphoreTestCases_testSignalWakesWaiter)
+{
+	Semaphore sem;
+	SemaphoreThread waiter(sem, 1, false);
+	waiter.start();
+	Thread::sleep(20); // let it block
+	sem.signal();
+	unitAssertEquals(0, waiter.join());
+	unitAssertEquals(0, sem.getCount());
+}
+
+AUTO_UNIT_TEST(SemaphoreTestCases_testManyWaitersAndSignalers)
+{
+	const int NUM_THREADS = 4;
+	const int COUNT = 5000;
+	Semaphore sem;
+	std::vector<ThreadRef> threads;
+	for (int i = 0; i < NUM_THREADS; ++i)
+	{
+		threads.push_back(ThreadRef(new SemaphoreThread(sem, COUNT, false)));
+		threads.push_back(ThreadRef(new SemaphoreThread(sem, COUNT, true)));
+	}
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		threads[i]->start();
+	}
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		unitAssertEquals(0, threads[i]->join());
+	}
+	unitAssertEquals(0, sem.getCount());
+}
+
@@ -0,0 +1,162 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/SmallArray.hpp"
+#include "blocxx/String.hpp"
+
+using namespace blocxx;
+
+namespace
+{
+	int g_liveObjects = 0;
+
+	// Counts its instances, to check every element is destroyed.
+	struct Tracked
+	{
+		Tracked(int v = 0) : value(v)
+		{
+			++g_liveObjects;
+		}
+		Tracked(const Tracked& x) : value(x.value)
+		{
+			++g_liveObjects;
+		}
+		~Tracked()
+		{
+			--g_liveObjects;
+		}
+		int value;
+	};
+}
+
+AUTO_UNIT_TEST(SmallArrayTestCases_testInline)
+{
+	SmallArray<String, 4> a;
+	unitAssert(a.empty());
+	unitAssert(a.isInline());
+	unitAssertEquals(4u, a.capacity());
+	a.push_back("one");
+	a.push_back("two");
+	a.push_back("three");
+	unitAssertEquals(3u, a.size());
+	unitAssert(a.isInline());
+	unitAssertEquals(String("one"), a.front());
+	unitAssertEquals(String("three"), a.back());
+	unitAssertEquals(String("two"), a[1]);
+	a.pop_back();
+	unitAssertEquals(2u, a.size());
+	unitAssertEquals(String("two"), a.back());
+}
+
+AUTO_UNIT_TEST(SmallArrayTestCases_testSpill)
+{
+	{
+		SmallArray<Tracked, 2> a;
+		for (int i = 0; i < 100; ++i)
+		{
+			a.push_back(Tracked(i));
+		}
+		unitAssert(!a.isInline());
+		unitAssertEquals(100u, a.size());
+		unitAssertEquals(100, g_liveObjects);
+		for (int i = 0; i < 100; ++i)
+		{
+			unitAssertEquals(i, a[i].value);
+		}
+		// An element of the array itself, while it grows.
+		SmallArray<Tracked, 2> b;
+		b.push_back(Tracked(7));
+		b.push_back(Tracked(8));
+		b.push_back(b[0]);
+		unitAssertEquals(7, b[2].value);
+	}
+	unitAssertEquals(0, g_liveObjects);
+}
+
+AUTO_UNIT_TEST(SmallArrayTestCases_testResize)
+{
+	{
+		SmallArray<Tracked, 4> a;
+		a.resize(10, Tracked(3));
+		unitAssertEquals(10u, a.size());
+		unitAssertEquals(3, a[9].value);
+		a.resize(2);
+		unitAssertEquals(2u, a.size());
+		unitAssertEquals(2, g_liveObjects);
+		a.reserve(50);
+		unitAssert(a.capacity() >= 50);
+		unitAssertEquals(3, a[1].value);
+		a.clear();
+		unitAssert(a.empty());
+		unitAssertEquals(0, g_liveObjects);
+	}
+	unitAssertEquals(0, g_liveObjects);
+}
+
+AUTO_UNIT_TEST(SmallArrayTestCases_testCopy)
+{
+	SmallArray<String, 2> a;
+	a.push_back("a");
+	SmallArray<String, 2> b(a);
+	b.push_back("b");
+	b.push_back("c");
+	unitAssertEquals(1u, a.size());
+	unitAssertEquals(3u, b.size());
+	a = b;
+	unitAssertEquals(3u, a.size());
+	unitAssertEquals(String("c"), a[2]);
+	b = SmallArray<String, 2>();
+	unitAssert(b.empty());
+
+	StringArray sa;
+	sa.push_back("x");
+	sa.push_back("y");
+	SmallArray<String, 2> c(sa.begin(), sa.end());
+	unitAssertEquals(2u, c.size());
+	unitAssertEquals(String("y"), c[1]);
+}
+
+AUTO_UNIT_TEST(SmallArrayTestCases_testToArray)
+{
+	SmallArray<String, 4> a;
+	unitAssert(a.toArray().empty());
+	a.push_back("one");
+	a.push_back("two");
+	StringArray sa = a.toArray();
+	unitAssertEquals(2u, sa.size());
+	unitAssertEquals(String("one"), sa[0]);
+	unitAssertEquals(String("two"), sa[1]);
+}
@@ -0,0 +1,176 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/SmallObjectPool.hpp"
+#include "blocxx/Thread.hpp"
+
+#include <cstring>
+
+using namespace blocxx;
+
+namespace
+{
+	inline bool isAligned(void* p)
+	{
+		return reinterpret_cast<size_t>(p) % 16 == 0;
+	}
+
+	class Base : public PooledObject
+	{
+	public:
+		Base(int& destroyed) : m_destroyed(destroyed)
+		{
+		}
+		virtual ~Base()
+		{
+			++m_destroyed;
+		}
+	private:
+		int& m_destroyed;
+	};
+
+	class Derived : public Base
+	{
+	public:
+		Derived(int& destroyed) : Base(destroyed)
+		{
+			std::memset(m_data, 'd', sizeof(m_data));
+		}
+	private:
+		char m_data[100];
+	};
+
+	class Huge : public PooledObject
+	{
+	private:
+		char m_data[SmallObjectPool::MAX_SIZE * 2];
+	};
+
+	const size_t OBJECT_SIZE = 64;
+	const size_t OBJECT_COUNT = 1000;
+
+	// Allocates objects, and frees the first half itself, leaving the rest
+	// for another thread to free.
+	class AllocatingThread : public Thread
+	{
+	public:
+		AllocatingThread(void** objects) : m_objects(objects)
+		{
+		}
+		virtual Int32 run()
+		{
+			for (size_t i = 0; i < OBJECT_COUNT; ++i)
+			{
+				m_objects[i] = SmallObjectPool::allocate(OBJECT_SIZE);
+				std::memset(m_objects[i], int(i), OBJECT_SIZE);
+			}
+			for (size_t i = 0; i < OBJECT_COUNT / 2; ++i)
+			{
+				SmallObjectPool::deallocate(m_objects[i], OBJECT_SIZE);
+			}
+			return 0;
+		}
+	private:
+		void** m_objects;
+	};
+}
+
+AUTO_UNIT_TEST(SmallObjectPoolTestCases_testAllocate)
+{
+	for (size_t size = 1; size <= SmallObjectPool::MAX_SIZE + 64; ++size)
+	{
+		void* a = SmallObjectPool::allocate(size);
+		void* b = SmallObjectPool::allocate(size);
+		unitAssert(a != b);
+		unitAssert(isAligned(a));
+		unitAssert(isAligned(b));
+		std::memset(a, 'a', size);
+		std::memset(b, 'b', size);
+		unitAssert(static_cast<char*>(a)[size - 1] == 'a');
+		SmallObjectPool::deallocate(a, size);
+		SmallObjectPool::deallocate(b, size);
+	}
+	SmallObjectPool::deallocate(0, 16);
+}
+
+#if !defined(BLOCXX_DEBUG_MEMORY) && !defined(BLOCXX_HEAP_PROFILER)
+AUTO_UNIT_TEST(SmallObjectPoolTestCases_testReuse)
+{
+	// 40 and 48 bytes are in the same size class.
+	void* p = SmallObjectPool::allocate(40);
+	SmallObjectPool::deallocate(p, 40);
+	void* q = SmallObjectPool::allocate(48);
+	unitAssert(p == q);
+	SmallObjectPool::deallocate(q, 48);
+
+	unitAssert(SmallObjectPool::getReservedBytes() > 0);
+}
+
+AUTO_UNIT_TEST(SmallObjectPoolTestCases_testPooledObject)
+{
+	int destroyed = 0;
+	Base* b = new Derived(destroyed);
+	delete b;
+	unitAssertEquals(1, destroyed);
+	// Deleting through the base must have freed the object as a Derived.
+	Derived* d = new Derived(destroyed);
+	unitAssert(static_cast<Base*>(d) == b);
+	delete d;
+	unitAssertEquals(2, destroyed);
+
+	Huge* h = new Huge;
+	unitAssert(h != 0);
+	delete h;
+}
+
+AUTO_UNIT_TEST(SmallObjectPoolTestCases_testThreads)
+{
+	void* objects[OBJECT_COUNT];
+	AllocatingThread t(objects);
+	t.start();
+	t.join();
+
+	// The thread's cached objects went back to the central lists when it
+	// exited.
+	unitAssert(SmallObjectPool::getCentralFreeBytes() >= OBJECT_COUNT / 2 * OBJECT_SIZE);
+
+	for (size_t i = OBJECT_COUNT / 2; i < OBJECT_COUNT; ++i)
+	{
+		unitAssert(static_cast<unsigned char*>(objects[i])[OBJECT_SIZE - 1] == (i & 0xff));
+		SmallObjectPool::deallocate(objects[i], OBJECT_SIZE);
+	}
+}
+#endif
@@ -65,3 +65,56 @@ AUTO_UNIT_TEST(StackTraceTestCases_testGetStackTrace)
 	}
 }
 #endif
+
+#if defined(BLOCXX_HAVE_BACKTRACE) && defined(BLOCXX_HAVE_DLADDR)
+// Not static, so dladdr() can find its name, and returns something so the
+// call to capture() isn't a tail call, which would leave it off the stack.
+#if defined(__GNUC__)
+__attribute__((noinline, noclone))
+#endif
+size_t captureInNamedFunction(StackTrace::CallStack& stack)
+{
+	stack.capture();
+	return stack.size();
+}
+
+AUTO_UNIT_TEST(StackTraceTestCases_testCallStack)
+{
+	StackTrace::CallStack stack;
+	unitAssertEquals(size_t(0), stack.size());
+	captureInNamedFunction(stack);
+	unitAssert(stack.size() > 1);
+	unitAssert(stack.size() <= size_t(StackTrace::CallStack::MAX_FRAMES));
+
+	// The innermost frame is the function that called capture().
+	String first = StackTrace::symbolize(stack[0]);
+	unitAssert(first.indexOf("captureInNamedFunction") != String::npos);
+
+	String text = stack.toString();
+	unitAssert(text.startsWith(first + "\n"));
+	unitAssert(text.indexOf("StackTraceTestCases_testCallStack") != String::npos);
+}
+
+AUTO_UNIT_TEST(StackTraceTestCases_testSymbolizeIsCached)
+{
+	StackTrace::CallStack stack;
+	captureInNamedFunction(stack);
+	String a = StackTrace::symbolize(stack[0]);
+	String b = StackTrace::symbolize(stack[0]);
+	unitAssertEquals(a, b);
+	unitAssertEquals(stack.toString(), stack.toString());
+}
+
+AUTO_UNIT_TEST(StackTraceTestCases_testCaptureSkipsFrames)
+{
+	void* frames[4];
+	size_t all = StackTrace::capture(frames, 4);
+	unitAssert(all > 0);
+	void* skipped[4];
+	size_t fewer = StackTrace::capture(skipped, 4, 1);
+	unitAssert(fewer > 0);
+	// Both start in this function, but skipping one starts in its caller.
+	unitAssert(StackTrace::symbolize(frames[0]).indexOf("testCaptureSkipsFrames") != String::npos);
+	unitAssert(StackTrace::symbolize(skipped[0]).indexOf("testCaptureSkipsFrames") == String::npos);
+}
+#endif
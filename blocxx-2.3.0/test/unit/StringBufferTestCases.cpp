@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/StringBuffer.hpp"
+#include "blocxx/String.hpp"
+
+using namespace blocxx;
+
+AUTO_UNIT_TEST(StringBufferTestCases_testInline)
+{
+	InlineStringBuffer<16> sb;
+	unitAssertEquals(16u, sb.allocated());
+	sb += "short";
+	sb += 42;
+	unitAssertEquals(16u, sb.allocated());
+	unitAssert(sb.equals("short42"));
+	unitAssertEquals(String("short42"), sb.releaseString());
+}
+
+AUTO_UNIT_TEST(StringBufferTestCases_testInlineSpill)
+{
+	InlineStringBuffer<8> sb("abc");
+	sb += "defghijklmnop";
+	unitAssert(sb.allocated() > 8);
+	unitAssert(sb.equals("abcdefghijklmnop"));
+	unitAssertEquals(String("abcdefghijklmnop"), sb.releaseString());
+}
+
+AUTO_UNIT_TEST(StringBufferTestCases_testInlineCopy)
+{
+	InlineStringBuffer<16> a("inline");
+	InlineStringBuffer<16> b(a);
+	b += '!';
+	unitAssert(a.equals("inline"));
+	unitAssert(b.equals("inline!"));
+
+	StringBuffer heap(a);
+	unitAssert(heap.equals(a));
+
+	a = "much longer than sixteen characters";
+	unitAssert(a.equals("much longer than sixteen characters"));
+	a = String("short");
+	unitAssert(a.equals("short"));
+	a = b;
+	unitAssert(a.equals("inline!"));
+	a = heap;
+	unitAssert(a.equals("inline"));
+}
+
+AUTO_UNIT_TEST(StringBufferTestCases_testInlineSwap)
+{
+	InlineStringBuffer<16> a("first");
+	StringBuffer b("second");
+	a.swap(b);
+	unitAssert(a.equals("second"));
+	unitAssert(b.equals("first"));
+	b.swap(a);
+	unitAssert(a.equals("first"));
+	unitAssert(b.equals("second"));
+
+	InlineStringBuffer<4> c;
+	c += "spilled to the heap";
+	InlineStringBuffer<4> d;
+	d += "also on the heap";
+	c.swap(d);
+	unitAssert(c.equals("also on the heap"));
+	unitAssert(d.equals("spilled to the heap"));
+
+	// Assigning through the base class goes through swap().
+	StringBuffer& base = c;
+	base = StringBuffer("x");
+	unitAssert(c.equals("x"));
+}
@@ -367,10 +367,65 @@ AUTO_UNIT_TEST(StringTestCases_testTokenizeMultipleDefaultTokensBetweenValues)
 
 AUTO_UNIT_TEST(StringTestCases_testRealConstructors)
 {
-	unitAssert(String(Real32(-32897.238)).startsWith("-32897.238"));
+	// -32897.24 is the shortest string that reads back as this float.
+	unitAssertEquals("-32897.24", String(Real32(-32897.238)));
+	unitAssertEquals(Real32(-32897.238), String(Real32(-32897.238)).toReal32());
 	unitAssert(String(Real64(-32897.23828125)).startsWith("-32897.23828125"));
 }
 
+AUTO_UNIT_TEST(StringTestCases_testIntegerConversions)
+{
+	unitAssertEquals("-2147483648", String(std::numeric_limits<Int32>::min()));
+	unitAssertEquals("4294967295", String(std::numeric_limits<UInt32>::max()));
+	unitAssertEquals("-9223372036854775808", String(std::numeric_limits<Int64>::min()));
+	unitAssertEquals("18446744073709551615", String(std::numeric_limits<UInt64>::max()));
+	unitAssertEquals("0", String(Int32(0)));
+
+	unitAssertEquals(std::numeric_limits<Int64>::min(), String("-9223372036854775808").toInt64());
+	unitAssertEquals(std::numeric_limits<UInt64>::max(), String("18446744073709551615").toUInt64());
+	unitAssertEquals(1234567812345678LL, String("+1234567812345678").toInt64());
+	unitAssertEquals(-128, String("-128").toInt8());
+	unitAssertEquals(255U, String("255").toUInt8());
+	unitAssertEquals(42, String(" 42").toInt32());
+	unitAssertEquals(16, String("0x10").toInt32(16));
+	unitAssertThrowsEx(String("-129").toInt8(), StringConversionException);
+	unitAssertThrowsEx(String("4294967296").toUInt32(), StringConversionException);
+	unitAssertThrowsEx(String("9223372036854775808").toInt64(), StringConversionException);
+	unitAssertThrowsEx(String("12345678x").toInt32(), StringConversionException);
+	unitAssertThrowsEx(String("42 ").toInt32(), StringConversionException);
+	unitAssertThrowsEx(String("-").toInt32(), StringConversionException);
+}
+
+AUTO_UNIT_TEST(StringTestCases_testRealConversionsRoundTrip)
+{
+	// The shortest string that reads back as the same value.
+	unitAssertEquals("0.1", String(Real64(0.1)));
+	unitAssertEquals("0.30000000000000004", String(Real64(0.1) + Real64(0.2)));
+	unitAssertEquals("0.1", String(Real32(0.1f)));
+	unitAssertEquals("1e+16", String(Real64(1e16)));
+	unitAssertEquals("1.5e-05", String(Real64(1.5e-5)));
+	unitAssertEquals("123456.789", String(Real64(123456.789)));
+	unitAssertEquals("-0", String(Real64(-0.0)));
+	unitAssertEquals("5e-324", String(std::numeric_limits<Real64>::denorm_min()));
+	unitAssertEquals("1.7976931348623157e+308", String(std::numeric_limits<Real64>::max()));
+
+	Real64 values[] = { 0.1, 1.0 / 3.0, 2.0 / 3.0, 1e-300, 123456789.123456789, 6.02214076e23 };
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+	{
+		unitAssertEquals(values[i], String(values[i]).toReal64());
+		unitAssertEquals(-values[i], String(-values[i]).toReal64());
+	}
+
+	unitAssertEquals(0.5, String(".5").toReal64());
+	unitAssertEquals(5.0, String("5.").toReal64());
+	unitAssertEquals(1.5f, String("+1.5e0").toReal32());
+	unitAssertEquals(1e22, String("1e22").toReal64());
+	unitAssertEquals(1e23, String("1e23").toReal64());
+	unitAssertThrowsEx(String(".").toReal64(), StringConversionException);
+	unitAssertThrowsEx(String("1e").toReal64(), StringConversionException);
+	unitAssertThrowsEx(String("1.5 ").toReal64(), StringConversionException);
+}
+
 AUTO_UNIT_TEST(StringTestCases_test_cstr)
 {
 	// This tests for a bug we found and fixed that caused c_str() to behave
@@ -422,3 +477,30 @@ AUTO_UNIT_TEST(StringTestCases_testFreeJoin)
 	String s4 = StringJoin(tokenized1.begin(), tokenized1.begin(), ", ");
 	unitAssert(s4.empty());
 }
+
+#ifdef BLOCXX_HAVE_RVALUE_REFERENCES
+AUTO_UNIT_TEST(StringTestCases_testMove)
+{
+	String a("moved string");
+	const char* buf = a.c_str();
+	String b(std::move(a));
+	unitAssert(b.c_str() == buf);
+	unitAssert(a.empty());
+
+	String c("other");
+	c = std::move(b);
+	unitAssert(c.c_str() == buf);
+
+	StringArray arr;
+	arr.push_back(std::move(c));
+	unitAssert(arr[0].c_str() == buf);
+	arr.emplace_back("emplaced");
+	unitAssertEquals(2U, arr.size());
+	unitAssertEquals(String("emplaced"), arr[1]);
+
+	StringArray arr2;
+	arr2 = std::move(arr);
+	unitAssertEquals(2U, arr2.size());
+	unitAssert(arr2[0].c_str() == buf);
+}
+#endif
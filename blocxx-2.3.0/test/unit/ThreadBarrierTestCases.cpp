@@ -41,6 +41,9 @@
 
 #include "blocxx/ThreadBarrier.hpp"
 #include "blocxx/Thread.hpp"
+#include "blocxx/Atomic.hpp"
+
+#include <vector>
 
 using namespace blocxx;
 
@@ -70,6 +73,44 @@ private:
 };
 
 
+// Counts the threads into each of rounds barrier waits, and checks that
+// nobody gets ahead of the others.
+class roundThread : public Thread
+{
+public:
+	roundThread(const ThreadBarrier& b, Atomic<Int32>& a, int n, int r)
+		: Thread()
+		, barrier(b)
+		, arrived(a)
+		, numThreads(n)
+		, rounds(r)
+	{
+	}
+
+	virtual Int32 run()
+	{
+		for (int i = 0; i < rounds; ++i)
+		{
+			arrived.fetchAdd(1);
+			barrier.wait();
+			// everyone has arrived in this round, and nobody can arrive in
+			// the next one until this thread has passed the second wait.
+			if (arrived.load() != (i + 1) * numThreads)
+			{
+				return 1;
+			}
+			barrier.wait();
+		}
+		return 0;
+	}
+
+private:
+	ThreadBarrier barrier;
+	Atomic<Int32>& arrived;
+	int numThreads;
+	int rounds;
+};
+
 } // end anonymous namespace
 
 AUTO_UNIT_TEST(ThreadBarrierTestCases_testBarrier)
@@ -90,3 +131,23 @@ AUTO_UNIT_TEST(ThreadBarrierTestCases_testBarrier)
 
 	anotherThread.join();
 }
+
+AUTO_UNIT_TEST(ThreadBarrierTestCases_testManyRounds)
+{
+	const int NUM_THREADS = 8;
+	const int ROUNDS = 500;
+	ThreadBarrier barrier(NUM_THREADS);
+	Atomic<Int32> arrived(0);
+	std::vector<ThreadRef> threads;
+	for (int i = 0; i < NUM_THREADS; ++i)
+	{
+		threads.push_back(ThreadRef(new roundThread(barrier, arrived, NUM_THREADS, ROUNDS)));
+		threads.back()->start();
+	}
+	for (int i = 0; i < NUM_THREADS; ++i)
+	{
+		unitAssertEquals(0, threads[i]->join());
+	}
+	unitAssertEquals(NUM_THREADS * ROUNDS, arrived.load());
+}
+
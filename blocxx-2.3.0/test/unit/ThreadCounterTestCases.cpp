@@ -0,0 +1,158 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx/ThreadCounter.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/Timeout.hpp"
+#include "blocxx/TimeoutException.hpp"
+
+#include <vector>
+
+using namespace blocxx;
+
+AUTO_UNIT_TEST(ThreadCounterTestCases_testMax)
+{
+	ThreadCounter counter(2);
+	counter.incThreadCount(Timeout::relative(0));
+	counter.incThreadCount(Timeout::relative(0));
+	unitAssertEquals(2, counter.getThreadCount());
+	unitAssertThrows(counter.incThreadCount(Timeout::relative(0.01)));
+	unitAssertEquals(2, counter.getThreadCount());
+
+	counter.setMax(3);
+	counter.incThreadCount(Timeout::relative(0));
+	unitAssertEquals(3, counter.getThreadCount());
+
+	counter.decThreadCount();
+	counter.decThreadCount();
+	counter.decThreadCount();
+	unitAssertEquals(0, counter.getThreadCount());
+	counter.waitForAll(Timeout::relative(0));
+}
+
+namespace
+{
+	// Takes a slot from the counter and gives it back, count times.
+	class CountingThread : public Thread
+	{
+	public:
+		CountingThread(ThreadCounter& counter, int count)
+			: m_counter(counter)
+			, m_count(count)
+		{
+		}
+
+	private:
+		virtual Int32 run()
+		{
+			for (int i = 0; i < m_count; ++i)
+			{
+				m_counter.incThreadCount(Timeout::relative(60));
+				if (m_counter.getThreadCount() > 2)
+				{
+					return 1;
+				}
+				m_counter.decThreadCount();
+			}
+			return 0;
+		}
+
+		ThreadCounter& m_counter;
+		int m_count;
+	};
+
+	class DecrementThread : public Thread
+	{
+	public:
+		DecrementThread(ThreadCounter& counter)
+			: m_counter(counter)
+		{
+		}
+
+	private:
+		virtual Int32 run()
+		{
+			Thread::sleep(20);
+			m_counter.decThreadCount();
+			return 0;
+		}
+
+		ThreadCounter& m_counter;
+	};
+}
+
+AUTO_UNIT_TEST(ThreadCounterTestCases_testIncBlocksUntilDec)
+{
+	ThreadCounter counter(1);
+	counter.incThreadCount(Timeout::relative(0));
+	DecrementThread decrementer(counter);
+	decrementer.start();
+	counter.incThreadCount(Timeout::relative(60));
+	unitAssertEquals(1, counter.getThreadCount());
+	decrementer.join();
+	counter.decThreadCount();
+}
+
+AUTO_UNIT_TEST(ThreadCounterTestCases_testWaitForAll)
+{
+	ThreadCounter counter(5);
+	counter.incThreadCount(Timeout::relative(0));
+	unitAssertThrows(counter.waitForAll(Timeout::relative(0.01)));
+
+	DecrementThread decrementer(counter);
+	decrementer.start();
+	counter.waitForAll(Timeout::relative(60));
+	unitAssertEquals(0, counter.getThreadCount());
+	decrementer.join();
+}
+
+AUTO_UNIT_TEST(ThreadCounterTestCases_testContention)
+{
+	const int NUM_THREADS = 6;
+	ThreadCounter counter(2);
+	std::vector<ThreadRef> threads;
+	for (int i = 0; i < NUM_THREADS; ++i)
+	{
+		threads.push_back(ThreadRef(new CountingThread(counter, 2000)));
+		threads.back()->start();
+	}
+	for (int i = 0; i < NUM_THREADS; ++i)
+	{
+		unitAssertEquals(0, threads[i]->join());
+	}
+	unitAssertEquals(0, counter.getThreadCount());
+}
+
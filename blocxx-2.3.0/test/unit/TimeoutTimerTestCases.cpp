@@ -39,6 +39,7 @@
 #include "blocxx/Thread.hpp"
 #include "blocxx/Infinity.hpp"
 #include "blocxx/TimeDuration.hpp"
+#include "blocxx/TimePoint.hpp"
 
 #include <iostream>
 using namespace std;
@@ -65,8 +66,32 @@ namespace
 		{
 			return currentTime;
 		}
+
+		// move the monotonic clock by the same amount as the faked wall clock.
+		virtual Time::TimePoint getCurrentMonotonicTime() const
+		{
+			return Time::TimePoint::now() + (currentTime - DateTime::getCurrent());
+		}
 	};
 	DateTime TestTimeoutTimer::currentTime;
+
+	// Simulates the system time being changed: only the wall clock moves.
+	class WallClockJumpTimeoutTimer : public TimeoutTimer
+	{
+	public:
+		WallClockJumpTimeoutTimer(const Timeout& x)
+		: TimeoutTimer(x)
+		{
+		}
+
+		static Time::TimeDuration jump;
+
+		virtual DateTime getCurrentTime() const
+		{
+			return DateTime::getCurrent() + jump;
+		}
+	};
+	Time::TimeDuration WallClockJumpTimeoutTimer::jump;
 }
 
 AUTO_UNIT_TEST(TimeoutTimerTestCases_testRelative)
@@ -170,6 +195,89 @@ AUTO_UNIT_TEST(TimeoutTimerTestCases_testAbsolute)
 	}
 }
 
+AUTO_UNIT_TEST(TimeoutTimerTestCases_testWallClockJump)
+{
+	// a relative timeout doesn't expire when the system time jumps forward...
+	{
+		WallClockJumpTimeoutTimer::jump = Time::seconds(0);
+		WallClockJumpTimeoutTimer tt(Timeout::relative(60));
+		tt.start();
+		WallClockJumpTimeoutTimer::jump = Time::hours(1);
+		tt.loop();
+		unitAssert(!tt.expired());
+		unitAssert(tt.asIntMs() > 59 * 1000);
+	}
+	// ...and doesn't wait any longer when it jumps back.
+	{
+		WallClockJumpTimeoutTimer::jump = Time::seconds(0);
+		WallClockJumpTimeoutTimer tt(Timeout::relativeWithReset(0.01));
+		tt.start();
+		WallClockJumpTimeoutTimer::jump = -Time::hours(1);
+		while (!tt.expired())
+		{
+			tt.loop();
+		}
+		unitAssert(tt.asIntMs() <= 0);
+	}
+	// converting a relative timeout to an absolute one uses the wall clock
+	// at the time of the conversion.
+	{
+		WallClockJumpTimeoutTimer::jump = Time::seconds(0);
+		WallClockJumpTimeoutTimer tt(Timeout::relative(60));
+		tt.start();
+		WallClockJumpTimeoutTimer::jump = Time::hours(1);
+		Real64 diff = Time::timeBetween(DateTime::getCurrent() + Time::hours(1),
+			tt.asAbsoluteTimeout().getAbsolute()).realSeconds();
+		unitAssert(diff > 59 && diff <= 60);
+	}
+	// an absolute timeout follows the wall clock.
+	{
+		WallClockJumpTimeoutTimer::jump = Time::seconds(0);
+		WallClockJumpTimeoutTimer tt(Timeout::absolute(DateTime::getCurrent() + Time::minutes(1)));
+		tt.start();
+		tt.loop();
+		unitAssert(!tt.expired());
+		WallClockJumpTimeoutTimer::jump = Time::hours(1);
+		tt.loop();
+		unitAssert(tt.expired());
+	}
+}
+
+AUTO_UNIT_TEST(TimeoutTimerTestCases_testasTimePoint)
+{
+	{
+		TimeoutTimer tt(Timeout::infinite);
+		unitAssert(tt.asTimePoint() == Time::TimePoint::maxValue());
+	}
+	{
+		Time::TimePoint before = Time::TimePoint::now();
+		TimeoutTimer tt(Timeout::relative(2.5));
+		Time::TimePoint after = Time::TimePoint::now();
+		unitAssert(after >= before);
+		unitAssert(tt.asTimePoint() >= before + Time::TimeDuration(2.5));
+		unitAssert(tt.asTimePoint() <= after + Time::TimeDuration(2.5));
+	}
+	{
+		// the wall clock being an hour ahead doesn't matter for an absolute
+		// timeout given relative to it.
+		WallClockJumpTimeoutTimer::jump = Time::hours(1);
+		WallClockJumpTimeoutTimer tt(Timeout::absolute(
+			DateTime::getCurrent() + Time::hours(1) + Time::seconds(10)));
+		Time::TimeDuration remaining = tt.asTimePoint() - Time::TimePoint::now();
+		// The timer reads the wall clock and the monotonic clock one after
+		// the other, so allow a little slack over 10 seconds.
+		unitAssert(remaining.realSeconds() > 9 && remaining.realSeconds() < 10.5);
+	}
+	{
+		Time::TimePoint p(1500000);
+		timespec ts;
+		unitAssert(p.toTimespec(ts) == &ts);
+		unitAssertLongsEqual(1, ts.tv_sec);
+		unitAssertLongsEqual(500000000, ts.tv_nsec);
+		unitAssert((p - Time::TimePoint(500000)).microseconds() == 1000000);
+	}
+}
+
 namespace
 {
 
@@ -190,6 +298,10 @@ Real64 calcDiff(const DateTime& x, const DateTime& y)
 	return Time::timeBetween(x,y).realSeconds();
 }
 
+// A relative timer works its wall clock start out from the monotonic clock
+// when it's converted, and the two clocks are read a moment apart.
+const Real64 CLOCK_SKEW = 0.001;
+
 } // end unnamed namespace
 
 AUTO_UNIT_TEST(TimeoutTimerTestCases_testasTimespec)
@@ -206,8 +318,8 @@ AUTO_UNIT_TEST(TimeoutTimerTestCases_testasTimespec)
 		TimeoutTimer tt(t);
 		gettimeofday(&now2, 0);
 		tt.asTimespec(timeout);
-		unitAssert(calcDiff(now1, timeout) >= vals[i] - vals[i] * 0.01);
-		unitAssert(calcDiff(now2, timeout) <= vals[i] + vals[i] * 0.01);
+		unitAssert(calcDiff(now1, timeout) >= vals[i] - vals[i] * 0.01 - CLOCK_SKEW);
+		unitAssert(calcDiff(now2, timeout) <= vals[i] + vals[i] * 0.01 + CLOCK_SKEW);
 	}
 	for (unsigned i = 0; i < sizeof(vals)/sizeof(vals[0]); ++i)
 	{
@@ -219,8 +331,8 @@ AUTO_UNIT_TEST(TimeoutTimerTestCases_testasTimespec)
 		TimeoutTimer tt(t);
 		gettimeofday(&now2, 0);
 		tt.asTimespec(timeout);
-		unitAssert(calcDiff(now1, timeout) >= vals[i] - vals[i] * 0.01);
-		unitAssert(calcDiff(now2, timeout) <= vals[i] + vals[i] * 0.01);
+		unitAssert(calcDiff(now1, timeout) >= vals[i] - vals[i] * 0.01 - CLOCK_SKEW);
+		unitAssert(calcDiff(now2, timeout) <= vals[i] + vals[i] * 0.01 + CLOCK_SKEW);
 	}
 	{
 		Timeout t = Timeout::relative(2);
@@ -324,8 +436,8 @@ AUTO_UNIT_TEST(TimeoutTimerTestCases_testasAbsoluteTimeout)
 		DateTime now2 = DateTime::getCurrent();
 		Timeout abst = tt.asAbsoluteTimeout();
 		unitAssert(abst.getType() == Timeout::E_ABSOLUTE);
-		unitAssertGreaterOrEqual(calcDiff(now1, abst.getAbsolute()), vals[i] - vals[i] * 0.01);
-		unitAssertLessOrEqual(calcDiff(now2, abst.getAbsolute()), vals[i] + vals[i] * 0.01);
+		unitAssertGreaterOrEqual(calcDiff(now1, abst.getAbsolute()), vals[i] - vals[i] * 0.01 - CLOCK_SKEW);
+		unitAssertLessOrEqual(calcDiff(now2, abst.getAbsolute()), vals[i] + vals[i] * 0.01 + CLOCK_SKEW);
 	}
 	for (unsigned i = 0; i < sizeof(vals)/sizeof(vals[0]); ++i)
 	{
@@ -335,8 +447,8 @@ AUTO_UNIT_TEST(TimeoutTimerTestCases_testasAbsoluteTimeout)
 		DateTime now2 = DateTime::getCurrent();
 		Timeout abst = tt.asAbsoluteTimeout();
 		unitAssert(abst.getType() == Timeout::E_ABSOLUTE);
-		unitAssertGreaterOrEqual(calcDiff(now1, abst.getAbsolute()), vals[i] - vals[i] * 0.01);
-		unitAssertLessOrEqual(calcDiff(now2, abst.getAbsolute()), vals[i] + vals[i] * 0.01);
+		unitAssertGreaterOrEqual(calcDiff(now1, abst.getAbsolute()), vals[i] - vals[i] * 0.01 - CLOCK_SKEW);
+		unitAssertLessOrEqual(calcDiff(now2, abst.getAbsolute()), vals[i] + vals[i] * 0.01 + CLOCK_SKEW);
 	}
 
 	{
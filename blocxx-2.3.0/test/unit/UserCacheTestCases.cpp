@@ -0,0 +1,302 @@
+/*******************************************************************************
+* Copyright (C) 2009-2010, Quest Software, Inc. All rights reserved.
+* Copyright (C) 2006, Novell, Inc. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright notice,
+*       this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in the
+*       documentation and/or other materials provided with the distribution.
+*     * Neither the name of
+*       Quest Software, Inc.,
+*       nor Novell, Inc.,
+*       nor the names of its contributors or employees may be used to
+*       endorse or promote products derived from this software without
+*       specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+* LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include "blocxx/BLOCXX_config.h"
+#define PROVIDE_AUTO_TEST_MAIN
+#include "AutoTest.hpp"
+
+#include "blocxx_test/CannedFileSystem.hpp"
+#include "blocxx_test/FileSystemMockObjectScope.hpp"
+
+#include "blocxx/UserCache.hpp"
+#include "blocxx/UserUtils.hpp"
+#include "blocxx/String.hpp"
+#include "blocxx/Thread.hpp"
+#include "blocxx/TimePoint.hpp"
+
+#include <vector>
+
+using namespace blocxx;
+
+namespace
+{
+	const char PASSWD[] =
+		"root:x:0:0:root:/root:/bin/bash\n"
+		"# a comment\n"
+		"daemon:x:1:1:daemon:/usr/sbin:/bin/sh\n"
+		"\n"
+		"alice:x:1000:100:Alice:/home/alice:/bin/bash\n";
+
+	const char GROUP[] =
+		"root:x:0:\n"
+		"wheel:x:10:root,alice\n"
+		"users:x:100:\n";
+
+	// Replace a file in the canned filesystem, with the given mtime.
+	void setFile(blocxx::Test::FSMockObjectRef& fs, const String& path, const String& contents, time_t mtime)
+	{
+		FileSystem::FileInformation info;
+		info.mtime = DateTime(mtime);
+		info.ctime = info.mtime;
+		info.size = contents.length();
+		info.type = FileSystem::FileInformation::E_FILE_REGULAR;
+		info.permissions = FileSystem::FileInformation::E_FILE_USER_READ;
+		blocxx::Test::addNormalFile(fs, path, contents, info);
+	}
+
+	blocxx::Test::FSMockObjectRef fixtureFS()
+	{
+		blocxx::Test::FSMockObjectRef fs = blocxx::Test::createCannedFSObject();
+		setFile(fs, "/etc/passwd", PASSWD, 1000);
+		setFile(fs, "/etc/group", GROUP, 1000);
+		return fs;
+	}
+
+	UserCache::Config fixtureConfig()
+	{
+		UserCache::Config config;
+		config.passwdFile = "/etc/passwd";
+		config.groupFile = "/etc/group";
+		config.positiveTTL = 60;
+		config.negativeTTL = 10;
+		config.checkFiles = false;
+		return config;
+	}
+
+	class TestCache : public UserCache
+	{
+	public:
+		TestCache(const Config& config)
+			: UserCache(config)
+			, m_now(Time::TimePoint::now())
+		{
+		}
+		void advance(long seconds)
+		{
+			m_now += Time::TimeDuration(double(seconds));
+		}
+	protected:
+		virtual Time::TimePoint getCurrentTime() const
+		{
+			return m_now;
+		}
+	private:
+		Time::TimePoint m_now;
+	};
+}
+
+AUTO_UNIT_TEST(UserCacheTestCases_testLookups)
+{
+	blocxx::Test::FileSystemMockObjectScope mos(fixtureFS());
+	UserCache cache(fixtureConfig());
+	bool ok = false;
+
+	unitAssertEquals("root", cache.getUserName(0, ok));
+	unitAssert(ok);
+	unitAssertEquals("alice", cache.getUserName(1000, ok));
+	unitAssert(ok);
+	unitAssertEquals(UserId(1), cache.getUserId("daemon", ok));
+	unitAssert(ok);
+	unitAssertEquals("users", cache.getGroupName(100, ok));
+	unitAssert(ok);
+	unitAssertEquals(GroupId(10), cache.getGroupId("wheel", ok));
+	unitAssert(ok);
+
+	unitAssertEquals("", cache.getUserName(4242, ok));
+	unitAssert(!ok);
+	unitAssertEquals(UserUtils::INVALID_USERID, cache.getUserId("bob", ok));
+	unitAssert(!ok);
+	unitAssertEquals(UserUtils::INVALID_GROUPID, cache.getGroupId("alice", ok));
+	unitAssert(!ok);
+	cache.getUserName(UserUtils::INVALID_USERID, ok);
+	unitAssert(!ok);
+
+	// answered from the cache the second time
+	unitAssertEquals("alice", cache.getUserName(1000, ok));
+	unitAssert(ok);
+	unitAssertEquals(UserUtils::INVALID_USERID, cache.getUserId("bob", ok));
+	unitAssert(!ok);
+}
+
+AUTO_UNIT_TEST(UserCacheTestCases_testExpiryAndInvalidate)
+{
+	blocxx::Test::FSMockObjectRef fs = fixtureFS();
+	blocxx::Test::FileSystemMockObjectScope mos(fs);
+	TestCache cache(fixtureConfig());
+	bool ok = false;
+
+	unitAssertEquals("alice", cache.getUserName(1000, ok));
+	unitAssertEquals(UserUtils::INVALID_USERID, cache.getUserId("bob", ok));
+
+	// Changes aren't seen while the entries are cached.
+	setFile(fs, "/etc/passwd", "bob:x:1001:100::/home/bob:/bin/sh\nalicia:x:1000:100::/:/bin/sh\n", 2000);
+	unitAssertEquals("alice", cache.getUserName(1000, ok));
+	unitAssertEquals(UserUtils::INVALID_USERID, cache.getUserId("bob", ok));
+
+	// The negative entry expires first.
+	cache.advance(11);
+	unitAssertEquals("alice", cache.getUserName(1000, ok));
+	unitAssertEquals(UserId(1001), cache.getUserId("bob", ok));
+	unitAssert(ok);
+
+	cache.advance(50);
+	unitAssertEquals("alicia", cache.getUserName(1000, ok));
+
+	setFile(fs, "/etc/passwd", PASSWD, 3000);
+	unitAssertEquals("alicia", cache.getUserName(1000, ok));
+	cache.invalidate();
+	unitAssertEquals("alice", cache.getUserName(1000, ok));
+	unitAssertEquals(UserUtils::INVALID_USERID, cache.getUserId("bob", ok));
+}
+
+AUTO_UNIT_TEST(UserCacheTestCases_testFileCheck)
+{
+	blocxx::Test::FSMockObjectRef fs = fixtureFS();
+	blocxx::Test::FileSystemMockObjectScope mos(fs);
+	UserCache::Config config(fixtureConfig());
+	config.checkFiles = true;
+	config.fileCheckInterval = 5;
+	TestCache cache(config);
+	bool ok = false;
+
+	unitAssertEquals("users", cache.getGroupName(100, ok));
+	setFile(fs, "/etc/group", "staff:x:100:\n", 2000);
+
+	// not checked again until the interval has passed
+	cache.advance(1);
+	unitAssertEquals("users", cache.getGroupName(100, ok));
+	cache.advance(5);
+	unitAssertEquals("staff", cache.getGroupName(100, ok));
+	unitAssertEquals(GroupId(100), cache.getGroupId("staff", ok));
+
+	// a file that disappears counts as a change too
+	setFile(fs, "/etc/passwd", PASSWD, 1000);
+	cache.advance(6);
+	unitAssertEquals("root", cache.getUserName(0, ok));
+	fs->removeFile("/etc/passwd");
+	cache.advance(6);
+	cache.getUserName(0, ok);
+	unitAssert(!ok);
+}
+
+AUTO_UNIT_TEST(UserCacheTestCases_testSizeLimit)
+{
+	blocxx::Test::FSMockObjectRef fs = fixtureFS();
+	blocxx::Test::FileSystemMockObjectScope mos(fs);
+	UserCache::Config config(fixtureConfig());
+	config.maxEntries = 1;
+	UserCache cache(config);
+	bool ok = false;
+
+	// Every entry goes in the same slot, so each lookup replaces the last.
+	unitAssertEquals("root", cache.getUserName(0, ok));
+	unitAssertEquals("daemon", cache.getUserName(1, ok));
+	setFile(fs, "/etc/passwd", "superuser:x:0:0::/:/bin/sh\n", 2000);
+	unitAssertEquals("superuser", cache.getUserName(0, ok));
+
+	config.maxEntries = 0;
+	UserCache uncached(config);
+	unitAssertEquals("superuser", uncached.getUserName(0, ok));
+	setFile(fs, "/etc/passwd", PASSWD, 3000);
+	unitAssertEquals("root", uncached.getUserName(0, ok));
+}
+
+namespace
+{
+	// Looks up every user and group in the fixture, many times.
+	class LookupThread : public Thread
+	{
+	public:
+		LookupThread(UserCache& cache)
+			: m_errors(0)
+			, m_cache(cache)
+		{
+		}
+
+		int m_errors;
+
+	private:
+		virtual Int32 run()
+		{
+			for (int i = 0; i < 20000; ++i)
+			{
+				bool ok;
+				if (m_cache.getUserName(0, ok) != "root" || !ok ||
+					m_cache.getUserName(1000, ok) != "alice" || !ok ||
+					m_cache.getUserId("daemon", ok) != 1 || !ok ||
+					m_cache.getGroupName(10, ok) != "wheel" || !ok ||
+					m_cache.getGroupId("users", ok) != 100 || !ok ||
+					(m_cache.getUserId("nobody", ok), ok))
+				{
+					++m_errors;
+				}
+			}
+			return 0;
+		}
+
+		UserCache& m_cache;
+	};
+}
+
+AUTO_UNIT_TEST(UserCacheTestCases_testConcurrentHits)
+{
+	blocxx::Test::FileSystemMockObjectScope mos(fixtureFS());
+	// With the default table size the fixture's keys all get slots of their
+	// own, so once the cache is warm every lookup is a hit and the threads
+	// never read the canned filesystem, which isn't thread safe.
+	TestCache cache(fixtureConfig());
+
+	std::vector<LookupThread*> threads;
+	for (int i = 0; i < 4; ++i)
+	{
+		threads.push_back(new LookupThread(cache));
+	}
+	// Warm the cache first.
+	threads[0]->start();
+	threads[0]->join();
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		if (i > 0)
+		{
+			threads[i]->start();
+		}
+	}
+	for (size_t i = 1; i < threads.size(); ++i)
+	{
+		threads[i]->join();
+	}
+	for (size_t i = 0; i < threads.size(); ++i)
+	{
+		unitAssertEquals(0, threads[i]->m_errors);
+		delete threads[i];
+	}
+}